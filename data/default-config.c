@@ -76,6 +76,10 @@ gst_config_init(void)
 	/* --- Draw latency --- */
 	/* gst_config_set_min_latency(config, 8); */
 	/* gst_config_set_max_latency(config, 33); */
+	/* gst_config_set_pty_read_budget(config, 1048576); */
+	/* gst_config_set_pty_read_time(config, 4); */
+	/* gst_config_set_glyph_atlas(config, FALSE); */
+	/* gst_config_set_render_thread(config, FALSE); */
 
 	/* --- Keybinds (append to existing, or clear first) --- */
 	/* gst_config_clear_keybinds(config); */
@@ -85,6 +89,8 @@ gst_config_init(void)
 	/* --- Module config (direct struct access) --- */
 	/* config->modules.scrollback.enabled = TRUE; */
 	/* config->modules.scrollback.lines = 10000; */
+	/* config->modules.scrollback.spill_to_disk = FALSE; */
+	/* config->modules.scrollback.search_index = FALSE; */
 	/* config->modules.transparency.opacity = 0.9; */
 	/* GST_CONFIG_SET_STRING(config->modules.urlclick.opener, "xdg-open"); */
 	/* config->modules.sixel.enabled = TRUE; */
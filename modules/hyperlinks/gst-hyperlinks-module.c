@@ -90,7 +90,7 @@ struct _GstHyperlinksModule
 	gint        hover_row;          /* mouse row position (-1 = unknown) */
 
 	/* Signal handler IDs for disconnection on deactivate */
-	gulong      sig_scrolled;       /* "line-scrolled-out" handler */
+	gulong      sig_scrolled;       /* "lines-scrolled-out" handler */
 };
 
 /* Forward declarations for interface init functions */
@@ -272,16 +272,17 @@ find_span_at(
 }
 
 /*
- * on_line_scrolled_out:
+ * on_lines_scrolled_out:
  *
- * Signal callback for "line-scrolled-out". Adjusts all span row
- * positions downward by one and removes spans that have scrolled
- * entirely off the screen (end_row < 0).
+ * Signal callback for "lines-scrolled-out". Adjusts all span row
+ * positions upward by the batch size and removes spans that have
+ * scrolled entirely off the screen (end_row < 0).
  */
 static void
-on_line_scrolled_out(
+on_lines_scrolled_out(
 	GstTerminal *term,
-	gpointer     line,
+	gpointer     lines,
+	gint         n_lines,
 	gint         cols,
 	gpointer     user_data
 ){
@@ -290,19 +291,19 @@ on_line_scrolled_out(
 	guint write_idx;
 
 	(void)term;
-	(void)line;
+	(void)lines;
 	(void)cols;
 
 	self = GST_HYPERLINKS_MODULE(user_data);
 
-	/* Shift all span rows up by one */
+	/* Shift all span rows up by the number of lines */
 	write_idx = 0;
 	for (i = 0; i < self->spans->len; i++) {
 		HyperlinkSpan *sp;
 
 		sp = &g_array_index(self->spans, HyperlinkSpan, i);
-		sp->start_row--;
-		sp->end_row--;
+		sp->start_row -= n_lines;
+		sp->end_row -= n_lines;
 
 		/* Keep spans that are still (partially) visible */
 		if (sp->end_row >= 0) {
@@ -695,7 +696,7 @@ gst_hyperlinks_module_get_description(GstModule *module)
  * activate:
  *
  * Allocates span and URI storage, connects to the terminal's
- * "line-scrolled-out" signal for scroll management.
+ * "lines-scrolled-out" signal for scroll management.
  */
 static gboolean
 gst_hyperlinks_module_activate(GstModule *module)
@@ -724,8 +725,8 @@ gst_hyperlinks_module_activate(GstModule *module)
 	term = (GstTerminal *)gst_module_manager_get_terminal(mgr);
 	if (term != NULL) {
 		self->sig_scrolled = g_signal_connect(term,
-			"line-scrolled-out",
-			G_CALLBACK(on_line_scrolled_out), self);
+			"lines-scrolled-out",
+			G_CALLBACK(on_lines_scrolled_out), self);
 	}
 
 	g_debug("hyperlinks: activated (opener=%s)", self->opener);
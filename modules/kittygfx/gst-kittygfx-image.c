@@ -55,6 +55,87 @@ placement_free(gpointer data)
 	g_free(data);
 }
 
+/*
+ * queue_render_release:
+ *
+ * Hands the image's render context upload to cache->released so
+ * the next render pass can free it, and forgets the handle. The
+ * render side cannot see the image go away on its own.
+ */
+static void
+queue_render_release(
+	GstKittyImageCache *cache,
+	GstKittyImage      *img
+){
+	if (img->render_handle != 0 && cache->released != NULL) {
+		g_array_append_val(cache->released, img->render_handle);
+	}
+	img->render_handle = 0;
+}
+
+/*
+ * image_is_placed:
+ *
+ * Returns TRUE if any placement still shows @image_id.
+ */
+static gboolean
+image_is_placed(
+	GstKittyImageCache *cache,
+	guint32             image_id
+){
+	GList *l;
+
+	for (l = cache->placements; l != NULL; l = l->next) {
+		GstImagePlacement *pl;
+
+		pl = (GstImagePlacement *)l->data;
+		if (pl->image_id == image_id) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * release_if_unplaced:
+ *
+ * Queues the upload of an image whose last placement went away.
+ * The pixels stay cached; a later display uploads them again.
+ */
+static void
+release_if_unplaced(
+	GstKittyImageCache *cache,
+	guint32             image_id
+){
+	GstKittyImage *img;
+
+	if (image_is_placed(cache, image_id)) {
+		return;
+	}
+	img = (GstKittyImage *)g_hash_table_lookup(
+		cache->images, GUINT_TO_POINTER(image_id));
+	if (img != NULL) {
+		queue_render_release(cache, img);
+	}
+}
+
+/*
+ * release_all_images:
+ *
+ * Queues the upload of every cached image.
+ */
+static void
+release_all_images(GstKittyImageCache *cache)
+{
+	GHashTableIter iter;
+	gpointer value;
+
+	g_hash_table_iter_init(&iter, cache->images);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		queue_render_release(cache, (GstKittyImage *)value);
+	}
+}
+
 /*
  * evict_lru:
  *
@@ -88,6 +169,7 @@ evict_lru(GstKittyImageCache *cache)
 
 	if (oldest != NULL) {
 		cache->total_ram -= oldest->data_size;
+		queue_render_release(cache, oldest);
 		g_hash_table_remove(cache->images, GUINT_TO_POINTER(oldest_id));
 	}
 }
@@ -191,6 +273,7 @@ finalize_upload(
 	GstKittyUpload     *upload
 ){
 	GstKittyImage *img;
+	GstKittyImage *old;
 	guchar *decoded;
 	gsize decoded_len;
 	guint8 *pixels;
@@ -327,6 +410,11 @@ finalize_upload(
 	cache->total_ram += img->data_size;
 
 	/* Remove any existing image with same id */
+	old = (GstKittyImage *)g_hash_table_lookup(cache->images,
+		GUINT_TO_POINTER(img->image_id));
+	if (old != NULL) {
+		queue_render_release(cache, old);
+	}
 	g_hash_table_remove(cache->images,
 		GUINT_TO_POINTER(img->image_id));
 
@@ -667,16 +755,10 @@ maybe_free_orphan_image(
 	guint32             image_id
 ){
 	GstKittyImage *img;
-	GList *l;
 
 	/* Check if any placement still references this image */
-	for (l = cache->placements; l != NULL; l = l->next) {
-		GstImagePlacement *pl;
-
-		pl = (GstImagePlacement *)l->data;
-		if (pl->image_id == image_id) {
-			return; /* still referenced */
-		}
+	if (image_is_placed(cache, image_id)) {
+		return;
 	}
 
 	/* No placements remain - free image data */
@@ -684,6 +766,7 @@ maybe_free_orphan_image(
 		cache->images, GUINT_TO_POINTER(image_id));
 	if (img != NULL) {
 		cache->total_ram -= img->data_size;
+		queue_render_release(cache, img);
 		g_hash_table_remove(cache->images, GUINT_TO_POINTER(image_id));
 	}
 }
@@ -723,22 +806,26 @@ delete_placements_matching(
 		pl = (GstImagePlacement *)l->data;
 
 		if (match_fn(pl, cmd, cursor_col, cursor_row)) {
-			if (free_orphans) {
-				/* Track image id for orphan check */
-				orphan_ids = g_list_prepend(orphan_ids,
-					GUINT_TO_POINTER(pl->image_id));
-			}
+			/* Track image id for orphan check */
+			orphan_ids = g_list_prepend(orphan_ids,
+				GUINT_TO_POINTER(pl->image_id));
 			placement_free(pl);
 			cache->placements = g_list_delete_link(
 				cache->placements, l);
 		}
 	}
 
-	/* Free orphaned images for uppercase variants */
-	if (free_orphans) {
-		for (l = orphan_ids; l != NULL; l = l->next) {
+	/*
+	 * Free orphaned images for uppercase variants; lowercase ones
+	 * keep the pixels but drop the upload nothing shows anymore.
+	 */
+	for (l = orphan_ids; l != NULL; l = l->next) {
+		if (free_orphans) {
 			maybe_free_orphan_image(cache,
 				GPOINTER_TO_UINT(l->data));
+		} else {
+			release_if_unplaced(cache,
+				GPOINTER_TO_UINT(l->data));
 		}
 	}
 	g_list_free(orphan_ids);
@@ -882,6 +969,7 @@ handle_delete(
 		/* Delete all placements */
 		g_list_free_full(cache->placements, placement_free);
 		cache->placements = NULL;
+		release_all_images(cache);
 
 		if (is_upper) {
 			/* Free all image data */
@@ -955,6 +1043,8 @@ handle_delete(
 
 				if (is_upper) {
 					maybe_free_orphan_image(cache, newest_id);
+				} else {
+					release_if_unplaced(cache, newest_id);
 				}
 			}
 		}
@@ -1005,20 +1095,21 @@ handle_delete(
 				next = l->next;
 				pl = (GstImagePlacement *)l->data;
 				if (pl->image_id >= lo && pl->image_id <= hi) {
-					if (is_upper) {
-						orphan_ids = g_list_prepend(orphan_ids,
-							GUINT_TO_POINTER(pl->image_id));
-					}
+					orphan_ids = g_list_prepend(orphan_ids,
+						GUINT_TO_POINTER(pl->image_id));
 					placement_free(pl);
 					cache->placements = g_list_delete_link(
 						cache->placements, l);
 				}
 			}
 
-			if (is_upper) {
-				for (l = orphan_ids; l != NULL; l = l->next) {
+			for (l = orphan_ids; l != NULL; l = l->next) {
+				if (is_upper) {
 					maybe_free_orphan_image(cache,
 						GPOINTER_TO_UINT(l->data));
+				} else {
+					release_if_unplaced(cache,
+						GPOINTER_TO_UINT(l->data));
 				}
 			}
 			g_list_free(orphan_ids);
@@ -1090,6 +1181,7 @@ gst_kitty_image_cache_new(
 	cache->max_single = (gsize)max_single_mb * 1024 * 1024;
 	cache->max_placements = max_placements;
 	cache->next_image_id = 1;
+	cache->released = NULL;
 
 	return cache;
 }
@@ -1107,6 +1199,7 @@ gst_kitty_image_cache_free(GstKittyImageCache *cache)
 		return;
 	}
 
+	release_all_images(cache);
 	g_hash_table_destroy(cache->images);
 	g_hash_table_destroy(cache->uploads);
 	g_list_free_full(cache->placements, placement_free);
@@ -1255,7 +1348,9 @@ gst_kitty_image_cache_scroll(
 ){
 	GList *l;
 	GList *next;
+	GList *gone_ids;
 
+	gone_ids = NULL;
 	for (l = cache->placements; l != NULL; l = next) {
 		GstImagePlacement *pl;
 
@@ -1265,11 +1360,18 @@ gst_kitty_image_cache_scroll(
 
 		/* Remove placements scrolled way off top */
 		if (pl->row < -1000) {
+			gone_ids = g_list_prepend(gone_ids,
+				GUINT_TO_POINTER(pl->image_id));
 			placement_free(pl);
 			cache->placements = g_list_delete_link(
 				cache->placements, l);
 		}
 	}
+
+	for (l = gone_ids; l != NULL; l = l->next) {
+		release_if_unplaced(cache, GPOINTER_TO_UINT(l->data));
+	}
+	g_list_free(gone_ids);
 }
 
 /**
@@ -1283,4 +1385,5 @@ gst_kitty_image_cache_clear_alt(GstKittyImageCache *cache)
 {
 	g_list_free_full(cache->placements, placement_free);
 	cache->placements = NULL;
+	release_all_images(cache);
 }
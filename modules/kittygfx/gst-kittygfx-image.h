@@ -32,6 +32,7 @@ typedef struct
 	gint     stride;      /* bytes per row (width * 4) */
 	gsize    data_size;   /* total bytes (width * height * 4) */
 	gint64   last_used;   /* monotonic timestamp for LRU */
+	guint    render_handle; /* render context upload of data, or 0 */
 } GstKittyImage;
 
 /*
@@ -107,6 +108,8 @@ typedef struct
 	gint        max_placements;
 	guint32     next_image_id;  /* auto-assign if id=0 */
 	guint32     last_image_id;  /* most recent transmit id for continuation chunks */
+	GArray     *released;     /* caller's guint array that receives the
+	                           * render handles of dropped uploads, or NULL */
 } GstKittyImageCache;
 
 /**
@@ -131,6 +134,8 @@ gst_kitty_image_cache_new(
  * @cache: the cache to free
  *
  * Frees all images, uploads, placements, and the cache itself.
+ * The render handles of the freed images are still queued on
+ * @cache->released for the owner to release.
  */
 void
 gst_kitty_image_cache_free(GstKittyImageCache *cache);
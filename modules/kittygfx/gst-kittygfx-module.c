@@ -38,6 +38,13 @@ struct _GstKittygfxModule
 
 	GstKittyImageCache *cache;
 
+	/*
+	 * Render context handles (guint) of images the cache dropped,
+	 * released at the start of the next render pass. Outlives the
+	 * cache so handles freed by deactivate are not lost.
+	 */
+	GArray *released;
+
 	/*
 	 * Queue of APC bodies (gchar*) we have sent as responses.
 	 * Used to detect and discard echoed responses that the PTY
@@ -136,6 +143,7 @@ kittygfx_activate(GstModule *base)
 			self->max_ram_mb,
 			self->max_single_mb,
 			self->max_placements);
+		self->cache->released = self->released;
 	}
 
 	return TRUE;
@@ -392,13 +400,25 @@ kittygfx_render(
 	GstTerminal *term;
 	GList *visible;
 	GList *l;
+	guint i;
 	gint rows;
 	gint top_row;
 
 	self = GST_KITTYGFX_MODULE(overlay);
 	ctx = (GstRenderContext *)render_ctx;
 
-	if (self->cache == NULL || ctx == NULL) {
+	if (ctx == NULL) {
+		return;
+	}
+
+	/* Free the uploads of deleted and scrolled-away images */
+	for (i = 0; i < self->released->len; i++) {
+		gst_render_context_release_image(ctx,
+			g_array_index(self->released, guint, i));
+	}
+	g_array_set_size(self->released, 0);
+
+	if (self->cache == NULL) {
 		return;
 	}
 
@@ -425,8 +445,6 @@ kittygfx_render(
 		gint dh;
 		gint sw;
 		gint sh;
-		const guint8 *src_data;
-		gint src_stride;
 
 		pl = (GstImagePlacement *)l->data;
 		img = gst_kitty_image_cache_get_image(
@@ -467,10 +485,6 @@ kittygfx_render(
 			dh = sh;
 		}
 
-		/* Get source data pointer (offset by crop region) */
-		src_data = img->data + (pl->src_y * img->stride) + (pl->src_x * 4);
-		src_stride = img->stride;
-
 		/* Clip to window bounds */
 		if (px >= width || py >= height) {
 			continue;
@@ -482,9 +496,13 @@ kittygfx_render(
 			dh = height - py;
 		}
 
-		/* Draw the image */
-		gst_render_context_draw_image(ctx,
-			src_data, sw, sh, src_stride,
+		/*
+		 * Draw the crop from the image's cached upload. The whole
+		 * image is uploaded once and shared by all its placements.
+		 */
+		gst_render_context_draw_cached_image(ctx, &img->render_handle,
+			img->data, img->width, img->height, img->stride,
+			pl->src_x, pl->src_y, sw, sh,
 			px, py, dw, dh);
 	}
 
@@ -510,6 +528,8 @@ gst_kittygfx_module_finalize(GObject *object)
 		self->sent_responses = NULL;
 	}
 
+	g_clear_pointer(&self->released, g_array_unref);
+
 	G_OBJECT_CLASS(gst_kittygfx_module_parent_class)->finalize(object);
 }
 
@@ -559,6 +579,7 @@ static void
 gst_kittygfx_module_init(GstKittygfxModule *self)
 {
 	self->cache = NULL;
+	self->released = g_array_new(FALSE, FALSE, sizeof(guint));
 	self->sent_responses = g_queue_new();
 
 	/* Defaults */
@@ -276,6 +276,8 @@ handle_read_scrollback(
  *
  * Searches scrollback buffer lines with a regex pattern.
  * Returns matching lines with their indices and match positions.
+ * When the scrollback module's trigram index can narrow the
+ * pattern, only its candidate lines are read and matched.
  */
 static McpToolResult *
 handle_search_scrollback(
@@ -293,8 +295,10 @@ handle_search_scrollback(
 	JsonGenerator *gen;
 	gchar *json_str;
 	McpToolResult *result;
+	GArray *candidates;
+	gboolean indexed;
 	const gchar *pattern;
-	gint max_results, total, i, found;
+	gint max_results, total, n, k, i, found;
 
 	(void)server;
 	(void)name;
@@ -347,19 +351,26 @@ handle_search_scrollback(
 	json_builder_set_member_name(builder, "matches");
 	json_builder_begin_array(builder);
 
+	/* Lines the index cannot rule out, or every line */
+	candidates = g_array_new(FALSE, FALSE, sizeof(gint));
+	indexed = gst_scrollback_module_find_lines(sb, pattern, TRUE, candidates);
+	n = indexed ? (gint)candidates->len : total;
+
 	found = 0;
-	for (i = 0; i < total && found < max_results; i++) {
+	for (k = 0; k < n && found < max_results; k++) {
 		const GstGlyph *glyphs;
 		gint ncols, x;
 		GString *line_str;
 		GMatchInfo *match_info;
 
+		i = indexed ? g_array_index(candidates, gint, k) : k;
 		glyphs = gst_scrollback_module_get_line_glyphs(sb, i, &ncols);
 		if (glyphs == NULL) {
 			continue;
 		}
 
-		/* Build line string */
+		/* Build line string; empty cells read as spaces, as the
+		 * index sees them */
 		line_str = g_string_new(NULL);
 		for (x = 0; x < ncols; x++) {
 			gchar buf[8];
@@ -368,7 +379,8 @@ handle_search_scrollback(
 			if (gst_glyph_is_dummy(&glyphs[x])) {
 				continue;
 			}
-			len = g_unichar_to_utf8(glyphs[x].rune, buf);
+			len = g_unichar_to_utf8(
+				(glyphs[x].rune != 0) ? glyphs[x].rune : ' ', buf);
 			buf[len] = '\0';
 			g_string_append(line_str, buf);
 		}
@@ -394,6 +406,7 @@ handle_search_scrollback(
 		g_match_info_free(match_info);
 		g_string_free(line_str, TRUE);
 	}
+	g_array_free(candidates, TRUE);
 
 	json_builder_end_array(builder);
 	json_builder_set_member_name(builder, "match_count");
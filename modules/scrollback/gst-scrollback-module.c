@@ -5,9 +5,22 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  *
  * Ring buffer scrollback with keyboard navigation and overlay rendering.
- * Captures lines via the "line-scrolled-out" signal, stores them in a
+ * Captures lines via the "lines-scrolled-out" signal, stores them in a
  * ring buffer, and renders history using GstRenderOverlay when the
  * user scrolls back with Shift+Page_Up/Down.
+ *
+ * History is kept in two tiers. The newest lines sit in the ring as
+ * packed cells; once the ring is full, its oldest lines are frozen
+ * into LZ-compressed pages of SCROLL_PAGE_LINES lines each, which
+ * are decoded again only when something reads them. With
+ * spill_to_disk, compressed pages are moved on into a GstSpillFile
+ * and read back through its mapping, leaving only the page index
+ * in memory.
+ *
+ * With search_index, every stored line is also added to a
+ * GstTrigramIndex, which other modules query through
+ * gst_scrollback_module_find_lines() to skip lines that cannot
+ * match a search.
  */
 
 #include "gst-scrollback-module.h"
@@ -15,6 +28,11 @@
 #include "../../src/config/gst-config.h"
 #include "../../src/core/gst-terminal.h"
 #include "../../src/core/gst-line.h"
+#include "../../src/core/gst-style-table.h"
+#include "../../src/core/gst-block-arena.h"
+#include "../../src/core/gst-lz.h"
+#include "../../src/core/gst-spill-file.h"
+#include "../../src/core/gst-trigram-index.h"
 #include "../../src/boxed/gst-glyph.h"
 #include "../../src/rendering/gst-render-context.h"
 
@@ -22,6 +40,10 @@
 #include <X11/keysym.h>
 #include <X11/X.h>
 #include <string.h>
+#ifdef __linux__
+#include <sys/vfs.h>
+#include <linux/magic.h>
+#endif
 
 /**
  * SECTION:gst-scrollback-module
@@ -34,30 +56,100 @@
  * lines as an overlay on the terminal surface.
  */
 
+/* Lines per frozen page */
+#define SCROLL_PAGE_LINES   (256)
+
+/* Newest lines kept uncompressed in the ring */
+#define SCROLL_HOT_LINES    (4096)
+
+/* Decoded pages kept for scrolling and searches */
+#define SCROLL_PAGE_CACHE   (4)
+
+/* Capacity of an unlimited scrollback (lines: 0) */
+#define SCROLL_UNLIMITED    (G_MAXINT - 1)
+
 /*
  * ScrollLine:
- * @glyphs: array of glyph data for the line
- * @cols: number of columns in this line
+ * @data: the stored cells, carved from the module's arena, or %NULL
+ * @block: arena block holding @data
+ * @len: number of cells stored
+ * @cols: number of columns in this line, 0 for an empty slot
+ * @packed: whether @data holds packed cells or plain glyphs
  *
- * A saved scrollback line. Stores a copy of the glyph data.
+ * A saved scrollback line. Lines are normally stored as packed
+ * cells against the module's style table, at half the size of a
+ * GstGlyph copy; plain glyphs are only used for a line whose styles
+ * do not fit even after the table was compacted. Trailing blank
+ * cells are not stored: cells from @len up to @cols read back as
+ * blanks.
  */
 typedef struct
 {
-	GstGlyph *glyphs;
+	gpointer  data;
+	guint     block;
+	gint      len;
 	gint      cols;
+	gboolean  packed;
 } ScrollLine;
 
+/*
+ * ScrollPage:
+ * @data: LZ-compressed page records, or %NULL once spilled
+ * @offset: position of the compressed records in the spill file
+ * @size: compressed bytes
+ * @raw_size: bytes once decoded
+ * @n_lines: lines frozen into the page
+ * @first: lines already dropped from the front of the page
+ * @raw: the decoded records while the page is cached, or %NULL
+ *
+ * A page of cold scrollback. Decoded, it starts with @n_lines
+ * 32-bit offsets of the line records that follow, then the 32-bit
+ * offset of the page's style dictionary, which ends the page. Each
+ * record is the line's cols, len and a packed flag as LEB128
+ * varints; packed lines then give their style runs as (style ID,
+ * length) pairs and their runes, plain lines their raw glyphs. The
+ * style IDs index the page's dictionary of #GstStyle entries, not
+ * the module's style table, so frozen pages never pin a style.
+ */
+typedef struct
+{
+	guint8 *data;
+	guint64 offset;
+	gsize   size;
+	gsize   raw_size;
+	gint    n_lines;
+	gint    first;
+	guint8 *raw;
+} ScrollPage;
+
 struct _GstScrollbackModule
 {
 	GstModule parent_instance;
 
-	ScrollLine *lines;          /* ring buffer of saved lines */
+	ScrollLine *lines;          /* ring buffer of hot lines */
 	gint        capacity;       /* max lines (from config) */
 	gint        count;          /* lines currently stored */
 	gint        head;           /* write position in ring */
+	gint        hot_cap;        /* ring size */
+	gint        n_hot;          /* lines in the ring */
+
+	GPtrArray  *pages;          /* frozen ScrollPages, oldest first */
+	gint        n_cold;         /* lines in frozen pages */
+	ScrollPage *cache[SCROLL_PAGE_CACHE]; /* decoded, most recent first */
+	gboolean    spill_to_disk;  /* from config */
+	GstSpillFile *spill;        /* frozen pages on disk, or NULL */
+	gboolean    search_index;   /* from config */
+	GstTrigramIndex *index;     /* trigrams of stored lines, or NULL */
+
 	gint        scroll_offset;  /* 0=live, >0=viewing history */
 	gint        scroll_lines;   /* lines per mouse scroll step */
 	gulong      sig_id;         /* signal handler ID for disconnection */
+
+	GstBlockArena *arena;       /* cell storage of all saved lines */
+	GstStyleTable *styles;      /* styles of packed lines in the ring */
+	gint        styles_wait;    /* lines to store before compacting again */
+	GstGlyph   *scratch;        /* unpacked line handed to readers */
+	gint        scratch_cols;
 };
 
 /* Forward declarations */
@@ -76,48 +168,783 @@ G_DEFINE_TYPE_WITH_CODE(GstScrollbackModule, gst_scrollback_module,
 /* ===== Internal helpers ===== */
 
 /*
- * on_line_scrolled_out:
+ * scroll_line_clear:
+ *
+ * Releases the cells held by a ring slot back to the arena.
+ */
+static void
+scroll_line_clear(
+	GstScrollbackModule *self,
+	ScrollLine          *sl
+){
+	if (sl->data != NULL) {
+		gst_block_arena_release(self->arena, sl->block);
+	}
+	sl->data = NULL;
+	sl->len = 0;
+	sl->cols = 0;
+	sl->packed = FALSE;
+}
+
+/*
+ * scroll_page_free:
+ *
+ * Frees a frozen page, dropping it from the decode cache.
+ */
+static void
+scroll_page_free(
+	GstScrollbackModule *self,
+	ScrollPage          *page
+){
+	gint i;
+
+	for (i = 0; i < SCROLL_PAGE_CACHE; i++) {
+		if (self->cache[i] == page) {
+			memmove(&self->cache[i], &self->cache[i + 1],
+				sizeof(ScrollPage *) * (gsize)(SCROLL_PAGE_CACHE - 1 - i));
+			self->cache[SCROLL_PAGE_CACHE - 1] = NULL;
+			break;
+		}
+	}
+
+	if (page->data == NULL && self->spill != NULL) {
+		gst_spill_file_discard(self->spill, page->offset, page->size);
+	}
+
+	g_free(page->raw);
+	g_free(page->data);
+	g_free(page);
+}
+
+/*
+ * free_ring:
+ *
+ * Frees the ring buffer, frozen pages, cell arena, style table,
+ * search index and scratch line.
+ */
+static void
+free_ring(GstScrollbackModule *self)
+{
+	guint i;
+
+	g_free(self->lines);
+	self->lines = NULL;
+
+	if (self->pages != NULL) {
+		for (i = 0; i < self->pages->len; i++) {
+			scroll_page_free(self, g_ptr_array_index(self->pages, i));
+		}
+		g_ptr_array_free(self->pages, TRUE);
+		self->pages = NULL;
+	}
+	self->n_cold = 0;
+	self->n_hot = 0;
+
+	gst_spill_file_free(self->spill);
+	self->spill = NULL;
+
+	gst_block_arena_free(self->arena);
+	self->arena = NULL;
+
+	gst_style_table_free(self->styles);
+	self->styles = NULL;
+
+	gst_trigram_index_free(self->index);
+	self->index = NULL;
+
+	g_free(self->scratch);
+	self->scratch = NULL;
+	self->scratch_cols = 0;
+}
+
+/*
+ * is_blank:
+ *
+ * TRUE for a cell as left by clearing it: a space with default
+ * colors and no attributes.
+ */
+static gboolean
+is_blank(const GstGlyph *g)
+{
+	return g->rune == ' ' && g->attr == GST_GLYPH_ATTR_NONE
+		&& g->fg == GST_COLOR_DEFAULT_FG && g->bg == GST_COLOR_DEFAULT_BG;
+}
+
+/* Grows the scratch line to at least @cols glyphs */
+static void
+scratch_reserve(
+	GstScrollbackModule *self,
+	gint                 cols
+){
+	if (self->scratch_cols < cols) {
+		self->scratch = g_renew(GstGlyph, self->scratch, (gsize)cols);
+		self->scratch_cols = cols;
+	}
+}
+
+/* Fills the scratch line from @from up to @cols with blanks */
+static void
+scratch_pad(
+	GstScrollbackModule *self,
+	gint                 from,
+	gint                 cols
+){
+	gint x;
+
+	for (x = from; x < cols; x++) {
+		self->scratch[x].rune = ' ';
+		self->scratch[x].attr = GST_GLYPH_ATTR_NONE;
+		self->scratch[x].fg = GST_COLOR_DEFAULT_FG;
+		self->scratch[x].bg = GST_COLOR_DEFAULT_BG;
+	}
+}
+
+/*
+ * scroll_line_glyphs:
+ *
+ * Returns the glyphs of a ring slot, unpacking stored cells into
+ * the module's scratch buffer and padding the trimmed tail with
+ * blanks. The result is only valid until the next call. Returns
+ * %NULL for an empty slot.
+ */
+static const GstGlyph *
+scroll_line_glyphs(
+	GstScrollbackModule *self,
+	const ScrollLine    *sl
+){
+	if (sl->cols == 0) {
+		return NULL;
+	}
+
+	scratch_reserve(self, sl->cols);
+
+	if (sl->packed) {
+		gst_style_table_unpack_row(self->styles, sl->data, sl->len,
+			self->scratch);
+	} else if (sl->len > 0) {
+		memcpy(self->scratch, sl->data, sizeof(GstGlyph) * (gsize)sl->len);
+	}
+
+	scratch_pad(self, sl->len, sl->cols);
+	return self->scratch;
+}
+
+/* ===== Frozen pages ===== */
+
+static void
+put_varint(
+	GByteArray *buf,
+	guint32     v
+){
+	guint8 b;
+
+	do {
+		b = (guint8)(v & 0x7F);
+		v >>= 7;
+		if (v != 0) {
+			b |= 0x80;
+		}
+		g_byte_array_append(buf, &b, 1);
+	} while (v != 0);
+}
+
+/* Reads a varint, stopping at @end; truncated input reads as 0 bits */
+static guint32
+get_varint(
+	const guint8 **p,
+	const guint8  *end
+){
+	guint32 v;
+	guint shift;
+	guint8 b;
+
+	v = 0;
+	shift = 0;
+	while (*p < end && shift < 32) {
+		b = *(*p)++;
+		v |= (guint32)(b & 0x7F) << shift;
+		if (!(b & 0x80)) {
+			break;
+		}
+		shift += 7;
+	}
+	return v;
+}
+
+/*
+ * scroll_encode_line:
+ *
+ * Appends the page record of a hot line to @buf. Style IDs change
+ * rarely along a line, so they are stored as runs apart from the
+ * runes, which mostly take a single byte each. Each style is
+ * translated to its index in the page's dictionary @dict, which
+ * @local maps style table IDs (plus one) into and is grown as new
+ * styles turn up.
+ */
+static void
+scroll_encode_line(
+	GstScrollbackModule *self,
+	GByteArray          *buf,
+	const ScrollLine    *sl,
+	GHashTable          *local,
+	GArray              *dict
+){
+	const GstPackedCell *cells;
+	const GstStyle *style;
+	gpointer found;
+	gint x;
+	gint run;
+	guint16 id;
+
+	put_varint(buf, (guint32)sl->cols);
+	put_varint(buf, (guint32)sl->len);
+	put_varint(buf, sl->packed ? 1 : 0);
+
+	if (sl->len == 0) {
+		return;
+	}
+
+	if (!sl->packed) {
+		g_byte_array_append(buf, sl->data,
+			(guint)(sizeof(GstGlyph) * (gsize)sl->len));
+		return;
+	}
+
+	cells = sl->data;
+	for (x = 0; x < sl->len; x += run) {
+		id = GST_PACKED_CELL_STYLE(cells[x]);
+		run = 1;
+		while (x + run < sl->len
+		       && GST_PACKED_CELL_STYLE(cells[x + run]) == id) {
+			run++;
+		}
+
+		found = g_hash_table_lookup(local, GUINT_TO_POINTER((guint)id + 1));
+		if (found == NULL) {
+			style = gst_style_table_lookup(self->styles, id);
+			if (style == NULL) {
+				style = gst_style_table_lookup(self->styles,
+					GST_STYLE_ID_DEFAULT);
+			}
+			g_array_append_val(dict, *style);
+			found = GUINT_TO_POINTER(dict->len);
+			g_hash_table_insert(local, GUINT_TO_POINTER((guint)id + 1),
+				found);
+		}
+
+		put_varint(buf, GPOINTER_TO_UINT(found) - 1);
+		put_varint(buf, (guint32)run);
+	}
+
+	for (x = 0; x < sl->len; x++) {
+		put_varint(buf, GST_PACKED_CELL_RUNE(cells[x]));
+	}
+}
+
+/*
+ * scroll_freeze_page:
+ *
+ * Moves the SCROLL_PAGE_LINES oldest hot lines into a new frozen
+ * page, releasing their cells to the arena.
+ */
+static void
+scroll_freeze_page(GstScrollbackModule *self)
+{
+	GByteArray *raw;
+	ScrollPage *page;
+	ScrollLine *sl;
+	GHashTable *local;
+	GArray *dict;
+	gsize bound;
+	guint32 off;
+	gint oldest;
+	gint i;
+
+	raw = g_byte_array_sized_new(SCROLL_PAGE_LINES * 64);
+	g_byte_array_set_size(raw, sizeof(guint32) * (SCROLL_PAGE_LINES + 1));
+	local = g_hash_table_new(g_direct_hash, g_direct_equal);
+	dict = g_array_new(FALSE, FALSE, sizeof(GstStyle));
+
+	oldest = (self->head - self->n_hot + self->hot_cap) % self->hot_cap;
+	for (i = 0; i < SCROLL_PAGE_LINES; i++) {
+		sl = &self->lines[(oldest + i) % self->hot_cap];
+
+		off = raw->len;
+		memcpy(raw->data + sizeof(guint32) * (gsize)i, &off, sizeof(off));
+		scroll_encode_line(self, raw, sl, local, dict);
+		scroll_line_clear(self, sl);
+	}
+	self->n_hot -= SCROLL_PAGE_LINES;
+
+	/* The dictionary closes the page */
+	off = raw->len;
+	memcpy(raw->data + sizeof(guint32) * SCROLL_PAGE_LINES, &off, sizeof(off));
+	g_byte_array_append(raw, (const guint8 *)dict->data,
+		dict->len * (guint)sizeof(GstStyle));
+	g_hash_table_destroy(local);
+	g_array_free(dict, TRUE);
+
+	page = g_new0(ScrollPage, 1);
+	page->n_lines = SCROLL_PAGE_LINES;
+	page->raw_size = raw->len;
+
+	bound = gst_lz_compress_bound(raw->len);
+	page->data = g_malloc(bound);
+	page->size = gst_lz_compress(raw->data, raw->len, page->data, bound);
+	g_byte_array_free(raw, TRUE);
+
+	if (self->spill != NULL && self->spill_to_disk) {
+		GError *error;
+
+		error = NULL;
+		if (gst_spill_file_append(self->spill, page->data, page->size,
+		                          &page->offset, &error)) {
+			g_clear_pointer(&page->data, g_free);
+		} else {
+			/* Keep this and later pages in memory; pages
+			 * already spilled stay readable */
+			g_warning("scrollback: %s", error->message);
+			g_error_free(error);
+			self->spill_to_disk = FALSE;
+		}
+	}
+	if (page->data != NULL) {
+		page->data = g_realloc(page->data, page->size);
+	}
+
+	g_ptr_array_add(self->pages, page);
+	self->n_cold += SCROLL_PAGE_LINES;
+}
+
+/*
+ * scroll_page_thaw:
+ *
+ * Returns the decoded records of a frozen page, decompressing it
+ * into the cache and evicting the least recently used page if it
+ * is not there yet. Returns %NULL if the page fails to decode.
+ */
+static const guint8 *
+scroll_page_thaw(
+	GstScrollbackModule *self,
+	ScrollPage          *page
+){
+	const guint8 *src;
+	ScrollPage *victim;
+	gint i;
+
+	if (page->raw != NULL) {
+		for (i = 0; i < SCROLL_PAGE_CACHE - 1; i++) {
+			if (self->cache[i] == page) {
+				break;
+			}
+		}
+		memmove(&self->cache[1], &self->cache[0],
+			sizeof(ScrollPage *) * (gsize)i);
+		self->cache[0] = page;
+		return page->raw;
+	}
+
+	src = page->data;
+	if (src == NULL) {
+		src = (self->spill != NULL)
+			? gst_spill_file_read(self->spill, page->offset, page->size)
+			: NULL;
+		if (src == NULL) {
+			return NULL;
+		}
+	}
+
+	page->raw = g_malloc(page->raw_size);
+	if (!gst_lz_decompress(src, page->size, page->raw, page->raw_size)) {
+		g_warning("scrollback: frozen page failed to decode");
+		g_free(page->raw);
+		page->raw = NULL;
+		return NULL;
+	}
+
+	victim = self->cache[SCROLL_PAGE_CACHE - 1];
+	if (victim != NULL) {
+		g_free(victim->raw);
+		victim->raw = NULL;
+	}
+	memmove(&self->cache[1], &self->cache[0],
+		sizeof(ScrollPage *) * (SCROLL_PAGE_CACHE - 1));
+	self->cache[0] = page;
+
+	return page->raw;
+}
+
+/*
+ * scroll_page_line:
+ *
+ * Decodes line @idx of a frozen page into the scratch buffer,
+ * like scroll_line_glyphs(). Stores the line's cols and stored
+ * length in @cols_out and @len_out.
+ */
+static const GstGlyph *
+scroll_page_line(
+	GstScrollbackModule *self,
+	ScrollPage          *page,
+	gint                 idx,
+	gint                *cols_out,
+	gint                *len_out
+){
+	const guint8 *raw;
+	const guint8 *p;
+	const guint8 *end;
+	GstStyle style;
+	guint32 off;
+	guint32 dict_off;
+	guint32 n_styles;
+	guint32 id;
+	gboolean packed;
+	gint cols;
+	gint len;
+	gint x;
+	gint n;
+
+	raw = scroll_page_thaw(self, page);
+	if (raw == NULL) {
+		return NULL;
+	}
+
+	memcpy(&dict_off, raw + sizeof(guint32) * SCROLL_PAGE_LINES,
+		sizeof(dict_off));
+	dict_off = MIN(dict_off, (guint32)page->raw_size);
+	n_styles = ((guint32)page->raw_size - dict_off) / sizeof(GstStyle);
+
+	memcpy(&off, raw + sizeof(guint32) * (gsize)idx, sizeof(off));
+	p = raw + off;
+	end = raw + dict_off;
+
+	cols = (gint)get_varint(&p, end);
+	len = (gint)get_varint(&p, end);
+	packed = get_varint(&p, end) != 0;
+	if (cols <= 0) {
+		return NULL;
+	}
+	len = MIN(len, cols);
+
+	scratch_reserve(self, cols);
+
+	if (!packed) {
+		if ((gsize)(end - p) < sizeof(GstGlyph) * (gsize)len) {
+			len = 0;
+		}
+		memcpy(self->scratch, p, sizeof(GstGlyph) * (gsize)len);
+	} else {
+		/* Styles from the runs, then the runes */
+		x = 0;
+		while (x < len) {
+			id = get_varint(&p, end);
+			if (id < n_styles) {
+				memcpy(&style, raw + dict_off + sizeof(GstStyle) * id,
+					sizeof(style));
+			} else {
+				style.attr = GST_GLYPH_ATTR_NONE;
+				style.fg = GST_COLOR_DEFAULT_FG;
+				style.bg = GST_COLOR_DEFAULT_BG;
+			}
+			n = (gint)get_varint(&p, end);
+			n = CLAMP(n, 1, len - x);
+			for (; n > 0; n--, x++) {
+				self->scratch[x].attr = style.attr;
+				self->scratch[x].fg = style.fg;
+				self->scratch[x].bg = style.bg;
+			}
+		}
+		for (x = 0; x < len; x++) {
+			self->scratch[x].rune = (GstRune)get_varint(&p, end);
+		}
+	}
+
+	scratch_pad(self, len, cols);
+	*cols_out = cols;
+	*len_out = len;
+	return self->scratch;
+}
+
+/*
+ * scroll_drop_oldest:
+ *
+ * Discards the oldest frozen line, freeing its page once every
+ * line in it is gone.
+ */
+static void
+scroll_drop_oldest(GstScrollbackModule *self)
+{
+	ScrollPage *page;
+
+	page = g_ptr_array_index(self->pages, 0);
+	page->first++;
+	self->n_cold--;
+
+	if (page->first == page->n_lines) {
+		g_ptr_array_remove_index(self->pages, 0);
+		scroll_page_free(self, page);
+	}
+}
+
+/*
+ * scroll_get_line:
+ *
+ * Returns the glyphs of line @index (0 = most recent), from the
+ * ring or a frozen page, with its cols and stored length. The
+ * result is only valid until the next call.
+ */
+static const GstGlyph *
+scroll_get_line(
+	GstScrollbackModule *self,
+	gint                 index,
+	gint                *cols_out,
+	gint                *len_out
+){
+	const GstGlyph *glyphs;
+	ScrollLine *sl;
+	ScrollPage *page;
+	gint avail;
+	gint o;
+
+	*cols_out = 0;
+	*len_out = 0;
+
+	if (index < 0 || index >= self->n_hot + self->n_cold) {
+		return NULL;
+	}
+
+	if (index < self->n_hot) {
+		sl = &self->lines[(self->head - 1 - index + self->hot_cap)
+			% self->hot_cap];
+		glyphs = scroll_line_glyphs(self, sl);
+		if (glyphs != NULL) {
+			*cols_out = sl->cols;
+			*len_out = sl->len;
+		}
+		return glyphs;
+	}
+
+	/* Position among frozen lines, counted from the oldest; only
+	 * the first page can be partly dropped */
+	o = self->n_cold - 1 - (index - self->n_hot);
+	page = g_ptr_array_index(self->pages, 0);
+	avail = page->n_lines - page->first;
+	if (o < avail) {
+		return scroll_page_line(self, page, page->first + o,
+			cols_out, len_out);
+	}
+
+	o -= avail;
+	page = g_ptr_array_index(self->pages, 1 + o / SCROLL_PAGE_LINES);
+	return scroll_page_line(self, page, o % SCROLL_PAGE_LINES,
+		cols_out, len_out);
+}
+
+/*
+ * scroll_compact_styles:
+ *
+ * Replaces a full style table with one holding only the styles of
+ * the lines still in the ring; frozen pages carry their own styles.
+ * A line whose styles no longer fit is stored as plain glyphs.
+ */
+static void
+scroll_compact_styles(GstScrollbackModule *self)
+{
+	GstStyleTable *fresh;
+	ScrollLine *sl;
+	GstGlyph *glyphs;
+	guint block;
+	gint i;
+
+	fresh = gst_style_table_new();
+
+	for (i = 0; i < self->n_hot; i++) {
+		sl = &self->lines[(self->head - 1 - i + self->hot_cap)
+			% self->hot_cap];
+		if (!sl->packed || sl->len == 0
+		    || gst_style_table_repack_row(self->styles, fresh,
+		                                  sl->data, sl->len)) {
+			continue;
+		}
+
+		glyphs = gst_block_arena_alloc(self->arena,
+			sizeof(GstGlyph) * (gsize)sl->len, &block);
+		gst_style_table_unpack_row(self->styles, sl->data, sl->len, glyphs);
+		gst_block_arena_release(self->arena, sl->block);
+		sl->data = glyphs;
+		sl->block = block;
+		sl->packed = FALSE;
+	}
+
+	gst_style_table_free(self->styles);
+	self->styles = fresh;
+
+	/* Let the ring turn over before paying for this again */
+	self->styles_wait = self->hot_cap;
+}
+
+/*
+ * on_lines_scrolled_out:
+ *
+ * Signal callback for "lines-scrolled-out". Copies glyph data
+ * from each scrolling-out line into the ring buffer. Lines that
+ * would be overwritten within the same batch are skipped.
  *
- * Signal callback for "line-scrolled-out". Copies glyph data
- * from the scrolling-out line into the ring buffer.
+ * Cells are appended to the module's block arena, so storing a
+ * line is a pointer bump rather than a malloc, and the arena's
+ * blocks empty out and are reused in order as the ring wraps.
+ * When the capacity exceeds the ring, a full ring freezes its
+ * oldest page instead of overwriting it, and the oldest frozen
+ * line is dropped once the capacity is reached. The search index
+ * follows along: each stored line is added to it, and lines that
+ * fell out of the history are dropped from it after the batch.
+ * When the style table fills up, it is compacted and the line
+ * packed again before falling back to plain glyphs; after a
+ * compaction, a full ring's worth of lines goes by before the next.
  */
 static void
-on_line_scrolled_out(
+on_lines_scrolled_out(
 	GstTerminal *term,
-	GstLine     *line,
+	GstLine     **lines,
+	gint         n_lines,
 	gint         cols,
 	gpointer     user_data
 ){
 	GstScrollbackModule *self;
 	ScrollLine *sl;
-	gint x;
+	GstLine *line;
+	gint first;
+	gint i;
+	gint n;
 
 	self = GST_SCROLLBACK_MODULE(user_data);
 
-	/* Get the slot at the write head */
-	sl = &self->lines[self->head];
+	first = MAX(0, n_lines - self->capacity);
+	for (i = first; i < n_lines; i++) {
+		line = lines[i];
+
+		/* Make room in the ring: freeze its oldest page, or
+		 * overwrite its oldest line when there is no cold tier */
+		if (self->n_hot == self->hot_cap) {
+			if (self->hot_cap < self->capacity) {
+				scroll_freeze_page(self);
+			} else {
+				self->n_hot--;
+			}
+		}
+
+		/* Get the slot at the write head */
+		sl = &self->lines[self->head];
+
+		/* Release previous data if slot was occupied */
+		scroll_line_clear(self, sl);
+
+		/* Store the line up to its last non-blank cell, packed
+		 * when the styles fit */
+		n = MIN(cols, line->len);
+		while (n > 0 && is_blank(&line->glyphs[n - 1])) {
+			n--;
+		}
+		sl->cols = cols;
+		sl->len = n;
+
+		if (n > 0) {
+			sl->data = gst_block_arena_alloc(self->arena,
+				sizeof(GstPackedCell) * (gsize)n, &sl->block);
+			sl->packed = gst_style_table_pack_row(self->styles,
+				line->glyphs, n, sl->data);
+			if (!sl->packed && self->styles_wait == 0) {
+				scroll_compact_styles(self);
+				sl->packed = gst_style_table_pack_row(self->styles,
+					line->glyphs, n, sl->data);
+			}
+			if (!sl->packed) {
+				gst_block_arena_release(self->arena, sl->block);
+				sl->data = gst_block_arena_alloc(self->arena,
+					sizeof(GstGlyph) * (gsize)n, &sl->block);
+				memcpy(sl->data, line->glyphs, sizeof(GstGlyph) * (gsize)n);
+			}
+		}
+
+		if (self->index != NULL) {
+			gst_trigram_index_add_line(self->index, line->glyphs, n, cols);
+		}
+		if (self->styles_wait > 0) {
+			self->styles_wait--;
+		}
 
-	/* Free previous data if slot was occupied */
-	g_free(sl->glyphs);
+		/* Advance head in ring buffer */
+		self->head = (self->head + 1) % self->hot_cap;
+		self->n_hot++;
 
-	/* Copy glyph data from the line */
-	sl->cols = cols;
-	sl->glyphs = g_new0(GstGlyph, (gsize)cols);
+		if (self->n_hot + self->n_cold > self->capacity) {
+			scroll_drop_oldest(self);
+		}
+		self->count = self->n_hot + self->n_cold;
+	}
 
-	for (x = 0; x < cols; x++) {
-		GstGlyph *g;
+	/* Only the newest count indexed lines are still stored */
+	if (self->index != NULL) {
+		gst_trigram_index_drop_before(self->index,
+			gst_trigram_index_get_next_seq(self->index) - (guint64)self->count);
+	}
+}
+
+/*
+ * dir_in_memory:
+ *
+ * Returns TRUE if @path is on a file system backed by RAM, such as
+ * the tmpfs usually mounted at $XDG_RUNTIME_DIR. Spilling there
+ * would keep the history resident after all.
+ */
+static gboolean
+dir_in_memory(const gchar *path)
+{
+#ifdef __linux__
+	struct statfs sfs;
+
+	if (statfs(path, &sfs) == 0) {
+		return sfs.f_type == TMPFS_MAGIC || sfs.f_type == RAMFS_MAGIC;
+	}
+#else
+	(void)path;
+#endif
+	return FALSE;
+}
 
-		g = gst_line_get_glyph(line, x);
-		if (g != NULL) {
-			sl->glyphs[x] = *g;
+/*
+ * open_spill_file:
+ *
+ * Creates the spill file for frozen pages under the user runtime
+ * directory, unless that lives in RAM, and otherwise under the
+ * cache directory. Returns %NULL, after warning, if neither works.
+ */
+static GstSpillFile *
+open_spill_file(void)
+{
+	GstSpillFile *spill;
+	GError *error;
+	gchar *dir;
+
+	error = NULL;
+	if (!dir_in_memory(g_get_user_runtime_dir())) {
+		dir = g_build_filename(g_get_user_runtime_dir(), "gst", NULL);
+		spill = gst_spill_file_new(dir, &error);
+		g_free(dir);
+		if (spill != NULL) {
+			return spill;
 		}
+		g_clear_error(&error);
 	}
 
-	/* Advance head in ring buffer */
-	self->head = (self->head + 1) % self->capacity;
-	if (self->count < self->capacity) {
-		self->count++;
+	dir = g_build_filename(g_get_user_cache_dir(), "gst", NULL);
+	spill = gst_spill_file_new(dir, &error);
+	g_free(dir);
+	if (spill == NULL) {
+		g_warning("scrollback: keeping history in memory: %s",
+			error->message);
+		g_error_free(error);
 	}
+	return spill;
 }
 
 /*
@@ -326,31 +1153,30 @@ gst_scrollback_module_render(
 
 	/* Render scrollback lines in the top region */
 	for (y = 0; y < self->scroll_offset && y < rows; y++) {
-		gint ring_idx;
-		ScrollLine *sl;
+		const GstGlyph *glyphs;
+		gint line_cols;
+		gint line_len;
 		gint x;
 		gint pixel_y;
 
 		/*
-		 * Map visible row y to ring buffer index.
+		 * Map visible row y to a line index.
 		 * Row 0 = oldest visible, row (scroll_offset-1) = most recent.
 		 */
-		ring_idx = (self->head - self->scroll_offset + y + self->capacity)
-			% self->capacity;
-
-		sl = &self->lines[ring_idx];
-		if (sl->glyphs == NULL) {
+		glyphs = scroll_get_line(self, self->scroll_offset - 1 - y,
+			&line_cols, &line_len);
+		if (glyphs == NULL) {
 			continue;
 		}
 
 		pixel_y = ctx->borderpx + y * ctx->ch;
 
-		/* Draw each glyph in the line */
-		for (x = 0; x < sl->cols && x < cols; x++) {
-			GstGlyph *g;
+		/* Draw each stored glyph; the trimmed tail is blank */
+		for (x = 0; x < line_len && x < cols; x++) {
+			const GstGlyph *g;
 			gint pixel_x;
 
-			g = &sl->glyphs[x];
+			g = &glyphs[x];
 			if (g->rune == 0) {
 				continue;
 			}
@@ -463,7 +1289,7 @@ gst_scrollback_module_get_description(GstModule *module)
  * activate:
  *
  * Allocates the ring buffer and connects to the terminal's
- * "line-scrolled-out" signal.
+ * "lines-scrolled-out" signal.
  */
 static gboolean
 gst_scrollback_module_activate(GstModule *module)
@@ -474,21 +1300,37 @@ gst_scrollback_module_activate(GstModule *module)
 
 	self = GST_SCROLLBACK_MODULE(module);
 
-	/* Allocate ring buffer */
-	self->lines = g_new0(ScrollLine, (gsize)self->capacity);
+	/* Allocate ring buffer; lines beyond it are frozen into pages */
+	self->hot_cap = MIN(self->capacity, SCROLL_HOT_LINES + SCROLL_PAGE_LINES);
+	self->lines = g_new0(ScrollLine, (gsize)self->hot_cap);
+	self->pages = g_ptr_array_new();
+	self->arena = gst_block_arena_new(GST_BLOCK_ARENA_DEFAULT_BLOCK_SIZE);
+	self->styles = gst_style_table_new();
+	self->styles_wait = 0;
 	self->count = 0;
 	self->head = 0;
+	self->n_hot = 0;
+	self->n_cold = 0;
 	self->scroll_offset = 0;
 
-	/* Connect to terminal's line-scrolled-out signal */
+	if (self->spill_to_disk) {
+		self->spill = open_spill_file();
+	}
+	if (self->search_index) {
+		self->index = gst_trigram_index_new();
+	}
+
+	/* Connect to terminal's lines-scrolled-out signal */
 	mgr = gst_module_manager_get_default();
 	term = (GstTerminal *)gst_module_manager_get_terminal(mgr);
 	if (term != NULL) {
-		self->sig_id = g_signal_connect(term, "line-scrolled-out",
-			G_CALLBACK(on_line_scrolled_out), self);
+		self->sig_id = g_signal_connect(term, "lines-scrolled-out",
+			G_CALLBACK(on_lines_scrolled_out), self);
 	}
 
-	g_debug("scrollback: activated (capacity=%d)", self->capacity);
+	g_debug("scrollback: activated (capacity=%d, spill=%s, index=%s)",
+		self->capacity, (self->spill != NULL) ? "yes" : "no",
+		(self->index != NULL) ? "yes" : "no");
 	return TRUE;
 }
 
@@ -503,7 +1345,6 @@ gst_scrollback_module_deactivate(GstModule *module)
 	GstScrollbackModule *self;
 	GstModuleManager *mgr;
 	GstTerminal *term;
-	gint i;
 
 	self = GST_SCROLLBACK_MODULE(module);
 
@@ -518,13 +1359,7 @@ gst_scrollback_module_deactivate(GstModule *module)
 	}
 
 	/* Free ring buffer */
-	if (self->lines != NULL) {
-		for (i = 0; i < self->capacity; i++) {
-			g_free(self->lines[i].glyphs);
-		}
-		g_free(self->lines);
-		self->lines = NULL;
-	}
+	free_ring(self);
 
 	self->count = 0;
 	self->head = 0;
@@ -537,8 +1372,10 @@ gst_scrollback_module_deactivate(GstModule *module)
  * configure:
  *
  * Reads scrollback configuration from the config struct:
- *  - lines: ring buffer capacity
+ *  - lines: capacity, 0 for unlimited
  *  - mouse_scroll_lines: lines per mouse scroll step
+ *  - spill_to_disk: move frozen pages to a file
+ *  - search_index: keep a trigram index of stored lines
  */
 static void
 gst_scrollback_module_configure(GstModule *module, gpointer config)
@@ -550,7 +1387,12 @@ gst_scrollback_module_configure(GstModule *module, gpointer config)
 	cfg = (GstConfig *)config;
 
 	self->capacity = cfg->modules.scrollback.lines;
+	if (self->capacity <= 0) {
+		self->capacity = SCROLL_UNLIMITED;
+	}
 	self->scroll_lines = cfg->modules.scrollback.mouse_scroll_lines;
+	self->spill_to_disk = cfg->modules.scrollback.spill_to_disk;
+	self->search_index = cfg->modules.scrollback.search_index;
 
 	g_debug("scrollback: configured (capacity=%d, scroll_lines=%d)",
 		self->capacity, self->scroll_lines);
@@ -562,17 +1404,10 @@ static void
 gst_scrollback_module_dispose(GObject *object)
 {
 	GstScrollbackModule *self;
-	gint i;
 
 	self = GST_SCROLLBACK_MODULE(object);
 
-	if (self->lines != NULL) {
-		for (i = 0; i < self->capacity; i++) {
-			g_free(self->lines[i].glyphs);
-		}
-		g_free(self->lines);
-		self->lines = NULL;
-	}
+	free_ring(self);
 
 	G_OBJECT_CLASS(gst_scrollback_module_parent_class)->dispose(object);
 }
@@ -601,9 +1436,22 @@ gst_scrollback_module_init(GstScrollbackModule *self)
 	self->capacity = 10000;
 	self->count = 0;
 	self->head = 0;
+	self->hot_cap = 0;
+	self->n_hot = 0;
+	self->pages = NULL;
+	self->n_cold = 0;
+	memset(self->cache, 0, sizeof(self->cache));
 	self->scroll_offset = 0;
 	self->scroll_lines = 3;
 	self->sig_id = 0;
+	self->spill_to_disk = FALSE;
+	self->spill = NULL;
+	self->search_index = FALSE;
+	self->index = NULL;
+	self->arena = NULL;
+	self->styles = NULL;
+	self->scratch = NULL;
+	self->scratch_cols = 0;
 }
 
 /* ===== Public accessors for other modules ===== */
@@ -680,7 +1528,10 @@ gst_scrollback_module_set_scroll_offset(
  * @index: line index (0 = most recent, positive = older)
  * @cols_out: (out): number of columns in the returned line
  *
- * Gets the glyph data for a scrollback line.
+ * Gets the glyph data for a scrollback line. Packed lines are
+ * unpacked into a buffer owned by the module, so the result is
+ * only valid until the next call. Reading a frozen line decodes
+ * its page, which then stays cached for neighbouring lines.
  *
  * Returns: (transfer none) (nullable): the glyph array, or %NULL
  */
@@ -690,31 +1541,66 @@ gst_scrollback_module_get_line_glyphs(
 	gint                 index,
 	gint                *cols_out
 ){
-	gint ring_idx;
+	gint len;
 
 	g_return_val_if_fail(GST_IS_SCROLLBACK_MODULE(self), NULL);
 	g_return_val_if_fail(cols_out != NULL, NULL);
 
-	if (index < 0 || index >= self->count)
-	{
-		*cols_out = 0;
-		return NULL;
+	return scroll_get_line(self, index, cols_out, &len);
+}
+
+/**
+ * gst_scrollback_module_find_lines:
+ * @self: A #GstScrollbackModule
+ * @pattern: the search query
+ * @regex: whether @pattern is a regular expression
+ * @indices: (element-type gint): array the candidate line indices
+ *   are appended to
+ *
+ * Narrows a search through the trigram index. Every line that can
+ * match @pattern, with or without case, is appended to @indices,
+ * most recent first; lines that are not listed cannot match.
+ *
+ * Returns: %TRUE if @indices holds the candidates, %FALSE if there
+ *   is no index or @pattern cannot be narrowed and every line has
+ *   to be searched
+ */
+gboolean
+gst_scrollback_module_find_lines(
+	GstScrollbackModule *self,
+	const gchar         *pattern,
+	gboolean             regex,
+	GArray              *indices
+){
+	GArray *seqs;
+	guint64 next;
+	guint i;
+	gint index;
+
+	g_return_val_if_fail(GST_IS_SCROLLBACK_MODULE(self), FALSE);
+	g_return_val_if_fail(pattern != NULL, FALSE);
+	g_return_val_if_fail(indices != NULL, FALSE);
+
+	if (self->index == NULL) {
+		return FALSE;
 	}
 
-	/*
-	 * Index 0 = most recent line = head - 1 in ring.
-	 * Index N = N lines back from most recent.
-	 */
-	ring_idx = (self->head - 1 - index + self->capacity) % self->capacity;
+	seqs = g_array_new(FALSE, FALSE, sizeof(guint64));
+	if (!gst_trigram_index_lookup(self->index, pattern, regex, seqs)) {
+		g_array_free(seqs, TRUE);
+		return FALSE;
+	}
 
-	if (self->lines[ring_idx].glyphs == NULL)
-	{
-		*cols_out = 0;
-		return NULL;
+	/* Sequence numbers count up from the oldest line ever stored,
+	 * indices back from the newest */
+	next = gst_trigram_index_get_next_seq(self->index);
+	for (i = 0; i < seqs->len; i++) {
+		index = (gint)(next - 1 - g_array_index(seqs, guint64, i));
+		g_array_append_val(indices, index);
 	}
 
-	*cols_out = self->lines[ring_idx].cols;
-	return self->lines[ring_idx].glyphs;
+	g_array_free(seqs, TRUE);
+	return TRUE;
 }
 
 G_MODULE_EXPORT GType
@@ -71,7 +71,8 @@ gst_scrollback_module_set_scroll_offset(
  * @cols_out: (out): number of columns in the returned line
  *
  * Gets the glyph data for a scrollback line. Index 0 is the
- * most recently scrolled-out line.
+ * most recently scrolled-out line. The returned array may be a
+ * buffer shared between calls; use it before calling again.
  *
  * Returns: (transfer none) (nullable): the glyph array, or %NULL
  */
@@ -82,6 +83,29 @@ gst_scrollback_module_get_line_glyphs(
 	gint                *cols_out
 );
 
+/**
+ * gst_scrollback_module_find_lines:
+ * @self: A #GstScrollbackModule
+ * @pattern: the search query
+ * @regex: whether @pattern is a regular expression
+ * @indices: (element-type gint): array the candidate line indices
+ *   are appended to, most recent first
+ *
+ * Uses the module's trigram index to find the lines that can
+ * match @pattern. Lines left out cannot match; the ones listed
+ * still have to be checked.
+ *
+ * Returns: %TRUE if @indices holds the candidates, %FALSE if every
+ *   line has to be searched
+ */
+gboolean
+gst_scrollback_module_find_lines(
+	GstScrollbackModule *self,
+	const gchar         *pattern,
+	gboolean             regex,
+	GArray              *indices
+);
+
 G_END_DECLS
 
 #endif /* GST_SCROLLBACK_MODULE_H */
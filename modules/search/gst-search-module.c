@@ -8,8 +8,8 @@
  * keybind (default Ctrl+Shift+f), intercepts key input for:
  *  - Printable characters: append to search query
  *  - Backspace: delete last character from query
- *  - Enter: jump to next match
- *  - Shift+Enter: jump to previous match
+ *  - Enter: jump to the next (older) match
+ *  - Shift+Enter: jump to the previous (newer) match
  *  - Escape: deactivate search mode
  *
  * Matches are found using plain text (g_strstr_len) or GRegex
@@ -17,6 +17,15 @@
  * semi-transparent overlays, with the current match shown in a
  * distinct color. A search bar at the bottom displays the query
  * string and match count.
+ *
+ * The screen is searched at once; the scrollback module's history
+ * is then searched from the newest line back in short idle slices,
+ * so a huge history never blocks input or drawing. Lines are named
+ * by absolute numbers that count every line scrolled out, so
+ * matches stay put as new output arrives. If the scrollback module
+ * keeps a trigram index, only the lines it cannot rule out are
+ * searched; otherwise, when a plain-text query only grows, just the
+ * lines that matched before are searched again.
  */
 
 #include "gst-search-module.h"
@@ -30,6 +39,7 @@
 /* keysym values and modifier masks */
 #include <X11/keysym.h>
 #include <X11/X.h>
+#include <gmodule.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -38,29 +48,38 @@
  * @title: GstSearchModule
  * @short_description: Interactive scrollback text search with highlighting
  *
- * #GstSearchModule provides interactive text search through the visible
- * terminal buffer. When activated, it intercepts keyboard input for
- * building a search query, highlights all matches with semi-transparent
- * overlay rectangles, and allows navigating between matches with
- * Enter / Shift+Enter.
+ * #GstSearchModule provides interactive text search through the
+ * terminal buffer and scrollback history. When activated, it
+ * intercepts keyboard input for building a search query, highlights
+ * all matches with semi-transparent overlay rectangles, and allows
+ * navigating between matches with Enter / Shift+Enter, scrolling
+ * the history to each one.
  */
 
 /* Maximum length of the search query string */
 #define GST_SEARCH_MAX_QUERY_LEN (256)
 
+/* Time spent scanning history per idle callback */
+#define GST_SEARCH_SLICE_USEC (4000)
+
+/* Matches kept before a search stops early */
+#define GST_SEARCH_MAX_MATCHES (100000)
+
 /*
  * SearchMatch:
- * @line_idx: terminal row index where the match occurs
+ * @line: absolute line number of the match (see below)
  * @col_start: starting column of the match (inclusive)
  * @col_end: ending column of the match (exclusive)
  *
- * Represents a single search match location in the terminal buffer.
+ * Represents a single search match location. With N lines scrolled
+ * out so far, screen row y is line N + y and scrollback line i
+ * (0 = most recent) is line N - 1 - i.
  */
 typedef struct
 {
-	gint line_idx;
-	gint col_start;
-	gint col_end;
+	gint64 line;
+	gint   col_start;
+	gint   col_end;
 } SearchMatch;
 
 struct _GstSearchModule
@@ -69,9 +88,42 @@ struct _GstSearchModule
 
 	gboolean  active;             /* whether search mode is on */
 	GString  *query;              /* current search query text */
-	GArray   *matches;            /* array of SearchMatch results */
+	GArray   *matches;            /* SearchMatch results, newest first */
 	gint      current_match_idx;  /* index of the focused match, -1 = none */
 
+	/* absolute line numbering */
+	gint64    pushed;             /* lines scrolled out so far */
+	gulong    sig_id;             /* "lines-scrolled-out" handler */
+
+	/* history scan in progress: candidates first, then, if
+	 * scan_full, every line from scan_next back */
+	guint     scan_id;            /* idle source, 0 when not scanning */
+	GArray   *candidates;         /* lines to rescan when refining, or NULL */
+	guint     cand_pos;
+	gboolean  scan_full;
+	gint64    scan_next;
+	GRegex   *regex;              /* compiled query in regex mode */
+	gchar    *needle;             /* folded query in plain mode */
+
+	/* last search, for refining */
+	gchar    *prev_query;
+	gint64    prev_pushed;
+	gboolean  capped;             /* it hit GST_SEARCH_MAX_MATCHES */
+
+	/* line text scratch */
+	GString  *text;
+	GArray   *byte_col;           /* column of each byte of text */
+	GArray   *line_hits;          /* matches of the line being scanned */
+
+	/* scrollback module API, resolved at runtime */
+	gboolean  sb_resolved;
+	gpointer  sb_module;          /* GstScrollbackModule*, or NULL */
+	gint (*sb_get_offset)(gpointer);
+	void (*sb_set_offset)(gpointer, gint);
+	gint (*sb_get_count)(gpointer);
+	const GstGlyph * (*sb_get_line_glyphs)(gpointer, gint, gint *);
+	gboolean (*sb_find_lines)(gpointer, const gchar *, gboolean, GArray *);
+
 	/* highlight color config (RGBA components) */
 	guint8    hl_r;               /* highlight red */
 	guint8    hl_g;               /* highlight green */
@@ -163,43 +215,442 @@ parse_hex_color(
 	return TRUE;
 }
 
+/*
+ * ensure_scrollback_api:
+ *
+ * Lazily resolves the scrollback module's public API from the
+ * process global symbol table, as the webview module does, so the
+ * search module has no link-time dependency on it. Without an
+ * active scrollback module only the screen is searched.
+ */
+static gboolean
+ensure_scrollback_api(GstSearchModule *self)
+{
+	GstModuleManager *mgr;
+	GstModule *mod;
+	GModule *global;
+
+	if (self->sb_resolved) {
+		return self->sb_module != NULL;
+	}
+
+	mgr = gst_module_manager_get_default();
+	mod = gst_module_manager_get_module(mgr, "scrollback");
+	if (mod == NULL || !gst_module_is_active(mod)) {
+		return FALSE;
+	}
+	self->sb_resolved = TRUE;
+
+	global = g_module_open(NULL, 0);
+	if (global == NULL) {
+		return FALSE;
+	}
+
+	if (!g_module_symbol(global, "gst_scrollback_module_get_scroll_offset",
+			(gpointer *)&self->sb_get_offset) ||
+		!g_module_symbol(global, "gst_scrollback_module_set_scroll_offset",
+			(gpointer *)&self->sb_set_offset) ||
+		!g_module_symbol(global, "gst_scrollback_module_get_count",
+			(gpointer *)&self->sb_get_count) ||
+		!g_module_symbol(global, "gst_scrollback_module_get_line_glyphs",
+			(gpointer *)&self->sb_get_line_glyphs))
+	{
+		g_debug("search: scrollback API symbols not found");
+		return FALSE;
+	}
+
+	/* Optional: without it every history line is scanned */
+	if (!g_module_symbol(global, "gst_scrollback_module_find_lines",
+			(gpointer *)&self->sb_find_lines))
+	{
+		self->sb_find_lines = NULL;
+	}
+
+	self->sb_module = mod;
+	return TRUE;
+}
+
+/*
+ * on_lines_scrolled_out:
+ *
+ * Counts lines leaving the screen, which keeps absolute line
+ * numbers in step with the scrollback module's indices.
+ */
+static void
+on_lines_scrolled_out(
+	GstTerminal *term,
+	GstLine     **lines,
+	gint         n_lines,
+	gint         cols,
+	gpointer     user_data
+){
+	GstSearchModule *self;
+
+	(void)term;
+	(void)lines;
+	(void)cols;
+
+	self = GST_SEARCH_MODULE(user_data);
+	self->pushed += n_lines;
+}
+
+/*
+ * search_stop:
+ *
+ * Cancels a history scan in progress and drops its compiled query.
+ */
+static void
+search_stop(GstSearchModule *self)
+{
+	if (self->scan_id != 0) {
+		g_source_remove(self->scan_id);
+		self->scan_id = 0;
+	}
+	if (self->candidates != NULL) {
+		g_array_free(self->candidates, TRUE);
+		self->candidates = NULL;
+	}
+	g_clear_pointer(&self->regex, g_regex_unref);
+	g_clear_pointer(&self->needle, g_free);
+}
+
+/*
+ * search_reset:
+ *
+ * Clears the query, results and refinement state.
+ */
+static void
+search_reset(GstSearchModule *self)
+{
+	search_stop(self);
+	g_string_truncate(self->query, 0);
+	g_array_set_size(self->matches, 0);
+	self->current_match_idx = -1;
+	g_clear_pointer(&self->prev_query, g_free);
+	self->capped = FALSE;
+}
+
+/*
+ * scan_glyphs:
+ *
+ * Searches one line of glyphs for the current query and appends
+ * its matches, right to left so that the result list stays in
+ * newest-first order. Columns come from the cells themselves, so
+ * wide characters highlight correctly.
+ */
+static void
+scan_glyphs(
+	GstSearchModule *self,
+	const GstGlyph  *glyphs,
+	gint             n,
+	gint64           line
+){
+	const gchar *text;
+	gint *byte_col;
+	gint len;
+	gint x;
+	gint i;
+
+	/* Build the line's text; plain searches fold case per rune so
+	 * byte offsets map back to cells exactly */
+	g_string_truncate(self->text, 0);
+	g_array_set_size(self->byte_col, 0);
+	for (x = 0; x < n; x++) {
+		gunichar uc;
+		gchar buf[6];
+		gint blen;
+
+		if (glyphs[x].attr & GST_GLYPH_ATTR_WDUMMY) {
+			continue;
+		}
+		uc = (glyphs[x].rune != 0) ? glyphs[x].rune : ' ';
+		if (self->needle != NULL && !self->match_case) {
+			uc = g_unichar_tolower(uc);
+		}
+		blen = g_unichar_to_utf8(uc, buf);
+		g_string_append_len(self->text, buf, blen);
+		for (i = 0; i < blen; i++) {
+			g_array_append_val(self->byte_col, x);
+		}
+	}
+	g_array_append_val(self->byte_col, n);
+
+	text = self->text->str;
+	len = (gint)self->text->len;
+	byte_col = (gint *)(gpointer)self->byte_col->data;
+	if (len == 0) {
+		return;
+	}
+
+	g_array_set_size(self->line_hits, 0);
+
+	if (self->regex != NULL) {
+		GMatchInfo *match_info;
+
+		match_info = NULL;
+		g_regex_match_full(self->regex, text, len, 0, 0, &match_info, NULL);
+		while (g_match_info_matches(match_info)) {
+			gint start_byte;
+			gint end_byte;
+			SearchMatch m;
+
+			/* Empty matches (e.g. "a*") would highlight nothing */
+			if (g_match_info_fetch_pos(match_info, 0,
+				&start_byte, &end_byte) && end_byte > start_byte)
+			{
+				m.line = line;
+				m.col_start = byte_col[start_byte];
+				m.col_end = byte_col[end_byte];
+				g_array_append_val(self->line_hits, m);
+			}
+
+			g_match_info_next(match_info, NULL);
+		}
+		g_match_info_free(match_info);
+	} else {
+		const gchar *pos;
+		gint needle_len;
+
+		needle_len = (gint)strlen(self->needle);
+		pos = text;
+		while ((pos = g_strstr_len(pos, len - (pos - text),
+		                           self->needle)) != NULL)
+		{
+			SearchMatch m;
+			gint byte_start;
+
+			byte_start = (gint)(pos - text);
+			m.line = line;
+			m.col_start = byte_col[byte_start];
+			m.col_end = byte_col[byte_start + needle_len];
+			g_array_append_val(self->line_hits, m);
+
+			/* Advance past this match to find the next */
+			pos = g_utf8_next_char(pos);
+		}
+	}
+
+	for (i = (gint)self->line_hits->len - 1; i >= 0; i--) {
+		g_array_append_val(self->matches,
+			g_array_index(self->line_hits, SearchMatch, i));
+	}
+}
+
+/*
+ * reveal_match:
+ * @self: the search module
+ *
+ * Scrolls the scrollback viewport so the focused match is on
+ * screen, centering it when it has to move.
+ */
+static void
+reveal_match(GstSearchModule *self)
+{
+	GstModuleManager *mgr;
+	GstTerminal *term;
+	SearchMatch *m;
+	gint rows;
+	gint offset;
+	gint64 row;
+
+	if (self->current_match_idx < 0 || !ensure_scrollback_api(self)) {
+		return;
+	}
+
+	mgr = gst_module_manager_get_default();
+	term = (GstTerminal *)gst_module_manager_get_terminal(mgr);
+	if (term == NULL) {
+		return;
+	}
+	rows = gst_terminal_get_rows(term);
+
+	m = &g_array_index(self->matches, SearchMatch, self->current_match_idx);
+	offset = self->sb_get_offset(self->sb_module);
+	row = m->line - self->pushed + offset;
+	if (row >= 0 && row < rows) {
+		return;
+	}
+
+	/* Clamped to the history by the scrollback module */
+	self->sb_set_offset(self->sb_module,
+		(gint)CLAMP(self->pushed - m->line + rows / 2, 0, G_MAXINT));
+}
+
+/*
+ * scan_history_chunk:
+ *
+ * Idle callback that searches scrollback history for up to
+ * GST_SEARCH_SLICE_USEC, newest line first, then yields. The
+ * candidate lines are visited first; a full scan then walks back
+ * from scan_next until it runs out of history.
+ */
+static gboolean
+scan_history_chunk(gpointer user_data)
+{
+	GstSearchModule *self;
+	gint64 deadline;
+	guint n_before;
+	gboolean done;
+	gint count;
+	guint n;
+
+	self = GST_SEARCH_MODULE(user_data);
+
+	if (!ensure_scrollback_api(self)) {
+		self->scan_id = 0;
+		search_stop(self);
+		mark_all_dirty();
+		return G_SOURCE_REMOVE;
+	}
+
+	deadline = g_get_monotonic_time() + GST_SEARCH_SLICE_USEC;
+	n_before = self->matches->len;
+	count = self->sb_get_count(self->sb_module);
+	done = FALSE;
+
+	for (n = 1; ; n++) {
+		const GstGlyph *glyphs;
+		gint64 line;
+		gint64 index;
+		gint cols;
+
+		if (self->matches->len >= GST_SEARCH_MAX_MATCHES) {
+			self->capped = TRUE;
+			done = TRUE;
+			break;
+		}
+
+		if (self->candidates != NULL
+		    && self->cand_pos < self->candidates->len)
+		{
+			line = g_array_index(self->candidates, gint64, self->cand_pos++);
+		} else if (self->scan_full) {
+			line = self->scan_next--;
+		} else {
+			done = TRUE;
+			break;
+		}
+
+		/* Scrollback index of the line; past count it was evicted,
+		 * and so was everything after it, which is older */
+		index = self->pushed - 1 - line;
+		if (index >= count) {
+			done = TRUE;
+			break;
+		}
+
+		glyphs = self->sb_get_line_glyphs(self->sb_module, (gint)index, &cols);
+		if (glyphs != NULL) {
+			scan_glyphs(self, glyphs, cols, line);
+		}
+
+		if ((n & 63) == 0 && g_get_monotonic_time() >= deadline) {
+			break;
+		}
+	}
+
+	if (self->current_match_idx < 0 && self->matches->len > 0) {
+		self->current_match_idx = 0;
+		reveal_match(self);
+	}
+
+	if (done) {
+		self->scan_id = 0;
+		search_stop(self);
+	}
+
+	if (done || self->matches->len != n_before) {
+		mark_all_dirty();
+	}
+
+	return done ? G_SOURCE_REMOVE : G_SOURCE_CONTINUE;
+}
+
 /*
  * perform_search:
  * @self: the search module
  *
- * Searches all visible terminal lines for the current query string.
- * Populates self->matches with SearchMatch entries for each hit.
- * Supports both plain text (case-insensitive by default) and
- * regex matching modes.
+ * Restarts the search for the current query. Visible lines are
+ * searched right away; scrollback history is handed to
+ * scan_history_chunk(), limited to the candidates of the
+ * scrollback's trigram index when it can narrow the query.
+ *
+ * If the query only extends the previous plain-text query and no
+ * output arrived since, a line can only match if it matched
+ * before, so the new scan visits just those lines, plus whatever
+ * the previous scan had not reached yet when it was replaced.
  */
 static void
 perform_search(GstSearchModule *self)
 {
 	GstModuleManager *mgr;
 	GstTerminal *term;
+	GArray *candidates;
+	gboolean refine;
+	gboolean scan_full;
+	gint64 scan_next;
 	gint rows;
 	gint cols;
 	gint y;
-	g_autoptr(GRegex) regex = NULL;
+	guint i;
+
+	refine = !self->use_regex && !self->capped
+		&& self->prev_query != NULL && self->pushed == self->prev_pushed
+		&& g_str_has_prefix(self->query->str, self->prev_query);
+
+	candidates = NULL;
+	scan_full = TRUE;
+	scan_next = self->pushed - 1;
+
+	if (refine) {
+		/* History lines of the previous results... */
+		candidates = g_array_new(FALSE, FALSE, sizeof(gint64));
+		for (i = 0; i < self->matches->len; i++) {
+			gint64 line;
+
+			line = g_array_index(self->matches, SearchMatch, i).line;
+			if (line < self->pushed && (candidates->len == 0
+			    || g_array_index(candidates, gint64,
+			                     candidates->len - 1) != line))
+			{
+				g_array_append_val(candidates, line);
+			}
+		}
+
+		/* ...then what the previous scan still had to do */
+		scan_full = FALSE;
+		if (self->scan_id != 0) {
+			if (self->candidates != NULL) {
+				g_array_append_vals(candidates,
+					&g_array_index(self->candidates, gint64, self->cand_pos),
+					self->candidates->len - self->cand_pos);
+			}
+			scan_full = self->scan_full;
+			scan_next = self->scan_next;
+		}
+	}
 
 	/* Clear previous results */
+	search_stop(self);
 	g_array_set_size(self->matches, 0);
 	self->current_match_idx = -1;
-
-	/* Nothing to search for */
-	if (self->query->len == 0) {
-		return;
-	}
+	g_clear_pointer(&self->prev_query, g_free);
+	self->capped = FALSE;
 
 	mgr = gst_module_manager_get_default();
 	term = (GstTerminal *)gst_module_manager_get_terminal(mgr);
-	if (term == NULL) {
+
+	/* Nothing to search for */
+	if (self->query->len == 0 || term == NULL) {
+		if (candidates != NULL) {
+			g_array_free(candidates, TRUE);
+		}
 		return;
 	}
 
 	gst_terminal_get_size(term, &cols, &rows);
 
-	/* Compile regex if in regex mode */
+	/* Compile the query once for the whole scan */
 	if (self->use_regex) {
 		GRegexCompileFlags flags;
 		GError *err = NULL;
@@ -209,138 +660,99 @@ perform_search(GstSearchModule *self)
 			flags |= G_REGEX_CASELESS;
 		}
 
-		regex = g_regex_new(self->query->str, flags, 0, &err);
-		if (regex == NULL) {
+		self->regex = g_regex_new(self->query->str, flags, 0, &err);
+		if (self->regex == NULL) {
 			g_debug("search: invalid regex '%s': %s",
 				self->query->str,
 				err != NULL ? err->message : "unknown");
 			g_clear_error(&err);
 			return;
 		}
+	} else if (self->match_case) {
+		self->needle = g_strdup(self->query->str);
+	} else {
+		GString *folded;
+		const gchar *p;
+
+		/* Fold per rune, exactly as scan_glyphs() folds the text */
+		folded = g_string_sized_new(self->query->len);
+		for (p = self->query->str; *p != '\0'; p = g_utf8_next_char(p)) {
+			g_string_append_unichar(folded,
+				g_unichar_tolower(g_utf8_get_char(p)));
+		}
+		self->needle = g_string_free(folded, FALSE);
 	}
 
-	/* Search each visible line */
-	for (y = 0; y < rows; y++) {
-		g_autofree gchar *text = NULL;
+	self->prev_query = g_strdup(self->query->str);
+	self->prev_pushed = self->pushed;
+
+	/* Search each visible line, bottom up */
+	for (y = rows - 1; y >= 0; y--) {
 		GstLine *line;
-		gint text_len;
 
 		line = gst_terminal_get_line(term, y);
 		if (line == NULL) {
 			continue;
 		}
+		scan_glyphs(self, line->glyphs, MIN(line->len, cols),
+			self->pushed + y);
+	}
 
-		text = gst_line_to_string(line);
-		if (text == NULL) {
-			continue;
-		}
-
-		text_len = (gint)strlen(text);
-		if (text_len == 0) {
-			continue;
-		}
+	if (self->matches->len > 0) {
+		self->current_match_idx = 0;
+		reveal_match(self);
+	}
 
-		if (self->use_regex && regex != NULL) {
-			/*
-			 * Regex matching: iterate over all matches in the line.
-			 * GMatchInfo provides byte offsets; we convert them to
-			 * column positions by counting UTF-8 characters.
-			 */
-			GMatchInfo *match_info = NULL;
-
-			g_regex_match(regex, text, 0, &match_info);
-			while (g_match_info_matches(match_info)) {
-				gint start_byte;
-				gint end_byte;
-				SearchMatch m;
-
-				if (g_match_info_fetch_pos(match_info, 0,
-					&start_byte, &end_byte))
-				{
-					/*
-					 * Convert byte offsets to column positions.
-					 * Count UTF-8 characters up to each offset.
-					 */
-					m.line_idx = y;
-					m.col_start = (gint)g_utf8_pointer_to_offset(
-						text, text + start_byte);
-					m.col_end = (gint)g_utf8_pointer_to_offset(
-						text, text + end_byte);
-					g_array_append_val(self->matches, m);
-				}
-
-				g_match_info_next(match_info, NULL);
-			}
+	/* Then history, in the background */
+	if (ensure_scrollback_api(self) && self->sb_find_lines != NULL) {
+		GArray *indices;
 
-			g_match_info_free(match_info);
-		} else {
-			/*
-			 * Plain text matching: scan the line for all
-			 * occurrences of the query string.
-			 */
-			const gchar *haystack;
-			const gchar *needle;
-			g_autofree gchar *lower_text = NULL;
-			g_autofree gchar *lower_query = NULL;
-
-			if (self->match_case) {
-				haystack = text;
-				needle = self->query->str;
+		indices = g_array_new(FALSE, FALSE, sizeof(gint));
+		if (self->sb_find_lines(self->sb_module, self->query->str,
+			self->use_regex, indices))
+		{
+			/* Indices count back from the newest line */
+			if (candidates != NULL) {
+				g_array_set_size(candidates, 0);
 			} else {
-				lower_text = g_utf8_strdown(text, -1);
-				lower_query = g_utf8_strdown(self->query->str, -1);
-				haystack = lower_text;
-				needle = lower_query;
+				candidates = g_array_new(FALSE, FALSE, sizeof(gint64));
 			}
+			for (i = 0; i < indices->len; i++) {
+				gint64 line;
 
-			{
-				const gchar *pos;
-				gint needle_len;
-
-				needle_len = (gint)strlen(needle);
-				pos = haystack;
-
-				while ((pos = g_strstr_len(pos, -1, needle)) != NULL) {
-					SearchMatch m;
-					gint byte_start;
-					gint byte_end;
-
-					byte_start = (gint)(pos - haystack);
-					byte_end = byte_start + needle_len;
-
-					/*
-					 * Convert byte offsets to column positions
-					 * using the original text for correct UTF-8
-					 * character counting.
-					 */
-					m.line_idx = y;
-					m.col_start = (gint)g_utf8_pointer_to_offset(
-						haystack, haystack + byte_start);
-					m.col_end = (gint)g_utf8_pointer_to_offset(
-						haystack, haystack + byte_end);
-
-					g_array_append_val(self->matches, m);
-
-					/* Advance past this match to find the next */
-					pos = g_utf8_next_char(pos);
-				}
+				line = self->pushed - 1 - g_array_index(indices, gint, i);
+				g_array_append_val(candidates, line);
 			}
+			scan_full = FALSE;
 		}
+		g_array_free(indices, TRUE);
 	}
 
-	/* If we found matches, focus on the first one */
-	if (self->matches->len > 0) {
-		self->current_match_idx = 0;
+	if (ensure_scrollback_api(self)
+	    && (scan_full || (candidates != NULL && candidates->len > 0)))
+	{
+		self->candidates = candidates;
+		self->cand_pos = 0;
+		self->scan_full = scan_full;
+		self->scan_next = scan_next;
+		self->scan_id = g_idle_add(scan_history_chunk, self);
+		return;
+	}
+
+	if (candidates != NULL) {
+		g_array_free(candidates, TRUE);
 	}
+	search_stop(self);
 }
 
 /*
  * navigate_match:
  * @self: the search module
- * @direction: +1 for next match, -1 for previous match
+ * @direction: +1 for the next older match, -1 for the next newer one
  *
  * Moves the current match index forward or backward, wrapping
- * around at the ends of the match list.
+ * around at the ends of the match list, and scrolls the match
+ * into view.
  */
 static void
 navigate_match(
@@ -363,6 +775,7 @@ navigate_match(
 		self->current_match_idx = count - 1;
 	}
 
+	reveal_match(self);
 	mark_all_dirty();
 }
 
@@ -410,9 +823,7 @@ gst_search_module_handle_key_event(
 			(ControlMask | ShiftMask))
 		{
 			self->active = TRUE;
-			g_string_truncate(self->query, 0);
-			g_array_set_size(self->matches, 0);
-			self->current_match_idx = -1;
+			search_reset(self);
 			mark_all_dirty();
 			g_debug("search: activated");
 			return TRUE;
@@ -427,9 +838,7 @@ gst_search_module_handle_key_event(
 	/* Escape: deactivate search */
 	if (keyval == XK_Escape) {
 		self->active = FALSE;
-		g_string_truncate(self->query, 0);
-		g_array_set_size(self->matches, 0);
-		self->current_match_idx = -1;
+		search_reset(self);
 		mark_all_dirty();
 		g_debug("search: deactivated");
 		return TRUE;
@@ -565,7 +974,13 @@ gst_search_module_render(
 ){
 	GstSearchModule *self;
 	GstRenderContext *ctx;
+	GstTerminal *term;
 	guint i;
+	guint lo;
+	guint hi;
+	gint offset;
+	gint64 top;
+	gint64 bottom;
 	gchar status[64];
 	gint status_len;
 	gint bar_y;
@@ -584,16 +999,44 @@ gst_search_module_render(
 
 	/* ===== Draw match highlight rectangles ===== */
 
-	for (i = 0; i < self->matches->len; i++) {
+	/*
+	 * With the history scrolled back by offset lines, line L shows
+	 * on row L - pushed + offset. Matches are sorted newest first,
+	 * so the visible ones are found by bisection.
+	 */
+	offset = ensure_scrollback_api(self)
+		? self->sb_get_offset(self->sb_module) : 0;
+	top = self->pushed - offset;
+	term = (GstTerminal *)gst_module_manager_get_terminal(
+		gst_module_manager_get_default());
+	bottom = top + ((term != NULL) ? gst_terminal_get_rows(term) : 0);
+
+	lo = 0;
+	hi = self->matches->len;
+	while (lo < hi) {
+		guint mid;
+
+		mid = lo + (hi - lo) / 2;
+		if (g_array_index(self->matches, SearchMatch, mid).line >= bottom) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	for (i = lo; i < self->matches->len; i++) {
 		SearchMatch *m;
 		gint px;
 		gint py;
 		gint pw;
 
 		m = &g_array_index(self->matches, SearchMatch, i);
+		if (m->line < top) {
+			break;
+		}
 
 		px = ctx->borderpx + m->col_start * ctx->cw;
-		py = ctx->borderpx + m->line_idx * ctx->ch;
+		py = ctx->borderpx + (gint)(m->line - top) * ctx->ch;
 		pw = (m->col_end - m->col_start) * ctx->cw;
 
 		if ((gint)i == self->current_match_idx) {
@@ -667,12 +1110,15 @@ gst_search_module_render(
 
 	text_x += ctx->cw;
 
-	/* Draw match count status */
+	/* Draw match count status; "+" while history is still searched */
 	if (self->matches->len > 0) {
 		status_len = g_snprintf(status, sizeof(status),
-			"[%d/%d]",
+			"[%d/%d%s]",
 			self->current_match_idx + 1,
-			(gint)self->matches->len);
+			(gint)self->matches->len,
+			(self->scan_id != 0 || self->capped) ? "+" : "");
+	} else if (self->scan_id != 0) {
+		status_len = g_snprintf(status, sizeof(status), "Searching...");
 	} else if (self->query->len > 0) {
 		status_len = g_snprintf(status, sizeof(status), "No matches");
 	} else {
@@ -724,20 +1170,31 @@ gst_search_module_get_description(GstModule *module)
 /*
  * activate:
  *
- * Activates the search module. Initializes the match array
- * and resets search state.
+ * Activates the search module. Resets search state and starts
+ * counting lines scrolled out of the terminal.
  */
 static gboolean
 gst_search_module_activate(GstModule *module)
 {
 	GstSearchModule *self;
+	GstModuleManager *mgr;
+	GstTerminal *term;
 
 	self = GST_SEARCH_MODULE(module);
 
 	self->active = FALSE;
-	g_string_truncate(self->query, 0);
-	g_array_set_size(self->matches, 0);
-	self->current_match_idx = -1;
+	search_reset(self);
+	self->pushed = 0;
+	self->sb_resolved = FALSE;
+	self->sb_module = NULL;
+	self->sb_find_lines = NULL;
+
+	mgr = gst_module_manager_get_default();
+	term = (GstTerminal *)gst_module_manager_get_terminal(mgr);
+	if (term != NULL) {
+		self->sig_id = g_signal_connect(term, "lines-scrolled-out",
+			G_CALLBACK(on_lines_scrolled_out), self);
+	}
 
 	g_debug("search: activated");
 	return TRUE;
@@ -752,13 +1209,22 @@ static void
 gst_search_module_deactivate(GstModule *module)
 {
 	GstSearchModule *self;
+	GstModuleManager *mgr;
+	GstTerminal *term;
 
 	self = GST_SEARCH_MODULE(module);
 
 	self->active = FALSE;
-	g_string_truncate(self->query, 0);
-	g_array_set_size(self->matches, 0);
-	self->current_match_idx = -1;
+	search_reset(self);
+
+	if (self->sig_id != 0) {
+		mgr = gst_module_manager_get_default();
+		term = (GstTerminal *)gst_module_manager_get_terminal(mgr);
+		if (term != NULL) {
+			g_signal_handler_disconnect(term, self->sig_id);
+		}
+		self->sig_id = 0;
+	}
 
 	g_debug("search: deactivated");
 }
@@ -837,6 +1303,9 @@ gst_search_module_configure(GstModule *module, gpointer config)
 	self->match_case = cfg->modules.search.match_case;
 	self->use_regex = cfg->modules.search.regex;
 
+	/* Old results were found under the old flags */
+	g_clear_pointer(&self->prev_query, g_free);
+
 	g_debug("search: configured (case=%s, regex=%s, "
 		"hl=#%02x%02x%02x/%d, cur=#%02x%02x%02x/%d)",
 		self->match_case ? "yes" : "no",
@@ -854,6 +1323,16 @@ gst_search_module_dispose(GObject *object)
 
 	self = GST_SEARCH_MODULE(object);
 
+	search_stop(self);
+	g_clear_pointer(&self->prev_query, g_free);
+
+	if (self->text != NULL) {
+		g_string_free(self->text, TRUE);
+		self->text = NULL;
+	}
+	g_clear_pointer(&self->byte_col, g_array_unref);
+	g_clear_pointer(&self->line_hits, g_array_unref);
+
 	if (self->query != NULL) {
 		g_string_free(self->query, TRUE);
 		self->query = NULL;
@@ -892,6 +1371,21 @@ gst_search_module_init(GstSearchModule *self)
 	self->matches = g_array_new(FALSE, FALSE, sizeof(SearchMatch));
 	self->current_match_idx = -1;
 
+	self->pushed = 0;
+	self->sig_id = 0;
+	self->scan_id = 0;
+	self->candidates = NULL;
+	self->regex = NULL;
+	self->needle = NULL;
+	self->prev_query = NULL;
+	self->capped = FALSE;
+	self->text = g_string_new(NULL);
+	self->byte_col = g_array_new(FALSE, FALSE, sizeof(gint));
+	self->line_hits = g_array_new(FALSE, FALSE, sizeof(SearchMatch));
+	self->sb_resolved = FALSE;
+	self->sb_module = NULL;
+	self->sb_find_lines = NULL;
+
 	/* Default highlight color: yellow (#ffff00) alpha 100 */
 	self->hl_r = 0xFF;
 	self->hl_g = 0xFF;
@@ -908,6 +1402,65 @@ gst_search_module_init(GstSearchModule *self)
 	self->use_regex = FALSE;
 }
 
+/* ===== Public accessors ===== */
+
+/**
+ * gst_search_module_get_n_matches:
+ * @self: A #GstSearchModule
+ *
+ * Gets the number of matches found for the current query.
+ *
+ * Returns: the number of matches
+ */
+guint
+gst_search_module_get_n_matches(GstSearchModule *self)
+{
+	g_return_val_if_fail(GST_IS_SEARCH_MODULE(self), 0);
+
+	return self->matches->len;
+}
+
+/**
+ * gst_search_module_get_match:
+ * @self: A #GstSearchModule
+ * @index: match index, 0 being the newest
+ * @line: (out) (optional): absolute line number of the match
+ * @col_start: (out) (optional): first column of the match
+ * @col_end: (out) (optional): column just past the match
+ *
+ * Gets a match of the current query.
+ *
+ * Returns: %FALSE if @index is out of range
+ */
+gboolean
+gst_search_module_get_match(
+	GstSearchModule *self,
+	guint           index,
+	gint64          *line,
+	gint            *col_start,
+	gint            *col_end
+){
+	SearchMatch *m;
+
+	g_return_val_if_fail(GST_IS_SEARCH_MODULE(self), FALSE);
+
+	if (index >= self->matches->len) {
+		return FALSE;
+	}
+
+	m = &g_array_index(self->matches, SearchMatch, index);
+	if (line != NULL) {
+		*line = m->line;
+	}
+	if (col_start != NULL) {
+		*col_start = m->col_start;
+	}
+	if (col_end != NULL) {
+		*col_end = m->col_end;
+	}
+	return TRUE;
+}
+
 /* ===== Module entry point ===== */
 
 /**
@@ -26,6 +26,42 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE(GstSearchModule, gst_search_module,
 	GST, SEARCH_MODULE, GstModule)
 
+/**
+ * gst_search_module_get_n_matches:
+ * @self: A #GstSearchModule
+ *
+ * Gets the number of matches found for the current query. While
+ * the history is still being searched, idle callbacks add more.
+ *
+ * Returns: the number of matches
+ */
+guint
+gst_search_module_get_n_matches(GstSearchModule *self);
+
+/**
+ * gst_search_module_get_match:
+ * @self: A #GstSearchModule
+ * @index: match index, 0 being the newest
+ * @line: (out) (optional): absolute line number of the match
+ * @col_start: (out) (optional): first column of the match
+ * @col_end: (out) (optional): column just past the match
+ *
+ * Gets a match of the current query. Line numbers count every line
+ * scrolled out since the module was activated: with N lines
+ * scrolled out, screen row y is line N + y and scrollback line i
+ * (0 = most recent) is line N - 1 - i.
+ *
+ * Returns: %FALSE if @index is out of range
+ */
+gboolean
+gst_search_module_get_match(
+	GstSearchModule *self,
+	guint           index,
+	gint64          *line,
+	gint            *col_start,
+	gint            *col_end
+);
+
 /**
  * gst_module_register:
  *
@@ -91,7 +91,7 @@ struct _GstShellintModule
 	GstModule parent_instance;
 
 	GArray   *zones;            /* array of GstSemanticZone */
-	gulong    scroll_sig_id;    /* signal handler for line-scrolled-out */
+	gulong    scroll_sig_id;    /* signal handler for lines-scrolled-out */
 
 	/* Configuration */
 	gboolean  mark_prompts;     /* render prompt markers */
@@ -204,16 +204,18 @@ get_current_cursor_row(void)
 }
 
 /*
- * on_line_scrolled_out:
+ * on_lines_scrolled_out:
  *
- * Signal callback for "line-scrolled-out". Decrements all row
- * indices in the zone array by one and removes zones that have
- * scrolled entirely off-screen (all rows < 0).
+ * Signal callback for "lines-scrolled-out". Moves all row indices
+ * in the zone array up by the batch size (rows that leave the
+ * screen become -1) and removes zones that have scrolled entirely
+ * off-screen (all rows < 0).
  */
 static void
-on_line_scrolled_out(
+on_lines_scrolled_out(
 	GstTerminal *term,
-	GstLine     *line,
+	GstLine     **lines,
+	gint         n_lines,
 	gint         cols,
 	gpointer     user_data
 ){
@@ -221,21 +223,25 @@ on_line_scrolled_out(
 	guint i;
 
 	(void)term;
-	(void)line;
+	(void)lines;
 	(void)cols;
 
 	self = GST_SHELLINT_MODULE(user_data);
 
-	/* Decrement all row indices */
+	/* Shift all row indices */
 	for (i = 0; i < self->zones->len; i++) {
 		GstSemanticZone *zone;
 
 		zone = &g_array_index(self->zones, GstSemanticZone, i);
 
-		if (zone->prompt_row >= 0)  zone->prompt_row--;
-		if (zone->command_row >= 0) zone->command_row--;
-		if (zone->output_row >= 0)  zone->output_row--;
-		if (zone->end_row >= 0)     zone->end_row--;
+		if (zone->prompt_row >= 0)
+			zone->prompt_row = MAX(zone->prompt_row - n_lines, -1);
+		if (zone->command_row >= 0)
+			zone->command_row = MAX(zone->command_row - n_lines, -1);
+		if (zone->output_row >= 0)
+			zone->output_row = MAX(zone->output_row - n_lines, -1);
+		if (zone->end_row >= 0)
+			zone->end_row = MAX(zone->end_row - n_lines, -1);
 	}
 
 	/*
@@ -705,7 +711,7 @@ gst_shellint_module_get_description(GstModule *module)
  * activate:
  *
  * Activates the shell integration module. Allocates the zone
- * array and connects to the terminal's "line-scrolled-out"
+ * array and connects to the terminal's "lines-scrolled-out"
  * signal to track row adjustments.
  */
 static gboolean
@@ -723,13 +729,13 @@ gst_shellint_module_activate(GstModule *module)
 			sizeof(GstSemanticZone));
 	}
 
-	/* Connect to terminal's line-scrolled-out signal */
+	/* Connect to terminal's lines-scrolled-out signal */
 	mgr = gst_module_manager_get_default();
 	term = (GstTerminal *)gst_module_manager_get_terminal(mgr);
 	if (term != NULL) {
 		self->scroll_sig_id = g_signal_connect(term,
-			"line-scrolled-out",
-			G_CALLBACK(on_line_scrolled_out), self);
+			"lines-scrolled-out",
+			G_CALLBACK(on_lines_scrolled_out), self);
 	}
 
 	g_debug("shell_integration: activated (mark_prompts=%d, "
@@ -742,7 +748,7 @@ gst_shellint_module_activate(GstModule *module)
  * deactivate:
  *
  * Deactivates the shell integration module. Disconnects from
- * the line-scrolled-out signal and frees the zone array.
+ * the lines-scrolled-out signal and frees the zone array.
  */
 static void
 gst_shellint_module_deactivate(GstModule *module)
@@ -104,6 +104,7 @@ typedef struct
 	gint     stride;     /* bytes per row (width * SIXEL_BPP) */
 	guint8  *data;       /* RGBA pixel data (row-major) */
 	gsize    data_size;  /* total allocation size of data in bytes */
+	guint    image_handle; /* render context upload of data, or 0 */
 } SixelPlacement;
 
 /* ===== Sixel color entry ===== */
@@ -147,6 +148,12 @@ struct _GstSixelModule
 	/* Next auto-incrementing placement ID */
 	guint32 next_id;
 
+	/*
+	 * Render context handles (guint) of removed placements,
+	 * released at the start of the next render pass
+	 */
+	GArray *released;
+
 	/* Signal handler IDs */
 	gulong sig_scrolled;
 
@@ -212,6 +219,26 @@ sixel_placement_free(gpointer data)
 	}
 }
 
+/*
+ * sixel_remove_placement:
+ * @self: the sixel module
+ * @pl: a placement in self->placements
+ *
+ * Removes and frees a placement, queueing its render context
+ * upload for release by the next render pass.
+ */
+static void
+sixel_remove_placement(
+	GstSixelModule *self,
+	SixelPlacement *pl
+){
+	if (pl->image_handle != 0) {
+		g_array_append_val(self->released, pl->image_handle);
+	}
+	self->total_ram -= pl->data_size;
+	g_hash_table_remove(self->placements, GUINT_TO_POINTER(pl->id));
+}
+
 /*
  * sixel_evict_oldest:
  * @self: the sixel module
@@ -243,9 +270,7 @@ sixel_evict_oldest(GstSixelModule *self)
 	}
 
 	if (oldest_pl != NULL) {
-		self->total_ram -= oldest_pl->data_size;
-		g_hash_table_remove(self->placements,
-			GUINT_TO_POINTER(oldest_id));
+		sixel_remove_placement(self, oldest_pl);
 	}
 }
 
@@ -871,16 +896,18 @@ sixel_decode(
 /* ===== Signal callbacks ===== */
 
 /*
- * on_line_scrolled_out:
+ * on_lines_scrolled_out:
  *
- * Signal callback for "line-scrolled-out". Adjusts all placement
- * row positions upward by one and removes placements that have
- * scrolled entirely off the screen (bottom edge above row 0).
+ * Signal callback for "lines-scrolled-out". Adjusts all placement
+ * row positions upward by the batch size and removes placements
+ * that have scrolled entirely off the screen (bottom edge above
+ * row 0).
  */
 static void
-on_line_scrolled_out(
+on_lines_scrolled_out(
 	GstTerminal *term,
-	gpointer     line,
+	gpointer     lines,
+	gint         n_lines,
 	gint         cols,
 	gpointer     user_data
 ){
@@ -892,13 +919,13 @@ on_line_scrolled_out(
 	GList *l;
 
 	(void)term;
-	(void)line;
+	(void)lines;
 	(void)cols;
 
 	self = GST_SIXEL_MODULE(user_data);
 	remove_ids = NULL;
 
-	/* Shift all placement rows up by one, collect expired IDs */
+	/* Shift all placement rows up, collect expired IDs */
 	g_hash_table_iter_init(&iter, self->placements);
 	while (g_hash_table_iter_next(&iter, &key, &value)) {
 		SixelPlacement *pl;
@@ -909,7 +936,7 @@ on_line_scrolled_out(
 		gint img_rows;
 
 		pl = (SixelPlacement *)value;
-		pl->row--;
+		pl->row -= n_lines;
 
 		/*
 		 * Calculate how many terminal rows this image spans.
@@ -948,10 +975,8 @@ on_line_scrolled_out(
 		pl = (SixelPlacement *)g_hash_table_lookup(
 			self->placements, GUINT_TO_POINTER(id));
 		if (pl != NULL) {
-			self->total_ram -= pl->data_size;
+			sixel_remove_placement(self, pl);
 		}
-		g_hash_table_remove(self->placements,
-			GUINT_TO_POINTER(id));
 	}
 
 	g_list_free(remove_ids);
@@ -1018,7 +1043,7 @@ sixel_configure(
  * activate:
  *
  * Creates the placement hash table and connects to the terminal's
- * "line-scrolled-out" signal for scroll management.
+ * "lines-scrolled-out" signal for scroll management.
  */
 static gboolean
 sixel_activate(GstModule *base)
@@ -1036,13 +1061,13 @@ sixel_activate(GstModule *base)
 			NULL, sixel_placement_free);
 	}
 
-	/* Connect to terminal's line-scrolled-out signal */
+	/* Connect to terminal's lines-scrolled-out signal */
 	mgr = gst_module_manager_get_default();
 	term = (GstTerminal *)gst_module_manager_get_terminal(mgr);
 	if (term != NULL) {
 		self->sig_scrolled = g_signal_connect(term,
-			"line-scrolled-out",
-			G_CALLBACK(on_line_scrolled_out), self);
+			"lines-scrolled-out",
+			G_CALLBACK(on_lines_scrolled_out), self);
 	}
 
 	g_debug("sixel: activated");
@@ -1074,8 +1099,21 @@ sixel_deactivate(GstModule *base)
 		self->sig_scrolled = 0;
 	}
 
-	/* Free all placements */
+	/* Free all placements, keeping their uploads for release */
 	if (self->placements != NULL) {
+		GHashTableIter iter;
+		gpointer value;
+
+		g_hash_table_iter_init(&iter, self->placements);
+		while (g_hash_table_iter_next(&iter, NULL, &value)) {
+			SixelPlacement *pl;
+
+			pl = (SixelPlacement *)value;
+			if (pl->image_handle != 0) {
+				g_array_append_val(self->released,
+					pl->image_handle);
+			}
+		}
 		g_hash_table_remove_all(self->placements);
 		self->total_ram = 0;
 	}
@@ -1226,12 +1264,24 @@ sixel_render(
 	GHashTableIter iter;
 	gpointer key;
 	gpointer value;
+	guint i;
 	gint rows;
 
 	self = GST_SIXEL_MODULE(overlay);
 	ctx = (GstRenderContext *)render_ctx;
 
-	if (self->placements == NULL || ctx == NULL) {
+	if (ctx == NULL) {
+		return;
+	}
+
+	/* Free the uploads of evicted and scrolled-away placements */
+	for (i = 0; i < self->released->len; i++) {
+		gst_render_context_release_image(ctx,
+			g_array_index(self->released, guint, i));
+	}
+	g_array_set_size(self->released, 0);
+
+	if (self->placements == NULL) {
 		return;
 	}
 
@@ -1298,9 +1348,13 @@ sixel_render(
 			continue;
 		}
 
-		/* Draw the image using the render context vtable */
-		gst_render_context_draw_image(ctx,
+		/*
+		 * Draw through the render context's image cache so the
+		 * pixels are uploaded once, not every frame.
+		 */
+		gst_render_context_draw_cached_image(ctx, &pl->image_handle,
 			pl->data, pl->width, pl->height, pl->stride,
+			0, 0, dw, dh,
 			px, py, dw, dh);
 	}
 }
@@ -1318,6 +1372,7 @@ gst_sixel_module_finalize(GObject *object)
 		g_hash_table_destroy(self->placements);
 		self->placements = NULL;
 	}
+	g_clear_pointer(&self->released, g_array_unref);
 
 	G_OBJECT_CLASS(gst_sixel_module_parent_class)->finalize(object);
 }
@@ -1344,6 +1399,7 @@ gst_sixel_module_init(GstSixelModule *self)
 {
 	self->placements = NULL;
 	self->next_id = 1;
+	self->released = g_array_new(FALSE, FALSE, sizeof(guint));
 	self->sig_scrolled = 0;
 	self->total_ram = 0;
 
@@ -67,6 +67,7 @@ struct _GstWallpaperModule
 	gint        scaled_stride;
 	gint        draw_x;        /* x offset for centering/letterboxing */
 	gint        draw_y;        /* y offset for centering/letterboxing */
+	guint       image_handle;  /* uploaded copy of scaled_pixels, or 0 */
 
 	/* Cached window dimensions for resize detection */
 	gint        last_win_w;
@@ -387,8 +388,10 @@ gst_wallpaper_module_render_background(
 		return;
 	}
 
-	/* Recompute scaled image if window size changed */
+	/* Recompute scaled image if window size changed (or it was reloaded) */
 	if (width != self->last_win_w || height != self->last_win_h) {
+		gst_render_context_release_image(ctx, self->image_handle);
+		self->image_handle = 0;
 		compute_scaled_image(self, width, height);
 	}
 
@@ -396,10 +399,11 @@ gst_wallpaper_module_render_background(
 		return;
 	}
 
-	/* Draw the pre-scaled wallpaper image (1:1 blit) */
-	gst_render_context_draw_image(ctx,
+	/* Draw the pre-scaled wallpaper image (1:1 blit), uploaded once */
+	gst_render_context_draw_cached_image(ctx, &self->image_handle,
 		self->scaled_pixels,
 		self->scaled_w, self->scaled_h, self->scaled_stride,
+		0, 0, self->scaled_w, self->scaled_h,
 		self->draw_x, self->draw_y,
 		self->scaled_w, self->scaled_h);
 
@@ -556,6 +560,7 @@ gst_wallpaper_module_init(GstWallpaperModule *self)
 	self->bg_alpha = 0.3;
 	self->src_pixels = NULL;
 	self->scaled_pixels = NULL;
+	self->image_handle = 0;
 	self->src_w = 0;
 	self->src_h = 0;
 	self->scaled_w = 0;
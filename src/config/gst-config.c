@@ -157,6 +157,12 @@ gst_config_init(GstConfig *self)
 	self->min_latency = 8;
 	self->max_latency = 33;
 
+	/* PTY read batching defaults */
+	self->pty_read_budget = 1048576;
+	self->pty_read_time = 4;
+	self->glyph_atlas = FALSE;
+	self->render_thread = FALSE;
+
 	/* Module config defaults (match data/default-config.yaml) */
 	memset(&self->modules, 0, sizeof(GstModuleConfigs));
 
@@ -164,6 +170,8 @@ gst_config_init(GstConfig *self)
 	self->modules.scrollback.enabled = TRUE;
 	self->modules.scrollback.lines = 10000;
 	self->modules.scrollback.mouse_scroll_lines = 3;
+	self->modules.scrollback.spill_to_disk = FALSE;
+	self->modules.scrollback.search_index = FALSE;
 
 	/* transparency */
 	self->modules.transparency.enabled = FALSE;
@@ -763,7 +771,8 @@ load_selection_section(
 /*
  * load_draw_section:
  *
- * Parse the "draw:" mapping for min_latency and max_latency.
+ * Parse the "draw:" mapping for min_latency, max_latency,
+ * pty_read_budget, pty_read_time, glyph_atlas and render_thread.
  */
 static gboolean
 load_draw_section(
@@ -803,6 +812,40 @@ load_draw_section(
 		self->max_latency = (guint)int_val;
 	}
 
+	if (yaml_mapping_has_member(section, "pty_read_budget")) {
+		int_val = yaml_mapping_get_int_member(section, "pty_read_budget");
+		if (int_val < 4096 || int_val > 1048576) {
+			g_set_error(error, GST_CONFIG_ERROR,
+				GST_CONFIG_ERROR_INVALID_VALUE,
+				"pty_read_budget must be 4096-1048576 bytes, got %"
+				G_GINT64_FORMAT, int_val);
+			return FALSE;
+		}
+		self->pty_read_budget = (guint)int_val;
+	}
+
+	if (yaml_mapping_has_member(section, "pty_read_time")) {
+		int_val = yaml_mapping_get_int_member(section, "pty_read_time");
+		if (int_val < 1 || int_val > 1000) {
+			g_set_error(error, GST_CONFIG_ERROR,
+				GST_CONFIG_ERROR_INVALID_VALUE,
+				"pty_read_time must be 1-1000 ms, got %" G_GINT64_FORMAT,
+				int_val);
+			return FALSE;
+		}
+		self->pty_read_time = (guint)int_val;
+	}
+
+	if (yaml_mapping_has_member(section, "glyph_atlas")) {
+		self->glyph_atlas = yaml_mapping_get_boolean_member(
+			section, "glyph_atlas");
+	}
+
+	if (yaml_mapping_has_member(section, "render_thread")) {
+		self->render_thread = yaml_mapping_get_boolean_member(
+			section, "render_thread");
+	}
+
 	return TRUE;
 }
 
@@ -868,6 +911,10 @@ load_mod_scrollback(GstConfig *self, YamlMapping *mod)
 	LOAD_MOD_INT(mod, "lines", self->modules.scrollback.lines);
 	LOAD_MOD_INT(mod, "mouse_scroll_lines",
 		self->modules.scrollback.mouse_scroll_lines);
+	LOAD_MOD_BOOL(mod, "spill_to_disk",
+		self->modules.scrollback.spill_to_disk);
+	LOAD_MOD_BOOL(mod, "search_index",
+		self->modules.scrollback.search_index);
 }
 
 static void
@@ -2155,6 +2202,72 @@ gst_config_get_max_latency(GstConfig *self)
 	return self->max_latency;
 }
 
+/**
+ * gst_config_get_pty_read_budget:
+ * @self: A #GstConfig
+ *
+ * Gets the most bytes read from the PTY per main-loop wakeup.
+ *
+ * Returns: Read budget in bytes
+ */
+guint
+gst_config_get_pty_read_budget(GstConfig *self)
+{
+	g_return_val_if_fail(GST_IS_CONFIG(self), 1048576);
+
+	return self->pty_read_budget;
+}
+
+/**
+ * gst_config_get_pty_read_time:
+ * @self: A #GstConfig
+ *
+ * Gets the most time spent draining the PTY per wakeup.
+ *
+ * Returns: Read time budget in ms
+ */
+guint
+gst_config_get_pty_read_time(GstConfig *self)
+{
+	g_return_val_if_fail(GST_IS_CONFIG(self), 4);
+
+	return self->pty_read_time;
+}
+
+/**
+ * gst_config_get_glyph_atlas:
+ * @self: A #GstConfig
+ *
+ * Gets whether the Wayland renderer blits glyphs from a
+ * pre-rasterized atlas.
+ *
+ * Returns: %TRUE if the glyph atlas is enabled
+ */
+gboolean
+gst_config_get_glyph_atlas(GstConfig *self)
+{
+	g_return_val_if_fail(GST_IS_CONFIG(self), FALSE);
+
+	return self->glyph_atlas;
+}
+
+/**
+ * gst_config_get_render_thread:
+ * @self: A #GstConfig
+ *
+ * Gets whether the Wayland renderer paints dirty lines on a
+ * dedicated render thread.
+ *
+ * Returns: %TRUE if the render thread is enabled
+ */
+gboolean
+gst_config_get_render_thread(GstConfig *self)
+{
+	g_return_val_if_fail(GST_IS_CONFIG(self), FALSE);
+
+	return self->render_thread;
+}
+
 /* ===== Key binding getters ===== */
 
 /**
@@ -2520,6 +2633,48 @@ gst_config_set_max_latency(
 	self->max_latency = ms;
 }
 
+void
+gst_config_set_pty_read_budget(
+	GstConfig *self,
+	guint      bytes
+){
+	g_return_if_fail(GST_IS_CONFIG(self));
+	g_return_if_fail(bytes >= 4096 && bytes <= 1048576);
+
+	self->pty_read_budget = bytes;
+}
+
+void
+gst_config_set_pty_read_time(
+	GstConfig *self,
+	guint      ms
+){
+	g_return_if_fail(GST_IS_CONFIG(self));
+	g_return_if_fail(ms >= 1 && ms <= 1000);
+
+	self->pty_read_time = ms;
+}
+
+void
+gst_config_set_glyph_atlas(
+	GstConfig *self,
+	gboolean   enabled
+){
+	g_return_if_fail(GST_IS_CONFIG(self));
+
+	self->glyph_atlas = enabled;
+}
+
+void
+gst_config_set_render_thread(
+	GstConfig *self,
+	gboolean   enabled
+){
+	g_return_if_fail(GST_IS_CONFIG(self));
+
+	self->render_thread = enabled;
+}
+
 /* ===== Keybind / mousebind management ===== */
 
 gboolean
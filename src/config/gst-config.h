@@ -113,6 +113,16 @@ struct _GstConfig
 	guint min_latency;
 	guint max_latency;
 
+	/* PTY read batching */
+	guint pty_read_budget;
+	guint pty_read_time;
+
+	/* Software glyph rasterization (Wayland) */
+	gboolean glyph_atlas;
+
+	/* Paint dirty lines on a render thread (Wayland) */
+	gboolean render_thread;
+
 	/* Module configs — direct struct access */
 	GstModuleConfigs modules;
 
@@ -500,6 +510,53 @@ gst_config_get_min_latency(GstConfig *self);
 guint
 gst_config_get_max_latency(GstConfig *self);
 
+/**
+ * gst_config_get_pty_read_budget:
+ * @self: A #GstConfig
+ *
+ * Gets the most bytes read from the PTY per main-loop wakeup.
+ * Output is drained up to this amount before it is parsed.
+ *
+ * Returns: Read budget in bytes
+ */
+guint
+gst_config_get_pty_read_budget(GstConfig *self);
+
+/**
+ * gst_config_get_pty_read_time:
+ * @self: A #GstConfig
+ *
+ * Gets the most time spent draining the PTY per wakeup.
+ *
+ * Returns: Read time budget in ms
+ */
+guint
+gst_config_get_pty_read_time(GstConfig *self);
+
+/**
+ * gst_config_get_glyph_atlas:
+ * @self: A #GstConfig
+ *
+ * Gets whether the Wayland renderer blits glyphs from a
+ * pre-rasterized atlas.
+ *
+ * Returns: %TRUE if the glyph atlas is enabled
+ */
+gboolean
+gst_config_get_glyph_atlas(GstConfig *self);
+
+/**
+ * gst_config_get_render_thread:
+ * @self: A #GstConfig
+ *
+ * Gets whether the Wayland renderer paints dirty lines on a
+ * dedicated render thread.
+ *
+ * Returns: %TRUE if the render thread is enabled
+ */
+gboolean
+gst_config_get_render_thread(GstConfig *self);
+
 /* ===== Key binding getters ===== */
 
 /**
@@ -876,6 +933,58 @@ gst_config_set_max_latency(
 	guint      ms
 );
 
+/**
+ * gst_config_set_pty_read_budget:
+ * @self: A #GstConfig
+ * @bytes: Bytes to read per wakeup (4096-1048576)
+ *
+ * Sets the PTY read budget.
+ */
+void
+gst_config_set_pty_read_budget(
+	GstConfig *self,
+	guint      bytes
+);
+
+/**
+ * gst_config_set_pty_read_time:
+ * @self: A #GstConfig
+ * @ms: Time to spend reading per wakeup in milliseconds (1-1000)
+ *
+ * Sets the PTY read time budget.
+ */
+void
+gst_config_set_pty_read_time(
+	GstConfig *self,
+	guint      ms
+);
+
+/**
+ * gst_config_set_glyph_atlas:
+ * @self: A #GstConfig
+ * @enabled: Whether to blit glyphs from a pre-rasterized atlas
+ *
+ * Enables or disables the Wayland glyph atlas.
+ */
+void
+gst_config_set_glyph_atlas(
+	GstConfig *self,
+	gboolean   enabled
+);
+
+/**
+ * gst_config_set_render_thread:
+ * @self: A #GstConfig
+ * @enabled: Whether to paint dirty lines on a render thread
+ *
+ * Enables or disables the Wayland render thread.
+ */
+void
+gst_config_set_render_thread(
+	GstConfig *self,
+	gboolean   enabled
+);
+
 /* ===== Keybind / mousebind management ===== */
 
 /**
@@ -45,14 +45,18 @@ G_BEGIN_DECLS
 /**
  * GstScrollbackConfig:
  * @enabled: whether the scrollback module is active
- * @lines: scrollback ring buffer capacity
+ * @lines: scrollback capacity, 0 for unlimited
  * @mouse_scroll_lines: lines scrolled per mouse wheel tick
+ * @spill_to_disk: keep compressed history in a file instead of RAM
+ * @search_index: keep a trigram index of history for fast searches
  */
 typedef struct _GstScrollbackConfig
 {
 	gboolean enabled;
 	gint     lines;
 	gint     mouse_scroll_lines;
+	gboolean spill_to_disk;
+	gboolean search_index;
 } GstScrollbackConfig;
 
 /**
@@ -0,0 +1,263 @@
+/*
+ * gst-block-arena.c - FIFO arena of fixed-size memory blocks
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Block IDs index a flat array and never move, so records can be
+ * addressed by plain pointers. Emptied blocks go on a spare stack;
+ * a couple keep their memory for reuse, the rest are freed and
+ * only their slot is kept.
+ */
+
+#include "gst-block-arena.h"
+
+/* Empty blocks kept allocated for reuse */
+#define ARENA_MAX_POOLED (2)
+
+/* Record alignment */
+#define ARENA_ALIGN(n) (((n) + 7) & ~(gsize)7)
+
+typedef struct {
+	guint8 *data;      /* NULL for a freed slot */
+	gsize size;
+	gsize used;
+	guint live;        /* records not yet released */
+} ArenaBlock;
+
+struct _GstBlockArena {
+	ArenaBlock *blocks;
+	guint n_blocks;
+	guint cap;
+
+	guint *spare;      /* empty blocks, pooled or freed */
+	guint n_spare;
+	guint n_pooled;
+
+	guint cur;         /* block being filled, or G_MAXUINT */
+	gsize block_size;
+	gsize bytes;
+};
+
+/*
+ * arena_retire:
+ *
+ * Moves an empty block onto the spare stack, keeping its memory
+ * if it is a regular block and the pool has room.
+ */
+static void
+arena_retire(
+	GstBlockArena   *arena,
+	guint           id
+){
+	ArenaBlock *b;
+
+	b = &arena->blocks[id];
+	b->used = 0;
+	b->live = 0;
+
+	if (b->size == arena->block_size && arena->n_pooled < ARENA_MAX_POOLED) {
+		arena->n_pooled++;
+	} else {
+		arena->bytes -= b->size;
+		g_free(b->data);
+		b->data = NULL;
+		b->size = 0;
+	}
+
+	arena->spare[arena->n_spare++] = id;
+}
+
+/*
+ * arena_take_block:
+ *
+ * Returns the ID of an empty block with room for @need bytes,
+ * preferring pooled memory, then a freed slot, then a new slot.
+ */
+static guint
+arena_take_block(
+	GstBlockArena   *arena,
+	gsize           need
+){
+	ArenaBlock *b;
+	guint id;
+	guint i;
+
+	/* A pooled block, if the record fits a regular one */
+	if (need <= arena->block_size) {
+		for (i = arena->n_spare; i > 0; i--) {
+			id = arena->spare[i - 1];
+			if (arena->blocks[id].data != NULL) {
+				arena->spare[i - 1] = arena->spare[--arena->n_spare];
+				arena->n_pooled--;
+				return id;
+			}
+		}
+	}
+
+	/* Any other empty slot, or a new one */
+	id = G_MAXUINT;
+	for (i = arena->n_spare; i > 0; i--) {
+		if (arena->blocks[arena->spare[i - 1]].data == NULL) {
+			id = arena->spare[i - 1];
+			arena->spare[i - 1] = arena->spare[--arena->n_spare];
+			break;
+		}
+	}
+	if (id == G_MAXUINT) {
+		if (arena->n_blocks == arena->cap) {
+			arena->cap = (arena->cap == 0) ? 16 : arena->cap * 2;
+			arena->blocks = g_renew(ArenaBlock, arena->blocks, arena->cap);
+			arena->spare = g_renew(guint, arena->spare, arena->cap);
+		}
+		id = arena->n_blocks++;
+	}
+
+	b = &arena->blocks[id];
+	b->size = MAX(arena->block_size, need);
+	b->data = g_malloc(b->size);
+	b->used = 0;
+	b->live = 0;
+	arena->bytes += b->size;
+
+	return id;
+}
+
+GstBlockArena *
+gst_block_arena_new(gsize block_size)
+{
+	GstBlockArena *arena;
+
+	arena = g_new0(GstBlockArena, 1);
+	arena->block_size = ARENA_ALIGN(MAX(block_size, (gsize)64));
+	arena->cur = G_MAXUINT;
+
+	return arena;
+}
+
+void
+gst_block_arena_free(GstBlockArena *arena)
+{
+	guint i;
+
+	if (arena == NULL) {
+		return;
+	}
+
+	for (i = 0; i < arena->n_blocks; i++) {
+		g_free(arena->blocks[i].data);
+	}
+	g_free(arena->blocks);
+	g_free(arena->spare);
+	g_free(arena);
+}
+
+gpointer
+gst_block_arena_alloc(
+	GstBlockArena   *arena,
+	gsize           size,
+	guint           *block_out
+){
+	ArenaBlock *b;
+	gpointer p;
+
+	g_return_val_if_fail(arena != NULL, NULL);
+	g_return_val_if_fail(block_out != NULL, NULL);
+
+	size = ARENA_ALIGN(MAX(size, (gsize)1));
+
+	if (arena->cur == G_MAXUINT
+	    || arena->blocks[arena->cur].used + size
+	       > arena->blocks[arena->cur].size)
+	{
+		guint old;
+
+		old = arena->cur;
+		arena->cur = arena_take_block(arena, size);
+
+		/* Everything in the old block was already released */
+		if (old != G_MAXUINT && arena->blocks[old].live == 0) {
+			arena_retire(arena, old);
+		}
+	}
+
+	b = &arena->blocks[arena->cur];
+	p = b->data + b->used;
+	b->used += size;
+	b->live++;
+
+	*block_out = arena->cur;
+	return p;
+}
+
+void
+gst_block_arena_release(
+	GstBlockArena   *arena,
+	guint           block
+){
+	ArenaBlock *b;
+
+	g_return_if_fail(arena != NULL);
+	g_return_if_fail(block < arena->n_blocks);
+
+	b = &arena->blocks[block];
+	g_return_if_fail(b->live > 0);
+
+	b->live--;
+	if (b->live > 0) {
+		return;
+	}
+
+	/* The current block is simply refilled from the start */
+	if (block == arena->cur) {
+		b->used = 0;
+		return;
+	}
+
+	arena_retire(arena, block);
+}
+
+void
+gst_block_arena_clear(GstBlockArena *arena)
+{
+	guint i;
+
+	g_return_if_fail(arena != NULL);
+
+	arena->n_spare = 0;
+	arena->n_pooled = 0;
+	arena->cur = G_MAXUINT;
+
+	for (i = 0; i < arena->n_blocks; i++) {
+		if (arena->blocks[i].data == NULL) {
+			arena->spare[arena->n_spare++] = i;
+			continue;
+		}
+		arena_retire(arena, i);
+	}
+}
+
+gsize
+gst_block_arena_get_bytes(GstBlockArena *arena)
+{
+	g_return_val_if_fail(arena != NULL, 0);
+
+	return arena->bytes;
+}
+
+guint
+gst_block_arena_get_n_blocks(GstBlockArena *arena)
+{
+	guint n;
+	guint i;
+
+	g_return_val_if_fail(arena != NULL, 0);
+
+	n = 0;
+	for (i = 0; i < arena->n_blocks; i++) {
+		if (arena->blocks[i].live > 0) {
+			n++;
+		}
+	}
+	return n;
+}
@@ -0,0 +1,112 @@
+/*
+ * gst-block-arena.h - FIFO arena of fixed-size memory blocks
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Carves variable-sized records out of large blocks, for data that
+ * is released in roughly the order it was allocated (scrollback
+ * lines). Allocation is a pointer bump; each block counts its live
+ * records and goes back to a small pool once the last one is
+ * released, so a full ring recycles whole blocks instead of
+ * hitting malloc for every record.
+ */
+
+#ifndef GST_BLOCK_ARENA_H
+#define GST_BLOCK_ARENA_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Default block size (256 KiB) */
+#define GST_BLOCK_ARENA_DEFAULT_BLOCK_SIZE ((gsize)256 * 1024)
+
+typedef struct _GstBlockArena GstBlockArena;
+
+/**
+ * gst_block_arena_new:
+ * @block_size: bytes per block
+ *
+ * Creates an empty arena. Blocks are allocated on first use.
+ *
+ * Returns: (transfer full): a new #GstBlockArena
+ */
+GstBlockArena *
+gst_block_arena_new(gsize block_size);
+
+/**
+ * gst_block_arena_free:
+ * @arena: (nullable): a #GstBlockArena
+ *
+ * Frees the arena and every block it holds.
+ */
+void
+gst_block_arena_free(GstBlockArena *arena);
+
+/**
+ * gst_block_arena_alloc:
+ * @arena: a #GstBlockArena
+ * @size: bytes to allocate
+ * @block_out: (out): block the record lives in, for
+ *   gst_block_arena_release()
+ *
+ * Allocates @size bytes, 8-byte aligned, from the current block,
+ * moving on to a pooled or new block when it is full. A record
+ * larger than a block gets a block of its own. The memory is not
+ * cleared and stays put until released.
+ *
+ * Returns: (transfer none): the record
+ */
+gpointer
+gst_block_arena_alloc(
+	GstBlockArena   *arena,
+	gsize           size,
+	guint           *block_out
+);
+
+/**
+ * gst_block_arena_release:
+ * @arena: a #GstBlockArena
+ * @block: block returned by gst_block_arena_alloc()
+ *
+ * Releases one record in @block. Once a block other than the
+ * current one has no records left, it is reset and pooled.
+ */
+void
+gst_block_arena_release(
+	GstBlockArena   *arena,
+	guint           block
+);
+
+/**
+ * gst_block_arena_clear:
+ * @arena: a #GstBlockArena
+ *
+ * Releases every record at once, keeping a few blocks pooled.
+ */
+void
+gst_block_arena_clear(GstBlockArena *arena);
+
+/**
+ * gst_block_arena_get_bytes:
+ * @arena: a #GstBlockArena
+ *
+ * Returns: bytes of block memory currently allocated, pooled
+ *   blocks included
+ */
+gsize
+gst_block_arena_get_bytes(GstBlockArena *arena);
+
+/**
+ * gst_block_arena_get_n_blocks:
+ * @arena: a #GstBlockArena
+ *
+ * Returns: number of blocks holding at least one record
+ */
+guint
+gst_block_arena_get_n_blocks(GstBlockArena *arena);
+
+G_END_DECLS
+
+#endif /* GST_BLOCK_ARENA_H */
@@ -0,0 +1,31 @@
+/*
+ * gst-escape-parser-private.h - Unchecked GstEscapeParser entry points
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * For GstTerminal, which steps its parser once per codepoint of
+ * output. The state machine is fetched from the parser once and
+ * then driven without the GObject type check and private lookup
+ * that gst_escape_parser_put() pays on every call. This header is
+ * not installed; everything else uses gst-escape-parser.h.
+ */
+
+#ifndef GST_ESCAPE_PARSER_PRIVATE_H
+#define GST_ESCAPE_PARSER_PRIVATE_H
+
+#include "gst-escape-parser.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GstEscapeMachine GstEscapeMachine;
+
+GstEscapeMachine *gst_escape_parser_get_machine(GstEscapeParser *parser);
+
+void gst_escape_machine_put(GstEscapeMachine *machine, GstRune rune);
+
+gboolean gst_escape_machine_is_ground(const GstEscapeMachine *machine);
+
+G_END_DECLS
+
+#endif /* GST_ESCAPE_PARSER_PRIVATE_H */
@@ -4,23 +4,296 @@
  * Copyright (C) 2026 Zach Podbielniak
  * SPDX-License-Identifier: AGPL-3.0-or-later
  *
- * Thin wrapper class. The actual escape parsing logic is integrated
- * directly into GstTerminal (gst-terminal.c) for performance and
- * tight coupling with terminal state, matching st's architecture.
+ * Table-driven DEC/ANSI state machine modelled on Paul Williams'
+ * VT500 parser. Each codepoint is folded to a byte class and looked
+ * up in a [state][byte] table that yields the next state and the
+ * action to run, so the per-byte cost is one load and one switch.
+ * CSI parameters are accumulated in place as digits arrive.
  *
- * This class exists for API compatibility and can be used as a
- * standalone facade for feeding data to a terminal.
+ * GstTerminal owns one parser created with gst_escape_parser_new_full()
+ * and implements the actions. gst_escape_parser_new() keeps the older
+ * facade behaviour of feeding data straight into a terminal.
  */
 
 #include "gst-escape-parser.h"
+#include "gst-escape-parser-private.h"
 #include "gst-terminal.h"
+#include <string.h>
 
-typedef struct {
+/* Parser states; must fit in the low 4 bits of a table entry */
+typedef enum {
+	STATE_GROUND = 0,
+	STATE_ESCAPE,
+	STATE_ESCAPE_INTERMEDIATE,
+	STATE_CSI_ENTRY,
+	STATE_CSI_PARAM,
+	STATE_CSI_INTERMEDIATE,
+	STATE_CSI_IGNORE,
+	STATE_STRING,
+	N_STATES
+} ParserState;
+
+/* Transition actions; stored in the high 4 bits of a table entry */
+typedef enum {
+	ACTION_NONE = 0,
+	ACTION_PRINT,
+	ACTION_EXECUTE,
+	ACTION_CLEAR,
+	ACTION_COLLECT,
+	ACTION_PARAM,
+	ACTION_ESC_DISPATCH,
+	ACTION_CSI_DISPATCH,
+	ACTION_STR_START,
+	ACTION_STR_PUT,
+	ACTION_STR_END,
+	ACTION_STR_END_ESC
+} ParserAction;
+
+#define ENTRY(action, state) ((guint8)(((action) << 4) | (state)))
+#define ENTRY_STATE(e)       ((ParserState)((e) & 0x0f))
+#define ENTRY_ACTION(e)      ((ParserAction)((e) >> 4))
+
+/* CSI private marker bytes ('<', '=', '>', '?') */
+#define IS_PREFIX(c)         ((c) >= 0x3c && (c) <= 0x3f)
+
+/* Largest value a single numeric parameter may accumulate to */
+#define PARAM_MAX (65535)
+
+struct _GstEscapeMachine {
+	/* Facade mode: feed() forwards to this terminal */
 	GstTerminal *term;
-} GstEscapeParserPrivate;
+
+	/* Action callbacks (table-driven mode) */
+	GstEscapeParserActions actions;
+	gpointer user_data;
+
+	/* Machine state */
+	ParserState state;
+	GstEscapeParams params;
+	gboolean params_overflow;
+};
+
+typedef GstEscapeMachine GstEscapeParserPrivate;
 
 G_DEFINE_TYPE_WITH_PRIVATE(GstEscapeParser, gst_escape_parser, G_TYPE_OBJECT)
 
+/*
+ * The transition table. Codepoints above 0xff are folded onto 0xff,
+ * which behaves like any other GR byte (0xa0-0xff): printable in
+ * ground, payload in strings and ignored inside sequences.
+ */
+static guint8 parser_table[N_STATES][256];
+
+/* ===== Table construction ===== */
+
+/*
+ * table_set_range:
+ * @state: source state
+ * @lo: first byte (inclusive)
+ * @hi: last byte (inclusive)
+ * @action: action to perform
+ * @next: state to transition to
+ *
+ * Fills a byte range of one row of the transition table.
+ */
+static void
+table_set_range(
+	ParserState     state,
+	guint           lo,
+	guint           hi,
+	ParserAction    action,
+	ParserState     next
+){
+	guint b;
+
+	for (b = lo; b <= hi; b++) {
+		parser_table[state][b] = ENTRY(action, next);
+	}
+}
+
+/*
+ * table_set_anywhere:
+ * @state: source state
+ *
+ * Installs the controls shared by every non-string state:
+ * C0 controls execute in place, CAN/SUB abort to ground,
+ * ESC restarts an escape sequence, DEL is ignored, and the
+ * C1 CSI/DCS/OSC/PM/APC introducers start their sequences.
+ */
+static void
+table_set_anywhere(ParserState state)
+{
+	table_set_range(state, 0x00, 0x1f, ACTION_EXECUTE, state);
+	table_set_range(state, 0x18, 0x18, ACTION_NONE, STATE_GROUND);
+	table_set_range(state, 0x1a, 0x1a, ACTION_NONE, STATE_GROUND);
+	table_set_range(state, 0x1b, 0x1b, ACTION_CLEAR, STATE_ESCAPE);
+	table_set_range(state, 0x7f, 0x7f, ACTION_NONE, state);
+
+	table_set_range(state, 0x80, 0x9f, ACTION_EXECUTE, state);
+	table_set_range(state, 0x90, 0x90, ACTION_STR_START, STATE_STRING);
+	table_set_range(state, 0x9b, 0x9b, ACTION_CLEAR, STATE_CSI_ENTRY);
+	table_set_range(state, 0x9d, 0x9f, ACTION_STR_START, STATE_STRING);
+}
+
+/*
+ * parser_table_init:
+ *
+ * Builds the [state][byte] transition table. Called once from
+ * class_init.
+ */
+static void
+parser_table_init(void)
+{
+	/* Ground: print everything that is not a control */
+	table_set_range(STATE_GROUND, 0x20, 0x7e, ACTION_PRINT, STATE_GROUND);
+	table_set_range(STATE_GROUND, 0xa0, 0xff, ACTION_PRINT, STATE_GROUND);
+	table_set_anywhere(STATE_GROUND);
+
+	/* Escape: ESC seen */
+	table_set_range(STATE_ESCAPE, 0x20, 0x2f,
+		ACTION_COLLECT, STATE_ESCAPE_INTERMEDIATE);
+	table_set_range(STATE_ESCAPE, 0x30, 0x7e,
+		ACTION_ESC_DISPATCH, STATE_GROUND);
+	table_set_range(STATE_ESCAPE, '[', '[', ACTION_CLEAR, STATE_CSI_ENTRY);
+	table_set_range(STATE_ESCAPE, ']', ']', ACTION_STR_START, STATE_STRING);
+	table_set_range(STATE_ESCAPE, 'P', 'P', ACTION_STR_START, STATE_STRING);
+	table_set_range(STATE_ESCAPE, '_', '_', ACTION_STR_START, STATE_STRING);
+	table_set_range(STATE_ESCAPE, '^', '^', ACTION_STR_START, STATE_STRING);
+	table_set_range(STATE_ESCAPE, 'k', 'k', ACTION_STR_START, STATE_STRING);
+	table_set_range(STATE_ESCAPE, 0xa0, 0xff, ACTION_NONE, STATE_GROUND);
+	table_set_anywhere(STATE_ESCAPE);
+
+	/* Escape intermediate: ESC ( / ESC # / ESC % ... */
+	table_set_range(STATE_ESCAPE_INTERMEDIATE, 0x20, 0x2f,
+		ACTION_COLLECT, STATE_ESCAPE_INTERMEDIATE);
+	table_set_range(STATE_ESCAPE_INTERMEDIATE, 0x30, 0x7e,
+		ACTION_ESC_DISPATCH, STATE_GROUND);
+	table_set_range(STATE_ESCAPE_INTERMEDIATE, 0xa0, 0xff,
+		ACTION_NONE, STATE_GROUND);
+	table_set_anywhere(STATE_ESCAPE_INTERMEDIATE);
+
+	/* CSI entry: right after ESC [ */
+	table_set_range(STATE_CSI_ENTRY, 0x20, 0x2f,
+		ACTION_COLLECT, STATE_CSI_INTERMEDIATE);
+	table_set_range(STATE_CSI_ENTRY, 0x30, 0x39,
+		ACTION_PARAM, STATE_CSI_PARAM);
+	table_set_range(STATE_CSI_ENTRY, ':', ':', ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_range(STATE_CSI_ENTRY, ';', ';', ACTION_PARAM, STATE_CSI_PARAM);
+	table_set_range(STATE_CSI_ENTRY, 0x3c, 0x3f,
+		ACTION_COLLECT, STATE_CSI_PARAM);
+	table_set_range(STATE_CSI_ENTRY, 0x40, 0x7e,
+		ACTION_CSI_DISPATCH, STATE_GROUND);
+	table_set_range(STATE_CSI_ENTRY, 0xa0, 0xff,
+		ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_anywhere(STATE_CSI_ENTRY);
+
+	/* CSI param: digits and separators */
+	table_set_range(STATE_CSI_PARAM, 0x20, 0x2f,
+		ACTION_COLLECT, STATE_CSI_INTERMEDIATE);
+	table_set_range(STATE_CSI_PARAM, 0x30, 0x39,
+		ACTION_PARAM, STATE_CSI_PARAM);
+	table_set_range(STATE_CSI_PARAM, ':', ':', ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_range(STATE_CSI_PARAM, ';', ';', ACTION_PARAM, STATE_CSI_PARAM);
+	table_set_range(STATE_CSI_PARAM, 0x3c, 0x3f,
+		ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_range(STATE_CSI_PARAM, 0x40, 0x7e,
+		ACTION_CSI_DISPATCH, STATE_GROUND);
+	table_set_range(STATE_CSI_PARAM, 0xa0, 0xff,
+		ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_anywhere(STATE_CSI_PARAM);
+
+	/* CSI intermediate: e.g. the space in CSI 2 SP q */
+	table_set_range(STATE_CSI_INTERMEDIATE, 0x20, 0x2f,
+		ACTION_COLLECT, STATE_CSI_INTERMEDIATE);
+	table_set_range(STATE_CSI_INTERMEDIATE, 0x30, 0x3f,
+		ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_range(STATE_CSI_INTERMEDIATE, 0x40, 0x7e,
+		ACTION_CSI_DISPATCH, STATE_GROUND);
+	table_set_range(STATE_CSI_INTERMEDIATE, 0xa0, 0xff,
+		ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_anywhere(STATE_CSI_INTERMEDIATE);
+
+	/* CSI ignore: malformed sequence, swallow until the final byte */
+	table_set_range(STATE_CSI_IGNORE, 0x20, 0x3f,
+		ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_range(STATE_CSI_IGNORE, 0x40, 0x7e,
+		ACTION_NONE, STATE_GROUND);
+	table_set_range(STATE_CSI_IGNORE, 0xa0, 0xff,
+		ACTION_NONE, STATE_CSI_IGNORE);
+	table_set_anywhere(STATE_CSI_IGNORE);
+
+	/*
+	 * String (OSC/DCS/APC/PM/title): everything is payload except
+	 * the terminators. ESC ends the string and starts a new escape
+	 * sequence, so ESC \ (ST) falls out naturally.
+	 */
+	table_set_range(STATE_STRING, 0x00, 0xff, ACTION_STR_PUT, STATE_STRING);
+	table_set_range(STATE_STRING, 0x07, 0x07, ACTION_STR_END, STATE_GROUND);
+	table_set_range(STATE_STRING, 0x18, 0x18, ACTION_STR_END, STATE_GROUND);
+	table_set_range(STATE_STRING, 0x1a, 0x1a, ACTION_STR_END, STATE_GROUND);
+	table_set_range(STATE_STRING, 0x1b, 0x1b,
+		ACTION_STR_END_ESC, STATE_ESCAPE);
+	table_set_range(STATE_STRING, 0x9c, 0x9c, ACTION_STR_END, STATE_GROUND);
+}
+
+/* ===== Parameter helpers ===== */
+
+/*
+ * params_clear:
+ * @priv: parser private data
+ *
+ * Resets collected parameters and intermediates at the start
+ * of a new escape or CSI sequence.
+ */
+static void
+params_clear(GstEscapeParserPrivate *priv)
+{
+	memset(&priv->params, 0, sizeof(priv->params));
+	priv->params_overflow = FALSE;
+}
+
+/*
+ * params_put:
+ * @priv: parser private data
+ * @c: a digit or ';'
+ *
+ * Accumulates a parameter byte in place. Parameters beyond
+ * GST_MAX_ARGS are dropped; values saturate at PARAM_MAX.
+ */
+static void
+params_put(
+	GstEscapeParserPrivate  *priv,
+	guint                   c
+){
+	GstEscapeParams *p = &priv->params;
+	gint *arg;
+
+	if (p->nargs == 0) {
+		p->nargs = 1;
+	}
+
+	if (c == ';') {
+		if (p->nargs < GST_MAX_ARGS) {
+			p->nargs++;
+		} else {
+			priv->params_overflow = TRUE;
+		}
+		return;
+	}
+
+	if (priv->params_overflow) {
+		return;
+	}
+
+	arg = &p->args[p->nargs - 1];
+	*arg = *arg * 10 + (gint)(c - '0');
+	if (*arg > PARAM_MAX) {
+		*arg = PARAM_MAX;
+	}
+}
+
+/* ===== GObject lifecycle ===== */
+
 static void
 gst_escape_parser_finalize(GObject *object)
 {
@@ -39,20 +312,31 @@ gst_escape_parser_class_init(GstEscapeParserClass *klass)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS(klass);
 	object_class->finalize = gst_escape_parser_finalize;
+
+	parser_table_init();
 }
 
 static void
 gst_escape_parser_init(GstEscapeParser *parser)
 {
 	GstEscapeParserPrivate *priv = gst_escape_parser_get_instance_private(parser);
+
 	priv->term = NULL;
+	memset(&priv->actions, 0, sizeof(priv->actions));
+	priv->user_data = NULL;
+	priv->state = STATE_GROUND;
+	params_clear(priv);
 }
 
+/* ===== Public API ===== */
+
 /**
  * gst_escape_parser_new:
  * @term: a #GstTerminal to parse into
  *
- * Creates a new escape parser bound to the given terminal.
+ * Creates a facade parser bound to the given terminal.
+ * gst_escape_parser_feed() forwards data to gst_terminal_write(),
+ * which runs the terminal's own table-driven parser.
  *
  * Returns: (transfer full): a new GstEscapeParser
  */
@@ -71,14 +355,184 @@ gst_escape_parser_new(GstTerminal *term)
 	return parser;
 }
 
+/**
+ * gst_escape_parser_new_full:
+ * @actions: callbacks to invoke for recognized input (copied)
+ * @user_data: data passed to every callback
+ *
+ * Creates a standalone table-driven parser. Input is pushed with
+ * gst_escape_parser_put() and reported through @actions.
+ *
+ * Returns: (transfer full): a new GstEscapeParser
+ */
+GstEscapeParser *
+gst_escape_parser_new_full(
+    const GstEscapeParserActions    *actions,
+    gpointer                        user_data
+){
+	GstEscapeParser *parser;
+	GstEscapeParserPrivate *priv;
+
+	g_return_val_if_fail(actions != NULL, NULL);
+
+	parser = g_object_new(GST_TYPE_ESCAPE_PARSER, NULL);
+	priv = gst_escape_parser_get_instance_private(parser);
+	priv->actions = *actions;
+	priv->user_data = user_data;
+
+	return parser;
+}
+
+/*
+ * gst_escape_parser_get_machine:
+ * @parser: a #GstEscapeParser
+ *
+ * Gets the state machine behind @parser for the unchecked entry
+ * points in gst-escape-parser-private.h. It lives as long as
+ * @parser.
+ *
+ * Returns: (transfer none): the parser's state machine
+ */
+GstEscapeMachine *
+gst_escape_parser_get_machine(GstEscapeParser *parser)
+{
+	g_return_val_if_fail(GST_IS_ESCAPE_PARSER(parser), NULL);
+
+	return gst_escape_parser_get_instance_private(parser);
+}
+
+/*
+ * gst_escape_machine_put:
+ * @machine: a parser's state machine
+ * @rune: the next decoded codepoint
+ *
+ * gst_escape_parser_put() without the argument check.
+ */
+void
+gst_escape_machine_put(
+    GstEscapeMachine    *machine,
+    GstRune             rune
+){
+	GstEscapeParserPrivate *priv = machine;
+	const GstEscapeParserActions *act;
+	guint8 entry;
+	guint c;
+
+	act = &priv->actions;
+	c = (rune < 0x100) ? (guint)rune : 0xff;
+
+	entry = parser_table[priv->state][c];
+	priv->state = ENTRY_STATE(entry);
+
+	switch (ENTRY_ACTION(entry)) {
+	case ACTION_NONE:
+		break;
+
+	case ACTION_PRINT:
+		if (act->print != NULL) {
+			act->print(priv->user_data, rune);
+		}
+		break;
+
+	case ACTION_EXECUTE:
+		if (act->execute != NULL) {
+			act->execute(priv->user_data, rune);
+		}
+		break;
+
+	case ACTION_CLEAR:
+		params_clear(priv);
+		break;
+
+	case ACTION_COLLECT:
+		if (IS_PREFIX(c)) {
+			priv->params.prefix = (gchar)c;
+		} else if (priv->params.intermediate == 0) {
+			priv->params.intermediate = (gchar)c;
+		}
+		break;
+
+	case ACTION_PARAM:
+		params_put(priv, c);
+		break;
+
+	case ACTION_ESC_DISPATCH:
+		if (act->esc_dispatch != NULL) {
+			act->esc_dispatch(priv->user_data,
+				priv->params.intermediate, (gchar)c);
+		}
+		break;
+
+	case ACTION_CSI_DISPATCH:
+		if (priv->params.nargs == 0) {
+			priv->params.nargs = 1;
+		}
+		if (act->csi_dispatch != NULL) {
+			act->csi_dispatch(priv->user_data, &priv->params, (gchar)c);
+		}
+		break;
+
+	case ACTION_STR_START:
+		/* C1 introducers map onto their 7-bit ESC equivalents */
+		if (act->str_start != NULL) {
+			act->str_start(priv->user_data,
+				(gchar)((c >= 0x80) ? c - 0x40 : c));
+		}
+		break;
+
+	case ACTION_STR_PUT:
+		if (act->str_put != NULL) {
+			act->str_put(priv->user_data, rune);
+		}
+		break;
+
+	case ACTION_STR_END:
+		if (act->str_end != NULL) {
+			act->str_end(priv->user_data);
+		}
+		break;
+
+	case ACTION_STR_END_ESC:
+		params_clear(priv);
+		if (act->str_end != NULL) {
+			act->str_end(priv->user_data);
+		}
+		break;
+	}
+}
+
+/**
+ * gst_escape_parser_put:
+ * @parser: a #GstEscapeParser
+ * @rune: the next decoded codepoint
+ *
+ * Advances the state machine by one codepoint and runs the
+ * action selected by the transition table. The state is updated
+ * before the action runs, so callbacks may feed the parser again
+ * (e.g. REP printing the previous character).
+ */
+void
+gst_escape_parser_put(
+    GstEscapeParser *parser,
+    GstRune         rune
+){
+	g_return_if_fail(GST_IS_ESCAPE_PARSER(parser));
+
+	gst_escape_machine_put(gst_escape_parser_get_instance_private(parser),
+		rune);
+}
+
 /**
  * gst_escape_parser_feed:
  * @parser: a #GstEscapeParser
  * @data: data to parse
  * @len: length of data, or -1 if NUL-terminated
  *
- * Feeds data through the escape parser into the terminal.
- * Delegates to gst_terminal_write().
+ * Feeds data through the parser. A parser created with
+ * gst_escape_parser_new() forwards to gst_terminal_write(), which
+ * also handles UTF-8 decoding. A standalone parser treats each
+ * byte as one codepoint; use gst_escape_parser_put() for decoded
+ * input.
  */
 void
 gst_escape_parser_feed(
@@ -87,6 +541,7 @@ gst_escape_parser_feed(
     gssize          len
 ){
 	GstEscapeParserPrivate *priv;
+	gssize i;
 
 	g_return_if_fail(GST_IS_ESCAPE_PARSER(parser));
 	g_return_if_fail(data != NULL);
@@ -95,14 +550,55 @@ gst_escape_parser_feed(
 
 	if (priv->term != NULL) {
 		gst_terminal_write(priv->term, data, len);
+		return;
 	}
+
+	if (len < 0) {
+		len = (gssize)strlen(data);
+	}
+
+	for (i = 0; i < len; i++) {
+		gst_escape_machine_put(priv, (GstRune)(guchar)data[i]);
+	}
+}
+
+/**
+ * gst_escape_parser_is_ground:
+ * @parser: a #GstEscapeParser
+ *
+ * Checks whether the parser is in ground state, i.e. no escape
+ * sequence or control string is in progress.
+ *
+ * Returns: %TRUE if the next printable codepoint would be printed
+ */
+gboolean
+gst_escape_parser_is_ground(GstEscapeParser *parser)
+{
+	g_return_val_if_fail(GST_IS_ESCAPE_PARSER(parser), FALSE);
+
+	return gst_escape_machine_is_ground(
+		gst_escape_parser_get_instance_private(parser));
+}
+
+/*
+ * gst_escape_machine_is_ground:
+ * @machine: a parser's state machine
+ *
+ * gst_escape_parser_is_ground() without the argument check.
+ */
+gboolean
+gst_escape_machine_is_ground(const GstEscapeMachine *machine)
+{
+	return machine->state == STATE_GROUND;
 }
 
 /**
  * gst_escape_parser_reset:
  * @parser: a #GstEscapeParser
  *
- * Resets the parser state. Delegates to gst_terminal_reset().
+ * Returns the parser to ground state and discards any partial
+ * sequence. A parser bound to a terminal with gst_escape_parser_new()
+ * also resets that terminal via gst_terminal_reset().
  */
 void
 gst_escape_parser_reset(GstEscapeParser *parser)
@@ -112,6 +608,8 @@ gst_escape_parser_reset(GstEscapeParser *parser)
 	g_return_if_fail(GST_IS_ESCAPE_PARSER(parser));
 
 	priv = gst_escape_parser_get_instance_private(parser);
+	priv->state = STATE_GROUND;
+	params_clear(priv);
 
 	if (priv->term != NULL) {
 		gst_terminal_reset(priv->term, FALSE);
@@ -4,8 +4,10 @@
  * Copyright (C) 2026 Zach Podbielniak
  * SPDX-License-Identifier: AGPL-3.0-or-later
  *
- * Parses VT100/ANSI escape sequences from terminal output.
- * Handles CSI, OSC, DCS, and other control sequences.
+ * Table-driven DEC/ANSI (VT500-style) escape sequence parser.
+ * Classifies each incoming codepoint with a precomputed
+ * [state][byte] transition table and reports complete sequences
+ * through a set of action callbacks.
  */
 
 #ifndef GST_ESCAPE_PARSER_H
@@ -32,12 +34,61 @@ struct _GstEscapeParserClass {
     GObjectClass parent_class;
 };
 
+/**
+ * GstEscapeParams:
+ * @args: numeric parameters, accumulated in place as digits arrive
+ * @nargs: number of parameters (at least 1; omitted ones are 0)
+ * @prefix: private marker byte ('?', '>', '=', '<'), or 0
+ * @intermediate: first intermediate byte (0x20-0x2f), or 0
+ *
+ * Parameters of a CSI sequence, handed to the csi_dispatch action.
+ */
+typedef struct {
+    gint    args[GST_MAX_ARGS];
+    gint    nargs;
+    gchar   prefix;
+    gchar   intermediate;
+} GstEscapeParams;
+
+/**
+ * GstEscapeParserActions:
+ * @print: a printable codepoint in ground state
+ * @execute: a C0 or C1 control code to execute immediately
+ * @esc_dispatch: a complete ESC sequence; @intermediate is 0 if none
+ * @csi_dispatch: a complete CSI sequence with its @final byte
+ * @str_start: start of a control string; @type is the 7-bit
+ *   introducer (']' OSC, 'P' DCS, '_' APC, '^' PM, 'k' title)
+ * @str_put: one codepoint of control string payload
+ * @str_end: control string terminated (BEL, ST, ESC, CAN or SUB)
+ *
+ * Callbacks the parser invokes as it recognizes input. Any member
+ * may be %NULL to ignore that action. All callbacks receive the
+ * user_data passed to gst_escape_parser_new_full().
+ */
+typedef struct {
+    void (*print)        (gpointer user_data, GstRune rune);
+    void (*execute)      (gpointer user_data, GstRune code);
+    void (*esc_dispatch) (gpointer user_data, gchar intermediate, gchar final);
+    void (*csi_dispatch) (gpointer user_data, const GstEscapeParams *params,
+                          gchar final);
+    void (*str_start)    (gpointer user_data, gchar type);
+    void (*str_put)      (gpointer user_data, GstRune rune);
+    void (*str_end)      (gpointer user_data);
+} GstEscapeParserActions;
+
 GType gst_escape_parser_get_type(void) G_GNUC_CONST;
 
 GstEscapeParser *gst_escape_parser_new(GstTerminal *term);
 
+GstEscapeParser *gst_escape_parser_new_full(const GstEscapeParserActions *actions,
+                                            gpointer                      user_data);
+
+void gst_escape_parser_put(GstEscapeParser *parser, GstRune rune);
+
 void gst_escape_parser_feed(GstEscapeParser *parser, const gchar *data, gssize len);
 
+gboolean gst_escape_parser_is_ground(GstEscapeParser *parser);
+
 void gst_escape_parser_reset(GstEscapeParser *parser);
 
 G_END_DECLS
@@ -47,19 +47,29 @@ gst_line_flags_get_type(void)
  * @n: number of glyphs
  *
  * Initializes an array of glyphs to empty spaces with default attributes.
+ * The first cell is written once and then copied over the rest with
+ * doubling memcpy()s, so clearing a full row is a handful of block
+ * copies rather than a per-field loop.
  */
 static void
 init_glyphs(
     GstGlyph    *glyphs,
     gint        n
 ){
-    gint i;
+    gint done;
+
+    if (n <= 0) {
+        return;
+    }
 
-    for (i = 0; i < n; i++) {
-        glyphs[i].rune = ' ';
-        glyphs[i].attr = GST_GLYPH_ATTR_NONE;
-        glyphs[i].fg = GST_COLOR_DEFAULT_FG;
-        glyphs[i].bg = GST_COLOR_DEFAULT_BG;
+    glyphs[0].rune = ' ';
+    glyphs[0].attr = GST_GLYPH_ATTR_NONE;
+    glyphs[0].fg = GST_COLOR_DEFAULT_FG;
+    glyphs[0].bg = GST_COLOR_DEFAULT_BG;
+
+    for (done = 1; done < n; done *= 2) {
+        memcpy(&glyphs[done], glyphs,
+               sizeof(GstGlyph) * (gsize)MIN(done, n - done));
     }
 }
 
@@ -83,6 +93,8 @@ gst_line_new(gint cols)
     line = g_slice_new(GstLine);
     line->len = cols;
     line->flags = GST_LINE_FLAG_DIRTY;
+    line->dirty_start = 0;
+    line->dirty_end = cols;
     line->glyphs = g_new(GstGlyph, cols);
 
     init_glyphs(line->glyphs, cols);
@@ -108,6 +120,8 @@ gst_line_copy(const GstLine *line)
     copy = g_slice_new(GstLine);
     copy->len = line->len;
     copy->flags = line->flags;
+    copy->dirty_start = line->dirty_start;
+    copy->dirty_end = line->dirty_end;
     copy->glyphs = g_new(GstGlyph, line->len);
 
     memcpy(copy->glyphs, line->glyphs, sizeof(GstGlyph) * line->len);
@@ -169,7 +183,7 @@ gst_line_resize(
     g_free(line->glyphs);
     line->glyphs = new_glyphs;
     line->len = new_cols;
-    line->flags |= GST_LINE_FLAG_DIRTY;
+    gst_line_set_dirty(line, TRUE);
 }
 
 /**
@@ -239,7 +253,7 @@ gst_line_set_glyph(
     g_return_if_fail(col >= 0 && col < line->len);
 
     line->glyphs[col] = *glyph;
-    line->flags |= GST_LINE_FLAG_DIRTY;
+    gst_line_mark_dirty_range(line, col, col + 1);
 }
 
 /**
@@ -255,7 +269,7 @@ gst_line_clear(GstLine *line)
     g_return_if_fail(line != NULL);
 
     init_glyphs(line->glyphs, line->len);
-    line->flags |= GST_LINE_FLAG_DIRTY;
+    gst_line_mark_dirty_range(line, 0, line->len);
 }
 
 /**
@@ -282,7 +296,7 @@ gst_line_clear_range(
     }
 
     init_glyphs(&line->glyphs[start], end - start);
-    line->flags |= GST_LINE_FLAG_DIRTY;
+    gst_line_mark_dirty_range(line, start, end);
 }
 
 /**
@@ -356,7 +370,7 @@ gst_line_delete_chars(
 
     /* Initialize empty space at end */
     init_glyphs(&line->glyphs[line->len - n], n);
-    line->flags |= GST_LINE_FLAG_DIRTY;
+    gst_line_mark_dirty_range(line, col, line->len);
 }
 
 /**
@@ -395,7 +409,7 @@ gst_line_insert_blanks(
 
     /* Initialize blank space */
     init_glyphs(&line->glyphs[col], insert_count);
-    line->flags |= GST_LINE_FLAG_DIRTY;
+    gst_line_mark_dirty_range(line, col, line->len);
 }
 
 /**
@@ -430,9 +444,132 @@ gst_line_set_dirty(
 
     if (dirty) {
         line->flags |= GST_LINE_FLAG_DIRTY;
+        line->dirty_start = 0;
+        line->dirty_end = line->len;
     } else {
         line->flags &= ~GST_LINE_FLAG_DIRTY;
+        line->dirty_start = 0;
+        line->dirty_end = 0;
+    }
+}
+
+/**
+ * gst_line_mark_dirty_range:
+ * @line: a GstLine
+ * @start: first damaged column (inclusive)
+ * @end: last damaged column (exclusive)
+ *
+ * Marks the line dirty and widens its dirty span to cover
+ * [@start, @end). Out-of-range columns are clamped.
+ */
+void
+gst_line_mark_dirty_range(
+    GstLine *line,
+    gint    start,
+    gint    end
+){
+    g_return_if_fail(line != NULL);
+
+    start = CLAMP(start, 0, line->len);
+    end = CLAMP(end, 0, line->len);
+    if (start >= end) {
+        return;
+    }
+
+    if (!(line->flags & GST_LINE_FLAG_DIRTY)
+        || line->dirty_start >= line->dirty_end)
+    {
+        /* Clean line: the span starts fresh */
+        if (!(line->flags & GST_LINE_FLAG_DIRTY)) {
+            line->dirty_start = start;
+            line->dirty_end = end;
+        }
+        line->flags |= GST_LINE_FLAG_DIRTY;
+        return;
+    }
+
+    line->dirty_start = MIN(line->dirty_start, start);
+    line->dirty_end = MAX(line->dirty_end, end);
+}
+
+/**
+ * gst_line_get_dirty_span:
+ * @line: a GstLine
+ * @start: (out): first damaged column
+ * @end: (out): one past the last damaged column
+ *
+ * Gets the columns that changed since the line was last marked
+ * clean. A line flagged dirty without a recorded span reports
+ * its full width.
+ *
+ * Returns: %FALSE if the line is not dirty
+ */
+gboolean
+gst_line_get_dirty_span(
+    const GstLine   *line,
+    gint            *start,
+    gint            *end
+){
+    g_return_val_if_fail(line != NULL, FALSE);
+    g_return_val_if_fail(start != NULL && end != NULL, FALSE);
+
+    if (!(line->flags & GST_LINE_FLAG_DIRTY)) {
+        *start = 0;
+        *end = 0;
+        return FALSE;
+    }
+
+    if (line->dirty_start >= line->dirty_end
+        || line->dirty_end > line->len)
+    {
+        *start = 0;
+        *end = line->len;
+    } else {
+        *start = line->dirty_start;
+        *end = line->dirty_end;
     }
+
+    return TRUE;
+}
+
+/**
+ * gst_line_expand_span:
+ * @line: a GstLine
+ * @start: (inout): first column of the span
+ * @end: (inout): one past the last column of the span
+ *
+ * Widens a column span for redrawing. The span grows outwards
+ * until it meets a blank cell (or the line edge) on each side,
+ * which also takes in both halves of any wide character.
+ */
+void
+gst_line_expand_span(
+    const GstLine   *line,
+    gint            *start,
+    gint            *end
+){
+    gint s;
+    gint e;
+
+    g_return_if_fail(line != NULL);
+    g_return_if_fail(start != NULL && end != NULL);
+
+    s = CLAMP(*start, 0, line->len);
+    e = CLAMP(*end, 0, line->len);
+
+    while (s > 0 && s < line->len && line->glyphs[s - 1].rune != ' '
+           && line->glyphs[s].rune != ' ')
+    {
+        s--;
+    }
+    while (e < line->len && e > 0 && line->glyphs[e].rune != ' '
+           && line->glyphs[e - 1].rune != ' ')
+    {
+        e++;
+    }
+
+    *start = s;
+    *end = e;
 }
 
 /**
@@ -44,11 +44,18 @@ GType gst_line_flags_get_type(void) G_GNUC_CONST;
  *
  * Represents a single row in the terminal buffer.
  * Contains an array of glyphs and line metadata.
+ *
+ * While the line is dirty, [dirty_start, dirty_end) covers the
+ * columns changed since the last redraw. An empty span on a dirty
+ * line means the whole line; use gst_line_get_dirty_span() rather
+ * than reading the fields directly.
  */
 struct _GstLine {
     GstGlyph    *glyphs;    /* Array of glyphs */
     gint        len;        /* Number of glyphs (columns) */
     GstLineFlags flags;     /* Line flags */
+    gint        dirty_start; /* First damaged column */
+    gint        dirty_end;   /* One past the last damaged column */
 };
 
 /**
@@ -212,6 +219,43 @@ gboolean gst_line_is_dirty(const GstLine *line);
  */
 void gst_line_set_dirty(GstLine *line, gboolean dirty);
 
+/**
+ * gst_line_mark_dirty_range:
+ * @line: a GstLine
+ * @start: first damaged column (inclusive)
+ * @end: last damaged column (exclusive)
+ *
+ * Marks the line dirty and widens its dirty span to cover
+ * [@start, @end).
+ */
+void gst_line_mark_dirty_range(GstLine *line, gint start, gint end);
+
+/**
+ * gst_line_get_dirty_span:
+ * @line: a GstLine
+ * @start: (out): first damaged column
+ * @end: (out): one past the last damaged column
+ *
+ * Gets the columns that changed since the line was last marked
+ * clean.
+ *
+ * Returns: %FALSE if the line is not dirty
+ */
+gboolean gst_line_get_dirty_span(const GstLine *line, gint *start, gint *end);
+
+/**
+ * gst_line_expand_span:
+ * @line: a GstLine
+ * @start: (inout): first column of the span
+ * @end: (inout): one past the last column of the span
+ *
+ * Widens a column span for redrawing: both halves of a wide
+ * character are included, and the span is grown to the blank
+ * cells around it so that glyph overhang and multi-cell shaping
+ * (ligatures) are never cut at the span edge.
+ */
+void gst_line_expand_span(const GstLine *line, gint *start, gint *end);
+
 /**
  * gst_line_is_wrapped:
  * @line: a GstLine
@@ -0,0 +1,250 @@
+/*
+ * gst-lz.c - Small LZ77 block codec
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Each sequence is
+ *
+ *   token   high nibble: literal count, low nibble: match length - 4
+ *           (15 in either means more length bytes follow)
+ *   [len]   255, 255, ..., n    extra literal count
+ *   literals
+ *   offset  2 bytes, little endian, 1..65535
+ *   [len]   extra match length
+ *
+ * The last sequence stops after its literals. Matches are found
+ * through a single-entry hash of the next four bytes.
+ */
+
+#include "gst-lz.h"
+#include <string.h>
+
+#define LZ_MIN_MATCH    (4)
+#define LZ_MAX_OFFSET   (65535)
+#define LZ_HASH_BITS    (12)
+
+static guint32
+lz_read32(const guint8 *p)
+{
+	guint32 v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static guint
+lz_hash(guint32 v)
+{
+	return (guint)((v * 2654435761u) >> (32 - LZ_HASH_BITS));
+}
+
+/* Writes the extra bytes of a length whose nibble was saturated */
+static guint8 *
+lz_put_length(
+	guint8  *d,
+	gsize   len
+){
+	while (len >= 255) {
+		*d++ = 255;
+		len -= 255;
+	}
+	*d++ = (guint8)len;
+	return d;
+}
+
+/* Reads the extra bytes of a length; FALSE if the input ends first */
+static gboolean
+lz_get_length(
+	const guint8    **s,
+	const guint8    *end,
+	gsize           *len
+){
+	guint8 b;
+
+	do {
+		if (*s >= end) {
+			return FALSE;
+		}
+		b = *(*s)++;
+		*len += b;
+	} while (b == 255);
+
+	return TRUE;
+}
+
+/*
+ * lz_emit:
+ *
+ * Appends one sequence: @lit_len literals from @lit and, when
+ * @match_len is non-zero, a back-reference.
+ */
+static guint8 *
+lz_emit(
+	guint8          *d,
+	const guint8    *lit,
+	gsize           lit_len,
+	gsize           offset,
+	gsize           match_len
+){
+	guint8 *token;
+	gsize ml;
+
+	token = d++;
+	*token = (guint8)(MIN(lit_len, (gsize)15) << 4);
+	if (lit_len >= 15) {
+		d = lz_put_length(d, lit_len - 15);
+	}
+	memcpy(d, lit, lit_len);
+	d += lit_len;
+
+	if (match_len == 0) {
+		return d;
+	}
+
+	d[0] = (guint8)(offset & 0xFF);
+	d[1] = (guint8)(offset >> 8);
+	d += 2;
+
+	ml = match_len - LZ_MIN_MATCH;
+	*token |= (guint8)MIN(ml, (gsize)15);
+	if (ml >= 15) {
+		d = lz_put_length(d, ml - 15);
+	}
+	return d;
+}
+
+gsize
+gst_lz_compress_bound(gsize n)
+{
+	return n + n / 255 + 16;
+}
+
+gsize
+gst_lz_compress(
+	const guint8    *src,
+	gsize           n,
+	guint8          *dst,
+	gsize           cap
+){
+	guint32 table[1 << LZ_HASH_BITS];
+	guint8 *d;
+	gsize ip;
+	gsize anchor;
+
+	g_return_val_if_fail(src != NULL || n == 0, 0);
+	g_return_val_if_fail(dst != NULL, 0);
+
+	if (cap < gst_lz_compress_bound(n)) {
+		return 0;
+	}
+
+	/* Entries hold position + 1, so 0 means empty */
+	memset(table, 0, sizeof(table));
+	d = dst;
+	ip = 0;
+	anchor = 0;
+
+	while (ip + LZ_MIN_MATCH <= n) {
+		guint32 seq;
+		guint h;
+		gsize ref;
+		gsize ml;
+
+		seq = lz_read32(src + ip);
+		h = lz_hash(seq);
+		ref = table[h];
+		table[h] = (guint32)(ip + 1);
+
+		if (ref == 0 || ip - (ref - 1) > LZ_MAX_OFFSET
+		    || lz_read32(src + ref - 1) != seq) {
+			ip++;
+			continue;
+		}
+		ref--;
+
+		ml = LZ_MIN_MATCH;
+		while (ip + ml < n && src[ref + ml] == src[ip + ml]) {
+			ml++;
+		}
+
+		d = lz_emit(d, src + anchor, ip - anchor, ip - ref, ml);
+		ip += ml;
+		anchor = ip;
+	}
+
+	d = lz_emit(d, src + anchor, n - anchor, 0, 0);
+	return (gsize)(d - dst);
+}
+
+gboolean
+gst_lz_decompress(
+	const guint8    *src,
+	gsize           n,
+	guint8          *dst,
+	gsize           raw_size
+){
+	const guint8 *s;
+	const guint8 *end;
+	guint8 *d;
+	guint8 *d_end;
+
+	g_return_val_if_fail(src != NULL || n == 0, FALSE);
+	g_return_val_if_fail(dst != NULL || raw_size == 0, FALSE);
+
+	s = src;
+	end = src + n;
+	d = dst;
+	d_end = dst + raw_size;
+
+	while (s < end) {
+		guint8 token;
+		gsize lit_len;
+		gsize offset;
+		gsize ml;
+
+		token = *s++;
+
+		lit_len = token >> 4;
+		if (lit_len == 15 && !lz_get_length(&s, end, &lit_len)) {
+			return FALSE;
+		}
+		if (lit_len > (gsize)(end - s) || lit_len > (gsize)(d_end - d)) {
+			return FALSE;
+		}
+		memcpy(d, s, lit_len);
+		d += lit_len;
+		s += lit_len;
+
+		/* The last sequence has no match */
+		if (s == end) {
+			break;
+		}
+
+		if (end - s < 2) {
+			return FALSE;
+		}
+		offset = (gsize)s[0] | ((gsize)s[1] << 8);
+		s += 2;
+		if (offset == 0 || offset > (gsize)(d - dst)) {
+			return FALSE;
+		}
+
+		ml = token & 0x0F;
+		if (ml == 15 && !lz_get_length(&s, end, &ml)) {
+			return FALSE;
+		}
+		ml += LZ_MIN_MATCH;
+		if (ml > (gsize)(d_end - d)) {
+			return FALSE;
+		}
+
+		/* Byte by byte: the match may overlap its own output */
+		while (ml-- > 0) {
+			*d = *(d - offset);
+			d++;
+		}
+	}
+
+	return d == d_end;
+}
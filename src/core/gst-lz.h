@@ -0,0 +1,72 @@
+/*
+ * gst-lz.h - Small LZ77 block codec
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * A byte-oriented LZ77 codec in the style of LZ4: sequences of
+ * literals followed by a back-reference of at least four bytes
+ * within the previous 64 KiB. It trades ratio for speed and has
+ * no dependencies, which suits freezing cold scrollback pages that
+ * must decode again in well under a millisecond.
+ */
+
+#ifndef GST_LZ_H
+#define GST_LZ_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * gst_lz_compress_bound:
+ * @n: input size in bytes
+ *
+ * Returns: the largest output gst_lz_compress() can produce for
+ *   @n bytes of input
+ */
+gsize
+gst_lz_compress_bound(gsize n);
+
+/**
+ * gst_lz_compress:
+ * @src: input bytes
+ * @n: input size
+ * @dst: output buffer
+ * @cap: size of @dst, at least gst_lz_compress_bound(@n)
+ *
+ * Compresses @src into @dst.
+ *
+ * Returns: bytes written to @dst, or 0 if @cap was too small
+ */
+gsize
+gst_lz_compress(
+	const guint8    *src,
+	gsize           n,
+	guint8          *dst,
+	gsize           cap
+);
+
+/**
+ * gst_lz_decompress:
+ * @src: compressed bytes
+ * @n: compressed size
+ * @dst: output buffer
+ * @raw_size: exact decompressed size
+ *
+ * Decompresses @src into @dst. Every length and offset is checked,
+ * so corrupt input fails instead of overrunning either buffer.
+ *
+ * Returns: %TRUE if exactly @raw_size bytes were decoded
+ */
+gboolean
+gst_lz_decompress(
+	const guint8    *src,
+	gsize           n,
+	guint8          *dst,
+	gsize           raw_size
+);
+
+G_END_DECLS
+
+#endif /* GST_LZ_H */
@@ -19,8 +19,17 @@
 #include <sys/ioctl.h>
 #include <sys/wait.h>
 
-/* Read buffer size for PTY data */
-#define PTY_READ_BUF_SIZ (8192)
+/* Initial (and minimum) read buffer size for PTY data */
+#define PTY_READ_BUF_MIN (8192)
+
+/* Largest read buffer / per-wakeup byte budget */
+#define PTY_READ_BUF_MAX (1024 * 1024)
+
+/* Default per-wakeup time budget for draining the fd (ms) */
+#define PTY_READ_TIME_DEFAULT (4)
+
+/* Consecutive under-used wakeups before the read buffer shrinks */
+#define PTY_READ_SHRINK_AFTER (64)
 
 typedef struct {
 	gint master_fd;
@@ -31,6 +40,13 @@ typedef struct {
 	guint child_watch_id;
 	gint cols;
 	gint rows;
+
+	/* Adaptive read buffer, drained into once per wakeup */
+	gchar *read_buf;
+	gsize read_buf_size;
+	gsize read_budget;
+	gint64 read_time_budget_us;
+	guint read_low_count;
 } GstPtyPrivate;
 
 enum {
@@ -79,6 +95,8 @@ gst_pty_finalize(GObject *object)
 		priv->master_fd = -1;
 	}
 
+	g_free(priv->read_buf);
+
 	G_OBJECT_CLASS(gst_pty_parent_class)->finalize(object);
 }
 
@@ -134,13 +152,57 @@ gst_pty_init(GstPty *pty)
 	priv->child_watch_id = 0;
 	priv->cols = 80;
 	priv->rows = 24;
+	priv->read_buf = NULL;
+	priv->read_buf_size = 0;
+	priv->read_budget = PTY_READ_BUF_MAX;
+	priv->read_time_budget_us = (gint64)PTY_READ_TIME_DEFAULT * 1000;
+	priv->read_low_count = 0;
+}
+
+/*
+ * pty_read_buf_adapt:
+ *
+ * Resizes the read buffer after a wakeup that read @total bytes.
+ * A drain that filled the buffer doubles it (up to the byte budget);
+ * a long streak of wakeups that used under a quarter of it halves
+ * it again, down to PTY_READ_BUF_MIN.
+ */
+static void
+pty_read_buf_adapt(
+    GstPtyPrivate   *priv,
+    gsize           total
+){
+	if (total >= priv->read_buf_size) {
+		priv->read_low_count = 0;
+		if (priv->read_buf_size < priv->read_budget) {
+			priv->read_buf_size = MIN(priv->read_buf_size * 2,
+			                          priv->read_budget);
+			priv->read_buf = g_realloc(priv->read_buf, priv->read_buf_size);
+		}
+		return;
+	}
+
+	if (priv->read_buf_size > PTY_READ_BUF_MIN
+	    && total < priv->read_buf_size / 4)
+	{
+		if (++priv->read_low_count >= PTY_READ_SHRINK_AFTER) {
+			priv->read_low_count = 0;
+			priv->read_buf_size /= 2;
+			priv->read_buf = g_realloc(priv->read_buf, priv->read_buf_size);
+		}
+	} else {
+		priv->read_low_count = 0;
+	}
 }
 
 /*
  * pty_io_callback:
  *
- * GIOChannel watch callback. Reads data from the PTY master fd
- * and emits the "data-received" signal.
+ * GIOChannel watch callback. Drains the PTY master fd until it
+ * would block or the per-wakeup byte/time budget is spent, then
+ * emits "data-received" once with everything that was read.
+ * Batching reads this way cuts GSource dispatches and signal
+ * emissions when the child produces output faster than we draw.
  */
 static gboolean
 pty_io_callback(
@@ -150,23 +212,61 @@ pty_io_callback(
 ){
 	GstPty *pty = GST_PTY(user_data);
 	GstPtyPrivate *priv = gst_pty_get_instance_private(pty);
-	gchar buf[PTY_READ_BUF_SIZ];
+	gboolean eof;
+	gint64 deadline;
+	gsize total;
+	gsize limit;
 	gssize n;
 
-	if (condition & (G_IO_HUP | G_IO_ERR)) {
+	if (!(condition & G_IO_IN) && (condition & (G_IO_HUP | G_IO_ERR))) {
 		priv->io_watch_id = 0;
 		return FALSE;
 	}
 
-	if (condition & G_IO_IN) {
-		n = read(priv->master_fd, buf, sizeof(buf));
+	if (!(condition & G_IO_IN)) {
+		return TRUE;
+	}
+
+	if (priv->read_buf == NULL) {
+		priv->read_buf_size = MIN((gsize)PTY_READ_BUF_MIN, priv->read_budget);
+		priv->read_buf = g_malloc(priv->read_buf_size);
+	}
+
+	eof = FALSE;
+	total = 0;
+	limit = MIN(priv->read_buf_size, priv->read_budget);
+	deadline = g_get_monotonic_time() + priv->read_time_budget_us;
+
+	while (total < limit) {
+		n = read(priv->master_fd, priv->read_buf + total, limit - total);
 		if (n > 0) {
-			g_signal_emit(pty, signals[SIGNAL_DATA_RECEIVED], 0,
-			              (gpointer)buf, (gulong)n);
-		} else if (n <= 0) {
-			priv->io_watch_id = 0;
-			return FALSE;
+			total += (gsize)n;
+			if (g_get_monotonic_time() >= deadline) {
+				break;
+			}
+			continue;
+		}
+		if (n < 0 && errno == EINTR) {
+			continue;
 		}
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		}
+
+		/* EOF or EIO: the child side is gone */
+		eof = TRUE;
+		break;
+	}
+
+	if (total > 0) {
+		g_signal_emit(pty, signals[SIGNAL_DATA_RECEIVED], 0,
+		              (gpointer)priv->read_buf, (gulong)total);
+		pty_read_buf_adapt(priv, total);
+	}
+
+	if (eof || (total == 0 && (condition & (G_IO_HUP | G_IO_ERR)))) {
+		priv->io_watch_id = 0;
+		return FALSE;
 	}
 
 	return TRUE;
@@ -441,6 +541,38 @@ gst_pty_resize(
 	ioctl(priv->master_fd, TIOCSWINSZ, &ws);
 }
 
+/**
+ * gst_pty_set_read_budget:
+ * @pty: a #GstPty
+ * @max_bytes: most bytes to read per main-loop wakeup (4 KiB - 1 MiB)
+ * @max_ms: most time to spend draining the fd per wakeup, in ms
+ *
+ * Bounds how much output a single wakeup collects before it is
+ * handed to "data-received". The read buffer starts small and grows
+ * towards @max_bytes while the child keeps it full.
+ */
+void
+gst_pty_set_read_budget(
+    GstPty  *pty,
+    gsize   max_bytes,
+    guint   max_ms
+){
+	GstPtyPrivate *priv;
+
+	g_return_if_fail(GST_IS_PTY(pty));
+	g_return_if_fail(max_ms >= 1);
+
+	priv = gst_pty_get_instance_private(pty);
+
+	priv->read_budget = CLAMP(max_bytes, (gsize)4096, (gsize)PTY_READ_BUF_MAX);
+	priv->read_time_budget_us = (gint64)max_ms * 1000;
+
+	if (priv->read_buf != NULL && priv->read_buf_size > priv->read_budget) {
+		priv->read_buf_size = priv->read_budget;
+		priv->read_buf = g_realloc(priv->read_buf, priv->read_buf_size);
+	}
+}
+
 /**
  * gst_pty_get_fd:
  * @pty: a #GstPty
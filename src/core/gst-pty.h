@@ -46,6 +46,8 @@ void gst_pty_write_no_echo(GstPty *pty, const gchar *data, gssize len);
 
 void gst_pty_resize(GstPty *pty, gint cols, gint rows);
 
+void gst_pty_set_read_budget(GstPty *pty, gsize max_bytes, guint max_ms);
+
 gint gst_pty_get_fd(GstPty *pty);
 
 GPid gst_pty_get_child_pid(GstPty *pty);
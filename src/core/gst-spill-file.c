@@ -0,0 +1,182 @@
+/*
+ * gst-spill-file.c - Append-only, memory-mapped spill file
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Writes go through pwrite() and reads through one shared read-only
+ * mapping of the whole file, which is remapped when a read reaches
+ * past its end. Both see the same page cache, so a record can be
+ * read back as soon as it is appended.
+ */
+
+/* fallocate() and FALLOC_FL_PUNCH_HOLE */
+#define _GNU_SOURCE
+
+#include "gst-spill-file.h"
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+struct _GstSpillFile {
+	gint fd;
+	guint64 size;      /* bytes appended */
+
+	guint8 *map;       /* mapping of the first map_len bytes, or NULL */
+	gsize map_len;
+};
+
+GstSpillFile *
+gst_spill_file_new(
+	const gchar *dir,
+	GError      **error
+){
+	GstSpillFile *spill;
+	gchar *path;
+	gint fd;
+	gint saved;
+
+	g_return_val_if_fail(dir != NULL, NULL);
+
+	if (g_mkdir_with_parents(dir, 0700) != 0) {
+		saved = errno;
+		g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(saved),
+			"Failed to create %s: %s", dir, g_strerror(saved));
+		return NULL;
+	}
+
+	path = g_build_filename(dir, "scrollback-XXXXXX", NULL);
+	fd = g_mkstemp_full(path, O_RDWR | O_CLOEXEC, 0600);
+	if (fd < 0) {
+		saved = errno;
+		g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(saved),
+			"Failed to create spill file in %s: %s", dir, g_strerror(saved));
+		g_free(path);
+		return NULL;
+	}
+
+	/* Nameless from here on: the space goes away with the fd */
+	unlink(path);
+	g_free(path);
+
+	spill = g_new0(GstSpillFile, 1);
+	spill->fd = fd;
+	return spill;
+}
+
+void
+gst_spill_file_free(GstSpillFile *spill)
+{
+	if (spill == NULL) {
+		return;
+	}
+
+	if (spill->map != NULL) {
+		munmap(spill->map, spill->map_len);
+	}
+	close(spill->fd);
+	g_free(spill);
+}
+
+gboolean
+gst_spill_file_append(
+	GstSpillFile    *spill,
+	gconstpointer   data,
+	gsize           size,
+	guint64         *offset_out,
+	GError          **error
+){
+	const guint8 *p;
+	gsize done;
+	ssize_t n;
+	gint saved;
+
+	g_return_val_if_fail(spill != NULL, FALSE);
+	g_return_val_if_fail(data != NULL || size == 0, FALSE);
+	g_return_val_if_fail(offset_out != NULL, FALSE);
+
+	p = data;
+	done = 0;
+	while (done < size) {
+		n = pwrite(spill->fd, p + done, size - done,
+			(off_t)(spill->size + done));
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			saved = errno;
+			g_set_error(error, G_FILE_ERROR, g_file_error_from_errno(saved),
+				"Failed to write spill file: %s", g_strerror(saved));
+			return FALSE;
+		}
+		done += (gsize)n;
+	}
+
+	*offset_out = spill->size;
+	spill->size += size;
+	return TRUE;
+}
+
+const guint8 *
+gst_spill_file_read(
+	GstSpillFile    *spill,
+	guint64         offset,
+	gsize           size
+){
+	gpointer map;
+
+	g_return_val_if_fail(spill != NULL, NULL);
+
+	if (size == 0 || offset + size > spill->size) {
+		return NULL;
+	}
+
+	if (offset + size > spill->map_len) {
+		if (spill->map != NULL) {
+			munmap(spill->map, spill->map_len);
+			spill->map = NULL;
+			spill->map_len = 0;
+		}
+
+		map = mmap(NULL, (gsize)spill->size, PROT_READ, MAP_SHARED,
+			spill->fd, 0);
+		if (map == MAP_FAILED) {
+			g_warning("spill: mmap failed: %s", g_strerror(errno));
+			return NULL;
+		}
+		spill->map = map;
+		spill->map_len = (gsize)spill->size;
+	}
+
+	return spill->map + offset;
+}
+
+void
+gst_spill_file_discard(
+	GstSpillFile    *spill,
+	guint64         offset,
+	gsize           size
+){
+	g_return_if_fail(spill != NULL);
+
+#ifdef FALLOC_FL_PUNCH_HOLE
+	/* Best effort; unsupported file systems just keep the bytes */
+	if (size > 0) {
+		(void)fallocate(spill->fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+			(off_t)offset, (off_t)size);
+	}
+#else
+	(void)offset;
+	(void)size;
+#endif
+}
+
+guint64
+gst_spill_file_get_size(GstSpillFile *spill)
+{
+	g_return_val_if_fail(spill != NULL, 0);
+
+	return spill->size;
+}
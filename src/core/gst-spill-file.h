@@ -0,0 +1,119 @@
+/*
+ * gst-spill-file.h - Append-only, memory-mapped spill file
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Moves data that is rarely read out of the heap: records are
+ * appended to an anonymous file (created and unlinked at once, so
+ * it vanishes with the process) and read back through a read-only
+ * mapping. The page cache, not the process, owns the bytes, and
+ * the kernel can drop them at will. Used for frozen scrollback
+ * pages.
+ */
+
+#ifndef GST_SPILL_FILE_H
+#define GST_SPILL_FILE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstSpillFile GstSpillFile;
+
+/**
+ * gst_spill_file_new:
+ * @dir: directory to create the file in, made if missing
+ * @error: (nullable): return location for a #GError
+ *
+ * Creates an empty spill file in @dir. Only the open descriptor
+ * refers to it; it has no name on disk.
+ *
+ * Returns: (transfer full) (nullable): a new #GstSpillFile, or
+ *   %NULL on error
+ */
+GstSpillFile *
+gst_spill_file_new(
+	const gchar *dir,
+	GError      **error
+);
+
+/**
+ * gst_spill_file_free:
+ * @spill: (nullable): a #GstSpillFile
+ *
+ * Unmaps and closes the file, releasing its disk space.
+ */
+void
+gst_spill_file_free(GstSpillFile *spill);
+
+/**
+ * gst_spill_file_append:
+ * @spill: a #GstSpillFile
+ * @data: bytes to store
+ * @size: number of bytes
+ * @offset_out: (out): where the record starts in the file
+ * @error: (nullable): return location for a #GError
+ *
+ * Appends a record to the end of the file.
+ *
+ * Returns: %TRUE on success
+ */
+gboolean
+gst_spill_file_append(
+	GstSpillFile    *spill,
+	gconstpointer   data,
+	gsize           size,
+	guint64         *offset_out,
+	GError          **error
+);
+
+/**
+ * gst_spill_file_read:
+ * @spill: a #GstSpillFile
+ * @offset: offset returned by gst_spill_file_append()
+ * @size: record size
+ *
+ * Maps a record for reading, extending the mapping if the file has
+ * grown past it. The pointer stays valid until the next append or
+ * read.
+ *
+ * Returns: (transfer none) (nullable): the record, or %NULL if it
+ *   lies outside the file or the file cannot be mapped
+ */
+const guint8 *
+gst_spill_file_read(
+	GstSpillFile    *spill,
+	guint64         offset,
+	gsize           size
+);
+
+/**
+ * gst_spill_file_discard:
+ * @spill: a #GstSpillFile
+ * @offset: offset of a record
+ * @size: record size
+ *
+ * Tells the file a record will not be read again. Where the file
+ * system supports it, its blocks are punched out so a bounded
+ * history does not grow the file's disk usage without end.
+ */
+void
+gst_spill_file_discard(
+	GstSpillFile    *spill,
+	guint64         offset,
+	gsize           size
+);
+
+/**
+ * gst_spill_file_get_size:
+ * @spill: a #GstSpillFile
+ *
+ * Returns: bytes appended so far, discarded records included
+ */
+guint64
+gst_spill_file_get_size(GstSpillFile *spill);
+
+G_END_DECLS
+
+#endif /* GST_SPILL_FILE_H */
@@ -0,0 +1,379 @@
+/*
+ * gst-style-table.c - GST Packed Cells and Style Interning
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Styles are appended to a flat array, so an ID lookup is a plain
+ * index. Interning goes through a hash table keyed on the style
+ * triple, fronted by a one-entry cache because runs of cells with
+ * the same style are the common case when packing a row.
+ */
+
+#include "gst-style-table.h"
+#include <string.h>
+
+struct _GstStyleTable {
+    GArray      *styles;    /* GstStyle, indexed by ID */
+    GHashTable  *index;     /* GstStyle* (owned) -> ID + 1 */
+    guint16     last_id;    /* most recently interned ID */
+};
+
+static guint
+style_hash(gconstpointer key)
+{
+    const GstStyle *s = key;
+    guint h;
+
+    h = 2166136261u;
+    h = (h ^ (guint)s->attr) * 16777619u;
+    h = (h ^ s->fg) * 16777619u;
+    h = (h ^ s->bg) * 16777619u;
+    return h;
+}
+
+static gboolean
+style_equal(
+    gconstpointer a,
+    gconstpointer b
+){
+    const GstStyle *sa = a;
+    const GstStyle *sb = b;
+
+    return sa->attr == sb->attr && sa->fg == sb->fg && sa->bg == sb->bg;
+}
+
+/*
+ * style_table_seed:
+ *
+ * Interns the default style so that it always gets ID 0.
+ */
+static void
+style_table_seed(GstStyleTable *table)
+{
+    guint16 id;
+
+    gst_style_table_intern(table, GST_GLYPH_ATTR_NONE,
+        GST_COLOR_DEFAULT_FG, GST_COLOR_DEFAULT_BG, &id);
+}
+
+/**
+ * gst_style_table_new:
+ *
+ * Creates a style table holding only the default style.
+ *
+ * Returns: (transfer full): a new #GstStyleTable
+ */
+GstStyleTable *
+gst_style_table_new(void)
+{
+    GstStyleTable *table;
+
+    table = g_new0(GstStyleTable, 1);
+    table->styles = g_array_new(FALSE, FALSE, sizeof(GstStyle));
+    table->index = g_hash_table_new_full(style_hash, style_equal,
+                                         g_free, NULL);
+    style_table_seed(table);
+
+    return table;
+}
+
+/**
+ * gst_style_table_free:
+ * @table: (nullable): a #GstStyleTable
+ *
+ * Frees the table. Cells packed against it can no longer be unpacked.
+ */
+void
+gst_style_table_free(GstStyleTable *table)
+{
+    if (table == NULL) {
+        return;
+    }
+
+    g_array_free(table->styles, TRUE);
+    g_hash_table_destroy(table->index);
+    g_free(table);
+}
+
+/**
+ * gst_style_table_clear:
+ * @table: a #GstStyleTable
+ *
+ * Drops every style except the default. Only valid once no packed
+ * cell refers to the table any more.
+ */
+void
+gst_style_table_clear(GstStyleTable *table)
+{
+    g_return_if_fail(table != NULL);
+
+    g_array_set_size(table->styles, 0);
+    g_hash_table_remove_all(table->index);
+    table->last_id = 0;
+    style_table_seed(table);
+}
+
+/**
+ * gst_style_table_get_size:
+ * @table: a #GstStyleTable
+ *
+ * Returns: the number of interned styles
+ */
+guint
+gst_style_table_get_size(const GstStyleTable *table)
+{
+    g_return_val_if_fail(table != NULL, 0);
+
+    return table->styles->len;
+}
+
+/**
+ * gst_style_table_intern:
+ * @table: a #GstStyleTable
+ * @attr: attribute flags
+ * @fg: foreground color
+ * @bg: background color
+ * @id: (out): the style's ID
+ *
+ * Looks up the style, adding it if it is new.
+ *
+ * Returns: %FALSE if the style is new and the table is full
+ */
+gboolean
+gst_style_table_intern(
+    GstStyleTable   *table,
+    GstGlyphAttr    attr,
+    guint32         fg,
+    guint32         bg,
+    guint16         *id
+){
+    GstStyle key;
+    GstStyle *last;
+    gpointer found;
+
+    g_return_val_if_fail(table != NULL, FALSE);
+    g_return_val_if_fail(id != NULL, FALSE);
+
+    if (table->styles->len > 0) {
+        last = &g_array_index(table->styles, GstStyle, table->last_id);
+        if (last->attr == attr && last->fg == fg && last->bg == bg) {
+            *id = table->last_id;
+            return TRUE;
+        }
+    }
+
+    key.attr = attr;
+    key.fg = fg;
+    key.bg = bg;
+
+    found = g_hash_table_lookup(table->index, &key);
+    if (found != NULL) {
+        table->last_id = (guint16)(GPOINTER_TO_UINT(found) - 1);
+        *id = table->last_id;
+        return TRUE;
+    }
+
+    if (table->styles->len >= GST_STYLE_TABLE_MAX) {
+        return FALSE;
+    }
+
+    table->last_id = (guint16)table->styles->len;
+    g_array_append_val(table->styles, key);
+    g_hash_table_insert(table->index, g_memdup2(&key, sizeof(key)),
+                        GUINT_TO_POINTER((guint)table->last_id + 1));
+
+    *id = table->last_id;
+    return TRUE;
+}
+
+/**
+ * gst_style_table_lookup:
+ * @table: a #GstStyleTable
+ * @id: a style ID returned by gst_style_table_intern()
+ *
+ * Returns: (transfer none) (nullable): the style, or %NULL if @id
+ *   is not in the table
+ */
+const GstStyle *
+gst_style_table_lookup(
+    const GstStyleTable *table,
+    guint16             id
+){
+    g_return_val_if_fail(table != NULL, NULL);
+
+    if (id >= table->styles->len) {
+        return NULL;
+    }
+
+    return &g_array_index(table->styles, GstStyle, id);
+}
+
+/**
+ * gst_style_table_pack:
+ * @table: a #GstStyleTable
+ * @glyph: the glyph to pack
+ * @cell: (out): the packed cell
+ *
+ * Returns: %FALSE if the glyph's style could not be interned
+ */
+gboolean
+gst_style_table_pack(
+    GstStyleTable   *table,
+    const GstGlyph  *glyph,
+    GstPackedCell   *cell
+){
+    guint16 id;
+
+    g_return_val_if_fail(glyph != NULL, FALSE);
+    g_return_val_if_fail(cell != NULL, FALSE);
+
+    if (!gst_style_table_intern(table, glyph->attr, glyph->fg,
+                                glyph->bg, &id)) {
+        return FALSE;
+    }
+
+    *cell = GST_PACKED_CELL_MAKE(glyph->rune, id);
+    return TRUE;
+}
+
+/**
+ * gst_style_table_unpack:
+ * @table: the #GstStyleTable @cell was packed against
+ * @cell: a packed cell
+ * @glyph: (out caller-allocates): the expanded glyph
+ *
+ * Expands a packed cell. An unknown style ID expands to the
+ * default style.
+ */
+void
+gst_style_table_unpack(
+    const GstStyleTable *table,
+    GstPackedCell       cell,
+    GstGlyph            *glyph
+){
+    const GstStyle *style;
+
+    g_return_if_fail(glyph != NULL);
+
+    style = gst_style_table_lookup(table, GST_PACKED_CELL_STYLE(cell));
+    if (style == NULL) {
+        style = gst_style_table_lookup(table, GST_STYLE_ID_DEFAULT);
+    }
+
+    glyph->rune = GST_PACKED_CELL_RUNE(cell);
+    glyph->attr = style->attr;
+    glyph->fg = style->fg;
+    glyph->bg = style->bg;
+}
+
+/**
+ * gst_style_table_pack_row:
+ * @table: a #GstStyleTable
+ * @glyphs: glyphs to pack
+ * @n: number of glyphs
+ * @cells: (out caller-allocates): room for @n packed cells
+ *
+ * Packs a row of glyphs. On failure @cells is partly written and
+ * the styles interned so far stay in the table.
+ *
+ * Returns: %FALSE if the table filled up part way through
+ */
+gboolean
+gst_style_table_pack_row(
+    GstStyleTable   *table,
+    const GstGlyph  *glyphs,
+    gint            n,
+    GstPackedCell   *cells
+){
+    gint i;
+
+    g_return_val_if_fail(table != NULL, FALSE);
+    g_return_val_if_fail(n == 0 || (glyphs != NULL && cells != NULL), FALSE);
+
+    for (i = 0; i < n; i++) {
+        if (!gst_style_table_pack(table, &glyphs[i], &cells[i])) {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/**
+ * gst_style_table_unpack_row:
+ * @table: the #GstStyleTable @cells were packed against
+ * @cells: packed cells
+ * @n: number of cells
+ * @glyphs: (out caller-allocates): room for @n glyphs
+ *
+ * Expands a row of packed cells.
+ */
+void
+gst_style_table_unpack_row(
+    const GstStyleTable *table,
+    const GstPackedCell *cells,
+    gint                n,
+    GstGlyph            *glyphs
+){
+    gint i;
+
+    g_return_if_fail(table != NULL);
+    g_return_if_fail(n == 0 || (cells != NULL && glyphs != NULL));
+
+    for (i = 0; i < n; i++) {
+        gst_style_table_unpack(table, cells[i], &glyphs[i]);
+    }
+}
+
+/**
+ * gst_style_table_repack_row:
+ * @from: the #GstStyleTable @cells were packed against
+ * @to: the table to pack them against instead
+ * @cells: (inout): packed cells
+ * @n: number of cells
+ *
+ * Moves a row of packed cells over to another table, interning
+ * their styles there. Used to compact a table that filled up: the
+ * styles still in use are re-interned into a fresh one and the
+ * old table is dropped. On failure @cells is left untouched.
+ *
+ * Returns: %FALSE if @to filled up part way through
+ */
+gboolean
+gst_style_table_repack_row(
+    const GstStyleTable *from,
+    GstStyleTable       *to,
+    GstPackedCell       *cells,
+    gint                n
+){
+    const GstStyle *style;
+    guint16 id;
+    gint pass;
+    gint i;
+
+    g_return_val_if_fail(from != NULL, FALSE);
+    g_return_val_if_fail(to != NULL, FALSE);
+    g_return_val_if_fail(n == 0 || cells != NULL, FALSE);
+
+    /* Intern everything first so a full table leaves @cells intact */
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < n; i++) {
+            style = gst_style_table_lookup(from,
+                GST_PACKED_CELL_STYLE(cells[i]));
+            if (style == NULL) {
+                style = gst_style_table_lookup(from, GST_STYLE_ID_DEFAULT);
+            }
+            if (!gst_style_table_intern(to, style->attr, style->fg,
+                                        style->bg, &id)) {
+                return FALSE;
+            }
+            if (pass == 1) {
+                cells[i] = GST_PACKED_CELL_MAKE(
+                    GST_PACKED_CELL_RUNE(cells[i]), id);
+            }
+        }
+    }
+
+    return TRUE;
+}
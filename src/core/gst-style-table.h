@@ -0,0 +1,95 @@
+/*
+ * gst-style-table.h - GST Packed Cells and Style Interning
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * A compact 8-byte cell format for bulk glyph storage. The rune
+ * keeps its own 21 bits and the (attr, fg, bg) triple, which most
+ * cells share with their neighbours, is replaced by a 16-bit ID
+ * into an interned style table.
+ */
+
+#ifndef GST_STYLE_TABLE_H
+#define GST_STYLE_TABLE_H
+
+#include <glib.h>
+#include "../gst-types.h"
+#include "../boxed/gst-glyph.h"
+
+G_BEGIN_DECLS
+
+/**
+ * GstPackedCell:
+ *
+ * A cell packed into 64 bits: bits 0-20 hold the rune and bits
+ * 21-36 the style ID. Use the GST_PACKED_CELL_* macros to access it.
+ */
+typedef guint64 GstPackedCell;
+
+#define GST_PACKED_CELL_RUNE_BITS   (21)
+#define GST_PACKED_CELL_RUNE_MASK   ((1u << GST_PACKED_CELL_RUNE_BITS) - 1)
+
+#define GST_PACKED_CELL_MAKE(rune, style) \
+    ((((GstPackedCell)(style)) << GST_PACKED_CELL_RUNE_BITS) \
+     | ((GstPackedCell)(rune) & GST_PACKED_CELL_RUNE_MASK))
+#define GST_PACKED_CELL_RUNE(cell) \
+    ((GstRune)((cell) & GST_PACKED_CELL_RUNE_MASK))
+#define GST_PACKED_CELL_STYLE(cell) \
+    ((guint16)((cell) >> GST_PACKED_CELL_RUNE_BITS))
+
+/* Style ID 0 is always the default (no attributes, default colors) */
+#define GST_STYLE_ID_DEFAULT    (0)
+
+/* Most styles a table can hold */
+#define GST_STYLE_TABLE_MAX     (65536)
+
+/**
+ * GstStyle:
+ * @attr: attribute flags
+ * @fg: foreground color index or RGB value
+ * @bg: background color index or RGB value
+ *
+ * The non-rune part of a #GstGlyph, as stored in a #GstStyleTable.
+ */
+typedef struct {
+    GstGlyphAttr    attr;
+    guint32         fg;
+    guint32         bg;
+} GstStyle;
+
+typedef struct _GstStyleTable GstStyleTable;
+
+GstStyleTable *gst_style_table_new(void);
+
+void gst_style_table_free(GstStyleTable *table);
+
+void gst_style_table_clear(GstStyleTable *table);
+
+guint gst_style_table_get_size(const GstStyleTable *table);
+
+gboolean gst_style_table_intern(GstStyleTable *table, GstGlyphAttr attr,
+                                guint32 fg, guint32 bg, guint16 *id);
+
+const GstStyle *gst_style_table_lookup(const GstStyleTable *table, guint16 id);
+
+gboolean gst_style_table_pack(GstStyleTable *table, const GstGlyph *glyph,
+                              GstPackedCell *cell);
+
+void gst_style_table_unpack(const GstStyleTable *table, GstPackedCell cell,
+                            GstGlyph *glyph);
+
+gboolean gst_style_table_pack_row(GstStyleTable *table, const GstGlyph *glyphs,
+                                  gint n, GstPackedCell *cells);
+
+void gst_style_table_unpack_row(const GstStyleTable *table,
+                                const GstPackedCell *cells, gint n,
+                                GstGlyph *glyphs);
+
+gboolean gst_style_table_repack_row(const GstStyleTable *from,
+                                    GstStyleTable *to,
+                                    GstPackedCell *cells, gint n);
+
+G_END_DECLS
+
+#endif /* GST_STYLE_TABLE_H */
@@ -11,6 +11,7 @@
 
 #include "gst-terminal.h"
 #include "gst-escape-parser.h"
+#include "gst-escape-parser-private.h"
 #include "../util/gst-utf8.h"
 #include <string.h>
 #include <stdio.h>
@@ -18,16 +19,15 @@
 
 /* ===== Macros and constants ===== */
 
-#define ISCONTROL(c)   ((c) < 0x20 || (c) == 0x7f || ((c) >= 0x80 && (c) <= 0x9f))
 #define BETWEEN(x, a, b) ((x) >= (a) && (x) <= (b))
 #define DEFAULT(a, b)  ((a) != 0 ? (a) : (b))
 
-/* Size of CSI buffer */
-#define CSI_BUF_SIZ    (256)
-
 /* Size of string escape buffer (OSC, DCS, etc.) initial alloc */
 #define STR_BUF_SIZ    (256)
 
+/* Scrolled-out lines buffered during a write before a batch is emitted */
+#define OUT_BATCH_MAX  (128)
+
 /* True color macros are now in gst-types.h as GST_TRUECOLOR_FLAG, etc. */
 
 /*
@@ -47,6 +47,24 @@ static const GstRune vt100_graphic0[62] = {
 
 /* ===== Private data structure ===== */
 
+/*
+ * TermArena:
+ *
+ * Backing store for one screen. Every glyph lives in a single
+ * rows_cap x stride block and each row is a GstLine view onto one
+ * stride-sized slot of it. @rows is the row indirection table the
+ * rest of the terminal indexes by screen row: scrolling permutes
+ * its pointers while each view keeps its slot. Entries past the
+ * current row count are spare views kept for a later resize.
+ */
+typedef struct {
+	GstGlyph *cells;
+	GstLine *views;
+	GstLine **rows;
+	gint stride;
+	gint rows_cap;
+} TermArena;
+
 struct _GstTerminalPrivate {
 	/* Dimensions */
 	gint cols;
@@ -56,6 +74,19 @@ struct _GstTerminalPrivate {
 	GstLine **screen;       /* Current active screen */
 	GstLine **primary;      /* Primary screen buffer */
 	GstLine **alt;          /* Alternate screen buffer */
+	TermArena primary_arena;
+	TermArena alt_arena;
+
+	/*
+	 * Lines scrolled off the top during gst_terminal_write(), copied
+	 * here and emitted as one lines-scrolled-out batch when the
+	 * write finishes (or earlier, before anything that lets modules
+	 * observe the screen). Outside a write each scroll emits its
+	 * own batch straight from the screen rows.
+	 */
+	TermArena out_arena;
+	gint n_out;
+	gint write_depth;
 
 	/* Cursor state */
 	GstCursor cursor;
@@ -65,8 +96,21 @@ struct _GstTerminalPrivate {
 	/* Mode flags */
 	GstTermMode mode;
 
-	/* Escape state (bit flags) */
-	guint esc;
+	/* Table-driven escape sequence parser, and its state machine
+	 * for stepping it without per-codepoint checks */
+	GstEscapeParser *parser;
+	GstEscapeMachine *esc;
+
+	/*
+	 * Scrolls since the last gst_terminal_clear_dirty(). Lines
+	 * moved by a logged scroll keep their own dirty state, so a
+	 * renderer can blit them instead of repainting. Once the log
+	 * fills up (or the screen is invalidated as a whole) scrolling
+	 * falls back to marking moved lines dirty.
+	 */
+	GstScrollOp scroll_log[GST_SCROLL_LOG_MAX];
+	guint n_scroll_ops;
+	gboolean scroll_log_closed;
 
 	/* Scroll region */
 	gint scroll_top;
@@ -81,9 +125,7 @@ struct _GstTerminalPrivate {
 	gint charset_gl;    /* Current GL charset (0-3) */
 	gint icharset;      /* Intermediate charset for ESC ( etc */
 
-	/* CSI escape buffer */
-	gchar csi_buf[CSI_BUF_SIZ + 1];
-	gsize csi_len;
+	/* Current CSI sequence, filled in by the parser */
 	gint csi_priv;      /* Private mode flag ('?') */
 	gint csi_args[GST_MAX_ARGS];
 	gint csi_nargs;
@@ -134,6 +176,7 @@ enum {
 	SIGNAL_CONTENTS_CHANGED,
 	SIGNAL_RESPONSE,
 	SIGNAL_LINE_SCROLLED_OUT,
+	SIGNAL_LINES_SCROLLED_OUT,
 	SIGNAL_ESCAPE_STRING,
 	N_SIGNALS
 };
@@ -151,17 +194,26 @@ static void gst_terminal_get_property(GObject *object, guint prop_id,
 static void gst_terminal_set_property(GObject *object, guint prop_id,
                                       const GValue *value, GParamSpec *pspec);
 static void gst_terminal_init_screen(GstTerminal *term);
-static void gst_terminal_free_screen(GstLine **screen, gint rows);
-static GstLine **gst_terminal_alloc_screen(gint cols, gint rows);
+static void term_arena_alloc(TermArena *arena, gint stride, gint rows_cap,
+                             gint cols);
+static void term_arena_free(TermArena *arena);
+static void term_flush_scrolled_out(GstTerminal *term);
+
+/* Escape parser actions */
+static void term_print(gpointer user_data, GstRune rune);
+static void term_execute(gpointer user_data, GstRune code);
+static void term_esc_dispatch(gpointer user_data, gchar intermediate,
+                              gchar final);
+static void term_csi_dispatch(gpointer user_data,
+                              const GstEscapeParams *params, gchar final);
+static void term_str_start(gpointer user_data, gchar type);
+static void term_str_put(gpointer user_data, GstRune rune);
+static void term_str_end(gpointer user_data);
 
 /* Escape parser internal functions */
-static void term_controlcode(GstTerminal *term, guchar c);
-static gint term_eschandle(GstTerminal *term, guchar c);
-static void term_csiparse(GstTerminal *term);
 static void term_csihandle(GstTerminal *term);
 static void term_strparse(GstTerminal *term);
 static void term_strhandle(GstTerminal *term);
-static void term_strsequence(GstTerminal *term, guchar c);
 static void term_setattr(GstTerminal *term, const gint *attr, gint l);
 static void term_setmode(GstTerminal *term, gint priv, gint set,
                          const gint *args, gint narg);
@@ -172,6 +224,16 @@ static void term_defutf8(GstTerminal *term, gchar c);
 static void term_dectest(GstTerminal *term, gchar c);
 static gint32 term_defcolor(const gint *attr, gint *npar, gint l);
 
+static const GstEscapeParserActions term_parser_actions = {
+	term_print,
+	term_execute,
+	term_esc_dispatch,
+	term_csi_dispatch,
+	term_str_start,
+	term_str_put,
+	term_str_end
+};
+
 /* ===== Class and Instance Init ===== */
 
 static void
@@ -255,14 +317,28 @@ gst_terminal_class_init(GstTerminalClass *klass)
 
 	/*
 	 * line-scrolled-out signal: emitted when a line scrolls off the top
-	 * of the screen. The scrollback module connects to this to capture
-	 * history lines. Parameters: (GstLine *line, gint cols).
+	 * of the screen, once per line. Kept for external modules; prefer
+	 * lines-scrolled-out. Parameters: (GstLine *line, gint cols).
 	 */
 	signals[SIGNAL_LINE_SCROLLED_OUT] = g_signal_new(
 	    "line-scrolled-out", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
 	    0, NULL, NULL, NULL,
 	    G_TYPE_NONE, 2, G_TYPE_POINTER, G_TYPE_INT);
 
+	/*
+	 * lines-scrolled-out signal: batched form of line-scrolled-out.
+	 * Emitted once per scroll call, or once per gst_terminal_write()
+	 * for the lines that scrolled out while it ran, oldest first.
+	 * The scrollback, hyperlinks, shell integration and sixel
+	 * modules connect to this. The lines are only valid for the
+	 * duration of the emission.
+	 * Parameters: (GstLine **lines, gint n_lines, gint cols).
+	 */
+	signals[SIGNAL_LINES_SCROLLED_OUT] = g_signal_new(
+	    "lines-scrolled-out", G_TYPE_FROM_CLASS(klass), G_SIGNAL_RUN_LAST,
+	    0, NULL, NULL, NULL,
+	    G_TYPE_NONE, 3, G_TYPE_POINTER, G_TYPE_INT, G_TYPE_INT);
+
 	/*
 	 * escape-string signal: emitted when a string-type escape sequence
 	 * (APC, DCS, PM) is fully received and parsed.
@@ -288,7 +364,8 @@ gst_terminal_init(GstTerminal *term)
 	priv->rows = GST_DEFAULT_ROWS;
 	priv->mode = GST_MODE_WRAP | GST_MODE_UTF8;
 	priv->tabstop = GST_DEFAULT_TABSTOP;
-	priv->esc = 0;
+	priv->parser = gst_escape_parser_new_full(&term_parser_actions, term);
+	priv->esc = gst_escape_parser_get_machine(priv->parser);
 
 	/* Initialize cursor */
 	priv->cursor.x = 0;
@@ -330,17 +407,15 @@ gst_terminal_finalize(GObject *object)
 	GstTerminal *term = GST_TERMINAL(object);
 	GstTerminalPrivate *priv = term->priv;
 
-	if (priv->primary != NULL) {
-		gst_terminal_free_screen(priv->primary, priv->rows);
-	}
-	if (priv->alt != NULL) {
-		gst_terminal_free_screen(priv->alt, priv->rows);
-	}
+	term_arena_free(&priv->primary_arena);
+	term_arena_free(&priv->alt_arena);
+	term_arena_free(&priv->out_arena);
 
 	g_free(priv->title);
 	g_free(priv->icon);
 	g_free(priv->tabs);
 	g_free(priv->str_buf);
+	g_clear_object(&priv->parser);
 
 	G_OBJECT_CLASS(gst_terminal_parent_class)->finalize(object);
 }
@@ -421,35 +496,105 @@ gst_terminal_set_property(
 
 /* ===== Screen Buffer Management ===== */
 
-static GstLine **
-gst_terminal_alloc_screen(
-    gint cols,
-    gint rows
+/*
+ * term_arena_alloc:
+ *
+ * Allocates a blank arena with room for @rows_cap rows of @stride
+ * cells. Every view starts @cols wide, dirty, in slot order.
+ */
+static void
+term_arena_alloc(
+    TermArena   *arena,
+    gint        stride,
+    gint        rows_cap,
+    gint        cols
 ){
-	GstLine **screen;
 	gint i;
 
-	screen = g_new(GstLine *, rows);
-	for (i = 0; i < rows; i++) {
-		screen[i] = gst_line_new(cols);
+	arena->stride = stride;
+	arena->rows_cap = rows_cap;
+	arena->cells = g_new(GstGlyph, (gsize)stride * (gsize)rows_cap);
+	arena->views = g_new(GstLine, rows_cap);
+	arena->rows = g_new(GstLine *, rows_cap);
+
+	for (i = 0; i < rows_cap; i++) {
+		arena->views[i].glyphs = arena->cells + (gsize)i * (gsize)stride;
+		arena->views[i].len = cols;
+		arena->views[i].flags = GST_LINE_FLAG_NONE;
+		arena->views[i].dirty_start = 0;
+		arena->views[i].dirty_end = 0;
+		gst_line_clear(&arena->views[i]);
+		arena->rows[i] = &arena->views[i];
 	}
-	return screen;
 }
 
 static void
-gst_terminal_free_screen(
-    GstLine **screen,
-    gint    rows
+term_arena_free(TermArena *arena)
+{
+	g_free(arena->cells);
+	g_free(arena->views);
+	g_free(arena->rows);
+	arena->cells = NULL;
+	arena->views = NULL;
+	arena->rows = NULL;
+	arena->stride = 0;
+	arena->rows_cap = 0;
+}
+
+/*
+ * term_arena_resize:
+ *
+ * Resizes an arena holding @old_rows rows to @cols x @rows. Rows
+ * that survive keep their content (truncated or blank-extended);
+ * rows that come into use start blank. When the new size fits the
+ * existing capacity the views are just re-lengthened in place and
+ * nothing is allocated; otherwise a larger arena is built and the
+ * surviving rows are copied into it in screen order.
+ */
+static void
+term_arena_resize(
+    TermArena   *arena,
+    gint        old_rows,
+    gint        cols,
+    gint        rows
 ){
+	TermArena grown;
+	GstLine *line;
+	gint old_len;
 	gint i;
 
-	if (screen == NULL) {
+	if (cols <= arena->stride && rows <= arena->rows_cap) {
+		for (i = 0; i < rows; i++) {
+			line = arena->rows[i];
+			if (i >= old_rows) {
+				line->len = cols;
+				line->flags = GST_LINE_FLAG_NONE;
+				gst_line_clear(line);
+				continue;
+			}
+			old_len = line->len;
+			line->len = cols;
+			if (cols > old_len) {
+				gst_line_clear_range(line, old_len, cols);
+			}
+			gst_line_set_dirty(line, TRUE);
+		}
 		return;
 	}
-	for (i = 0; i < rows; i++) {
-		gst_line_free(screen[i]);
+
+	term_arena_alloc(&grown, MAX(cols, arena->stride),
+	                 MAX(rows, arena->rows_cap), cols);
+
+	for (i = 0; i < MIN(old_rows, rows); i++) {
+		line = arena->rows[i];
+		memcpy(grown.rows[i]->glyphs, line->glyphs,
+		       sizeof(GstGlyph) * (gsize)MIN(line->len, cols));
+		grown.rows[i]->flags = line->flags;
+		gst_line_set_dirty(grown.rows[i], TRUE);
 	}
-	g_free(screen);
+
+	term_arena_free(arena);
+	*arena = grown;
 }
 
 static void
@@ -461,8 +606,10 @@ gst_terminal_init_screen(GstTerminal *term)
 		return;
 	}
 
-	priv->primary = gst_terminal_alloc_screen(priv->cols, priv->rows);
-	priv->alt = gst_terminal_alloc_screen(priv->cols, priv->rows);
+	term_arena_alloc(&priv->primary_arena, priv->cols, priv->rows, priv->cols);
+	term_arena_alloc(&priv->alt_arena, priv->cols, priv->rows, priv->cols);
+	priv->primary = priv->primary_arena.rows;
+	priv->alt = priv->alt_arena.rows;
 	priv->screen = priv->primary;
 
 	priv->scroll_top = 0;
@@ -521,9 +668,6 @@ gst_terminal_resize(
     gint        rows
 ){
 	GstTerminalPrivate *priv;
-	GstLine **new_primary;
-	GstLine **new_alt;
-	gint copy_rows;
 	gint i;
 
 	g_return_if_fail(GST_IS_TERMINAL(term));
@@ -538,26 +682,18 @@ gst_terminal_resize(
 
 	gst_terminal_init_screen(term);
 
-	new_primary = gst_terminal_alloc_screen(cols, rows);
-	new_alt = gst_terminal_alloc_screen(cols, rows);
-
-	copy_rows = MIN(priv->rows, rows);
+	/* Pending scrolled-out lines are still at the old width */
+	term_flush_scrolled_out(term);
+	term_arena_free(&priv->out_arena);
 
-	for (i = 0; i < copy_rows; i++) {
-		gst_line_free(new_primary[i]);
-		new_primary[i] = gst_line_copy(priv->primary[i]);
-		gst_line_resize(new_primary[i], cols);
-
-		gst_line_free(new_alt[i]);
-		new_alt[i] = gst_line_copy(priv->alt[i]);
-		gst_line_resize(new_alt[i], cols);
-	}
+	/* Resize in place when the arenas have room, else grow them */
+	term_arena_resize(&priv->primary_arena, priv->rows, cols, rows);
+	term_arena_resize(&priv->alt_arena, priv->rows, cols, rows);
 
-	gst_terminal_free_screen(priv->primary, priv->rows);
-	gst_terminal_free_screen(priv->alt, priv->rows);
-
-	priv->primary = new_primary;
-	priv->alt = new_alt;
+	priv->primary = priv->primary_arena.rows;
+	priv->alt = priv->alt_arena.rows;
+	priv->n_scroll_ops = 0;
+	priv->scroll_log_closed = TRUE;
 	priv->screen = (priv->mode & GST_MODE_ALTSCREEN) ? priv->alt : priv->primary;
 
 	priv->cols = cols;
@@ -869,7 +1005,7 @@ gst_terminal_reset(
 	gst_glyph_reset(&priv->cursor.glyph);
 
 	priv->mode = GST_MODE_WRAP | GST_MODE_UTF8;
-	priv->esc = 0;
+	gst_escape_parser_reset(priv->parser);
 	priv->scroll_top = 0;
 	priv->scroll_bot = priv->rows - 1;
 
@@ -902,7 +1038,8 @@ gst_terminal_reset(
 		}
 	}
 
-	priv->dirty = TRUE;
+	/* The active screen may have changed under the renderer */
+	gst_terminal_mark_dirty(term, -1);
 }
 
 void
@@ -950,6 +1087,138 @@ gst_terminal_clear_region(
 	priv->dirty = TRUE;
 }
 
+/*
+ * term_flush_scrolled_out:
+ *
+ * Emits the lines buffered during a write as one lines-scrolled-out
+ * batch and empties the buffer.
+ */
+static void
+term_flush_scrolled_out(GstTerminal *term)
+{
+	GstTerminalPrivate *priv;
+	gint n;
+
+	priv = term->priv;
+	if (priv->n_out == 0) {
+		return;
+	}
+
+	/* Reset first: a handler may write to the terminal */
+	n = priv->n_out;
+	priv->n_out = 0;
+	g_signal_emit(term, signals[SIGNAL_LINES_SCROLLED_OUT], 0,
+		priv->out_arena.rows, n, priv->out_arena.stride);
+}
+
+/*
+ * term_scrolled_out:
+ *
+ * Reports the @n screen rows starting at @top as scrolled out. The
+ * per-line signal is emitted only when something listens to it.
+ * Inside a write the rows are copied into the batch buffer, since
+ * the caller is about to clear them; otherwise they are emitted as
+ * a batch in place.
+ */
+static void
+term_scrolled_out(
+    GstTerminal *term,
+    gint        top,
+    gint        n
+){
+	GstTerminalPrivate *priv;
+	gint i;
+
+	priv = term->priv;
+
+	if (g_signal_has_handler_pending(term,
+			signals[SIGNAL_LINE_SCROLLED_OUT], 0, FALSE))
+	{
+		for (i = top; i < top + n; i++) {
+			g_signal_emit(term, signals[SIGNAL_LINE_SCROLLED_OUT], 0,
+				priv->screen[i], priv->cols);
+		}
+	}
+
+	if (!g_signal_has_handler_pending(term,
+			signals[SIGNAL_LINES_SCROLLED_OUT], 0, FALSE))
+	{
+		return;
+	}
+
+	if (priv->write_depth == 0) {
+		g_signal_emit(term, signals[SIGNAL_LINES_SCROLLED_OUT], 0,
+			&priv->screen[top], n, priv->cols);
+		return;
+	}
+
+	if (priv->out_arena.cells == NULL) {
+		term_arena_alloc(&priv->out_arena, priv->cols, OUT_BATCH_MAX,
+			priv->cols);
+	}
+
+	for (i = top; i < top + n; i++) {
+		GstLine *src;
+		GstLine *dst;
+
+		if (priv->n_out == OUT_BATCH_MAX) {
+			term_flush_scrolled_out(term);
+		}
+
+		src = priv->screen[i];
+		dst = priv->out_arena.rows[priv->n_out++];
+		memcpy(dst->glyphs, src->glyphs,
+			sizeof(GstGlyph) * (gsize)MIN(src->len, dst->len));
+		dst->flags = src->flags;
+	}
+}
+
+/*
+ * term_log_scroll:
+ *
+ * Records a scroll of rows [top, bot] by @n (positive = up) in the
+ * scroll log, merging it into the previous entry when both move the
+ * same region in the same direction. Returns FALSE when the log is
+ * closed, in which case the caller must mark the moved lines dirty.
+ */
+static gboolean
+term_log_scroll(
+    GstTerminalPrivate  *priv,
+    gint                top,
+    gint                bot,
+    gint                n
+){
+	GstScrollOp *op;
+	gint height;
+
+	if (priv->scroll_log_closed) {
+		return FALSE;
+	}
+
+	height = bot - top + 1;
+
+	if (priv->n_scroll_ops > 0) {
+		op = &priv->scroll_log[priv->n_scroll_ops - 1];
+		if (op->top == top && op->bot == bot
+		    && (op->n > 0) == (n > 0))
+		{
+			op->n = CLAMP(op->n + n, -height, height);
+			return TRUE;
+		}
+	}
+
+	if (priv->n_scroll_ops >= GST_SCROLL_LOG_MAX) {
+		priv->scroll_log_closed = TRUE;
+		return FALSE;
+	}
+
+	op = &priv->scroll_log[priv->n_scroll_ops++];
+	op->top = top;
+	op->bot = bot;
+	op->n = CLAMP(n, -height, height);
+	return TRUE;
+}
+
 void
 gst_terminal_scroll_up(
     GstTerminal *term,
@@ -959,6 +1228,7 @@ gst_terminal_scroll_up(
 	GstTerminalPrivate *priv;
 	gint i;
 	GstLine *tmp;
+	gboolean logged;
 
 	g_return_if_fail(GST_IS_TERMINAL(term));
 	g_return_if_fail(n > 0);
@@ -969,22 +1239,21 @@ gst_terminal_scroll_up(
 	orig = CLAMP(orig, priv->scroll_top, priv->scroll_bot);
 	n = MIN(n, priv->scroll_bot - orig + 1);
 
-	/* Emit line-scrolled-out for lines about to be overwritten */
+	/* Report the lines about to be overwritten */
 	if (orig == priv->scroll_top)
 	{
-		for (i = orig; i < orig + n; i++)
-		{
-			g_signal_emit(term, signals[SIGNAL_LINE_SCROLLED_OUT], 0,
-				priv->screen[i], priv->cols);
-		}
+		term_scrolled_out(term, orig, n);
 	}
 
 	/* Rotate lines up within the scroll region */
+	logged = term_log_scroll(priv, orig, priv->scroll_bot, n);
 	for (i = orig; i <= priv->scroll_bot - n; i++) {
 		tmp = priv->screen[i];
 		priv->screen[i] = priv->screen[i + n];
 		priv->screen[i + n] = tmp;
-		gst_line_set_dirty(priv->screen[i], TRUE);
+		if (!logged) {
+			gst_line_set_dirty(priv->screen[i], TRUE);
+		}
 	}
 
 	/* Clear the bottom lines */
@@ -1005,6 +1274,7 @@ gst_terminal_scroll_down(
 	GstTerminalPrivate *priv;
 	gint i;
 	GstLine *tmp;
+	gboolean logged;
 
 	g_return_if_fail(GST_IS_TERMINAL(term));
 	g_return_if_fail(n > 0);
@@ -1015,11 +1285,14 @@ gst_terminal_scroll_down(
 	orig = CLAMP(orig, priv->scroll_top, priv->scroll_bot);
 	n = MIN(n, priv->scroll_bot - orig + 1);
 
+	logged = term_log_scroll(priv, orig, priv->scroll_bot, -n);
 	for (i = priv->scroll_bot; i >= orig + n; i--) {
 		tmp = priv->screen[i];
 		priv->screen[i] = priv->screen[i - n];
 		priv->screen[i - n] = tmp;
-		gst_line_set_dirty(priv->screen[i], TRUE);
+		if (!logged) {
+			gst_line_set_dirty(priv->screen[i], TRUE);
+		}
 	}
 
 	for (i = orig; i < orig + n; i++) {
@@ -1280,6 +1553,9 @@ gst_terminal_mark_dirty(
 	gst_terminal_init_screen(term);
 
 	if (row < 0) {
+		/* Everything is repainted, so the scroll log has no use */
+		priv->scroll_log_closed = TRUE;
+		priv->n_scroll_ops = 0;
 		for (i = 0; i < priv->rows; i++) {
 			gst_line_set_dirty(priv->screen[i], TRUE);
 		}
@@ -1302,9 +1578,37 @@ gst_terminal_clear_dirty(GstTerminal *term)
 	for (i = 0; i < priv->rows; i++) {
 		gst_line_set_dirty(priv->screen[i], FALSE);
 	}
+	priv->n_scroll_ops = 0;
+	priv->scroll_log_closed = FALSE;
 	priv->dirty = FALSE;
 }
 
+/**
+ * gst_terminal_get_scroll_log:
+ * @term: a #GstTerminal
+ * @n_ops: (out): number of entries
+ *
+ * Gets the scrolls performed since the last gst_terminal_clear_dirty().
+ * Rows moved by these scrolls are not marked dirty on their own: a
+ * renderer that keeps the previous frame must replay the log on it
+ * (shifting pixels of rows [top, bot] by n rows) before drawing the
+ * dirty lines. A renderer that cannot do that should call
+ * gst_terminal_mark_dirty() for the rows of each entry instead.
+ *
+ * Returns: (transfer none) (array length=n_ops): the log entries
+ */
+const GstScrollOp *
+gst_terminal_get_scroll_log(
+    GstTerminal *term,
+    guint       *n_ops
+){
+	g_return_val_if_fail(GST_IS_TERMINAL(term), NULL);
+	g_return_val_if_fail(n_ops != NULL, NULL);
+
+	*n_ops = term->priv->n_scroll_ops;
+	return term->priv->scroll_log;
+}
+
 gboolean
 gst_terminal_is_altscreen(GstTerminal *term)
 {
@@ -1370,7 +1674,8 @@ term_setchar(
 		}
 	}
 
-	gst_line_set_dirty(line, TRUE);
+	/* Damage covers the wide-char partner blanked above */
+	gst_line_mark_dirty_range(line, x - 1, x + 2);
 
 	g->rune = u;
 	g->attr = attr->attr;
@@ -1714,45 +2019,6 @@ term_setmode(
 	}
 }
 
-/*
- * term_csiparse:
- *
- * Parse CSI buffer into args and mode bytes.
- */
-static void
-term_csiparse(GstTerminal *term)
-{
-	GstTerminalPrivate *priv = term->priv;
-	gchar *p = priv->csi_buf;
-	glong v;
-
-	priv->csi_nargs = 0;
-	priv->csi_priv = 0;
-	memset(priv->csi_args, 0, sizeof(priv->csi_args));
-
-	if (*p == '?') {
-		priv->csi_priv = 1;
-		p++;
-	}
-
-	priv->csi_buf[priv->csi_len] = '\0';
-
-	while (p < priv->csi_buf + priv->csi_len) {
-		v = strtol(p, &p, 10);
-		if (v == G_MAXLONG || v == G_MINLONG) {
-			v = -1;
-		}
-		priv->csi_args[priv->csi_nargs++] = (gint)v;
-		if (*p != ';' || priv->csi_nargs == GST_MAX_ARGS) {
-			break;
-		}
-		p++;
-	}
-
-	priv->csi_mode[0] = *p++;
-	priv->csi_mode[1] = (p < priv->csi_buf + priv->csi_len) ? *p : '\0';
-}
-
 /*
  * term_csihandle:
  *
@@ -1764,7 +2030,6 @@ term_csihandle(GstTerminal *term)
 	GstTerminalPrivate *priv = term->priv;
 	gchar cmd;
 
-	term_csiparse(term);
 	cmd = priv->csi_mode[0];
 
 	switch (cmd) {
@@ -1906,7 +2171,7 @@ term_csihandle(GstTerminal *term)
 		if (priv->lastc != 0) {
 			gint count = DEFAULT(priv->csi_args[0], 1);
 			while (count-- > 0) {
-				gst_terminal_put_char(term, priv->lastc);
+				gst_escape_machine_put(priv->esc, priv->lastc);
 			}
 		}
 		break;
@@ -1965,8 +2230,8 @@ term_csihandle(GstTerminal *term)
 			gint top, bot;
 			/*
 			 * CSI r with no numeric args resets scroll region.
-			 * strtol always produces nargs >= 1 (parsing the
-			 * final byte yields 0), so check args[0] == 0 too.
+			 * The parser always reports nargs >= 1 (omitted
+			 * parameters read as 0), so check args[0] == 0 too.
 			 */
 			if (priv->csi_nargs <= 1 && priv->csi_args[0] == 0) {
 				top = 0;
@@ -2065,7 +2330,8 @@ term_strhandle(GstTerminal *term)
 	GstTerminalPrivate *priv = term->priv;
 	gint par;
 
-	priv->esc &= ~(GST_ESC_STR_END | GST_ESC_STR);
+	/* Modules handling the string must see the scrollback up to here */
+	term_flush_scrolled_out(term);
 
 	g_debug("term_strhandle: type='%c' len=%zu buf=%.40s",
 		priv->str_type, priv->str_len,
@@ -2171,38 +2437,20 @@ term_strhandle(GstTerminal *term)
 }
 
 /*
- * term_strsequence:
+ * term_str_start:
  *
- * Initialize a string escape sequence from a C1 code.
+ * Parser action: begin a string escape sequence (OSC, DCS, APC,
+ * PM or old-style title). @type is the 7-bit introducer.
  */
 static void
-term_strsequence(
-    GstTerminal *term,
-    guchar      c
+term_str_start(
+    gpointer    user_data,
+    gchar       type
 ){
+	GstTerminal *term = (GstTerminal *)user_data;
 	GstTerminalPrivate *priv = term->priv;
 
-	priv->esc &= ~(GST_ESC_CSI | GST_ESC_ALTCHARSET | GST_ESC_TEST);
-	priv->esc |= GST_ESC_STR;
-
-	switch (c) {
-	case 0x90: /* DCS */
-		priv->str_type = 'P';
-		break;
-	case 0x9d: /* OSC */
-		priv->str_type = ']';
-		break;
-	case 0x9e: /* PM */
-		priv->str_type = '^';
-		break;
-	case 0x9f: /* APC */
-		priv->str_type = '_';
-		break;
-	default:
-		priv->str_type = c;
-		break;
-	}
-
+	priv->str_type = type;
 	priv->str_len = 0;
 	priv->str_nargs = 0;
 
@@ -2213,6 +2461,71 @@ term_strsequence(
 	}
 }
 
+/*
+ * term_str_put:
+ *
+ * Parser action: append one codepoint of string payload. In UTF-8
+ * mode non-ASCII codepoints are stored UTF-8 encoded so titles and
+ * module payloads round-trip intact.
+ */
+static void
+term_str_put(
+    gpointer    user_data,
+    GstRune     rune
+){
+	GstTerminal *term = (GstTerminal *)user_data;
+	GstTerminalPrivate *priv = term->priv;
+	gchar enc[6];
+	gsize n;
+
+	if (priv->str_buf == NULL) {
+		return;
+	}
+
+	if (rune < 0x80 || !(priv->mode & GST_MODE_UTF8)) {
+		enc[0] = (gchar)rune;
+		n = 1;
+	} else {
+		n = (gsize)g_unichar_to_utf8((gunichar)rune, enc);
+	}
+
+	if (priv->str_len + n <= GST_MAX_STR_LEN) {
+		/* Grow buffer if needed (keep room for the NUL) */
+		while (priv->str_len + n >= priv->str_siz) {
+			priv->str_siz *= 2;
+			priv->str_buf = g_realloc(priv->str_buf, priv->str_siz);
+		}
+		memcpy(priv->str_buf + priv->str_len, enc, n);
+		priv->str_len += n;
+	} else if (priv->str_len <= GST_MAX_STR_LEN) {
+		g_warning("escape string buffer overflow "
+			"(%d bytes, type='%c')",
+			GST_MAX_STR_LEN, priv->str_type);
+		priv->str_len = GST_MAX_STR_LEN + 1; /* prevent repeated warnings */
+	}
+}
+
+/*
+ * term_str_end:
+ *
+ * Parser action: the string was terminated by BEL, ST, ESC,
+ * CAN or SUB. Dispatches it.
+ */
+static void
+term_str_end(gpointer user_data)
+{
+	GstTerminal *term = (GstTerminal *)user_data;
+	GstTerminalPrivate *priv = term->priv;
+
+	/* Drop strings that overflowed rather than dispatch a truncation */
+	if (priv->str_len > GST_MAX_STR_LEN) {
+		priv->str_len = 0;
+		return;
+	}
+
+	term_strhandle(term);
+}
+
 /*
  * term_deftran:
  *
@@ -2286,71 +2599,61 @@ term_dectest(
 }
 
 /*
- * term_eschandle:
+ * term_esc_dispatch:
  *
- * Handle ESC-prefixed sequences. Returns 1 if the sequence is complete,
- * 0 if more bytes are needed.
+ * Parser action: handle a complete ESC sequence. @intermediate
+ * selects the charset designation ('(' ')' '*' '+'), UTF-8 mode
+ * ('%') and DEC test ('#') families; 0 means a plain ESC <final>.
  */
-static gint
-term_eschandle(
-    GstTerminal *term,
-    guchar      c
+static void
+term_esc_dispatch(
+    gpointer    user_data,
+    gchar       intermediate,
+    gchar       final
 ){
+	GstTerminal *term = (GstTerminal *)user_data;
 	GstTerminalPrivate *priv = term->priv;
 
-	switch (c) {
-	case '[': /* CSI */
-		priv->esc |= GST_ESC_CSI;
-		return 0;
-
-	case '#': /* DEC test */
-		priv->esc |= GST_ESC_TEST;
-		return 0;
-
-	case '%': /* UTF-8 mode */
-		priv->esc |= GST_ESC_UTF8;
-		return 0;
-
-	case 'P': /* DCS - Device Control String */
-	case '_': /* APC - Application Program Command */
-	case '^': /* PM - Privacy Message */
-	case ']': /* OSC - Operating System Command */
-	case 'k': /* Old title set */
-		term_strsequence(term, c);
-		return 0;
-
+	switch (intermediate) {
 	case '(': /* GZD4 - set G0 charset */
-		priv->icharset = 0;
-		priv->esc |= GST_ESC_ALTCHARSET;
-		return 0;
 	case ')': /* G1D4 - set G1 charset */
-		priv->icharset = 1;
-		priv->esc |= GST_ESC_ALTCHARSET;
-		return 0;
 	case '*': /* G2D4 - set G2 charset */
-		priv->icharset = 2;
-		priv->esc |= GST_ESC_ALTCHARSET;
-		return 0;
 	case '+': /* G3D4 - set G3 charset */
-		priv->icharset = 3;
-		priv->esc |= GST_ESC_ALTCHARSET;
-		return 0;
+		priv->icharset = intermediate - '(';
+		term_deftran(term, final);
+		return;
 
+	case '%': /* UTF-8 mode */
+		term_defutf8(term, final);
+		return;
+
+	case '#': /* DEC test */
+		term_dectest(term, final);
+		return;
+
+	case 0:
+		break;
+
+	default:
+		return;
+	}
+
+	switch (final) {
 	case 'D': /* IND - Index (move cursor down, scroll if at bottom) */
 		if (priv->cursor.y == priv->scroll_bot) {
 			gst_terminal_scroll_up(term, priv->scroll_top, 1);
 		} else {
 			gst_terminal_move_to(term, priv->cursor.x, priv->cursor.y + 1);
 		}
-		return 1;
+		break;
 
 	case 'E': /* NEL - Next Line */
 		gst_terminal_newline(term, TRUE);
-		return 1;
+		break;
 
 	case 'H': /* HTS - Horizontal Tab Stop */
 		priv->tabs[priv->cursor.x] = TRUE;
-		return 1;
+		break;
 
 	case 'M': /* RI - Reverse Index */
 		if (priv->cursor.y == priv->scroll_top) {
@@ -2358,264 +2661,174 @@ term_eschandle(
 		} else {
 			gst_terminal_move_to(term, priv->cursor.x, priv->cursor.y - 1);
 		}
-		return 1;
+		break;
 
 	case 'Z': /* DECID - Identify terminal */
 		term_response(term, "\033[?6c", -1);
-		return 1;
+		break;
 
 	case 'c': /* RIS - Full reset */
 		gst_terminal_reset(term, TRUE);
-		return 1;
+		break;
 
 	case '=': /* DECPAM - Application keypad */
 		gst_terminal_set_mode(term, GST_MODE_APPKEYPAD, TRUE);
-		return 1;
+		break;
 
 	case '>': /* DECPNM - Normal keypad */
 		gst_terminal_set_mode(term, GST_MODE_APPKEYPAD, FALSE);
-		return 1;
+		break;
 
 	case '7': /* DECSC - Save cursor */
 		gst_terminal_cursor_save(term);
-		return 1;
+		break;
 
 	case '8': /* DECRC - Restore cursor */
 		gst_terminal_cursor_restore(term);
-		return 1;
+		break;
 
 	case 'n': /* LS2 - Locking Shift 2 */
 		priv->charset_gl = 2;
-		return 1;
+		break;
 
 	case 'o': /* LS3 - Locking Shift 3 */
 		priv->charset_gl = 3;
-		return 1;
-
-	case '\\': /* ST - String Terminator */
-		if (priv->esc & GST_ESC_STR_END) {
-			term_strhandle(term);
-		}
-		return 1;
+		break;
 
+	case '\\': /* ST - the string it ends was already dispatched on ESC */
 	default:
-		return 1;
+		break;
 	}
 }
 
 /*
- * term_controlcode:
+ * term_csi_dispatch:
  *
- * Handle C0/C1 control codes. Port of st's tcontrolcode().
+ * Parser action: load a complete CSI sequence into the terminal's
+ * csi_* fields and run it. Sequences with a private marker other
+ * than '?' are not implemented and are ignored.
  */
 static void
-term_controlcode(
-    GstTerminal *term,
-    guchar      c
+term_csi_dispatch(
+    gpointer                user_data,
+    const GstEscapeParams   *params,
+    gchar                   final
 ){
+	GstTerminal *term = (GstTerminal *)user_data;
 	GstTerminalPrivate *priv = term->priv;
 
-	switch (c) {
+	if (params->prefix != 0 && params->prefix != '?') {
+		return;
+	}
+
+	memcpy(priv->csi_args, params->args, sizeof(priv->csi_args));
+	priv->csi_nargs = params->nargs;
+	priv->csi_priv = (params->prefix == '?');
+
+	/* Intermediate-qualified commands switch on the intermediate */
+	if (params->intermediate != 0) {
+		priv->csi_mode[0] = params->intermediate;
+		priv->csi_mode[1] = final;
+	} else {
+		priv->csi_mode[0] = final;
+		priv->csi_mode[1] = '\0';
+	}
+
+	term_csihandle(term);
+}
+
+/*
+ * term_execute:
+ *
+ * Parser action: handle C0/C1 control codes. Port of st's
+ * tcontrolcode(). ESC, CAN, SUB and the string/CSI introducers
+ * are state transitions and never reach here.
+ */
+static void
+term_execute(
+    gpointer    user_data,
+    GstRune     code
+){
+	GstTerminal *term = (GstTerminal *)user_data;
+	GstTerminalPrivate *priv = term->priv;
+
+	switch (code) {
 	case '\t': /* TAB (HT) */
 		gst_terminal_put_tab(term, 1);
-		return;
+		break;
 
 	case '\n':   /* LF */
 	case '\x0b': /* VT */
 	case '\x0c': /* FF */
 		/* CRLF mode: also do CR */
 		gst_terminal_newline(term, (priv->mode & GST_MODE_CRLF) != 0);
-		return;
+		break;
 
 	case '\r': /* CR */
 		gst_terminal_move_to(term, 0, priv->cursor.y);
-		return;
+		break;
 
 	case '\b': /* BS */
 		gst_terminal_move_to(term, priv->cursor.x - 1, priv->cursor.y);
-		return;
+		break;
 
 	case '\a': /* BEL */
-		if (priv->esc & GST_ESC_STR) {
-			/* BEL terminates OSC string */
-			priv->esc &= ~(GST_ESC_START | GST_ESC_STR);
-			priv->esc |= GST_ESC_STR_END;
-			term_strhandle(term);
+		g_signal_emit(term, signals[SIGNAL_BELL], 0);
+		break;
+
+	case 0x84: /* IND */
+		if (priv->cursor.y == priv->scroll_bot) {
+			gst_terminal_scroll_up(term, priv->scroll_top, 1);
 		} else {
-			g_signal_emit(term, signals[SIGNAL_BELL], 0);
+			gst_terminal_move_to(term, priv->cursor.x, priv->cursor.y + 1);
 		}
-		return;
+		break;
 
-	case '\x1b': /* ESC */
-		priv->csi_len = 0;
-		priv->csi_mode[0] = 0;
-		priv->csi_mode[1] = 0;
-		priv->esc &= ~(GST_ESC_CSI | GST_ESC_ALTCHARSET | GST_ESC_TEST);
-		priv->esc |= GST_ESC_START;
-		return;
+	case 0x85: /* NEL */
+		gst_terminal_newline(term, TRUE);
+		break;
 
-	case '\x00': /* NUL - ignored */
-	case '\x05': /* ENQ - ignored */
-	case '\x11': /* XON - ignored */
-	case '\x13': /* XOFF - ignored */
-		return;
+	case 0x88: /* HTS */
+		priv->tabs[priv->cursor.x] = TRUE;
+		break;
 
-	case '\x18': /* CAN */
-	case '\x1a': /* SUB */
-		priv->esc = 0;
-		return;
+	case 0x8d: /* RI */
+		if (priv->cursor.y == priv->scroll_top) {
+			gst_terminal_scroll_down(term, priv->scroll_top, 1);
+		} else {
+			gst_terminal_move_to(term, priv->cursor.x, priv->cursor.y - 1);
+		}
+		break;
 
-	case 0x7f: /* DEL - ignored */
-		return;
+	case 0x9a: /* DECID */
+		term_response(term, "\033[?6c", -1);
+		break;
 
 	default:
+		/* NUL, ENQ, XON, XOFF and the rest are ignored */
 		break;
 	}
-
-	/* C1 control codes (0x80 - 0x9f) */
-	if (BETWEEN(c, 0x80, 0x9f)) {
-		switch (c) {
-		case 0x84: /* IND */
-			if (priv->cursor.y == priv->scroll_bot) {
-				gst_terminal_scroll_up(term, priv->scroll_top, 1);
-			} else {
-				gst_terminal_move_to(term, priv->cursor.x, priv->cursor.y + 1);
-			}
-			break;
-		case 0x85: /* NEL */
-			gst_terminal_newline(term, TRUE);
-			break;
-		case 0x88: /* HTS */
-			priv->tabs[priv->cursor.x] = TRUE;
-			break;
-		case 0x8d: /* RI */
-			if (priv->cursor.y == priv->scroll_top) {
-				gst_terminal_scroll_down(term, priv->scroll_top, 1);
-			} else {
-				gst_terminal_move_to(term, priv->cursor.x, priv->cursor.y - 1);
-			}
-			break;
-		case 0x9a: /* DECID */
-			term_response(term, "\033[?6c", -1);
-			break;
-		case 0x90: /* DCS */
-		case 0x9d: /* OSC */
-		case 0x9e: /* PM */
-		case 0x9f: /* APC */
-			term_strsequence(term, c);
-			break;
-		default:
-			break;
-		}
-	}
 }
 
 /* ===== Main Character Input (tputc equivalent) ===== */
 
-void
-gst_terminal_put_char(
-    GstTerminal *term,
+/*
+ * term_print:
+ *
+ * Parser action: place a printable codepoint at the cursor,
+ * handling combining characters, autowrap, insert mode and
+ * wide characters.
+ */
+static void
+term_print(
+    gpointer    user_data,
     GstRune     rune
 ){
-	GstTerminalPrivate *priv;
+	GstTerminal *term = (GstTerminal *)user_data;
+	GstTerminalPrivate *priv = term->priv;
 	GstLine *line;
 	gint width;
 
-	g_return_if_fail(GST_IS_TERMINAL(term));
-
-	priv = term->priv;
-	gst_terminal_init_screen(term);
-
-	/*
-	 * STR (string) state handling:
-	 * Accumulate bytes until terminator (BEL, ESC \, or cancel codes).
-	 */
-	if (priv->esc & GST_ESC_STR) {
-		if (rune == '\a' || rune == 0x18 || rune == 0x1a ||
-		    (rune == 0x1b && !(priv->esc & GST_ESC_STR_END))) {
-			/* BEL or cancel terminates the string */
-			if (rune == '\a' || rune == 0x18 || rune == 0x1a) {
-				priv->esc &= ~(GST_ESC_START | GST_ESC_STR);
-				priv->esc |= GST_ESC_STR_END;
-			}
-			term_strhandle(term);
-			return;
-		}
-
-		if (priv->esc & GST_ESC_STR_END) {
-			/* Expected ESC \ for proper ST */
-			priv->esc = 0;
-			term_strhandle(term);
-			return;
-		}
-
-		if (rune == '\033') {
-			/* ESC during string -> expect \ for ST */
-			priv->esc |= GST_ESC_STR_END;
-			return;
-		}
-
-		/* Accumulate byte into string buffer */
-		if (priv->str_buf != NULL && priv->str_len < GST_MAX_STR_LEN) {
-			/* Grow buffer if needed */
-			if (priv->str_len + 1 >= priv->str_siz) {
-				priv->str_siz *= 2;
-				priv->str_buf = g_realloc(priv->str_buf, priv->str_siz);
-			}
-			priv->str_buf[priv->str_len++] = (gchar)rune;
-		} else if (priv->str_buf != NULL &&
-			   priv->str_len == GST_MAX_STR_LEN)
-		{
-			g_warning("escape string buffer overflow "
-				"(%d bytes, type='%c')",
-				GST_MAX_STR_LEN, priv->str_type);
-			priv->str_len++; /* prevent repeated warnings */
-		}
-		return;
-	}
-
-	/* Handle control characters (< 0x20, 0x7f, or C1 0x80-0x9f) */
-	if (ISCONTROL(rune)) {
-		term_controlcode(term, (guchar)rune);
-		/* Control chars don't modify lastc */
-		return;
-	}
-
-	/* If in escape state, handle the escape sequence */
-	if (priv->esc & GST_ESC_START) {
-		if (priv->esc & GST_ESC_CSI) {
-			/* Accumulate CSI bytes */
-			priv->csi_buf[priv->csi_len++] = (gchar)rune;
-
-			/* Check for final byte (0x40-0x7e) */
-			if (BETWEEN(rune, 0x40, 0x7e) ||
-			    priv->csi_len >= (gsize)(CSI_BUF_SIZ - 1)) {
-				priv->esc = 0;
-				term_csihandle(term);
-			}
-			return;
-		} else if (priv->esc & GST_ESC_UTF8) {
-			term_defutf8(term, (gchar)rune);
-		} else if (priv->esc & GST_ESC_ALTCHARSET) {
-			term_deftran(term, (gchar)rune);
-		} else if (priv->esc & GST_ESC_TEST) {
-			term_dectest(term, (gchar)rune);
-		} else {
-			if (!term_eschandle(term, (guchar)rune)) {
-				/* Sequence needs more bytes */
-				return;
-			}
-		}
-
-		/* Sequence complete */
-		priv->esc = 0;
-		return;
-	}
-
-	/*
-	 * Normal character output
-	 */
-
 	/*
 	 * Get Unicode width via wcwidth (through gst_wcwidth).
 	 * This matches st's behavior: ambiguous-width characters
@@ -2642,7 +2855,8 @@ gst_terminal_put_char(
 			}
 			line = priv->screen[priv->cursor.y];
 			if (line != NULL) {
-				gst_line_set_dirty(line, TRUE);
+				gst_line_mark_dirty_range(line, priv->cursor.x - 1,
+				    priv->cursor.x);
 			}
 		}
 		return;
@@ -2692,6 +2906,8 @@ gst_terminal_put_char(
 			if (dummy != NULL) {
 				dummy->rune = '\0';
 				dummy->attr = GST_GLYPH_ATTR_WDUMMY;
+				gst_line_mark_dirty_range(priv->screen[priv->cursor.y],
+				    priv->cursor.x + 1, priv->cursor.x + 2);
 			}
 		}
 	}
@@ -2711,6 +2927,238 @@ gst_terminal_put_char(
 	priv->dirty = TRUE;
 }
 
+void
+gst_terminal_put_char(
+    GstTerminal *term,
+    GstRune     rune
+){
+	g_return_if_fail(GST_IS_TERMINAL(term));
+
+	gst_terminal_init_screen(term);
+	gst_escape_machine_put(term->priv->esc, rune);
+}
+
+/*
+ * term_put_ascii_run:
+ * @term: the terminal
+ * @s: run of printable ASCII bytes (0x20-0x7e)
+ * @n: number of bytes in @s
+ *
+ * Bulk equivalent of calling gst_terminal_put_char() for each byte
+ * of @s. Only valid when no escape sequence is pending, insert mode
+ * is off and the active charset is not DEC graphics: every byte is
+ * then a single-width glyph that needs no translation. Glyphs are
+ * stored straight into the line, with wrap handling, wide-char
+ * cleanup and dirty marking done once per line segment instead of
+ * once per character.
+ */
+static void
+term_put_ascii_run(
+    GstTerminal *term,
+    const gchar *s,
+    gsize       n
+){
+	GstTerminalPrivate *priv = term->priv;
+	const GstGlyph *attr = &priv->cursor.glyph;
+
+	while (n > 0) {
+		GstLine *line;
+		GstGlyph *g;
+		gint x;
+		gint avail;
+		gint chunk;
+		gint i;
+
+		/* Pending wrap from the previous segment or put_char */
+		if (priv->cursor.state & GST_CURSOR_STATE_WRAPNEXT) {
+			line = priv->screen[priv->cursor.y];
+			g = gst_line_get_glyph(line, priv->cols - 1);
+			if (g != NULL) {
+				g->attr |= GST_GLYPH_ATTR_WRAP;
+			}
+			gst_terminal_newline(term, TRUE);
+			priv->cursor.state &= ~GST_CURSOR_STATE_WRAPNEXT;
+		}
+
+		line = priv->screen[priv->cursor.y];
+		x = priv->cursor.x;
+		avail = MIN(priv->cols, line->len) - x;
+		if (avail <= 0) {
+			return;
+		}
+
+		/*
+		 * Without autowrap every byte past the margin lands on the
+		 * last column, so only the final one is visible.
+		 */
+		if (!(priv->mode & GST_MODE_WRAP) && avail == 1 && n > 1) {
+			s += n - 1;
+			n = 1;
+		}
+
+		chunk = (n < (gsize)avail) ? (gint)n : avail;
+		g = &line->glyphs[x];
+
+		/* Overwriting the right half of a wide char blanks its left half */
+		if ((g[0].attr & GST_GLYPH_ATTR_WDUMMY) && x > 0) {
+			g[-1].rune = ' ';
+			g[-1].attr &= ~GST_GLYPH_ATTR_WIDE;
+		}
+
+		/* Overwriting the left half of a wide char blanks its dummy */
+		if ((g[chunk - 1].attr & GST_GLYPH_ATTR_WIDE)
+		    && x + chunk < line->len) {
+			g[chunk].rune = ' ';
+			g[chunk].attr &= ~GST_GLYPH_ATTR_WDUMMY;
+		}
+
+		for (i = 0; i < chunk; i++) {
+			g[i].rune = (GstRune)(guchar)s[i];
+			g[i].attr = attr->attr;
+			g[i].fg = attr->fg;
+			g[i].bg = attr->bg;
+		}
+		gst_line_mark_dirty_range(line, x - 1, x + chunk + 1);
+
+		s += chunk;
+		n -= (gsize)chunk;
+
+		priv->cursor.x = x + chunk;
+		if (priv->cursor.x >= priv->cols) {
+			priv->cursor.x = priv->cols - 1;
+			if (priv->mode & GST_MODE_WRAP) {
+				priv->cursor.state |= GST_CURSOR_STATE_WRAPNEXT;
+			}
+		}
+
+		priv->lastc = (GstRune)(guchar)s[-1];
+	}
+
+	priv->dirty = TRUE;
+}
+
+/*
+ * term_put_utf8_run:
+ * @term: the terminal
+ * @s: run of printable characters, already validated as UTF-8
+ * @n: number of bytes in @s
+ *
+ * Wide-aware sibling of term_put_ascii_run() for runs holding
+ * non-ASCII characters, under the same preconditions. @s holds no
+ * C0 or C1 controls, so every character would only be printed by
+ * the parser and is decoded without checks here. Glyphs go straight
+ * into the line, with the dummy cell of a double-width character set
+ * up as in term_print() and dirty marking done once per line
+ * segment. Combining characters, and wide characters that do not
+ * fit before the margin, are handed to term_print().
+ */
+static void
+term_put_utf8_run(
+    GstTerminal *term,
+    const gchar *s,
+    gsize       n
+){
+	GstTerminalPrivate *priv = term->priv;
+	const GstGlyph *attr = &priv->cursor.glyph;
+	const gchar *end = s + n;
+	GstLine *seg_line = NULL;
+	gint seg_x1 = 0;
+	gint seg_x2 = 0;
+
+	while (s < end) {
+		GstLine *line;
+		GstGlyph *g;
+		GstRune rune;
+		gint width;
+		gint x;
+
+		rune = (GstRune)g_utf8_get_char(s);
+		s = g_utf8_next_char(s);
+
+		width = gst_wcwidth(rune);
+		if (width < 0) {
+			width = 1;
+		}
+
+		/* Flush the segment before the cursor leaves its line */
+		if (seg_line != NULL && (width == 0
+		    || (priv->cursor.state & GST_CURSOR_STATE_WRAPNEXT)
+		    || priv->cursor.x + width > priv->cols)) {
+			gst_line_mark_dirty_range(seg_line, seg_x1 - 1, seg_x2 + 1);
+			seg_line = NULL;
+		}
+
+		/* Pending wrap from the previous character or put_char */
+		if (width > 0 && (priv->cursor.state & GST_CURSOR_STATE_WRAPNEXT)) {
+			line = priv->screen[priv->cursor.y];
+			g = gst_line_get_glyph(line, priv->cols - 1);
+			if (g != NULL) {
+				g->attr |= GST_GLYPH_ATTR_WRAP;
+			}
+			gst_terminal_newline(term, TRUE);
+			priv->cursor.state &= ~GST_CURSOR_STATE_WRAPNEXT;
+		}
+
+		line = priv->screen[priv->cursor.y];
+		x = priv->cursor.x;
+
+		if (width == 0 || x + width > MIN(priv->cols, line->len)) {
+			if (seg_line != NULL) {
+				gst_line_mark_dirty_range(seg_line, seg_x1 - 1, seg_x2 + 1);
+				seg_line = NULL;
+			}
+			term_print(term, rune);
+			continue;
+		}
+
+		g = &line->glyphs[x];
+
+		/* Same partner cleanup as term_setchar() */
+		if (g[0].attr & GST_GLYPH_ATTR_WIDE) {
+			if (x + 1 < priv->cols) {
+				g[1].rune = ' ';
+				g[1].attr &= ~GST_GLYPH_ATTR_WDUMMY;
+			}
+		} else if ((g[0].attr & GST_GLYPH_ATTR_WDUMMY) && x > 0) {
+			g[-1].rune = ' ';
+			g[-1].attr &= ~GST_GLYPH_ATTR_WIDE;
+		}
+
+		g[0].rune = rune;
+		g[0].attr = attr->attr;
+		g[0].fg = attr->fg;
+		g[0].bg = attr->bg;
+
+		if (width == 2) {
+			g[0].attr |= GST_GLYPH_ATTR_WIDE;
+			g[1].rune = '\0';
+			g[1].attr = GST_GLYPH_ATTR_WDUMMY;
+		}
+
+		if (seg_line == NULL) {
+			seg_line = line;
+			seg_x1 = x;
+		}
+		seg_x2 = x + width;
+
+		priv->cursor.x = x + width;
+		if (priv->cursor.x >= priv->cols) {
+			priv->cursor.x = priv->cols - 1;
+			if (priv->mode & GST_MODE_WRAP) {
+				priv->cursor.state |= GST_CURSOR_STATE_WRAPNEXT;
+			}
+		}
+
+		priv->lastc = rune;
+	}
+
+	if (seg_line != NULL) {
+		gst_line_mark_dirty_range(seg_line, seg_x1 - 1, seg_x2 + 1);
+	}
+
+	priv->dirty = TRUE;
+}
+
 /* ===== Terminal Write (Main Input Entry Point) ===== */
 
 void
@@ -2737,6 +3185,7 @@ gst_terminal_write(
 
 	p = data;
 	end = data + len;
+	priv->write_depth++;
 
 	/*
 	 * If we have a partial UTF-8 sequence from the previous write(),
@@ -2770,6 +3219,7 @@ gst_terminal_write(
 			 */
 			memcpy(priv->utf8_partial, combined, (gsize)combined_len);
 			priv->utf8_partial_len = (gint)combined_len;
+			priv->write_depth--;
 			g_signal_emit(term, signals[SIGNAL_CONTENTS_CHANGED], 0);
 			return;
 		}
@@ -2781,7 +3231,7 @@ gst_terminal_write(
 			gint char_len = (gint)(g_utf8_next_char(combined) - combined);
 			gint new_consumed = char_len - (gint)(combined_len - need);
 
-			gst_terminal_put_char(term, (GstRune)rune);
+			gst_escape_machine_put(priv->esc, (GstRune)rune);
 
 			/*
 			 * Advance p past the new bytes that were consumed
@@ -2800,6 +3250,59 @@ gst_terminal_write(
 	while (p < end) {
 		gunichar rune;
 
+		/*
+		 * Fast path: in ground state, runs of printable ASCII
+		 * bypass UTF-8 decoding and the per-character state
+		 * machine and are written to the line in bulk.
+		 */
+		if (BETWEEN((guchar)*p, 0x20, 0x7e)
+		    && gst_escape_machine_is_ground(priv->esc)
+		    && !(priv->mode & GST_MODE_INSERT)
+		    && priv->charsets[priv->charset_gl] != GST_CHARSET_GRAPHIC0)
+		{
+			const gchar *run = p;
+
+			do {
+				p++;
+			} while (p < end && BETWEEN((guchar)*p, 0x20, 0x7e));
+
+			term_put_ascii_run(term, run, (gsize)(p - run));
+			continue;
+		}
+
+		/*
+		 * Same for text with non-ASCII characters: a run of valid,
+		 * printable UTF-8 is validated once here and decoded
+		 * straight into the line. Incomplete or invalid sequences
+		 * and C1 controls end the run and take the slow path.
+		 */
+		if ((guchar)*p >= 0xc2
+		    && (priv->mode & GST_MODE_UTF8)
+		    && gst_escape_machine_is_ground(priv->esc)
+		    && !(priv->mode & GST_MODE_INSERT)
+		    && priv->charsets[priv->charset_gl] != GST_CHARSET_GRAPHIC0)
+		{
+			const gchar *run = p;
+
+			while (p < end) {
+				if (BETWEEN((guchar)*p, 0x20, 0x7e)) {
+					p++;
+					continue;
+				}
+				rune = g_utf8_get_char_validated(p, end - p);
+				if (rune == (gunichar)-1 || rune == (gunichar)-2
+				    || rune < 0xa0) {
+					break;
+				}
+				p = g_utf8_next_char(p);
+			}
+
+			if (p > run) {
+				term_put_utf8_run(term, run, (gsize)(p - run));
+				continue;
+			}
+		}
+
 		if (priv->mode & GST_MODE_UTF8) {
 			/* Decode UTF-8 */
 			rune = g_utf8_get_char_validated(p, end - p);
@@ -2820,15 +3323,17 @@ gst_terminal_write(
 				p++;
 				continue;
 			}
-			gst_terminal_put_char(term, (GstRune)rune);
+			gst_escape_machine_put(priv->esc, (GstRune)rune);
 			p = g_utf8_next_char(p);
 		} else {
 			/* Single-byte mode */
 			rune = (guchar)*p++;
-			gst_terminal_put_char(term, (GstRune)rune);
+			gst_escape_machine_put(priv->esc, (GstRune)rune);
 		}
 	}
 
+	priv->write_depth--;
+	term_flush_scrolled_out(term);
 	g_signal_emit(term, signals[SIGNAL_CONTENTS_CHANGED], 0);
 }
 
@@ -33,6 +33,25 @@ G_BEGIN_DECLS
 
 typedef struct _GstTerminalPrivate GstTerminalPrivate;
 
+/* Scroll operations recorded per frame before falling back to repaints */
+#define GST_SCROLL_LOG_MAX (16)
+
+/**
+ * GstScrollOp:
+ * @top: first row of the scrolled region
+ * @bot: last row of the scrolled region (inclusive)
+ * @n: rows moved; positive scrolls content up, negative down
+ *
+ * One entry of the terminal's scroll log. Replaying the log in
+ * order on the previous frame moves every row that was not
+ * rewritten into its current position.
+ */
+typedef struct {
+    gint top;
+    gint bot;
+    gint n;
+} GstScrollOp;
+
 /**
  * GstTerminal:
  *
@@ -257,6 +276,7 @@ void gst_terminal_set_icon(GstTerminal *term, const gchar *icon);
 gboolean gst_terminal_is_dirty(GstTerminal *term);
 void gst_terminal_mark_dirty(GstTerminal *term, gint row);
 void gst_terminal_clear_dirty(GstTerminal *term);
+const GstScrollOp *gst_terminal_get_scroll_log(GstTerminal *term, guint *n_ops);
 
 /* Screen state */
 
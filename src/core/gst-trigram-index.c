@@ -0,0 +1,1077 @@
+/*
+ * gst-trigram-index.c - Incremental trigram index over lines of text
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Lines are grouped into segments of TRIGRAM_SEGMENT_LINES. The
+ * newest, open segment collects its posting lists in an
+ * open-addressing hash table keyed by trigram. Once full it is
+ * sealed into a sorted key array and one blob of delta-encoded
+ * line offsets, about a byte per posting. Dropping old lines frees
+ * whole sealed segments.
+ *
+ * A trigram key packs three folded 7-bit bytes into 21 bits; a
+ * byte is never 0, so neither is a key.
+ */
+
+#include "gst-trigram-index.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Lines per segment; offsets within one fit a guint16 */
+#define TRIGRAM_SEGMENT_LINES   (4096)
+
+/* Posting lists intersected per segment, shortest first */
+#define TRIGRAM_MAX_LISTS       (8)
+
+/* Initial hash slots of the open segment, a power of two */
+#define TRIGRAM_MIN_SLOTS       (1024)
+
+#define TRIGRAM_KEY(a, b, c) \
+	(((guint32)(a) << 14) | ((guint32)(b) << 7) | (guint32)(c))
+
+/* Posting list of the open segment: line offsets, ascending */
+typedef struct
+{
+	guint32  key;
+	guint16 *offs;
+	guint16  n;
+	guint16  cap;
+} OpenPosting;
+
+/* A full segment of TRIGRAM_SEGMENT_LINES lines */
+typedef struct
+{
+	guint64  base;          /* sequence number of its first line */
+	guint    n_keys;
+	guint32 *keys;          /* sorted */
+	guint32 *starts;        /* n_keys + 1 offsets into postings */
+	guint8  *postings;      /* LEB128 deltas from the previous offset */
+} TrigramSegment;
+
+/* A posting list found by a lookup, in either representation */
+typedef struct
+{
+	const guint16 *offs;    /* open segment, or NULL */
+	const guint8  *data;    /* sealed segment */
+	gsize          size;    /* entries in offs, or bytes of data */
+} PostingRef;
+
+/* The last two bytes seen and how many valid bytes led up to them */
+typedef struct
+{
+	guint8 a;
+	guint8 b;
+	gint   run;
+} Window;
+
+struct _GstTrigramIndex
+{
+	GPtrArray   *segments;  /* sealed TrigramSegments, oldest first */
+	guint64      next_seq;
+	guint64      min_seq;   /* lines below were dropped */
+
+	/* the open segment */
+	guint64      base;      /* sequence number of its first line */
+	guint32     *slot_keys; /* 0 for a free slot */
+	guint32     *slot_post; /* index into posts */
+	guint        n_slots;
+	OpenPosting *posts;
+	guint        n_posts;
+	guint        posts_cap;
+
+	/* lookup scratch */
+	GArray      *keys;      /* guint32 */
+	GArray      *refs;      /* PostingRef */
+	GArray      *cand;      /* guint16 */
+	GArray      *other;     /* guint16 */
+};
+
+/* ===== Folding ===== */
+
+/*
+ * fold_rune:
+ *
+ * Folds a character to the lower-case ASCII byte it is indexed
+ * as, or 0 if it is not indexed. Characters that fold to an ASCII
+ * letter, like the Kelvin sign, count as that letter, so a
+ * caseless query for it still finds them.
+ */
+static guint8
+fold_rune(gunichar rune)
+{
+	gunichar c;
+
+	if (rune == 0) {
+		return ' ';
+	}
+	if (rune < 0x80) {
+		return (guint8)g_ascii_tolower((gchar)rune);
+	}
+
+	c = g_unichar_tolower(rune);
+	if (c < 0x80) {
+		return (guint8)c;
+	}
+	c = g_unichar_tolower(g_unichar_toupper(rune));
+	if (c < 0x80) {
+		return (guint8)c;
+	}
+	return 0;
+}
+
+/*
+ * window_push:
+ *
+ * Shifts folded byte @c into the window. Returns the key of the
+ * trigram it completes, or 0; a 0 byte breaks the sequence.
+ */
+static guint32
+window_push(
+	Window  *w,
+	guint8   c
+){
+	guint32 key;
+
+	if (c == 0) {
+		w->run = 0;
+		return 0;
+	}
+
+	key = (w->run >= 2) ? TRIGRAM_KEY(w->a, w->b, c) : 0;
+	w->a = w->b;
+	w->b = c;
+	w->run++;
+	return key;
+}
+
+/* ===== Open segment ===== */
+
+static guint
+slot_hash(guint32 key)
+{
+	guint32 h;
+
+	h = key * 2654435761u;
+	return (guint)(h ^ (h >> 16));
+}
+
+/* Doubles the hash table and reinserts every posting list */
+static void
+open_grow(GstTrigramIndex *index)
+{
+	guint mask;
+	guint slot;
+	guint i;
+
+	index->n_slots *= 2;
+	g_free(index->slot_keys);
+	g_free(index->slot_post);
+	index->slot_keys = g_new0(guint32, index->n_slots);
+	index->slot_post = g_new(guint32, index->n_slots);
+
+	mask = index->n_slots - 1;
+	for (i = 0; i < index->n_posts; i++) {
+		slot = slot_hash(index->posts[i].key) & mask;
+		while (index->slot_keys[slot] != 0) {
+			slot = (slot + 1) & mask;
+		}
+		index->slot_keys[slot] = index->posts[i].key;
+		index->slot_post[slot] = i;
+	}
+}
+
+/* Finds the posting list of @key, creating it if @create */
+static OpenPosting *
+open_find(
+	GstTrigramIndex *index,
+	guint32          key,
+	gboolean         create
+){
+	OpenPosting *post;
+	guint mask;
+	guint slot;
+
+	mask = index->n_slots - 1;
+	slot = slot_hash(key) & mask;
+	while (index->slot_keys[slot] != 0) {
+		if (index->slot_keys[slot] == key) {
+			return &index->posts[index->slot_post[slot]];
+		}
+		slot = (slot + 1) & mask;
+	}
+
+	if (!create) {
+		return NULL;
+	}
+
+	if (index->n_posts == index->posts_cap) {
+		index->posts_cap = MAX(index->posts_cap * 2, 64);
+		index->posts = g_renew(OpenPosting, index->posts, index->posts_cap);
+	}
+	post = &index->posts[index->n_posts];
+	post->key = key;
+	post->offs = NULL;
+	post->n = 0;
+	post->cap = 0;
+
+	index->slot_keys[slot] = key;
+	index->slot_post[slot] = index->n_posts;
+	index->n_posts++;
+
+	/* Keep the load factor at or below one half */
+	if (index->n_posts * 2 > index->n_slots) {
+		open_grow(index);
+	}
+	return post;
+}
+
+/* Records that line @off of the open segment contains @key */
+static void
+open_add(
+	GstTrigramIndex *index,
+	guint32          key,
+	guint16          off
+){
+	OpenPosting *post;
+
+	post = open_find(index, key, TRUE);
+	if (post->n > 0 && post->offs[post->n - 1] == off) {
+		return;
+	}
+	if (post->n == post->cap) {
+		post->cap = (post->cap == 0) ? 4 : post->cap * 2;
+		post->offs = g_renew(guint16, post->offs, post->cap);
+	}
+	post->offs[post->n++] = off;
+}
+
+/* Empties the open segment; its next line is next_seq */
+static void
+open_clear(GstTrigramIndex *index)
+{
+	guint i;
+
+	for (i = 0; i < index->n_posts; i++) {
+		g_free(index->posts[i].offs);
+	}
+	index->n_posts = 0;
+	memset(index->slot_keys, 0, sizeof(guint32) * index->n_slots);
+	index->base = index->next_seq;
+}
+
+static gint
+compare_posting(
+	gconstpointer a,
+	gconstpointer b
+){
+	guint32 ka;
+	guint32 kb;
+
+	ka = ((const OpenPosting *)a)->key;
+	kb = ((const OpenPosting *)b)->key;
+	return (ka > kb) - (ka < kb);
+}
+
+/*
+ * open_seal:
+ *
+ * Turns the full open segment into a sealed one and starts a new
+ * open segment.
+ */
+static void
+open_seal(GstTrigramIndex *index)
+{
+	TrigramSegment *seg;
+	OpenPosting *post;
+	gsize total;
+	gsize pos;
+	guint16 prev;
+	guint32 d;
+	guint i;
+	guint j;
+
+	/* Nothing left to find in it */
+	if (index->base + TRIGRAM_SEGMENT_LINES <= index->min_seq) {
+		open_clear(index);
+		return;
+	}
+
+	qsort(index->posts, index->n_posts, sizeof(OpenPosting),
+		compare_posting);
+
+	total = 0;
+	for (i = 0; i < index->n_posts; i++) {
+		total += index->posts[i].n;
+	}
+
+	seg = g_new(TrigramSegment, 1);
+	seg->base = index->base;
+	seg->n_keys = index->n_posts;
+	seg->keys = g_new(guint32, index->n_posts);
+	seg->starts = g_new(guint32, index->n_posts + 1);
+
+	/* Deltas are below TRIGRAM_SEGMENT_LINES: two bytes at most */
+	seg->postings = g_malloc(MAX(total * 2, 1));
+
+	pos = 0;
+	for (i = 0; i < index->n_posts; i++) {
+		post = &index->posts[i];
+		seg->keys[i] = post->key;
+		seg->starts[i] = (guint32)pos;
+
+		prev = 0;
+		for (j = 0; j < post->n; j++) {
+			d = (guint32)(post->offs[j] - prev);
+			prev = post->offs[j];
+			while (d >= 0x80) {
+				seg->postings[pos++] = (guint8)(d | 0x80);
+				d >>= 7;
+			}
+			seg->postings[pos++] = (guint8)d;
+		}
+	}
+	seg->starts[index->n_posts] = (guint32)pos;
+	seg->postings = g_realloc(seg->postings, MAX(pos, 1));
+
+	g_ptr_array_add(index->segments, seg);
+	open_clear(index);
+}
+
+static void
+segment_free(gpointer data)
+{
+	TrigramSegment *seg;
+
+	seg = data;
+	g_free(seg->keys);
+	g_free(seg->starts);
+	g_free(seg->postings);
+	g_free(seg);
+}
+
+/* ===== Query parsing ===== */
+
+/* Appends the trigrams of a plain query */
+static void
+extract_literal(
+	const gchar *p,
+	GArray      *keys
+){
+	Window w;
+	guint32 key;
+
+	memset(&w, 0, sizeof(w));
+	for (; *p != '\0'; p = g_utf8_next_char(p)) {
+		key = window_push(&w, fold_rune(g_utf8_get_char(p)));
+		if (key != 0) {
+			g_array_append_val(keys, key);
+		}
+	}
+}
+
+/*
+ * quantifier_min:
+ *
+ * If @p starts a quantifier, returns the fewest repeats it allows
+ * and sets @end past it; otherwise returns -1. A '{' that is not
+ * a valid {n}, {n,} or {n,m} is a literal brace in PCRE.
+ */
+static gint
+quantifier_min(
+	const gchar  *p,
+	const gchar **end
+){
+	const gchar *q;
+	gint min;
+
+	switch (*p) {
+	case '*':
+	case '?':
+		min = 0;
+		q = p + 1;
+		break;
+	case '+':
+		min = 1;
+		q = p + 1;
+		break;
+	case '{':
+		q = p + 1;
+		if (!g_ascii_isdigit(*q)) {
+			return -1;
+		}
+		min = 0;
+		while (g_ascii_isdigit(*q)) {
+			min = MIN(min * 10 + (*q - '0'), 65535);
+			q++;
+		}
+		if (*q == ',') {
+			q++;
+			while (g_ascii_isdigit(*q)) {
+				q++;
+			}
+		}
+		if (*q != '}') {
+			return -1;
+		}
+		q++;
+		break;
+	default:
+		return -1;
+	}
+
+	if (end != NULL) {
+		*end = q;
+	}
+	return min;
+}
+
+/*
+ * push_literal:
+ *
+ * Adds a literal character of a regex, given what follows it. An
+ * optional character breaks the run before it; a repeated one
+ * ends the run after it, since what follows need not be adjacent.
+ */
+static void
+push_literal(
+	Window      *w,
+	gunichar     uc,
+	const gchar *next,
+	GArray      *keys
+){
+	guint32 key;
+	gint min;
+
+	min = quantifier_min(next, NULL);
+	if (min == 0) {
+		window_push(w, 0);
+		return;
+	}
+
+	key = window_push(w, fold_rune(uc));
+	if (key != 0) {
+		g_array_append_val(keys, key);
+	}
+	if (min > 0) {
+		window_push(w, 0);
+	}
+}
+
+/*
+ * skip_escape:
+ *
+ * Skips the arguments of an escape like \x41, \p{L} or \k<name>.
+ * @p points at the letter or digit after the backslash.
+ */
+static const gchar *
+skip_escape(const gchar *p)
+{
+	const gchar *q;
+	gchar close;
+	gchar c;
+	gint i;
+
+	c = *p++;
+	switch (c) {
+	case 'c':
+		return (*p != '\0') ? p + 1 : p;
+	case 'x':
+		if (*p != '{') {
+			for (i = 0; i < 2 && g_ascii_isxdigit(*p); i++) {
+				p++;
+			}
+			return p;
+		}
+		break;
+	case 'p':
+	case 'P':
+		if (*p != '{') {
+			return (*p != '\0') ? p + 1 : p;
+		}
+		break;
+	case 'g':
+		if (*p == '-' || *p == '+') {
+			p++;
+		}
+		while (g_ascii_isdigit(*p)) {
+			p++;
+		}
+		break;
+	case 'k':
+	case 'o':
+	case 'N':
+		break;
+	default:
+		/* Octal codes and back references */
+		if (g_ascii_isdigit(c)) {
+			while (g_ascii_isdigit(*p)) {
+				p++;
+			}
+		}
+		return p;
+	}
+
+	if (*p == '{' || *p == '<' || *p == '\'') {
+		close = (*p == '{') ? '}' : (*p == '<') ? '>' : '\'';
+		q = strchr(p + 1, close);
+		return (q != NULL) ? q + 1 : p + strlen(p);
+	}
+	return p;
+}
+
+/* Skips a character class; NULL if it holds a \Q quote */
+static const gchar *
+skip_class(const gchar *p)
+{
+	const gchar *q;
+
+	p++;
+	if (*p == '^') {
+		p++;
+	}
+	if (*p == ']') {
+		p++;
+	}
+	while (*p != '\0' && *p != ']') {
+		if (*p == '\\') {
+			if (p[1] == 'Q') {
+				return NULL;
+			}
+			p++;
+			if (*p != '\0') {
+				p++;
+			}
+			continue;
+		}
+		if (*p == '[' && p[1] == ':') {
+			q = strstr(p + 2, ":]");
+			if (q != NULL) {
+				p = q + 2;
+				continue;
+			}
+		}
+		p++;
+	}
+	return (*p == ']') ? p + 1 : p;
+}
+
+/* Skips a parenthesised group; NULL if it holds a \Q quote */
+static const gchar *
+skip_group(const gchar *p)
+{
+	gint depth;
+
+	depth = 0;
+	while (*p != '\0') {
+		if (*p == '\\') {
+			if (p[1] == 'Q') {
+				return NULL;
+			}
+			p++;
+			if (*p != '\0') {
+				p++;
+			}
+			continue;
+		}
+		if (*p == '[') {
+			p = skip_class(p);
+			if (p == NULL) {
+				return NULL;
+			}
+			continue;
+		}
+		if (*p == '(') {
+			depth++;
+		} else if (*p == ')' && --depth == 0) {
+			return p + 1;
+		}
+		p++;
+	}
+	return p;
+}
+
+/* TRUE if an inline (?x) makes whitespace and # insignificant */
+static gboolean
+has_extended_flag(const gchar *p)
+{
+	while ((p = strstr(p, "(?")) != NULL) {
+		for (p += 2; g_ascii_isalpha(*p) || *p == '-' || *p == '^'; p++) {
+			if (*p == 'x') {
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+/*
+ * extract_regex:
+ *
+ * Appends the trigrams of the literal runs every match of a
+ * regex must contain. Groups, classes, escapes and anchors break
+ * runs; a top-level alternative makes every run optional.
+ *
+ * Returns: %FALSE if the pattern cannot be narrowed at all
+ */
+static gboolean
+extract_regex(
+	const gchar *p,
+	GArray      *keys
+){
+	const gchar *q;
+	gboolean quoted;
+	Window w;
+
+	if (has_extended_flag(p)) {
+		return FALSE;
+	}
+
+	memset(&w, 0, sizeof(w));
+	quoted = FALSE;
+	while (*p != '\0') {
+		/* Inside \Q...\E everything is literal */
+		if (quoted) {
+			if (p[0] == '\\' && p[1] == 'E') {
+				quoted = FALSE;
+				p += 2;
+				continue;
+			}
+			q = g_utf8_next_char(p);
+			push_literal(&w, g_utf8_get_char(p),
+				(q[0] == '\\' && q[1] == 'E') ? q + 2 : "", keys);
+			p = q;
+			continue;
+		}
+
+		switch (*p) {
+		case '\\':
+			if (p[1] == '\0') {
+				return TRUE;
+			}
+			if (p[1] == 'Q') {
+				quoted = TRUE;
+				p += 2;
+				continue;
+			}
+			if (g_ascii_isalnum(p[1])) {
+				window_push(&w, 0);
+				p = skip_escape(p + 1);
+				continue;
+			}
+			/* Escaped punctuation stands for itself */
+			q = g_utf8_next_char(p + 1);
+			push_literal(&w, g_utf8_get_char(p + 1), q, keys);
+			p = q;
+			continue;
+		case '(':
+			window_push(&w, 0);
+			p = skip_group(p);
+			if (p == NULL) {
+				return FALSE;
+			}
+			continue;
+		case '[':
+			window_push(&w, 0);
+			p = skip_class(p);
+			if (p == NULL) {
+				return FALSE;
+			}
+			continue;
+		case '|':
+		case ')':
+			return FALSE;
+		case '.':
+		case '^':
+		case '$':
+			window_push(&w, 0);
+			p++;
+			continue;
+		case '*':
+		case '?':
+		case '+':
+		case '{':
+			/* Quantifiers of groups, classes or other quantifiers */
+			if (quantifier_min(p, &q) >= 0) {
+				window_push(&w, 0);
+				p = q;
+				continue;
+			}
+			break;
+		default:
+			break;
+		}
+
+		q = g_utf8_next_char(p);
+		push_literal(&w, g_utf8_get_char(p), q, keys);
+		p = q;
+	}
+	return TRUE;
+}
+
+static gint
+compare_key(
+	gconstpointer a,
+	gconstpointer b
+){
+	guint32 ka;
+	guint32 kb;
+
+	ka = *(const guint32 *)a;
+	kb = *(const guint32 *)b;
+	return (ka > kb) - (ka < kb);
+}
+
+static gint
+compare_ref(
+	gconstpointer a,
+	gconstpointer b
+){
+	gsize sa;
+	gsize sb;
+
+	sa = ((const PostingRef *)a)->size;
+	sb = ((const PostingRef *)b)->size;
+	return (sa > sb) - (sa < sb);
+}
+
+/* ===== Lookup ===== */
+
+/* Decodes a posting list into @out */
+static void
+decode_ref(
+	const PostingRef    *ref,
+	GArray              *out
+){
+	const guint8 *p;
+	const guint8 *end;
+	guint32 v;
+	guint32 d;
+	guint shift;
+	guint16 off;
+
+	g_array_set_size(out, 0);
+	if (ref->offs != NULL) {
+		g_array_append_vals(out, ref->offs, (guint)ref->size);
+		return;
+	}
+
+	p = ref->data;
+	end = p + ref->size;
+	v = 0;
+	while (p < end) {
+		d = 0;
+		shift = 0;
+		while (p < end && (*p & 0x80)) {
+			d |= (guint32)(*p++ & 0x7F) << shift;
+			shift += 7;
+		}
+		if (p < end) {
+			d |= (guint32)(*p++) << shift;
+		}
+		v += d;
+		off = (guint16)v;
+		g_array_append_val(out, off);
+	}
+}
+
+/* Keeps the entries of @cand that are also in @other */
+static void
+intersect(
+	GArray  *cand,
+	GArray  *other
+){
+	guint16 *c;
+	guint16 *o;
+	guint i;
+	guint j;
+	guint n;
+
+	c = (guint16 *)(gpointer)cand->data;
+	o = (guint16 *)(gpointer)other->data;
+	i = 0;
+	j = 0;
+	n = 0;
+	while (i < cand->len && j < other->len) {
+		if (c[i] < o[j]) {
+			i++;
+		} else if (c[i] > o[j]) {
+			j++;
+		} else {
+			c[n++] = c[i];
+			i++;
+			j++;
+		}
+	}
+	g_array_set_size(cand, n);
+}
+
+/*
+ * lookup_refs:
+ *
+ * Intersects the posting lists collected in index->refs for the
+ * segment starting at @base and appends the surviving lines to
+ * @seqs, newest first.
+ */
+static void
+lookup_refs(
+	GstTrigramIndex *index,
+	guint64          base,
+	GArray          *seqs
+){
+	guint64 seq;
+	guint i;
+
+	g_array_sort(index->refs, compare_ref);
+
+	decode_ref(&g_array_index(index->refs, PostingRef, 0), index->cand);
+	for (i = 1; i < MIN(index->refs->len, TRIGRAM_MAX_LISTS)
+	     && index->cand->len > 0; i++)
+	{
+		decode_ref(&g_array_index(index->refs, PostingRef, i), index->other);
+		intersect(index->cand, index->other);
+	}
+
+	for (i = index->cand->len; i-- > 0; ) {
+		seq = base + g_array_index(index->cand, guint16, i);
+		if (seq < index->min_seq) {
+			break;
+		}
+		g_array_append_val(seqs, seq);
+	}
+}
+
+static void
+lookup_open(
+	GstTrigramIndex *index,
+	GArray          *seqs
+){
+	OpenPosting *post;
+	PostingRef ref;
+	guint i;
+
+	g_array_set_size(index->refs, 0);
+	for (i = 0; i < index->keys->len; i++) {
+		post = open_find(index, g_array_index(index->keys, guint32, i), FALSE);
+		if (post == NULL) {
+			return;
+		}
+		ref.offs = post->offs;
+		ref.data = NULL;
+		ref.size = post->n;
+		g_array_append_val(index->refs, ref);
+	}
+	lookup_refs(index, index->base, seqs);
+}
+
+static void
+lookup_sealed(
+	GstTrigramIndex *index,
+	TrigramSegment  *seg,
+	GArray          *seqs
+){
+	PostingRef ref;
+	guint32 key;
+	guint lo;
+	guint hi;
+	guint mid;
+	guint i;
+
+	g_array_set_size(index->refs, 0);
+	for (i = 0; i < index->keys->len; i++) {
+		key = g_array_index(index->keys, guint32, i);
+
+		lo = 0;
+		hi = seg->n_keys;
+		while (lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			if (seg->keys[mid] < key) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		if (lo == seg->n_keys || seg->keys[lo] != key) {
+			return;
+		}
+
+		ref.offs = NULL;
+		ref.data = seg->postings + seg->starts[lo];
+		ref.size = seg->starts[lo + 1] - seg->starts[lo];
+		g_array_append_val(index->refs, ref);
+	}
+	lookup_refs(index, seg->base, seqs);
+}
+
+/* ===== Public API ===== */
+
+GstTrigramIndex *
+gst_trigram_index_new(void)
+{
+	GstTrigramIndex *index;
+
+	index = g_new0(GstTrigramIndex, 1);
+	index->segments = g_ptr_array_new_with_free_func(segment_free);
+	index->n_slots = TRIGRAM_MIN_SLOTS;
+	index->slot_keys = g_new0(guint32, index->n_slots);
+	index->slot_post = g_new(guint32, index->n_slots);
+	index->keys = g_array_new(FALSE, FALSE, sizeof(guint32));
+	index->refs = g_array_new(FALSE, FALSE, sizeof(PostingRef));
+	index->cand = g_array_new(FALSE, FALSE, sizeof(guint16));
+	index->other = g_array_new(FALSE, FALSE, sizeof(guint16));
+	return index;
+}
+
+void
+gst_trigram_index_free(GstTrigramIndex *index)
+{
+	if (index == NULL) {
+		return;
+	}
+
+	open_clear(index);
+	g_free(index->posts);
+	g_free(index->slot_keys);
+	g_free(index->slot_post);
+	g_ptr_array_free(index->segments, TRUE);
+	g_array_free(index->keys, TRUE);
+	g_array_free(index->refs, TRUE);
+	g_array_free(index->cand, TRUE);
+	g_array_free(index->other, TRUE);
+	g_free(index);
+}
+
+guint64
+gst_trigram_index_add_line(
+	GstTrigramIndex *index,
+	const GstGlyph  *glyphs,
+	gint            len,
+	gint            cols
+){
+	Window w;
+	guint64 seq;
+	guint32 key;
+	guint16 off;
+	gint pad;
+	gint x;
+
+	g_return_val_if_fail(index != NULL, 0);
+	g_return_val_if_fail(glyphs != NULL || len == 0, 0);
+
+	seq = index->next_seq++;
+	off = (guint16)(seq - index->base);
+
+	memset(&w, 0, sizeof(w));
+	for (x = 0; x < len; x++) {
+		if (glyphs[x].attr & GST_GLYPH_ATTR_WDUMMY) {
+			continue;
+		}
+		key = window_push(&w, fold_rune(glyphs[x].rune));
+		if (key != 0) {
+			open_add(index, key, off);
+		}
+	}
+
+	/* The blank tail only adds trigrams over its first three cells */
+	for (pad = MIN(cols - len, 3); pad > 0; pad--) {
+		key = window_push(&w, ' ');
+		if (key != 0) {
+			open_add(index, key, off);
+		}
+	}
+
+	if (index->next_seq - index->base == TRIGRAM_SEGMENT_LINES) {
+		open_seal(index);
+	}
+	return seq;
+}
+
+void
+gst_trigram_index_drop_before(
+	GstTrigramIndex *index,
+	guint64         seq
+){
+	TrigramSegment *seg;
+
+	g_return_if_fail(index != NULL);
+
+	seq = MIN(seq, index->next_seq);
+	if (seq <= index->min_seq) {
+		return;
+	}
+	index->min_seq = seq;
+
+	while (index->segments->len > 0) {
+		seg = g_ptr_array_index(index->segments, 0);
+		if (seg->base + TRIGRAM_SEGMENT_LINES > seq) {
+			break;
+		}
+		g_ptr_array_remove_index(index->segments, 0);
+	}
+
+	/* A small history can outlive the open segment's lines */
+	if (seq == index->next_seq && index->n_posts > 0) {
+		open_clear(index);
+	}
+}
+
+guint64
+gst_trigram_index_get_next_seq(GstTrigramIndex *index)
+{
+	g_return_val_if_fail(index != NULL, 0);
+
+	return index->next_seq;
+}
+
+gboolean
+gst_trigram_index_lookup(
+	GstTrigramIndex *index,
+	const gchar     *pattern,
+	gboolean        regex,
+	GArray          *seqs
+){
+	guint32 *keys;
+	guint n;
+	guint i;
+
+	g_return_val_if_fail(index != NULL, FALSE);
+	g_return_val_if_fail(pattern != NULL, FALSE);
+	g_return_val_if_fail(seqs != NULL, FALSE);
+
+	if (!g_utf8_validate(pattern, -1, NULL)) {
+		return FALSE;
+	}
+
+	g_array_set_size(index->keys, 0);
+	if (regex) {
+		if (!extract_regex(pattern, index->keys)) {
+			return FALSE;
+		}
+	} else {
+		extract_literal(pattern, index->keys);
+	}
+	if (index->keys->len == 0) {
+		return FALSE;
+	}
+
+	/* Sort and drop repeated trigrams */
+	g_array_sort(index->keys, compare_key);
+	keys = (guint32 *)(gpointer)index->keys->data;
+	n = 1;
+	for (i = 1; i < index->keys->len; i++) {
+		if (keys[i] != keys[n - 1]) {
+			keys[n++] = keys[i];
+		}
+	}
+	g_array_set_size(index->keys, n);
+
+	/* Newest lines first: the open segment, then sealed ones back */
+	if (index->next_seq > index->base) {
+		lookup_open(index, seqs);
+	}
+	for (i = index->segments->len; i-- > 0; ) {
+		lookup_sealed(index, g_ptr_array_index(index->segments, i), seqs);
+	}
+	return TRUE;
+}
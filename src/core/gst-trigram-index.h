@@ -0,0 +1,122 @@
+/*
+ * gst-trigram-index.h - Incremental trigram index over lines of text
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Maps every three-character sequence of a line to the lines that
+ * contain it, so a search only has to look at lines holding all of
+ * the query's trigrams instead of the whole history. Lines are
+ * numbered in the order they are added and can only be forgotten
+ * oldest first, matching how scrollback fills and evicts.
+ *
+ * Only ASCII is indexed, folded to lower case; any other character
+ * breaks the sequence. Lookups therefore return a superset of the
+ * matching lines, for case-sensitive and caseless queries alike,
+ * and callers still verify each candidate.
+ */
+
+#ifndef GST_TRIGRAM_INDEX_H
+#define GST_TRIGRAM_INDEX_H
+
+#include <glib.h>
+#include "../gst-types.h"
+#include "../boxed/gst-glyph.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GstTrigramIndex GstTrigramIndex;
+
+/**
+ * gst_trigram_index_new:
+ *
+ * Creates an empty index. The first line added gets sequence
+ * number 0.
+ *
+ * Returns: (transfer full): a new #GstTrigramIndex
+ */
+GstTrigramIndex *
+gst_trigram_index_new(void);
+
+/**
+ * gst_trigram_index_free:
+ * @index: (nullable): a #GstTrigramIndex
+ *
+ * Frees the index.
+ */
+void
+gst_trigram_index_free(GstTrigramIndex *index);
+
+/**
+ * gst_trigram_index_add_line:
+ * @index: a #GstTrigramIndex
+ * @glyphs: the line's stored cells
+ * @len: number of cells in @glyphs
+ * @cols: width of the line; cells from @len up to @cols are blank
+ *
+ * Indexes the next line. Wide-character spacer cells are skipped
+ * and empty cells read as spaces, as when the line is turned into
+ * text for searching.
+ *
+ * Returns: the line's sequence number
+ */
+guint64
+gst_trigram_index_add_line(
+	GstTrigramIndex *index,
+	const GstGlyph  *glyphs,
+	gint            len,
+	gint            cols
+);
+
+/**
+ * gst_trigram_index_drop_before:
+ * @index: a #GstTrigramIndex
+ * @seq: first sequence number to keep
+ *
+ * Forgets every line numbered below @seq. Lookups stop returning
+ * them at once; their postings are freed a segment at a time.
+ */
+void
+gst_trigram_index_drop_before(
+	GstTrigramIndex *index,
+	guint64         seq
+);
+
+/**
+ * gst_trigram_index_get_next_seq:
+ * @index: a #GstTrigramIndex
+ *
+ * Returns: the sequence number the next added line will get
+ */
+guint64
+gst_trigram_index_get_next_seq(GstTrigramIndex *index);
+
+/**
+ * gst_trigram_index_lookup:
+ * @index: a #GstTrigramIndex
+ * @pattern: the query, UTF-8
+ * @regex: whether @pattern is a regular expression
+ * @seqs: (element-type guint64): array the candidate lines are
+ *   appended to, newest first
+ *
+ * Finds the lines that may match @pattern. A plain query must
+ * contain every trigram of its text. For a regular expression the
+ * trigrams are taken from the literal runs every match must
+ * contain; alternation at the top level, inline flags that change
+ * how the pattern parses, and the like make the pattern
+ * unusable.
+ *
+ * Returns: %TRUE if @seqs now holds the candidates, %FALSE if
+ *   @pattern has no usable trigram and every line must be searched
+ */
+gboolean
+gst_trigram_index_lookup(
+	GstTrigramIndex *index,
+	const gchar     *pattern,
+	gboolean        regex,
+	GArray          *seqs
+);
+
+G_END_DECLS
+
+#endif /* GST_TRIGRAM_INDEX_H */
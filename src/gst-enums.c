@@ -320,6 +320,7 @@ gst_selection_snap_get_type(void)
  *
  * Returns: the GType for GstEscapeState
  */
+G_GNUC_BEGIN_IGNORE_DEPRECATIONS
 GType
 gst_escape_state_get_type(void)
 {
@@ -344,6 +345,7 @@ gst_escape_state_get_type(void)
 
     return type;
 }
+G_GNUC_END_IGNORE_DEPRECATIONS
 
 /*
  * gst_charset_get_type:
@@ -246,6 +246,9 @@ GType gst_selection_snap_get_type(void) G_GNUC_CONST;
  * Escape sequence parser state flags (bit field).
  * Multiple flags can be set simultaneously to track
  * the current state of escape sequence parsing.
+ *
+ * Deprecated: the escape parser is table-driven and no longer
+ * reports its state as flags. Kept for source compatibility.
  */
 typedef enum {
     GST_ESC_START      = 1 << 0,   /* ESC received, waiting for command */
@@ -256,8 +259,9 @@ typedef enum {
     GST_ESC_TEST       = 1 << 5,   /* In DEC test sequence ESC # */
     GST_ESC_UTF8       = 1 << 6,   /* In UTF-8 mode sequence ESC % */
     GST_ESC_DCS        = 1 << 7    /* Device Control String */
-} GstEscapeState;
+} GstEscapeState G_DEPRECATED;
 
+G_DEPRECATED
 GType gst_escape_state_get_type(void) G_GNUC_CONST;
 #define GST_TYPE_ESCAPE_STATE (gst_escape_state_get_type())
 
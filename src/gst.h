@@ -27,6 +27,11 @@
 
 /* Core classes */
 #include "core/gst-line.h"
+#include "core/gst-style-table.h"
+#include "core/gst-block-arena.h"
+#include "core/gst-lz.h"
+#include "core/gst-spill-file.h"
+#include "core/gst-trigram-index.h"
 #include "core/gst-terminal.h"
 #include "core/gst-pty.h"
 #include "core/gst-escape-parser.h"
@@ -35,6 +40,11 @@
 #include "rendering/gst-renderer.h"
 #include "rendering/gst-x11-renderer.h"
 #include "rendering/gst-font-cache.h"
+#include "rendering/gst-glyph-cache.h"
+#include "rendering/gst-damage.h"
+#include "rendering/gst-glyph-atlas.h"
+#include "rendering/gst-blit.h"
+#include "rendering/gst-image-cache.h"
 
 /* Window */
 #include "window/gst-window.h"
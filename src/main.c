@@ -177,10 +177,13 @@ static const GstBuiltinModule builtin_modules[] = {
 		"    enabled: true\n"
 		"    lines: 10000\n"
 		"    mouse_scroll_lines: 3\n"
+		"    spill_to_disk: false\n"
+		"    search_index: false\n"
 		"\n",
 		"\t/*\n"
 		"\t * scrollback: history buffer with keyboard navigation\n"
-		"\t * YAML keys: lines (capacity), mouse_scroll_lines\n"
+		"\t * YAML keys: lines (capacity, 0 = unlimited),\n"
+		"\t *   mouse_scroll_lines, spill_to_disk, search_index\n"
 		"\t */\n"
 	},
 	{
@@ -514,6 +517,9 @@ static guint draw_timeout_id = 0;
 static gint64 draw_trigger_time = 0;
 static gboolean drawing = FALSE;
 
+/* Wayland: content changed while waiting for a frame callback */
+static gboolean frame_wanted = FALSE;
+
 /* Runtime config values (populated from GstConfig on startup) */
 static guint cfg_border_px = 2;
 static guint cfg_min_latency = 8;
@@ -967,6 +973,9 @@ detect_backend(void)
  * Called when there is new content to render.
  * Implements adaptive latency: waits up to minlatency
  * for more data, draws immediately after maxlatency.
+ * On Wayland, while the last frame's callback is pending,
+ * updates are coalesced until the compositor asks for the
+ * next frame.
  */
 static gboolean
 do_draw(gpointer user_data)
@@ -979,6 +988,12 @@ do_draw(gpointer user_data)
 	}
 
 	if (!gst_renderer_start_draw(renderer)) {
+#ifdef GST_HAVE_WAYLAND
+		/* Retried on "frame-done", e.g. once a buffer is released */
+		if (backend == GST_BACKEND_WAYLAND) {
+			frame_wanted = TRUE;
+		}
+#endif
 		return G_SOURCE_REMOVE;
 	}
 
@@ -995,6 +1010,15 @@ schedule_draw(void)
 	gint64 elapsed;
 	guint delay;
 
+#ifdef GST_HAVE_WAYLAND
+	if (backend == GST_BACKEND_WAYLAND
+	    && gst_wayland_renderer_is_frame_pending(
+	        GST_WAYLAND_RENDERER(renderer))) {
+		frame_wanted = TRUE;
+		return;
+	}
+#endif
+
 	now = g_get_monotonic_time();
 
 	if (!drawing) {
@@ -1025,6 +1049,31 @@ schedule_draw(void)
 	}
 }
 
+#ifdef GST_HAVE_WAYLAND
+/*
+ * on_frame_done:
+ *
+ * The compositor is ready for a new frame: draw everything that
+ * was coalesced while waiting, right away.
+ */
+static void
+on_frame_done(
+	GstWaylandRenderer  *wl_renderer,
+	gpointer            user_data
+){
+	if (!frame_wanted) {
+		return;
+	}
+	frame_wanted = FALSE;
+
+	if (draw_timeout_id != 0) {
+		g_source_remove(draw_timeout_id);
+		draw_timeout_id = 0;
+	}
+	do_draw(NULL);
+}
+#endif
+
 /*
  * zoom:
  * @action: GST_ACTION_ZOOM_IN, GST_ACTION_ZOOM_OUT, or GST_ACTION_ZOOM_RESET
@@ -1892,6 +1941,18 @@ init_wayland_backend(
 		cairo_font_cache, (gint)cfg_border_px);
 	renderer = GST_RENDERER(wl_renderer);
 
+	/* Pace drawing to the compositor's frame callbacks */
+	g_signal_connect(wl_renderer, "frame-done",
+		G_CALLBACK(on_frame_done), NULL);
+
+	/* Software glyph path: blit from the font cache's atlas */
+	gst_wayland_renderer_set_glyph_atlas(wl_renderer,
+		gst_config_get_glyph_atlas(config));
+
+	/* Optionally paint dirty lines off the main thread */
+	gst_wayland_renderer_set_render_thread(wl_renderer,
+		gst_config_get_render_thread(config));
+
 	/* Load colors from config */
 	if (!gst_wayland_renderer_load_colors(wl_renderer, config)) {
 		g_printerr("Cannot load colors\n");
@@ -2260,6 +2321,9 @@ skip_c_config:
 
 	/* Step 4: Create PTY and spawn shell */
 	pty = gst_pty_new();
+	gst_pty_set_read_budget(pty,
+		gst_config_get_pty_read_budget(config),
+		gst_config_get_pty_read_time(config));
 
 	if (!gst_pty_spawn(pty, shell_cmd, NULL, &error)) {
 		g_printerr("Failed to spawn shell: %s\n", error->message);
@@ -0,0 +1,339 @@
+/*
+ * gst-blit.c - Coverage mask blending kernels
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Every kernel computes, per 8-bit channel,
+ *
+ *   x = c * m + d * (255 - m)
+ *   t = x + 128
+ *   d = (t + (t >> 8)) >> 8
+ *
+ * which is x / 255 rounded to nearest, exact over the whole input
+ * range and small enough to stay in 16-bit lanes. Rows are split
+ * into a vector body and a scalar tail using the same arithmetic,
+ * so the result does not depend on which kernel ran.
+ */
+
+#include "gst-blit.h"
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GST_BLIT_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) && !defined(__ARM_BIG_ENDIAN)
+#define GST_BLIT_NEON 1
+#include <arm_neon.h>
+#endif
+
+typedef void (*BlitRowFunc)(guint32 *dst, const guint8 *mask,
+	gint width, guint32 color);
+
+static guint8
+blend_channel(
+	guint   c,
+	guint   d,
+	guint   m
+){
+	guint t;
+
+	t = c * m + d * (255 - m) + 128;
+	return (guint8)((t + (t >> 8)) >> 8);
+}
+
+static void
+blit_row_scalar(
+	guint32         *dst,
+	const guint8    *mask,
+	gint            width,
+	guint32         color
+){
+	gint i;
+
+	for (i = 0; i < width; i++) {
+		guint32 d;
+		guint m;
+
+		m = mask[i];
+		if (m == 0) {
+			continue;
+		}
+		if (m == 255) {
+			dst[i] = color;
+			continue;
+		}
+
+		d = dst[i];
+		dst[i] = ((guint32)blend_channel((color >> 24) & 0xFF, (d >> 24) & 0xFF, m) << 24)
+			| ((guint32)blend_channel((color >> 16) & 0xFF, (d >> 16) & 0xFF, m) << 16)
+			| ((guint32)blend_channel((color >> 8) & 0xFF, (d >> 8) & 0xFF, m) << 8)
+			| (guint32)blend_channel(color & 0xFF, d & 0xFF, m);
+	}
+}
+
+#ifdef GST_BLIT_X86
+
+#ifdef __SSE2__
+/* 4 pixels per step: widen to 16-bit lanes, blend, narrow back */
+static void
+blit_row_sse2(
+	guint32         *dst,
+	const guint8    *mask,
+	gint            width,
+	guint32         color
+){
+	__m128i zero;
+	__m128i c16;
+	__m128i k255;
+	__m128i k128;
+	gint i;
+
+	zero = _mm_setzero_si128();
+	c16 = _mm_unpacklo_epi8(_mm_set1_epi32((gint)color), zero);
+	k255 = _mm_set1_epi16(255);
+	k128 = _mm_set1_epi16(128);
+
+	for (i = 0; i + 4 <= width; i += 4) {
+		guint32 m4;
+		__m128i m;
+		__m128i d;
+		__m128i lo;
+		__m128i hi;
+		__m128i mlo;
+		__m128i mhi;
+
+		memcpy(&m4, mask + i, sizeof(m4));
+		if (m4 == 0) {
+			continue;
+		}
+
+		/* Spread each coverage byte over its pixel's four channels */
+		m = _mm_cvtsi32_si128((gint)m4);
+		m = _mm_unpacklo_epi8(m, m);
+		m = _mm_unpacklo_epi16(m, m);
+		mlo = _mm_unpacklo_epi8(m, zero);
+		mhi = _mm_unpackhi_epi8(m, zero);
+
+		d = _mm_loadu_si128((const __m128i *)(dst + i));
+		lo = _mm_unpacklo_epi8(d, zero);
+		hi = _mm_unpackhi_epi8(d, zero);
+
+		lo = _mm_add_epi16(_mm_mullo_epi16(c16, mlo),
+			_mm_mullo_epi16(lo, _mm_sub_epi16(k255, mlo)));
+		hi = _mm_add_epi16(_mm_mullo_epi16(c16, mhi),
+			_mm_mullo_epi16(hi, _mm_sub_epi16(k255, mhi)));
+		lo = _mm_add_epi16(lo, k128);
+		hi = _mm_add_epi16(hi, k128);
+		lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+		hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+	}
+
+	blit_row_scalar(dst + i, mask + i, width - i, color);
+}
+#endif /* __SSE2__ */
+
+/* 8 pixels per step; compiled for AVX2 and only used when the CPU has it */
+__attribute__((target("avx2")))
+static void
+blit_row_avx2(
+	guint32         *dst,
+	const guint8    *mask,
+	gint            width,
+	guint32         color
+){
+	__m128i spread;
+	__m256i c16;
+	__m256i k255;
+	__m256i k128;
+	gint i;
+
+	spread = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+	c16 = _mm256_cvtepu8_epi16(_mm_set1_epi32((gint)color));
+	k255 = _mm256_set1_epi16(255);
+	k128 = _mm256_set1_epi16(128);
+
+	for (i = 0; i + 8 <= width; i += 8) {
+		guint32 m_lo;
+		guint32 m_hi;
+		__m256i mlo;
+		__m256i mhi;
+		__m256i lo;
+		__m256i hi;
+
+		memcpy(&m_lo, mask + i, sizeof(m_lo));
+		memcpy(&m_hi, mask + i + 4, sizeof(m_hi));
+		if ((m_lo | m_hi) == 0) {
+			continue;
+		}
+
+		mlo = _mm256_cvtepu8_epi16(_mm_shuffle_epi8(
+			_mm_cvtsi32_si128((gint)m_lo), spread));
+		mhi = _mm256_cvtepu8_epi16(_mm_shuffle_epi8(
+			_mm_cvtsi32_si128((gint)m_hi), spread));
+
+		lo = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(dst + i)));
+		hi = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(dst + i + 4)));
+
+		lo = _mm256_add_epi16(_mm256_mullo_epi16(c16, mlo),
+			_mm256_mullo_epi16(lo, _mm256_sub_epi16(k255, mlo)));
+		hi = _mm256_add_epi16(_mm256_mullo_epi16(c16, mhi),
+			_mm256_mullo_epi16(hi, _mm256_sub_epi16(k255, mhi)));
+		lo = _mm256_add_epi16(lo, k128);
+		hi = _mm256_add_epi16(hi, k128);
+		lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+		hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+		/* packus interleaves 128-bit lanes; restore pixel order */
+		_mm256_storeu_si256((__m256i *)(dst + i),
+			_mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8));
+	}
+
+	blit_row_scalar(dst + i, mask + i, width - i, color);
+}
+
+#endif /* GST_BLIT_X86 */
+
+#ifdef GST_BLIT_NEON
+/* 8 pixels per step with the channels de-interleaved by vld4 */
+static void
+blit_row_neon(
+	guint32         *dst,
+	const guint8    *mask,
+	gint            width,
+	guint32         color
+){
+	uint8x8_t cb;
+	uint8x8_t cg;
+	uint8x8_t cr;
+	uint8x8_t ca;
+	gint i;
+
+	cb = vdup_n_u8((guint8)(color & 0xFF));
+	cg = vdup_n_u8((guint8)((color >> 8) & 0xFF));
+	cr = vdup_n_u8((guint8)((color >> 16) & 0xFF));
+	ca = vdup_n_u8((guint8)((color >> 24) & 0xFF));
+
+	for (i = 0; i + 8 <= width; i += 8) {
+		uint8x8_t m;
+		uint8x8_t inv;
+		uint8x8x4_t d;
+		uint16x8_t x;
+
+		m = vld1_u8(mask + i);
+		if (vget_lane_u64(vreinterpret_u64_u8(m), 0) == 0) {
+			continue;
+		}
+		inv = vmvn_u8(m);
+		d = vld4_u8((const guint8 *)(dst + i));
+
+		/* vraddhn(x, (x + 128) >> 8) == ((x + 128) + ((x + 128) >> 8)) >> 8 */
+		x = vmlal_u8(vmull_u8(cb, m), d.val[0], inv);
+		d.val[0] = vraddhn_u16(x, vrshrq_n_u16(x, 8));
+		x = vmlal_u8(vmull_u8(cg, m), d.val[1], inv);
+		d.val[1] = vraddhn_u16(x, vrshrq_n_u16(x, 8));
+		x = vmlal_u8(vmull_u8(cr, m), d.val[2], inv);
+		d.val[2] = vraddhn_u16(x, vrshrq_n_u16(x, 8));
+		x = vmlal_u8(vmull_u8(ca, m), d.val[3], inv);
+		d.val[3] = vraddhn_u16(x, vrshrq_n_u16(x, 8));
+
+		vst4_u8((guint8 *)(dst + i), d);
+	}
+
+	blit_row_scalar(dst + i, mask + i, width - i, color);
+}
+#endif /* GST_BLIT_NEON */
+
+static BlitRowFunc blit_row = NULL;
+static const gchar *blit_impl = NULL;
+
+static void
+blit_select(void)
+{
+	blit_row = blit_row_scalar;
+	blit_impl = "scalar";
+
+#ifdef GST_BLIT_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		blit_row = blit_row_avx2;
+		blit_impl = "avx2";
+		return;
+	}
+#ifdef __SSE2__
+	blit_row = blit_row_sse2;
+	blit_impl = "sse2";
+#endif
+#endif
+
+#ifdef GST_BLIT_NEON
+	blit_row = blit_row_neon;
+	blit_impl = "neon";
+#endif
+}
+
+static void
+blit_rows(
+	BlitRowFunc     row,
+	guint8          *dst,
+	gint            dst_stride,
+	const guint8    *mask,
+	gint            mask_stride,
+	gint            width,
+	gint            height,
+	guint32         color
+){
+	gint y;
+
+	color |= 0xFF000000u;
+	for (y = 0; y < height; y++) {
+		row((guint32 *)(dst + (gsize)y * (gsize)dst_stride),
+			mask + (gsize)y * (gsize)mask_stride, width, color);
+	}
+}
+
+void
+gst_blit_a8_over(
+	guint8          *dst,
+	gint            dst_stride,
+	const guint8    *mask,
+	gint            mask_stride,
+	gint            width,
+	gint            height,
+	guint32         color
+){
+	if (blit_row == NULL) {
+		blit_select();
+	}
+
+	blit_rows(blit_row, dst, dst_stride, mask, mask_stride,
+		width, height, color);
+}
+
+void
+gst_blit_a8_over_scalar(
+	guint8          *dst,
+	gint            dst_stride,
+	const guint8    *mask,
+	gint            mask_stride,
+	gint            width,
+	gint            height,
+	guint32         color
+){
+	blit_rows(blit_row_scalar, dst, dst_stride, mask, mask_stride,
+		width, height, color);
+}
+
+const gchar *
+gst_blit_get_impl(void)
+{
+	if (blit_row == NULL) {
+		blit_select();
+	}
+
+	return blit_impl;
+}
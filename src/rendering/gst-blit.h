@@ -0,0 +1,72 @@
+/*
+ * gst-blit.h - Coverage mask blending kernels
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Blends an 8-bit coverage mask in a solid color onto a
+ * premultiplied ARGB32 buffer (Cairo's CAIRO_FORMAT_ARGB32 layout).
+ * SSE2, AVX2 and NEON kernels are picked at runtime where the CPU
+ * supports them; all produce the same result as the scalar path.
+ */
+
+#ifndef GST_BLIT_H
+#define GST_BLIT_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/**
+ * gst_blit_a8_over:
+ * @dst: first destination pixel (native-endian 0xAARRGGBB)
+ * @dst_stride: bytes per destination row
+ * @mask: first coverage byte
+ * @mask_stride: bytes per mask row
+ * @width: pixels per row
+ * @height: number of rows
+ * @color: opaque source color as 0xRRGGBB (alpha is forced to 0xFF)
+ *
+ * Composites @color through @mask with the OVER operator:
+ * each channel becomes (color * m + dst * (255 - m)) / 255,
+ * rounded to nearest.
+ */
+void
+gst_blit_a8_over(
+	guint8          *dst,
+	gint            dst_stride,
+	const guint8    *mask,
+	gint            mask_stride,
+	gint            width,
+	gint            height,
+	guint32         color
+);
+
+/**
+ * gst_blit_a8_over_scalar:
+ *
+ * Portable reference implementation of gst_blit_a8_over().
+ */
+void
+gst_blit_a8_over_scalar(
+	guint8          *dst,
+	gint            dst_stride,
+	const guint8    *mask,
+	gint            mask_stride,
+	gint            width,
+	gint            height,
+	guint32         color
+);
+
+/**
+ * gst_blit_get_impl:
+ *
+ * Returns: name of the kernel gst_blit_a8_over() uses
+ *   ("avx2", "sse2", "neon" or "scalar")
+ */
+const gchar *
+gst_blit_get_impl(void);
+
+G_END_DECLS
+
+#endif /* GST_BLIT_H */
@@ -14,6 +14,8 @@
  */
 
 #include "gst-cairo-font-cache.h"
+#include "gst-glyph-cache.h"
+#include "gst-glyph-atlas.h"
 #include <math.h>
 #include <string.h>
 
@@ -100,6 +102,12 @@ struct _GstCairoFontCache
 	gint frc_len;
 	gint frc_cap;
 
+	/* Resolved (rune, style) -> (font, glyph), misses included */
+	GstGlyphCache *glyphs;
+
+	/* Rasterized coverage per (scaled font, glyph), created on first use */
+	GstGlyphAtlas *atlas;
+
 	/* Font name and size tracking */
 	gchar *used_font;
 	gdouble used_fontsize;
@@ -296,6 +304,8 @@ gst_cairo_font_cache_dispose(GObject *object)
 
 	g_clear_pointer(&self->used_font, g_free);
 	g_clear_pointer(&self->frc, g_free);
+	g_clear_pointer(&self->glyphs, gst_glyph_cache_free);
+	g_clear_pointer(&self->atlas, gst_glyph_atlas_free);
 
 	if (self->font_options != NULL) {
 		cairo_font_options_destroy(self->font_options);
@@ -327,6 +337,8 @@ gst_cairo_font_cache_init(GstCairoFontCache *self)
 	self->frc = NULL;
 	self->frc_len = 0;
 	self->frc_cap = 0;
+	self->glyphs = gst_glyph_cache_new();
+	self->atlas = NULL;
 	self->used_font = NULL;
 	self->used_fontsize = 0;
 	self->default_fontsize = 0;
@@ -378,6 +390,12 @@ gst_cairo_font_cache_load_fonts(
 	g_return_val_if_fail(GST_IS_CAIRO_FONT_CACHE(self), FALSE);
 	g_return_val_if_fail(fontstr != NULL, FALSE);
 
+	/* Cached lookups belong to the previous fonts (e.g. before zoom) */
+	gst_glyph_cache_clear(self->glyphs);
+	if (self->atlas != NULL) {
+		gst_glyph_atlas_clear(self->atlas);
+	}
+
 	/* Parse font specification string */
 	pattern = FcNameParse((const FcChar8 *)fontstr);
 	if (pattern == NULL) {
@@ -550,7 +568,8 @@ gst_cairo_font_cache_unload_fonts(GstCairoFontCache *self)
  * gst_cairo_font_cache_clear:
  * @self: A #GstCairoFontCache
  *
- * Clears the fallback font ring cache.
+ * Clears the fallback font ring cache and the glyph lookups
+ * and atlas entries that may point into it.
  */
 void
 gst_cairo_font_cache_clear(GstCairoFontCache *self)
@@ -559,6 +578,11 @@ gst_cairo_font_cache_clear(GstCairoFontCache *self)
 
 	g_return_if_fail(GST_IS_CAIRO_FONT_CACHE(self));
 
+	gst_glyph_cache_clear(self->glyphs);
+	if (self->atlas != NULL) {
+		gst_glyph_atlas_clear(self->atlas);
+	}
+
 	for (i = 0; i < self->frc_len; i++) {
 		if (self->frc[i].scaled_font != NULL) {
 			cairo_scaled_font_destroy(self->frc[i].scaled_font);
@@ -673,22 +697,14 @@ get_glyph_index(
 	return (gulong)idx;
 }
 
-/**
- * gst_cairo_font_cache_lookup_glyph:
- * @self: A #GstCairoFontCache
- * @rune: Unicode code point
- * @style: desired font style
- * @font_out: (out): the cairo_scaled_font_t containing the glyph
- * @glyph_out: (out): the glyph index
- *
- * Looks up a glyph, searching main font, ring cache,
- * then fontconfig system fonts. The Cairo equivalent of
- * gst_font_cache_lookup_glyph().
+/*
+ * resolve_glyph:
  *
- * Returns: TRUE if glyph was found
+ * Uncached glyph search: main font, then the fallback ring, then
+ * fontconfig system fonts (adding the match to the ring).
  */
-gboolean
-gst_cairo_font_cache_lookup_glyph(
+static gboolean
+resolve_glyph(
 	GstCairoFontCache       *self,
 	GstRune                 rune,
 	GstFontStyle            style,
@@ -705,10 +721,6 @@ gst_cairo_font_cache_lookup_glyph(
 	FcFontSet *fcsets[1];
 	CairoFontRingEntry *entry;
 
-	g_return_val_if_fail(GST_IS_CAIRO_FONT_CACHE(self), FALSE);
-	g_return_val_if_fail(font_out != NULL, FALSE);
-	g_return_val_if_fail(glyph_out != NULL, FALSE);
-
 	/* Get the appropriate font variant */
 	fv = get_variant(self, style);
 
@@ -808,6 +820,50 @@ gst_cairo_font_cache_lookup_glyph(
 	return (glyphidx != 0);
 }
 
+/**
+ * gst_cairo_font_cache_lookup_glyph:
+ * @self: A #GstCairoFontCache
+ * @rune: Unicode code point
+ * @style: desired font style
+ * @font_out: (out): the cairo_scaled_font_t containing the glyph
+ * @glyph_out: (out): the glyph index
+ *
+ * Looks up a glyph, searching main font, ring cache,
+ * then fontconfig system fonts. The Cairo equivalent of
+ * gst_font_cache_lookup_glyph(); results are cached the
+ * same way.
+ *
+ * Returns: TRUE if glyph was found
+ */
+gboolean
+gst_cairo_font_cache_lookup_glyph(
+	GstCairoFontCache       *self,
+	GstRune                 rune,
+	GstFontStyle            style,
+	cairo_scaled_font_t     **font_out,
+	gulong                  *glyph_out
+){
+	gpointer font;
+	gulong glyph;
+	gboolean found;
+
+	g_return_val_if_fail(GST_IS_CAIRO_FONT_CACHE(self), FALSE);
+	g_return_val_if_fail(font_out != NULL, FALSE);
+	g_return_val_if_fail(glyph_out != NULL, FALSE);
+
+	if (gst_glyph_cache_lookup(self->glyphs, rune, style, &font, &glyph)) {
+		*font_out = (cairo_scaled_font_t *)font;
+		*glyph_out = glyph;
+		return (glyph != 0);
+	}
+
+	found = resolve_glyph(self, rune, style, font_out, glyph_out);
+	gst_glyph_cache_insert(self->glyphs, rune, style, *font_out,
+		found ? *glyph_out : 0);
+
+	return found;
+}
+
 /**
  * gst_cairo_font_cache_get_used_font:
  * @self: A #GstCairoFontCache
@@ -1002,8 +1058,161 @@ gst_cairo_font_cache_load_spare_fonts(
 		loaded++;
 	}
 
+	/* Earlier misses may now be satisfied by a spare font */
+	gst_glyph_cache_clear(self->glyphs);
+
 	g_debug("font2: loaded %u spare font specs (%d ring cache entries)",
 		loaded, self->frc_len);
 
 	return loaded;
 }
+
+/*
+ * font_has_color:
+ *
+ * Whether the FreeType face behind @font carries color glyphs
+ * (emoji). Those cannot be reduced to a coverage mask.
+ */
+static gboolean
+font_has_color(cairo_scaled_font_t *font)
+{
+	FT_Face ft_face;
+	gboolean color;
+
+	ft_face = cairo_ft_scaled_font_lock_face(font);
+	if (ft_face == NULL) {
+		return FALSE;
+	}
+	color = FT_HAS_COLOR(ft_face) ? TRUE : FALSE;
+	cairo_ft_scaled_font_unlock_face(font);
+
+	return color;
+}
+
+/*
+ * rasterize_glyph:
+ *
+ * Renders one glyph into a fresh A8 surface with a pixel of
+ * slack on every side (antialiasing bleeds past the ink
+ * extents) and stores it in the atlas.
+ */
+static void
+rasterize_glyph(
+	GstCairoFontCache       *self,
+	cairo_scaled_font_t     *font,
+	gulong                  glyph,
+	GstAtlasGlyph           *out
+){
+	cairo_glyph_t g;
+	cairo_text_extents_t ext;
+	cairo_surface_t *surface;
+	cairo_t *cr;
+	gint x0;
+	gint y0;
+	gint x1;
+	gint y1;
+
+	if (font_has_color(font)) {
+		gst_glyph_atlas_insert(self->atlas, font, glyph, NULL, 0, 0, 0,
+			0, 0, out);
+		return;
+	}
+
+	g.index = glyph;
+	g.x = 0;
+	g.y = 0;
+	cairo_scaled_font_glyph_extents(font, &g, 1, &ext);
+
+	if (ext.width <= 0 || ext.height <= 0) {
+		/* Blank glyph (space): an empty bitmap, nothing to blit */
+		gst_glyph_atlas_insert(self->atlas, font, glyph,
+			(const guint8 *)"", 0, 0, 0, 0, 0, out);
+		return;
+	}
+
+	x0 = (gint)floor(ext.x_bearing) - 1;
+	y0 = (gint)floor(ext.y_bearing) - 1;
+	x1 = (gint)ceil(ext.x_bearing + ext.width) + 1;
+	y1 = (gint)ceil(ext.y_bearing + ext.height) + 1;
+
+	surface = cairo_image_surface_create(CAIRO_FORMAT_A8,
+		x1 - x0, y1 - y0);
+	if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS) {
+		cairo_surface_destroy(surface);
+		gst_glyph_atlas_insert(self->atlas, font, glyph, NULL, 0, 0, 0,
+			0, 0, out);
+		return;
+	}
+
+	cr = cairo_create(surface);
+	cairo_set_scaled_font(cr, font);
+	cairo_set_source_rgba(cr, 0, 0, 0, 1);
+	g.x = -x0;
+	g.y = -y0;
+	cairo_show_glyphs(cr, &g, 1);
+	cairo_destroy(cr);
+
+	cairo_surface_flush(surface);
+	gst_glyph_atlas_insert(self->atlas, font, glyph,
+		cairo_image_surface_get_data(surface),
+		cairo_image_surface_get_stride(surface),
+		x1 - x0, y1 - y0, x0, y0, out);
+	cairo_surface_destroy(surface);
+}
+
+/**
+ * gst_cairo_font_cache_get_atlas_glyph:
+ * @self: A #GstCairoFontCache
+ * @font: scaled font returned by gst_cairo_font_cache_lookup_glyph()
+ * @glyph: glyph index within @font
+ * @out: (out): where the glyph's coverage lives in the atlas
+ *
+ * Looks up the rasterized coverage of a glyph, rendering it into
+ * the atlas on first use.
+ *
+ * Returns: FALSE if the glyph must be drawn through Cairo instead
+ */
+gboolean
+gst_cairo_font_cache_get_atlas_glyph(
+	GstCairoFontCache       *self,
+	cairo_scaled_font_t     *font,
+	gulong                  glyph,
+	GstAtlasGlyph           *out
+){
+	g_return_val_if_fail(GST_IS_CAIRO_FONT_CACHE(self), FALSE);
+	g_return_val_if_fail(font != NULL, FALSE);
+	g_return_val_if_fail(out != NULL, FALSE);
+
+	if (self->atlas == NULL) {
+		self->atlas = gst_glyph_atlas_new(GST_GLYPH_ATLAS_DEFAULT_SIZE,
+			GST_GLYPH_ATLAS_DEFAULT_SIZE);
+	}
+
+	if (!gst_glyph_atlas_lookup(self->atlas, font, glyph, out)) {
+		rasterize_glyph(self, font, glyph, out);
+	}
+
+	return !out->fallback;
+}
+
+/**
+ * gst_cairo_font_cache_get_atlas_pixels:
+ * @self: A #GstCairoFontCache
+ * @stride: (out): bytes per atlas row
+ *
+ * Returns: (transfer none) (nullable): the atlas coverage, or
+ *   %NULL if no glyph has been rasterized yet
+ */
+const guint8 *
+gst_cairo_font_cache_get_atlas_pixels(
+	GstCairoFontCache       *self,
+	gint                    *stride
+){
+	g_return_val_if_fail(GST_IS_CAIRO_FONT_CACHE(self), NULL);
+
+	if (self->atlas == NULL) {
+		return NULL;
+	}
+
+	return gst_glyph_atlas_get_pixels(self->atlas, stride);
+}
@@ -19,6 +19,7 @@
 #include <fontconfig/fontconfig.h>
 #include "../gst-enums.h"
 #include "../gst-types.h"
+#include "gst-glyph-atlas.h"
 
 G_BEGIN_DECLS
 
@@ -183,6 +184,44 @@ gst_cairo_font_cache_load_spare_fonts(
 	const gchar *const      *fonts
 );
 
+/**
+ * gst_cairo_font_cache_get_atlas_glyph:
+ * @self: A #GstCairoFontCache
+ * @font: scaled font returned by gst_cairo_font_cache_lookup_glyph()
+ * @glyph: glyph index within @font
+ * @out: (out): where the glyph's coverage lives in the atlas
+ *
+ * Looks up the pre-rasterized A8 coverage of a glyph, rendering it
+ * into the cache's glyph atlas on first use. Color (emoji) glyphs
+ * and glyphs too large for the atlas are not rasterized.
+ *
+ * Returns: FALSE if the glyph must be drawn through Cairo instead
+ */
+gboolean
+gst_cairo_font_cache_get_atlas_glyph(
+	GstCairoFontCache       *self,
+	cairo_scaled_font_t     *font,
+	gulong                  glyph,
+	GstAtlasGlyph           *out
+);
+
+/**
+ * gst_cairo_font_cache_get_atlas_pixels:
+ * @self: A #GstCairoFontCache
+ * @stride: (out): bytes per atlas row
+ *
+ * Gets the glyph atlas coverage that placements returned by
+ * gst_cairo_font_cache_get_atlas_glyph() refer to.
+ *
+ * Returns: (transfer none) (nullable): the A8 pixels, or %NULL
+ *   if no glyph has been rasterized yet
+ */
+const guint8 *
+gst_cairo_font_cache_get_atlas_pixels(
+	GstCairoFontCache       *self,
+	gint                    *stride
+);
+
 G_END_DECLS
 
 #endif /* GST_CAIRO_FONT_CACHE_H */
@@ -0,0 +1,235 @@
+/*
+ * gst-damage.c - Per-frame damage region accumulator
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * A small fixed array of rectangles. Lines redrawn one after another
+ * abut vertically and collapse into one rectangle; scattered updates
+ * stay separate until the array fills up.
+ */
+
+#include "gst-damage.h"
+
+struct _GstDamage {
+	GstDamageRect rects[GST_DAMAGE_MAX_RECTS];
+	guint n_rects;
+	gint width;
+	gint height;
+	gboolean full;
+};
+
+static gint64
+rect_area(const GstDamageRect *r)
+{
+	return (gint64)r->width * (gint64)r->height;
+}
+
+static void
+rect_union(
+	const GstDamageRect *a,
+	const GstDamageRect *b,
+	GstDamageRect       *out
+){
+	gint x1;
+	gint y1;
+	gint x2;
+	gint y2;
+
+	x1 = MIN(a->x, b->x);
+	y1 = MIN(a->y, b->y);
+	x2 = MAX(a->x + a->width, b->x + b->width);
+	y2 = MAX(a->y + a->height, b->y + b->height);
+
+	out->x = x1;
+	out->y = y1;
+	out->width = x2 - x1;
+	out->height = y2 - y1;
+}
+
+static gint64
+rect_overlap(
+	const GstDamageRect *a,
+	const GstDamageRect *b
+){
+	gint w;
+	gint h;
+
+	w = MIN(a->x + a->width, b->x + b->width) - MAX(a->x, b->x);
+	h = MIN(a->y + a->height, b->y + b->height) - MAX(a->y, b->y);
+	if (w <= 0 || h <= 0) {
+		return 0;
+	}
+	return (gint64)w * (gint64)h;
+}
+
+GstDamage *
+gst_damage_new(void)
+{
+	return g_new0(GstDamage, 1);
+}
+
+void
+gst_damage_free(GstDamage *damage)
+{
+	g_free(damage);
+}
+
+void
+gst_damage_set_bounds(
+	GstDamage   *damage,
+	gint        width,
+	gint        height
+){
+	g_return_if_fail(damage != NULL);
+
+	damage->width = MAX(width, 0);
+	damage->height = MAX(height, 0);
+	gst_damage_add_all(damage);
+}
+
+void
+gst_damage_add(
+	GstDamage   *damage,
+	gint        x,
+	gint        y,
+	gint        width,
+	gint        height
+){
+	GstDamageRect r;
+	GstDamageRect u;
+	gint64 best_growth;
+	guint best;
+	guint i;
+
+	g_return_if_fail(damage != NULL);
+
+	if (damage->full) {
+		return;
+	}
+
+	/* Clip to the surface */
+	if (x < 0) {
+		width += x;
+		x = 0;
+	}
+	if (y < 0) {
+		height += y;
+		y = 0;
+	}
+	width = MIN(width, damage->width - x);
+	height = MIN(height, damage->height - y);
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+
+	r.x = x;
+	r.y = y;
+	r.width = width;
+	r.height = height;
+
+	/* Merge when the union covers no undamaged pixels */
+	for (i = 0; i < damage->n_rects; i++) {
+		rect_union(&damage->rects[i], &r, &u);
+		if (rect_area(&u) <= rect_area(&damage->rects[i]) + rect_area(&r)
+		    - rect_overlap(&damage->rects[i], &r)) {
+			damage->rects[i] = u;
+			return;
+		}
+	}
+
+	if (damage->n_rects < GST_DAMAGE_MAX_RECTS) {
+		damage->rects[damage->n_rects++] = r;
+		return;
+	}
+
+	/* Full: grow whichever rectangle absorbs this one most cheaply */
+	best = 0;
+	best_growth = G_MAXINT64;
+	for (i = 0; i < damage->n_rects; i++) {
+		gint64 growth;
+
+		rect_union(&damage->rects[i], &r, &u);
+		growth = rect_area(&u) - rect_area(&damage->rects[i]);
+		if (growth < best_growth) {
+			best_growth = growth;
+			best = i;
+		}
+	}
+	rect_union(&damage->rects[best], &r, &damage->rects[best]);
+}
+
+void
+gst_damage_add_all(GstDamage *damage)
+{
+	g_return_if_fail(damage != NULL);
+
+	damage->rects[0].x = 0;
+	damage->rects[0].y = 0;
+	damage->rects[0].width = damage->width;
+	damage->rects[0].height = damage->height;
+	damage->n_rects = (damage->width > 0 && damage->height > 0) ? 1 : 0;
+	damage->full = TRUE;
+}
+
+void
+gst_damage_clear(GstDamage *damage)
+{
+	g_return_if_fail(damage != NULL);
+
+	damage->n_rects = 0;
+	damage->full = FALSE;
+}
+
+gboolean
+gst_damage_is_empty(GstDamage *damage)
+{
+	g_return_val_if_fail(damage != NULL, TRUE);
+
+	return damage->n_rects == 0;
+}
+
+gboolean
+gst_damage_is_full(GstDamage *damage)
+{
+	g_return_val_if_fail(damage != NULL, FALSE);
+
+	return damage->full;
+}
+
+gboolean
+gst_damage_intersects(
+	GstDamage   *damage,
+	gint        x,
+	gint        y,
+	gint        width,
+	gint        height
+){
+	GstDamageRect r;
+	guint i;
+
+	g_return_val_if_fail(damage != NULL, FALSE);
+
+	r.x = x;
+	r.y = y;
+	r.width = width;
+	r.height = height;
+	for (i = 0; i < damage->n_rects; i++) {
+		if (rect_overlap(&damage->rects[i], &r) > 0) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+const GstDamageRect *
+gst_damage_get_rects(
+	GstDamage   *damage,
+	guint       *n_rects
+){
+	g_return_val_if_fail(damage != NULL, NULL);
+	g_return_val_if_fail(n_rects != NULL, NULL);
+
+	*n_rects = damage->n_rects;
+	return damage->rects;
+}
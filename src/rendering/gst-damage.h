@@ -0,0 +1,171 @@
+/*
+ * gst-damage.h - Per-frame damage region accumulator
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Collects the pixel rectangles a renderer touched while drawing a
+ * frame, so presentation can copy or damage only those areas instead
+ * of the whole window.
+ */
+
+#ifndef GST_DAMAGE_H
+#define GST_DAMAGE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Rectangles kept before new damage is merged into existing ones */
+#define GST_DAMAGE_MAX_RECTS (16)
+
+typedef struct _GstDamage GstDamage;
+
+/**
+ * GstDamageRect:
+ * @x: left edge in pixels
+ * @y: top edge in pixels
+ * @width: width in pixels
+ * @height: height in pixels
+ *
+ * A damaged rectangle in surface coordinates.
+ */
+typedef struct
+{
+	gint x;
+	gint y;
+	gint width;
+	gint height;
+} GstDamageRect;
+
+/**
+ * gst_damage_new:
+ *
+ * Creates an empty damage region with no bounds.
+ *
+ * Returns: (transfer full): a new #GstDamage
+ */
+GstDamage *
+gst_damage_new(void);
+
+/**
+ * gst_damage_free:
+ * @damage: (nullable): a #GstDamage
+ *
+ * Frees the damage region.
+ */
+void
+gst_damage_free(GstDamage *damage);
+
+/**
+ * gst_damage_set_bounds:
+ * @damage: a #GstDamage
+ * @width: surface width in pixels
+ * @height: surface height in pixels
+ *
+ * Sets the surface size that added rectangles are clipped to.
+ * A new surface has no valid content, so the whole of it is
+ * marked damaged.
+ */
+void
+gst_damage_set_bounds(
+	GstDamage   *damage,
+	gint        width,
+	gint        height
+);
+
+/**
+ * gst_damage_add:
+ * @damage: a #GstDamage
+ * @x: left edge in pixels
+ * @y: top edge in pixels
+ * @width: width in pixels
+ * @height: height in pixels
+ *
+ * Adds a rectangle to the region. Rectangles that overlap or abut
+ * an existing one without adding undamaged area are merged into it.
+ * Once %GST_DAMAGE_MAX_RECTS are held, the new rectangle is merged
+ * into whichever existing one grows the least.
+ */
+void
+gst_damage_add(
+	GstDamage   *damage,
+	gint        x,
+	gint        y,
+	gint        width,
+	gint        height
+);
+
+/**
+ * gst_damage_add_all:
+ * @damage: a #GstDamage
+ *
+ * Marks the whole surface damaged.
+ */
+void
+gst_damage_add_all(GstDamage *damage);
+
+/**
+ * gst_damage_clear:
+ * @damage: a #GstDamage
+ *
+ * Empties the region, typically after the frame was presented.
+ */
+void
+gst_damage_clear(GstDamage *damage);
+
+/**
+ * gst_damage_is_empty:
+ * @damage: a #GstDamage
+ *
+ * Returns: %TRUE if nothing was damaged since the last clear
+ */
+gboolean
+gst_damage_is_empty(GstDamage *damage);
+
+/**
+ * gst_damage_is_full:
+ * @damage: a #GstDamage
+ *
+ * Returns: %TRUE if the whole surface is damaged
+ */
+gboolean
+gst_damage_is_full(GstDamage *damage);
+
+/**
+ * gst_damage_intersects:
+ * @damage: a #GstDamage
+ * @x: left edge in pixels
+ * @y: top edge in pixels
+ * @width: width in pixels
+ * @height: height in pixels
+ *
+ * Returns: %TRUE if any damaged rectangle overlaps the given one
+ */
+gboolean
+gst_damage_intersects(
+	GstDamage   *damage,
+	gint        x,
+	gint        y,
+	gint        width,
+	gint        height
+);
+
+/**
+ * gst_damage_get_rects:
+ * @damage: a #GstDamage
+ * @n_rects: (out): number of rectangles
+ *
+ * Gets the damaged rectangles. They may overlap.
+ *
+ * Returns: (transfer none) (array length=n_rects): the rectangles
+ */
+const GstDamageRect *
+gst_damage_get_rects(
+	GstDamage   *damage,
+	guint       *n_rects
+);
+
+G_END_DECLS
+
+#endif /* GST_DAMAGE_H */
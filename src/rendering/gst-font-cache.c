@@ -13,6 +13,7 @@
  */
 
 #include "gst-font-cache.h"
+#include "gst-glyph-cache.h"
 #include <math.h>
 #include <string.h>
 
@@ -58,6 +59,9 @@ struct _GstFontCache
 	gint frc_len;
 	gint frc_cap;
 
+	/* Resolved (rune, style) -> (font, glyph), misses included */
+	GstGlyphCache *glyphs;
+
 	/* Font name and size tracking */
 	gchar *used_font;
 	gdouble used_fontsize;
@@ -200,6 +204,7 @@ gst_font_cache_dispose(GObject *object)
 
 	g_clear_pointer(&self->used_font, g_free);
 	g_clear_pointer(&self->frc, g_free);
+	g_clear_pointer(&self->glyphs, gst_glyph_cache_free);
 
 	G_OBJECT_CLASS(gst_font_cache_parent_class)->dispose(object);
 }
@@ -226,6 +231,7 @@ gst_font_cache_init(GstFontCache *self)
 	self->frc = NULL;
 	self->frc_len = 0;
 	self->frc_cap = 0;
+	self->glyphs = gst_glyph_cache_new();
 	self->used_font = NULL;
 	self->used_fontsize = 0;
 	self->default_fontsize = 0;
@@ -251,7 +257,8 @@ gst_font_cache_new(void)
  * gst_font_cache_clear:
  * @self: A #GstFontCache
  *
- * Clears the fallback font ring cache.
+ * Clears the fallback font ring cache and the glyph lookups
+ * that may point into it.
  */
 void
 gst_font_cache_clear(GstFontCache *self)
@@ -260,6 +267,8 @@ gst_font_cache_clear(GstFontCache *self)
 
 	g_return_if_fail(GST_IS_FONT_CACHE(self));
 
+	gst_glyph_cache_clear(self->glyphs);
+
 	/* Free all ring cache fonts */
 	if (self->display != NULL) {
 		for (i = 0; i < self->frc_len; i++) {
@@ -301,6 +310,9 @@ gst_font_cache_load_fonts(
 	self->display = display;
 	self->screen = screen;
 
+	/* Cached lookups belong to the previous fonts (e.g. before zoom) */
+	gst_glyph_cache_clear(self->glyphs);
+
 	/* Parse font specification string */
 	if (fontstr[0] == '-') {
 		pattern = XftXlfdParse(fontstr, False, False);
@@ -472,21 +484,15 @@ gst_font_cache_get_char_height(GstFontCache *self)
 	return self->ch;
 }
 
-/**
- * gst_font_cache_lookup_glyph:
- * @self: A #GstFontCache
- * @rune: Unicode code point
- * @style: desired font style
- * @font_out: (out): XftFont containing the glyph
- * @glyph_out: (out): glyph index
- *
- * Looks up a glyph, searching main font, ring cache,
- * then fontconfig system fonts. Ports st's frc[] lookup.
+/*
+ * resolve_glyph:
  *
- * Returns: TRUE if glyph was found
+ * Uncached glyph search: main font, then the fallback ring, then
+ * fontconfig system fonts (adding the match to the ring). Ports
+ * st's frc[] lookup.
  */
-gboolean
-gst_font_cache_lookup_glyph(
+static gboolean
+resolve_glyph(
 	GstFontCache    *self,
 	GstRune         rune,
 	GstFontStyle    style,
@@ -502,10 +508,6 @@ gst_font_cache_lookup_glyph(
 	FcCharSet *fccharset;
 	FcFontSet *fcsets[1];
 
-	g_return_val_if_fail(GST_IS_FONT_CACHE(self), FALSE);
-	g_return_val_if_fail(font_out != NULL, FALSE);
-	g_return_val_if_fail(glyph_out != NULL, FALSE);
-
 	/* Get the appropriate font variant */
 	fv = gst_font_cache_get_font(self, style);
 
@@ -593,6 +595,49 @@ gst_font_cache_lookup_glyph(
 	return (glyphidx != 0);
 }
 
+/**
+ * gst_font_cache_lookup_glyph:
+ * @self: A #GstFontCache
+ * @rune: Unicode code point
+ * @style: desired font style
+ * @font_out: (out): XftFont containing the glyph
+ * @glyph_out: (out): glyph index
+ *
+ * Looks up a glyph, searching main font, ring cache,
+ * then fontconfig system fonts. Results, including misses,
+ * are cached per (rune, style) until the fonts change.
+ *
+ * Returns: TRUE if glyph was found
+ */
+gboolean
+gst_font_cache_lookup_glyph(
+	GstFontCache    *self,
+	GstRune         rune,
+	GstFontStyle    style,
+	XftFont         **font_out,
+	FT_UInt         *glyph_out
+){
+	gpointer font;
+	gulong glyph;
+	gboolean found;
+
+	g_return_val_if_fail(GST_IS_FONT_CACHE(self), FALSE);
+	g_return_val_if_fail(font_out != NULL, FALSE);
+	g_return_val_if_fail(glyph_out != NULL, FALSE);
+
+	if (gst_glyph_cache_lookup(self->glyphs, rune, style, &font, &glyph)) {
+		*font_out = (XftFont *)font;
+		*glyph_out = (FT_UInt)glyph;
+		return (glyph != 0);
+	}
+
+	found = resolve_glyph(self, rune, style, font_out, glyph_out);
+	gst_glyph_cache_insert(self->glyphs, rune, style, *font_out,
+		found ? (gulong)*glyph_out : 0);
+
+	return found;
+}
+
 /**
  * gst_font_cache_get_used_font:
  * @self: A #GstFontCache
@@ -769,6 +814,9 @@ gst_font_cache_load_spare_fonts(
 		loaded++;
 	}
 
+	/* Earlier misses may now be satisfied by a spare font */
+	gst_glyph_cache_clear(self->glyphs);
+
 	g_debug("font2: loaded %u spare font specs (%d ring cache entries)",
 		loaded, self->frc_len);
 
@@ -0,0 +1,268 @@
+/*
+ * gst-glyph-atlas.c - Pre-rasterized glyph atlas
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Bitmaps are packed left to right on shelves as tall as the
+ * tallest bitmap placed on them. Terminal glyphs of one font are
+ * nearly the same height, so shelves waste little space. Lookups
+ * go through an open-addressed table keyed by (font, glyph).
+ */
+
+#include "gst-glyph-atlas.h"
+#include <string.h>
+
+/* Initial slot count of the lookup table (power of two) */
+#define ATLAS_TABLE_INIT (256)
+
+/* Empty pixels kept between neighbouring bitmaps */
+#define ATLAS_PAD (1)
+
+typedef struct {
+	gconstpointer font;     /* NULL marks an empty slot */
+	gulong glyph;
+	GstAtlasGlyph placement;
+} AtlasSlot;
+
+struct _GstGlyphAtlas {
+	guint8 *pixels;
+	gint width;
+	gint height;
+
+	/* Shelf packer state */
+	gint shelf_y;
+	gint shelf_h;
+	gint pen_x;
+
+	AtlasSlot *table;
+	guint table_size;
+	guint n_glyphs;
+};
+
+static guint
+atlas_hash(
+	gconstpointer   font,
+	gulong          glyph
+){
+	guint64 h;
+
+	h = (guint64)(gsize)font ^ ((guint64)glyph * G_GUINT64_CONSTANT(0x9E3779B97F4A7C15));
+	h ^= h >> 29;
+	h *= G_GUINT64_CONSTANT(0xBF58476D1CE4E5B9);
+	h ^= h >> 32;
+	return (guint)h;
+}
+
+static AtlasSlot *
+atlas_find_slot(
+	AtlasSlot       *table,
+	guint           size,
+	gconstpointer   font,
+	gulong          glyph
+){
+	guint i;
+
+	i = atlas_hash(font, glyph) & (size - 1);
+	while (table[i].font != NULL
+	       && (table[i].font != font || table[i].glyph != glyph)) {
+		i = (i + 1) & (size - 1);
+	}
+	return &table[i];
+}
+
+static void
+atlas_grow_table(GstGlyphAtlas *atlas)
+{
+	AtlasSlot *old;
+	guint old_size;
+	guint i;
+
+	old = atlas->table;
+	old_size = atlas->table_size;
+
+	atlas->table_size = old_size * 2;
+	atlas->table = g_new0(AtlasSlot, atlas->table_size);
+
+	for (i = 0; i < old_size; i++) {
+		if (old[i].font != NULL) {
+			*atlas_find_slot(atlas->table, atlas->table_size,
+				old[i].font, old[i].glyph) = old[i];
+		}
+	}
+	g_free(old);
+}
+
+/*
+ * atlas_reserve:
+ *
+ * Finds room for a @width x @height bitmap, opening a new shelf
+ * when the current one is full.
+ *
+ * Returns: FALSE if the atlas has no room left
+ */
+static gboolean
+atlas_reserve(
+	GstGlyphAtlas   *atlas,
+	gint            width,
+	gint            height,
+	gint            *x,
+	gint            *y
+){
+	if (atlas->pen_x + width > atlas->width) {
+		atlas->shelf_y += atlas->shelf_h + ATLAS_PAD;
+		atlas->shelf_h = 0;
+		atlas->pen_x = 0;
+	}
+	if (atlas->shelf_y + height > atlas->height) {
+		return FALSE;
+	}
+
+	*x = atlas->pen_x;
+	*y = atlas->shelf_y;
+	atlas->pen_x += width + ATLAS_PAD;
+	atlas->shelf_h = MAX(atlas->shelf_h, height);
+	return TRUE;
+}
+
+GstGlyphAtlas *
+gst_glyph_atlas_new(
+	gint    width,
+	gint    height
+){
+	GstGlyphAtlas *atlas;
+
+	g_return_val_if_fail(width > 0 && height > 0, NULL);
+
+	atlas = g_new0(GstGlyphAtlas, 1);
+	atlas->width = width;
+	atlas->height = height;
+	atlas->pixels = g_new0(guint8, (gsize)width * (gsize)height);
+	atlas->table_size = ATLAS_TABLE_INIT;
+	atlas->table = g_new0(AtlasSlot, atlas->table_size);
+
+	return atlas;
+}
+
+void
+gst_glyph_atlas_free(GstGlyphAtlas *atlas)
+{
+	if (atlas == NULL) {
+		return;
+	}
+
+	g_free(atlas->table);
+	g_free(atlas->pixels);
+	g_free(atlas);
+}
+
+void
+gst_glyph_atlas_clear(GstGlyphAtlas *atlas)
+{
+	g_return_if_fail(atlas != NULL);
+
+	memset(atlas->table, 0, sizeof(AtlasSlot) * atlas->table_size);
+	atlas->n_glyphs = 0;
+	atlas->shelf_y = 0;
+	atlas->shelf_h = 0;
+	atlas->pen_x = 0;
+}
+
+gboolean
+gst_glyph_atlas_lookup(
+	GstGlyphAtlas   *atlas,
+	gconstpointer   font,
+	gulong          glyph,
+	GstAtlasGlyph   *out
+){
+	AtlasSlot *slot;
+
+	g_return_val_if_fail(atlas != NULL, FALSE);
+	g_return_val_if_fail(font != NULL, FALSE);
+
+	slot = atlas_find_slot(atlas->table, atlas->table_size, font, glyph);
+	if (slot->font == NULL) {
+		return FALSE;
+	}
+
+	*out = slot->placement;
+	return TRUE;
+}
+
+void
+gst_glyph_atlas_insert(
+	GstGlyphAtlas   *atlas,
+	gconstpointer   font,
+	gulong          glyph,
+	const guint8    *pixels,
+	gint            stride,
+	gint            width,
+	gint            height,
+	gint            off_x,
+	gint            off_y,
+	GstAtlasGlyph   *out
+){
+	AtlasSlot *slot;
+	GstAtlasGlyph p;
+	gint row;
+
+	g_return_if_fail(atlas != NULL);
+	g_return_if_fail(font != NULL);
+
+	memset(&p, 0, sizeof(p));
+	p.off_x = off_x;
+	p.off_y = off_y;
+
+	if (pixels == NULL || width > atlas->width || height > atlas->height) {
+		p.fallback = TRUE;
+	} else if (width > 0 && height > 0) {
+		if (!atlas_reserve(atlas, width, height, &p.x, &p.y)) {
+			/* Full: start over rather than track per-glyph usage */
+			gst_glyph_atlas_clear(atlas);
+			atlas_reserve(atlas, width, height, &p.x, &p.y);
+		}
+		p.width = width;
+		p.height = height;
+		for (row = 0; row < height; row++) {
+			memcpy(atlas->pixels + (gsize)(p.y + row) * (gsize)atlas->width + p.x,
+				pixels + (gsize)row * (gsize)stride, (gsize)width);
+		}
+	}
+
+	if ((atlas->n_glyphs + 1) * 2 > atlas->table_size) {
+		atlas_grow_table(atlas);
+	}
+
+	slot = atlas_find_slot(atlas->table, atlas->table_size, font, glyph);
+	if (slot->font == NULL) {
+		atlas->n_glyphs++;
+	}
+	slot->font = font;
+	slot->glyph = glyph;
+	slot->placement = p;
+
+	if (out != NULL) {
+		*out = p;
+	}
+}
+
+const guint8 *
+gst_glyph_atlas_get_pixels(
+	GstGlyphAtlas   *atlas,
+	gint            *stride
+){
+	g_return_val_if_fail(atlas != NULL, NULL);
+
+	if (stride != NULL) {
+		*stride = atlas->width;
+	}
+	return atlas->pixels;
+}
+
+guint
+gst_glyph_atlas_get_n_glyphs(GstGlyphAtlas *atlas)
+{
+	g_return_val_if_fail(atlas != NULL, 0);
+
+	return atlas->n_glyphs;
+}
@@ -0,0 +1,159 @@
+/*
+ * gst-glyph-atlas.h - Pre-rasterized glyph atlas
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * An 8-bit coverage (A8) texture holding glyphs rasterized once
+ * per (scaled font, glyph index), so a renderer can blit cells
+ * straight into its pixel buffer instead of going through a
+ * vector rasterizer on every draw.
+ */
+
+#ifndef GST_GLYPH_ATLAS_H
+#define GST_GLYPH_ATLAS_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Default atlas page dimensions in pixels (1 MiB of coverage) */
+#define GST_GLYPH_ATLAS_DEFAULT_SIZE (1024)
+
+typedef struct _GstGlyphAtlas GstGlyphAtlas;
+
+/**
+ * GstAtlasGlyph:
+ * @x: left edge of the bitmap in the atlas
+ * @y: top edge of the bitmap in the atlas
+ * @width: bitmap width in pixels (0 for blank glyphs)
+ * @height: bitmap height in pixels
+ * @off_x: offset from the pen position to the bitmap's left edge
+ * @off_y: offset from the baseline to the bitmap's top edge
+ * @fallback: the glyph has no bitmap and must be drawn some other
+ *   way (color glyphs, or too large for the atlas)
+ *
+ * Where a glyph's coverage lives in the atlas and how to place it.
+ */
+typedef struct
+{
+	gint x;
+	gint y;
+	gint width;
+	gint height;
+	gint off_x;
+	gint off_y;
+	gboolean fallback;
+} GstAtlasGlyph;
+
+/**
+ * gst_glyph_atlas_new:
+ * @width: atlas width in pixels
+ * @height: atlas height in pixels
+ *
+ * Creates an empty atlas backed by a zeroed A8 buffer.
+ *
+ * Returns: (transfer full): a new #GstGlyphAtlas
+ */
+GstGlyphAtlas *
+gst_glyph_atlas_new(
+	gint    width,
+	gint    height
+);
+
+/**
+ * gst_glyph_atlas_free:
+ * @atlas: (nullable): a #GstGlyphAtlas
+ *
+ * Frees the atlas. Font pointers used as keys are not owned.
+ */
+void
+gst_glyph_atlas_free(GstGlyphAtlas *atlas);
+
+/**
+ * gst_glyph_atlas_clear:
+ * @atlas: a #GstGlyphAtlas
+ *
+ * Forgets every glyph. Must be called whenever a font used as a
+ * key is destroyed or rescaled.
+ */
+void
+gst_glyph_atlas_clear(GstGlyphAtlas *atlas);
+
+/**
+ * gst_glyph_atlas_lookup:
+ * @atlas: a #GstGlyphAtlas
+ * @font: font the glyph belongs to
+ * @glyph: glyph index within @font
+ * @out: (out): placement of the glyph
+ *
+ * Returns: TRUE if the glyph is in the atlas
+ */
+gboolean
+gst_glyph_atlas_lookup(
+	GstGlyphAtlas   *atlas,
+	gconstpointer   font,
+	gulong          glyph,
+	GstAtlasGlyph   *out
+);
+
+/**
+ * gst_glyph_atlas_insert:
+ * @atlas: a #GstGlyphAtlas
+ * @font: font the glyph belongs to
+ * @glyph: glyph index within @font
+ * @pixels: (nullable): A8 coverage, or %NULL to record a fallback
+ * @stride: bytes per row of @pixels
+ * @width: bitmap width
+ * @height: bitmap height
+ * @off_x: offset from the pen position to the bitmap's left edge
+ * @off_y: offset from the baseline to the bitmap's top edge
+ * @out: (out): placement of the stored glyph
+ *
+ * Copies a rasterized glyph into the atlas. Bitmaps are packed on
+ * shelves; when the atlas is full it is cleared and packing starts
+ * over, so previously returned placements must not be kept across
+ * inserts. A bitmap larger than the atlas is recorded as a fallback.
+ */
+void
+gst_glyph_atlas_insert(
+	GstGlyphAtlas   *atlas,
+	gconstpointer   font,
+	gulong          glyph,
+	const guint8    *pixels,
+	gint            stride,
+	gint            width,
+	gint            height,
+	gint            off_x,
+	gint            off_y,
+	GstAtlasGlyph   *out
+);
+
+/**
+ * gst_glyph_atlas_get_pixels:
+ * @atlas: a #GstGlyphAtlas
+ * @stride: (out): bytes per atlas row
+ *
+ * Gets the atlas coverage buffer. The pointer stays valid for the
+ * life of the atlas.
+ *
+ * Returns: (transfer none): the A8 pixels
+ */
+const guint8 *
+gst_glyph_atlas_get_pixels(
+	GstGlyphAtlas   *atlas,
+	gint            *stride
+);
+
+/**
+ * gst_glyph_atlas_get_n_glyphs:
+ * @atlas: a #GstGlyphAtlas
+ *
+ * Returns: number of glyphs currently stored, fallbacks included
+ */
+guint
+gst_glyph_atlas_get_n_glyphs(GstGlyphAtlas *atlas);
+
+G_END_DECLS
+
+#endif /* GST_GLYPH_ATLAS_H */
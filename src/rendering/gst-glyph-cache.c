@@ -0,0 +1,138 @@
+/*
+ * gst-glyph-cache.c - Codepoint to glyph lookup cache
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Caches the outcome of font lookups, hits and misses alike, keyed
+ * by (rune, style). Latin runes index a flat per-style table; the
+ * rest share a hash table keyed by (rune << 2 | style).
+ */
+
+#include "gst-glyph-cache.h"
+#include <string.h>
+
+/* Number of GstFontStyle values (regular, italic, bold, bold+italic) */
+#define GLYPH_CACHE_STYLES (4)
+
+/* Largest rune whose hash key (rune << 2 | style) fits in a guint */
+#define GLYPH_CACHE_MAX_RUNE (G_MAXUINT >> 2)
+
+typedef struct {
+	gpointer font;
+	gulong glyph;
+	gboolean valid;
+} GlyphCacheEntry;
+
+struct _GstGlyphCache {
+	GlyphCacheEntry direct[GLYPH_CACHE_STYLES][GST_GLYPH_CACHE_DIRECT];
+	guint n_direct;
+	GHashTable *map;    /* GUINT key -> GlyphCacheEntry* */
+};
+
+GstGlyphCache *
+gst_glyph_cache_new(void)
+{
+	GstGlyphCache *cache;
+
+	cache = g_new0(GstGlyphCache, 1);
+	cache->map = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+		NULL, g_free);
+
+	return cache;
+}
+
+void
+gst_glyph_cache_free(GstGlyphCache *cache)
+{
+	if (cache == NULL) {
+		return;
+	}
+
+	g_hash_table_destroy(cache->map);
+	g_free(cache);
+}
+
+void
+gst_glyph_cache_clear(GstGlyphCache *cache)
+{
+	g_return_if_fail(cache != NULL);
+
+	memset(cache->direct, 0, sizeof(cache->direct));
+	cache->n_direct = 0;
+	g_hash_table_remove_all(cache->map);
+}
+
+gboolean
+gst_glyph_cache_lookup(
+	GstGlyphCache   *cache,
+	GstRune         rune,
+	GstFontStyle    style,
+	gpointer        *font_out,
+	gulong          *glyph_out
+){
+	GlyphCacheEntry *e;
+
+	g_return_val_if_fail(cache != NULL, FALSE);
+	g_return_val_if_fail((guint)style < GLYPH_CACHE_STYLES, FALSE);
+
+	if (rune < GST_GLYPH_CACHE_DIRECT) {
+		e = &cache->direct[style][rune];
+		if (!e->valid) {
+			return FALSE;
+		}
+	} else {
+		if (rune > GLYPH_CACHE_MAX_RUNE) {
+			return FALSE;
+		}
+		e = (GlyphCacheEntry *)g_hash_table_lookup(cache->map,
+			GUINT_TO_POINTER((rune << 2) | (guint)style));
+		if (e == NULL) {
+			return FALSE;
+		}
+	}
+
+	*font_out = e->font;
+	*glyph_out = e->glyph;
+	return TRUE;
+}
+
+void
+gst_glyph_cache_insert(
+	GstGlyphCache   *cache,
+	GstRune         rune,
+	GstFontStyle    style,
+	gpointer        font,
+	gulong          glyph
+){
+	GlyphCacheEntry *e;
+
+	g_return_if_fail(cache != NULL);
+	g_return_if_fail((guint)style < GLYPH_CACHE_STYLES);
+
+	if (rune < GST_GLYPH_CACHE_DIRECT) {
+		e = &cache->direct[style][rune];
+		if (!e->valid) {
+			cache->n_direct++;
+		}
+	} else {
+		if (rune > GLYPH_CACHE_MAX_RUNE) {
+			return;
+		}
+		e = g_new(GlyphCacheEntry, 1);
+		g_hash_table_insert(cache->map,
+			GUINT_TO_POINTER((rune << 2) | (guint)style), e);
+	}
+
+	e->font = font;
+	e->glyph = glyph;
+	e->valid = TRUE;
+}
+
+guint
+gst_glyph_cache_get_size(GstGlyphCache *cache)
+{
+	g_return_val_if_fail(cache != NULL, 0);
+
+	return cache->n_direct + g_hash_table_size(cache->map);
+}
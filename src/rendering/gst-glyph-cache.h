@@ -0,0 +1,111 @@
+/*
+ * gst-glyph-cache.h - Codepoint to glyph lookup cache
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Remembers which font and glyph index a (rune, style) pair
+ * resolved to, so font caches only search their main font and
+ * fallback ring the first time a character is drawn.
+ */
+
+#ifndef GST_GLYPH_CACHE_H
+#define GST_GLYPH_CACHE_H
+
+#include <glib.h>
+#include "../gst-enums.h"
+#include "../gst-types.h"
+
+G_BEGIN_DECLS
+
+/* Runes below this are kept in a direct-mapped table per style */
+#define GST_GLYPH_CACHE_DIRECT (0x100)
+
+typedef struct _GstGlyphCache GstGlyphCache;
+
+/**
+ * gst_glyph_cache_new:
+ *
+ * Creates an empty glyph lookup cache. Runes below
+ * %GST_GLYPH_CACHE_DIRECT are stored in a per-style array;
+ * all others go to a hash table.
+ *
+ * Returns: (transfer full): a new #GstGlyphCache
+ */
+GstGlyphCache *
+gst_glyph_cache_new(void);
+
+/**
+ * gst_glyph_cache_free:
+ * @cache: (nullable): a #GstGlyphCache
+ *
+ * Frees the cache. The cached font pointers are not owned.
+ */
+void
+gst_glyph_cache_free(GstGlyphCache *cache);
+
+/**
+ * gst_glyph_cache_clear:
+ * @cache: a #GstGlyphCache
+ *
+ * Forgets every cached result. Must be called whenever a font
+ * a result may point to is closed, or the set of fonts that
+ * could satisfy a lookup changes (zoom, reload, spare fonts).
+ */
+void
+gst_glyph_cache_clear(GstGlyphCache *cache);
+
+/**
+ * gst_glyph_cache_lookup:
+ * @cache: a #GstGlyphCache
+ * @rune: Unicode code point
+ * @style: font style
+ * @font_out: (out) (transfer none): the cached font
+ * @glyph_out: (out): the cached glyph index, 0 for a cached miss
+ *
+ * Looks up a previously stored result.
+ *
+ * Returns: %TRUE if (@rune, @style) is cached
+ */
+gboolean
+gst_glyph_cache_lookup(
+	GstGlyphCache   *cache,
+	GstRune         rune,
+	GstFontStyle    style,
+	gpointer        *font_out,
+	gulong          *glyph_out
+);
+
+/**
+ * gst_glyph_cache_insert:
+ * @cache: a #GstGlyphCache
+ * @rune: Unicode code point
+ * @style: font style
+ * @font: (nullable): font the rune resolved to
+ * @glyph: glyph index in @font, or 0 to cache a miss
+ *
+ * Stores the result of a lookup, replacing any previous one.
+ */
+void
+gst_glyph_cache_insert(
+	GstGlyphCache   *cache,
+	GstRune         rune,
+	GstFontStyle    style,
+	gpointer        font,
+	gulong          glyph
+);
+
+/**
+ * gst_glyph_cache_get_size:
+ * @cache: a #GstGlyphCache
+ *
+ * Gets the number of cached (rune, style) results.
+ *
+ * Returns: the number of entries
+ */
+guint
+gst_glyph_cache_get_size(GstGlyphCache *cache);
+
+G_END_DECLS
+
+#endif /* GST_GLYPH_CACHE_H */
@@ -0,0 +1,220 @@
+/*
+ * gst-image-cache.c - Budgeted cache of backend image resources
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * A terminal shows a handful of images at a time (a wallpaper,
+ * some inline graphics), so entries live in a flat array searched
+ * linearly. Recency is a per-lookup tick; eviction drops the entry
+ * with the oldest tick.
+ */
+
+#include "gst-image-cache.h"
+
+typedef struct {
+	guint handle;
+	gpointer resource;
+	gsize bytes;
+	guint64 last_used;
+} ImageEntry;
+
+struct _GstImageCache {
+	ImageEntry *entries;
+	guint n_entries;
+	guint cap;
+
+	gsize budget;
+	gsize bytes;
+	guint next_handle;
+	guint64 tick;
+
+	GstImageCacheFreeFunc free_func;
+	gpointer user_data;
+};
+
+static gint
+image_find(
+	GstImageCache   *cache,
+	guint           handle
+){
+	guint i;
+
+	for (i = 0; i < cache->n_entries; i++) {
+		if (cache->entries[i].handle == handle) {
+			return (gint)i;
+		}
+	}
+	return -1;
+}
+
+/* Releases entry @i and fills its slot with the last entry */
+static void
+image_drop(
+	GstImageCache   *cache,
+	guint           i
+){
+	ImageEntry *e;
+
+	e = &cache->entries[i];
+	cache->bytes -= e->bytes;
+	if (cache->free_func != NULL) {
+		cache->free_func(e->resource, cache->user_data);
+	}
+
+	cache->n_entries--;
+	if (i != cache->n_entries) {
+		*e = cache->entries[cache->n_entries];
+	}
+}
+
+static void
+image_evict_lru(GstImageCache *cache)
+{
+	guint oldest;
+	guint i;
+
+	oldest = 0;
+	for (i = 1; i < cache->n_entries; i++) {
+		if (cache->entries[i].last_used < cache->entries[oldest].last_used) {
+			oldest = i;
+		}
+	}
+	image_drop(cache, oldest);
+}
+
+GstImageCache *
+gst_image_cache_new(
+	gsize                   budget,
+	GstImageCacheFreeFunc   free_func,
+	gpointer                user_data
+){
+	GstImageCache *cache;
+
+	cache = g_new0(GstImageCache, 1);
+	cache->budget = budget;
+	cache->next_handle = 1;
+	cache->free_func = free_func;
+	cache->user_data = user_data;
+
+	return cache;
+}
+
+void
+gst_image_cache_free(GstImageCache *cache)
+{
+	if (cache == NULL) {
+		return;
+	}
+
+	gst_image_cache_clear(cache);
+	g_free(cache->entries);
+	g_free(cache);
+}
+
+guint
+gst_image_cache_insert(
+	GstImageCache   *cache,
+	gpointer        resource,
+	gsize           bytes
+){
+	ImageEntry *e;
+
+	g_return_val_if_fail(cache != NULL, 0);
+	g_return_val_if_fail(resource != NULL, 0);
+
+	if (bytes > cache->budget) {
+		if (cache->free_func != NULL) {
+			cache->free_func(resource, cache->user_data);
+		}
+		return 0;
+	}
+
+	while (cache->n_entries > 0 && cache->bytes + bytes > cache->budget) {
+		image_evict_lru(cache);
+	}
+
+	if (cache->n_entries == cache->cap) {
+		cache->cap = (cache->cap == 0) ? 8 : cache->cap * 2;
+		cache->entries = g_renew(ImageEntry, cache->entries, cache->cap);
+	}
+
+	e = &cache->entries[cache->n_entries++];
+	e->handle = cache->next_handle++;
+	if (cache->next_handle == 0) {
+		cache->next_handle = 1;
+	}
+	e->resource = resource;
+	e->bytes = bytes;
+	e->last_used = ++cache->tick;
+	cache->bytes += bytes;
+
+	return e->handle;
+}
+
+gpointer
+gst_image_cache_lookup(
+	GstImageCache   *cache,
+	guint           handle
+){
+	gint i;
+
+	g_return_val_if_fail(cache != NULL, NULL);
+
+	if (handle == 0) {
+		return NULL;
+	}
+
+	i = image_find(cache, handle);
+	if (i < 0) {
+		return NULL;
+	}
+
+	cache->entries[i].last_used = ++cache->tick;
+	return cache->entries[i].resource;
+}
+
+void
+gst_image_cache_remove(
+	GstImageCache   *cache,
+	guint           handle
+){
+	gint i;
+
+	g_return_if_fail(cache != NULL);
+
+	if (handle == 0) {
+		return;
+	}
+
+	i = image_find(cache, handle);
+	if (i >= 0) {
+		image_drop(cache, (guint)i);
+	}
+}
+
+void
+gst_image_cache_clear(GstImageCache *cache)
+{
+	g_return_if_fail(cache != NULL);
+
+	while (cache->n_entries > 0) {
+		image_drop(cache, cache->n_entries - 1);
+	}
+}
+
+gsize
+gst_image_cache_get_bytes(GstImageCache *cache)
+{
+	g_return_val_if_fail(cache != NULL, 0);
+
+	return cache->bytes;
+}
+
+guint
+gst_image_cache_get_n_images(GstImageCache *cache)
+{
+	g_return_val_if_fail(cache != NULL, 0);
+
+	return cache->n_entries;
+}
@@ -0,0 +1,139 @@
+/*
+ * gst-image-cache.h - Budgeted cache of backend image resources
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Maps integer handles to images a backend has already uploaded
+ * (an XRender Picture, a cairo surface), so modules can draw the
+ * same pixels every frame without converting and uploading them
+ * again. The cache owns the resources and evicts the least
+ * recently drawn ones once their total size exceeds a budget.
+ */
+
+#ifndef GST_IMAGE_CACHE_H
+#define GST_IMAGE_CACHE_H
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* Default budget for cached image memory (128 MiB) */
+#define GST_IMAGE_CACHE_DEFAULT_BUDGET ((gsize)128 * 1024 * 1024)
+
+typedef struct _GstImageCache GstImageCache;
+
+/**
+ * GstImageCacheFreeFunc:
+ * @resource: backend resource being dropped
+ * @user_data: data passed to gst_image_cache_new()
+ *
+ * Releases a backend resource when its entry is removed or evicted.
+ */
+typedef void (*GstImageCacheFreeFunc)(gpointer resource, gpointer user_data);
+
+/**
+ * gst_image_cache_new:
+ * @budget: most bytes of image data to keep
+ * @free_func: releases evicted resources
+ * @user_data: passed to @free_func
+ *
+ * Creates an empty image cache.
+ *
+ * Returns: (transfer full): a new #GstImageCache
+ */
+GstImageCache *
+gst_image_cache_new(
+	gsize                   budget,
+	GstImageCacheFreeFunc   free_func,
+	gpointer                user_data
+);
+
+/**
+ * gst_image_cache_free:
+ * @cache: (nullable): a #GstImageCache
+ *
+ * Releases every cached resource and frees the cache.
+ */
+void
+gst_image_cache_free(GstImageCache *cache);
+
+/**
+ * gst_image_cache_insert:
+ * @cache: a #GstImageCache
+ * @resource: (transfer full): backend resource
+ * @bytes: memory the resource accounts for
+ *
+ * Stores @resource under a new handle, evicting the least recently
+ * used entries until the cache fits its budget again. A resource
+ * larger than the whole budget is released immediately.
+ *
+ * Returns: the new handle, or 0 if @resource was not cached
+ */
+guint
+gst_image_cache_insert(
+	GstImageCache   *cache,
+	gpointer        resource,
+	gsize           bytes
+);
+
+/**
+ * gst_image_cache_lookup:
+ * @cache: a #GstImageCache
+ * @handle: handle returned by gst_image_cache_insert()
+ *
+ * Gets the resource for @handle and marks it as recently used.
+ * Handles are never reused, so a stale handle simply misses.
+ *
+ * Returns: (transfer none) (nullable): the resource, or %NULL if
+ *   @handle was removed or evicted
+ */
+gpointer
+gst_image_cache_lookup(
+	GstImageCache   *cache,
+	guint           handle
+);
+
+/**
+ * gst_image_cache_remove:
+ * @cache: a #GstImageCache
+ * @handle: handle to drop
+ *
+ * Releases the resource for @handle. Unknown handles are ignored.
+ */
+void
+gst_image_cache_remove(
+	GstImageCache   *cache,
+	guint           handle
+);
+
+/**
+ * gst_image_cache_clear:
+ * @cache: a #GstImageCache
+ *
+ * Releases every cached resource.
+ */
+void
+gst_image_cache_clear(GstImageCache *cache);
+
+/**
+ * gst_image_cache_get_bytes:
+ * @cache: a #GstImageCache
+ *
+ * Returns: bytes currently accounted to cached resources
+ */
+gsize
+gst_image_cache_get_bytes(GstImageCache *cache);
+
+/**
+ * gst_image_cache_get_n_images:
+ * @cache: a #GstImageCache
+ *
+ * Returns: number of cached resources
+ */
+guint
+gst_image_cache_get_n_images(GstImageCache *cache);
+
+G_END_DECLS
+
+#endif /* GST_IMAGE_CACHE_H */
@@ -19,6 +19,8 @@
 #include <glib.h>
 #include "../gst-types.h"
 #include "../gst-enums.h"
+#include "gst-damage.h"
+#include "gst-image-cache.h"
 
 G_BEGIN_DECLS
 
@@ -88,6 +90,28 @@ struct _GstRenderContextOps
 	 */
 	void (*draw_glyph_id)(GstRenderContext *ctx, guint32 glyph_id,
 	                      GstFontStyle style, gint px, gint py);
+
+	/* Upload an RGBA image into the context's image cache.
+	 * Arguments are as for draw_image. Returns a handle for
+	 * draw_image_handle, or 0 if the image could not be cached.
+	 *
+	 * May be NULL if the backend does not cache images.
+	 */
+	guint (*register_image)(GstRenderContext *ctx,
+	                        const guint8 *data,
+	                        gint src_w, gint src_h, gint src_stride);
+
+	/* Draw part of a registered image.
+	 * @src_x, @src_y, @src_w, @src_h: source rectangle in image pixels
+	 * @dst_x, @dst_y, @dst_w, @dst_h: destination rectangle
+	 *
+	 * Returns FALSE if @handle is no longer cached.
+	 */
+	gboolean (*draw_image_handle)(GstRenderContext *ctx, guint handle,
+	                              gint src_x, gint src_y,
+	                              gint src_w, gint src_h,
+	                              gint dst_x, gint dst_y,
+	                              gint dst_w, gint dst_h);
 };
 
 /**
@@ -101,6 +125,8 @@ struct _GstRenderContextOps
  * @win_h: window height in pixels
  * @win_mode: current window mode flags
  * @glyph_attr: per-glyph attributes (set during draw_line dispatch)
+ * @damage: (nullable): region the backend adds every drawn rectangle to
+ * @images: (nullable): the renderer's uploaded images, shared across frames
  *
  * Abstract base render context. Backend-specific contexts embed this
  * struct as their first member, allowing safe casting from the
@@ -123,10 +149,37 @@ struct _GstRenderContext
 	gint          current_cols;  /* total columns in the terminal */
 	gboolean      has_wallpaper;   /* TRUE when a background provider is active */
 	gdouble       wallpaper_bg_alpha; /* cell bg alpha for default-bg cells */
+	GstDamage    *damage;      /* frame damage, NULL when not tracked */
+	GstImageCache *images;     /* uploaded images, NULL when not cached */
 };
 
 /* ===== Inline dispatch helpers ===== */
 
+/**
+ * gst_render_context_add_damage:
+ * @ctx: render context
+ * @x: left edge in pixels
+ * @y: top edge in pixels
+ * @w: width in pixels
+ * @h: height in pixels
+ *
+ * Records that an area of the frame was drawn to, so the renderer
+ * presents it. Backend ops call this for every primitive; modules
+ * only need it when they draw through backend handles directly.
+ */
+static inline void
+gst_render_context_add_damage(
+	GstRenderContext *ctx,
+	gint              x,
+	gint              y,
+	gint              w,
+	gint              h
+){
+	if (ctx->damage != NULL) {
+		gst_damage_add(ctx->damage, x, y, w, h);
+	}
+}
+
 /**
  * gst_render_context_fill_rect:
  * @ctx: render context
@@ -307,6 +360,150 @@ gst_render_context_draw_glyph_id(
 	}
 }
 
+/**
+ * gst_render_context_register_image:
+ * @ctx: render context
+ * @data: RGBA pixel data (4 bytes per pixel, row-major)
+ * @src_w: image width in pixels
+ * @src_h: image height in pixels
+ * @src_stride: bytes per row in @data
+ *
+ * Converts and uploads an image once so it can be drawn every
+ * frame with gst_render_context_draw_image_handle(). The handle
+ * stays valid across frames until the image is released or
+ * evicted to keep the renderer within its image memory budget.
+ *
+ * Returns: a handle, or 0 if the backend does not cache images
+ *   or the image does not fit the budget
+ */
+static inline guint
+gst_render_context_register_image(
+	GstRenderContext *ctx,
+	const guint8     *data,
+	gint              src_w,
+	gint              src_h,
+	gint              src_stride
+){
+	if (ctx->ops->register_image == NULL || ctx->images == NULL) {
+		return 0;
+	}
+	return ctx->ops->register_image(ctx, data, src_w, src_h, src_stride);
+}
+
+/**
+ * gst_render_context_draw_image_handle:
+ * @ctx: render context
+ * @handle: handle from gst_render_context_register_image()
+ * @src_x: left edge of the source rectangle
+ * @src_y: top edge of the source rectangle
+ * @src_w: source rectangle width
+ * @src_h: source rectangle height
+ * @dst_x: destination x in pixels
+ * @dst_y: destination y in pixels
+ * @dst_w: destination width in pixels
+ * @dst_h: destination height in pixels
+ *
+ * Draws part of a registered image, scaling it to the destination.
+ *
+ * Returns: FALSE if @handle is 0 or was evicted; the caller should
+ *   register the image again
+ */
+static inline gboolean
+gst_render_context_draw_image_handle(
+	GstRenderContext *ctx,
+	guint             handle,
+	gint              src_x,
+	gint              src_y,
+	gint              src_w,
+	gint              src_h,
+	gint              dst_x,
+	gint              dst_y,
+	gint              dst_w,
+	gint              dst_h
+){
+	if (handle == 0 || ctx->ops->draw_image_handle == NULL
+	    || ctx->images == NULL) {
+		return FALSE;
+	}
+	return ctx->ops->draw_image_handle(ctx, handle, src_x, src_y,
+		src_w, src_h, dst_x, dst_y, dst_w, dst_h);
+}
+
+/**
+ * gst_render_context_release_image:
+ * @ctx: render context
+ * @handle: handle from gst_render_context_register_image(), or 0
+ *
+ * Frees a registered image, e.g. because its pixels changed.
+ * Handles that are never released are evicted once the budget
+ * needs the room.
+ */
+static inline void
+gst_render_context_release_image(
+	GstRenderContext *ctx,
+	guint             handle
+){
+	if (ctx->images != NULL) {
+		gst_image_cache_remove(ctx->images, handle);
+	}
+}
+
+/**
+ * gst_render_context_draw_cached_image:
+ * @ctx: render context
+ * @handle: (inout): the caller's handle for @data, 0 if none yet
+ * @data: RGBA pixel data of the whole image
+ * @img_w: image width in pixels
+ * @img_h: image height in pixels
+ * @img_stride: bytes per row in @data
+ * @src_x: left edge of the source rectangle
+ * @src_y: top edge of the source rectangle
+ * @src_w: source rectangle width
+ * @src_h: source rectangle height
+ * @dst_x: destination x in pixels
+ * @dst_y: destination y in pixels
+ * @dst_w: destination width in pixels
+ * @dst_h: destination height in pixels
+ *
+ * Draws @data through the image cache, registering it again when
+ * *@handle is unset or was evicted. Falls back to an uncached
+ * gst_render_context_draw_image() when the image cannot be cached.
+ * Callers whose pixels change must release and zero *@handle.
+ */
+static inline void
+gst_render_context_draw_cached_image(
+	GstRenderContext *ctx,
+	guint            *handle,
+	const guint8     *data,
+	gint              img_w,
+	gint              img_h,
+	gint              img_stride,
+	gint              src_x,
+	gint              src_y,
+	gint              src_w,
+	gint              src_h,
+	gint              dst_x,
+	gint              dst_y,
+	gint              dst_w,
+	gint              dst_h
+){
+	if (gst_render_context_draw_image_handle(ctx, *handle,
+	    src_x, src_y, src_w, src_h, dst_x, dst_y, dst_w, dst_h)) {
+		return;
+	}
+
+	*handle = gst_render_context_register_image(ctx, data,
+		img_w, img_h, img_stride);
+	if (gst_render_context_draw_image_handle(ctx, *handle,
+	    src_x, src_y, src_w, src_h, dst_x, dst_y, dst_w, dst_h)) {
+		return;
+	}
+
+	gst_render_context_draw_image(ctx,
+		data + (gsize)src_y * (gsize)img_stride + (gsize)src_x * 4,
+		src_w, src_h, img_stride, dst_x, dst_y, dst_w, dst_h);
+}
+
 G_END_DECLS
 
 #endif /* GST_RENDER_CONTEXT_H */
@@ -6,6 +6,7 @@
  *
  * Implements the GstRenderContextOps vtable for the Wayland/Cairo
  * backend. Each operation translates to Cairo drawing calls.
+ * Registered images are kept as premultiplied cairo image surfaces.
  */
 
 #include "gst-wayland-render-context.h"
@@ -66,6 +67,7 @@ wl_fill_rect(
 	GstWaylandRenderContext *wctx;
 
 	wctx = (GstWaylandRenderContext *)ctx;
+	gst_render_context_add_damage(ctx, x, y, w, h);
 
 	if (wctx->cr == NULL || wctx->colors == NULL) {
 		return;
@@ -105,6 +107,7 @@ wl_fill_rect_rgba(
 	GstWaylandRenderContext *wctx;
 
 	wctx = (GstWaylandRenderContext *)ctx;
+	gst_render_context_add_damage(ctx, x, y, w, h);
 
 	if (wctx->cr == NULL) {
 		return;
@@ -137,6 +140,7 @@ wl_fill_rect_fg(
 	GstWaylandRenderContext *wctx;
 
 	wctx = (GstWaylandRenderContext *)ctx;
+	gst_render_context_add_damage(ctx, x, y, w, h);
 
 	if (wctx->cr == NULL) {
 		return;
@@ -165,6 +169,7 @@ wl_fill_rect_bg(
 	GstWaylandRenderContext *wctx;
 
 	wctx = (GstWaylandRenderContext *)ctx;
+	gst_render_context_add_damage(ctx, x, y, w, h);
 
 	if (wctx->cr == NULL) {
 		return;
@@ -204,6 +209,7 @@ wl_draw_glyph(
 	gint ascent;
 
 	wctx = (GstWaylandRenderContext *)ctx;
+	gst_render_context_add_damage(ctx, px, py, 2 * ctx->cw, ctx->ch);
 
 	if (wctx->cr == NULL || wctx->font_cache == NULL) {
 		return;
@@ -236,77 +242,92 @@ wl_draw_glyph(
 }
 
 /*
- * wl_draw_image:
+ * wl_free_image:
  *
- * Draws an RGBA image using Cairo.
- * Creates a temporary cairo image surface from the RGBA pixel data,
- * applying RGBA->ARGB32 pre-multiplied conversion (Cairo requires
- * pre-multiplied alpha in native byte order ARGB32 format).
- * Uses cairo_scale for resizing if src and dst sizes differ.
+ * GstImageCacheFreeFunc releasing a cached cairo surface.
  */
 static void
-wl_draw_image(
-	GstRenderContext *ctx,
+wl_free_image(
+	gpointer resource,
+	gpointer user_data
+){
+	cairo_surface_destroy((cairo_surface_t *)resource);
+}
+
+/*
+ * wl_upload_image:
+ *
+ * Creates an ARGB32 image surface holding the RGBA data. Cairo
+ * ARGB32 is pre-multiplied alpha in native byte order: on
+ * little-endian that's BGRA in memory.
+ *
+ * Returns: (transfer full) (nullable): the surface
+ */
+static cairo_surface_t *
+wl_upload_image(
 	const guint8     *data,
 	gint              src_w,
 	gint              src_h,
-	gint              src_stride,
-	gint              dst_x,
-	gint              dst_y,
-	gint              dst_w,
-	gint              dst_h
+	gint              src_stride
 ){
-	GstWaylandRenderContext *wctx;
 	cairo_surface_t *img_surface;
 	guint8 *argb_data;
 	gint cairo_stride;
 	gint row;
 	gint col;
 
-	wctx = (GstWaylandRenderContext *)ctx;
-
-	if (wctx->cr == NULL || data == NULL || src_w <= 0 || src_h <= 0) {
-		return;
+	img_surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32,
+		src_w, src_h);
+	if (cairo_surface_status(img_surface) != CAIRO_STATUS_SUCCESS) {
+		cairo_surface_destroy(img_surface);
+		return NULL;
 	}
 
-	/*
-	 * Create an ARGB32 surface. Cairo ARGB32 is pre-multiplied alpha
-	 * in native byte order: on little-endian that's BGRA in memory.
-	 */
-	cairo_stride = cairo_format_stride_for_width(CAIRO_FORMAT_ARGB32, src_w);
-	argb_data = (guint8 *)g_malloc0((gsize)cairo_stride * (gsize)src_h);
+	cairo_surface_flush(img_surface);
+	argb_data = cairo_image_surface_get_data(img_surface);
+	cairo_stride = cairo_image_surface_get_stride(img_surface);
 
 	for (row = 0; row < src_h; row++) {
-		for (col = 0; col < src_w; col++) {
-			guint8 r, g, b, a;
-			guint16 pr, pg, pb;
-			gint src_off;
-			gint dst_off;
-
-			src_off = row * src_stride + col * 4;
-			dst_off = row * cairo_stride + col * 4;
+		const guint8 *s;
+		guint32 *d;
 
-			r = data[src_off + 0];
-			g = data[src_off + 1];
-			b = data[src_off + 2];
-			a = data[src_off + 3];
+		s = data + (gsize)row * (gsize)src_stride;
+		d = (guint32 *)(argb_data + (gsize)row * (gsize)cairo_stride);
+		for (col = 0; col < src_w; col++, s += 4) {
+			guint a;
 
 			/* Pre-multiply */
-			pr = (guint16)((guint16)r * a + 127) / 255;
-			pg = (guint16)((guint16)g * a + 127) / 255;
-			pb = (guint16)((guint16)b * a + 127) / 255;
-
-			/* ARGB32 native byte order (little-endian: BGRA) */
-			argb_data[dst_off + 0] = (guint8)pb;
-			argb_data[dst_off + 1] = (guint8)pg;
-			argb_data[dst_off + 2] = (guint8)pr;
-			argb_data[dst_off + 3] = a;
+			a = s[3];
+			d[col] = ((guint32)a << 24)
+				| ((guint32)((s[0] * a + 127) / 255) << 16)
+				| ((guint32)((s[1] * a + 127) / 255) << 8)
+				| (guint32)((s[2] * a + 127) / 255);
 		}
 	}
+	cairo_surface_mark_dirty(img_surface);
 
-	img_surface = cairo_image_surface_create_for_data(
-		argb_data, CAIRO_FORMAT_ARGB32, src_w, src_h, cairo_stride);
+	return img_surface;
+}
 
+/*
+ * wl_paint_image:
+ *
+ * Paints a source rectangle of @img_surface into the destination
+ * rectangle, scaling with cairo_scale when the sizes differ.
+ */
+static void
+wl_paint_image(
+	GstWaylandRenderContext *wctx,
+	cairo_surface_t         *img_surface,
+	gint                     src_x,
+	gint                     src_y,
+	gint                     src_w,
+	gint                     src_h,
+	gint                     dst_x,
+	gint                     dst_y,
+	gint                     dst_w,
+	gint                     dst_h
+){
 	cairo_save(wctx->cr);
 
 	/* Position and optionally scale */
@@ -317,13 +338,117 @@ wl_draw_image(
 			(gdouble)dst_h / (gdouble)src_h);
 	}
 
-	cairo_set_source_surface(wctx->cr, img_surface, 0, 0);
-	cairo_paint(wctx->cr);
+	cairo_set_source_surface(wctx->cr, img_surface,
+		(gdouble)-src_x, (gdouble)-src_y);
+	cairo_rectangle(wctx->cr, 0, 0, (gdouble)src_w, (gdouble)src_h);
+	cairo_fill(wctx->cr);
 
 	cairo_restore(wctx->cr);
+}
+
+/*
+ * wl_draw_image:
+ *
+ * Draws an RGBA image using Cairo through a temporary image
+ * surface. Images drawn every frame should go through
+ * register_image instead.
+ */
+static void
+wl_draw_image(
+	GstRenderContext *ctx,
+	const guint8     *data,
+	gint              src_w,
+	gint              src_h,
+	gint              src_stride,
+	gint              dst_x,
+	gint              dst_y,
+	gint              dst_w,
+	gint              dst_h
+){
+	GstWaylandRenderContext *wctx;
+	cairo_surface_t *img_surface;
+
+	wctx = (GstWaylandRenderContext *)ctx;
+	gst_render_context_add_damage(ctx, dst_x, dst_y, dst_w, dst_h);
 
+	if (wctx->cr == NULL || data == NULL || src_w <= 0 || src_h <= 0) {
+		return;
+	}
+
+	img_surface = wl_upload_image(data, src_w, src_h, src_stride);
+	if (img_surface == NULL) {
+		return;
+	}
+
+	wl_paint_image(wctx, img_surface, 0, 0, src_w, src_h,
+		dst_x, dst_y, dst_w, dst_h);
 	cairo_surface_destroy(img_surface);
-	g_free(argb_data);
+}
+
+/*
+ * wl_register_image:
+ *
+ * Converts an RGBA image once into a cairo surface owned by the
+ * image cache.
+ */
+static guint
+wl_register_image(
+	GstRenderContext *ctx,
+	const guint8     *data,
+	gint              src_w,
+	gint              src_h,
+	gint              src_stride
+){
+	cairo_surface_t *img_surface;
+
+	if (data == NULL || src_w <= 0 || src_h <= 0) {
+		return 0;
+	}
+
+	img_surface = wl_upload_image(data, src_w, src_h, src_stride);
+	if (img_surface == NULL) {
+		return 0;
+	}
+
+	return gst_image_cache_insert(ctx->images, img_surface,
+		(gsize)cairo_image_surface_get_stride(img_surface) * (gsize)src_h);
+}
+
+/*
+ * wl_draw_image_handle:
+ *
+ * Paints part of a cached surface without converting it again.
+ */
+static gboolean
+wl_draw_image_handle(
+	GstRenderContext *ctx,
+	guint             handle,
+	gint              src_x,
+	gint              src_y,
+	gint              src_w,
+	gint              src_h,
+	gint              dst_x,
+	gint              dst_y,
+	gint              dst_w,
+	gint              dst_h
+){
+	GstWaylandRenderContext *wctx;
+	cairo_surface_t *img_surface;
+
+	wctx = (GstWaylandRenderContext *)ctx;
+
+	img_surface = (cairo_surface_t *)gst_image_cache_lookup(ctx->images,
+		handle);
+	if (img_surface == NULL) {
+		return FALSE;
+	}
+
+	gst_render_context_add_damage(ctx, dst_x, dst_y, dst_w, dst_h);
+	if (wctx->cr != NULL && src_w > 0 && src_h > 0) {
+		wl_paint_image(wctx, img_surface, src_x, src_y, src_w, src_h,
+			dst_x, dst_y, dst_w, dst_h);
+	}
+	return TRUE;
 }
 
 /*
@@ -349,6 +474,7 @@ wl_draw_glyph_id(
 	gint ascent;
 
 	wctx = (GstWaylandRenderContext *)ctx;
+	gst_render_context_add_damage(ctx, px, py, 2 * ctx->cw, ctx->ch);
 
 	if (wctx->cr == NULL || wctx->font_cache == NULL) {
 		return;
@@ -386,7 +512,9 @@ static const GstRenderContextOps wayland_ops = {
 	wl_fill_rect_bg,
 	wl_draw_glyph,
 	wl_draw_image,
-	wl_draw_glyph_id
+	wl_draw_glyph_id,
+	wl_register_image,
+	wl_draw_image_handle
 };
 
 /**
@@ -401,3 +529,18 @@ gst_wayland_render_context_init_ops(GstWaylandRenderContext *ctx)
 	ctx->base.ops = &wayland_ops;
 	ctx->base.backend = GST_BACKEND_WAYLAND;
 }
+
+/**
+ * gst_wayland_render_context_new_image_cache:
+ *
+ * Creates the image cache a Wayland renderer hands to its render
+ * contexts.
+ *
+ * Returns: (transfer full): a new #GstImageCache
+ */
+GstImageCache *
+gst_wayland_render_context_new_image_cache(void)
+{
+	return gst_image_cache_new(GST_IMAGE_CACHE_DEFAULT_BUDGET,
+		wl_free_image, NULL);
+}
@@ -62,6 +62,17 @@ typedef struct
 void
 gst_wayland_render_context_init_ops(GstWaylandRenderContext *ctx);
 
+/**
+ * gst_wayland_render_context_new_image_cache:
+ *
+ * Creates the cache backing gst_render_context_register_image()
+ * for Wayland contexts. Entries are ARGB32 cairo image surfaces.
+ *
+ * Returns: (transfer full): a new #GstImageCache
+ */
+GstImageCache *
+gst_wayland_render_context_new_image_cache(void);
+
 G_END_DECLS
 
 #endif /* GST_WAYLAND_RENDER_CONTEXT_H */
@@ -5,16 +5,22 @@
  * SPDX-License-Identifier: AGPL-3.0-or-later
  *
  * Wayland rendering engine using Cairo for drawing and wl_shm
- * for shared-memory double-buffered surface rendering.
+ * for shared-memory triple-buffered surface rendering.
  * Implements the GstRenderer abstract interface.
  *
  * All drawing is done to a Cairo image surface backed by
  * shared memory. Buffers are attached to the Wayland surface
- * and committed for display.
+ * and committed for display. Every commit requests a
+ * wl_surface.frame callback; "frame-done" tells the draw loop
+ * when the compositor is ready for the next frame. Optionally a
+ * render thread paints the dirty lines a pass has recorded, and
+ * the main loop commits the buffer once it is done.
  */
 
 #include "gst-wayland-renderer.h"
 #include "gst-wayland-render-context.h"
+#include "gst-damage.h"
+#include "gst-blit.h"
 #include "../core/gst-terminal.h"
 #include "../core/gst-line.h"
 #include "../boxed/gst-glyph.h"
@@ -70,6 +76,100 @@ static const gchar *default_colorname[] = {
 /* Size of wl_shm stride: 4 bytes per pixel (ARGB8888) */
 #define BYTES_PER_PIXEL (4)
 
+/* Number of shm buffers in the swapchain */
+#define WL_SWAPCHAIN_LEN (3)
+
+/*
+ * WlShmBuffer:
+ *
+ * One swapchain slot carved from the shared pool. @stale collects
+ * every area presented from another buffer since this one was last
+ * drawn; it is copied forward before the buffer is reused.
+ */
+typedef struct
+{
+	struct wl_buffer *buffer;
+	cairo_surface_t  *surface;
+	cairo_t          *cr;
+	guint8           *data;
+	gboolean          busy;    /* attached and not yet released */
+	GstDamage        *stale;
+	GstWaylandRenderer *owner;
+} WlShmBuffer;
+
+/*
+ * WlGlyphSpec:
+ *
+ * A positioned glyph and the scaled font it comes from, the Cairo
+ * counterpart of XftGlyphFontSpec.
+ */
+typedef struct
+{
+	cairo_scaled_font_t *font;
+	cairo_glyph_t        glyph;
+} WlGlyphSpec;
+
+/*
+ * WlLineRun:
+ *
+ * One same-attribute run queued while a line is being drawn. Runs
+ * are collected for the whole line and then submitted together by
+ * wl_flush_line_runs().
+ */
+typedef struct
+{
+	GstGlyph base;
+	gint     x;            /* starting column */
+	gint     ncols;        /* columns covered, wide cells count twice */
+	gint     spec_start;   /* index of first spec in specbuf */
+	gint     nspecs;
+	GstColor fg;
+	GstColor bg;
+	gdouble  bg_alpha;
+	cairo_operator_t bg_op;
+	gboolean done;         /* already emitted in the current pass */
+} WlLineRun;
+
+/*
+ * WlJobOp:
+ *
+ * One step of a frame recorded for the render thread: either a
+ * line's runs (@row >= 0) or a solid cursor rectangle.
+ */
+typedef struct
+{
+	gint     row;          /* line row, or -1 for a rectangle */
+	gint     run_start;    /* index of first run in the job */
+	gint     n_runs;
+	GstColor color;        /* rectangle fill */
+	gint     x;
+	gint     y;
+	gint     width;
+	gint     height;
+} WlJobOp;
+
+/*
+ * WlRenderJob:
+ *
+ * Everything the render thread needs to paint a frame's lines and
+ * cursor: resolved runs, positioned glyphs and the order to draw
+ * them in. Fonts used by the specs are referenced until the job
+ * has been presented, so a font reload cannot pull them away.
+ */
+typedef struct
+{
+	WlJobOp     *ops;
+	gint         n_ops;
+	gint         ops_len;
+	WlLineRun   *runs;
+	gint         n_runs;
+	gint         runs_len;
+	WlGlyphSpec *specs;
+	gint         n_specs;
+	gint         specs_len;
+	GPtrArray   *fonts;
+} WlRenderJob;
+
 struct _GstWaylandRenderer
 {
 	GstRenderer parent_instance;
@@ -80,14 +180,23 @@ struct _GstWaylandRenderer
 	struct wl_surface   *wl_surface;
 	struct wl_shm       *wl_shm;
 
-	/* Shared memory buffer */
+	/* Shared memory pool (one memfd, reused across resizes) */
 	gint shm_fd;
 	guint8 *shm_data;
 	gsize shm_size;
 	struct wl_shm_pool *shm_pool;
-	struct wl_buffer *buffer;
 
-	/* Cairo drawing surface */
+	/* Swapchain carved from the pool; slots are created on demand */
+	WlShmBuffer bufs[WL_SWAPCHAIN_LEN];
+	gint n_bufs;
+	gint buf_width;
+	gint buf_height;
+	gint buf_stride;
+	gsize buf_size;
+	gint cur_buf;            /* slot being drawn, or -1 */
+	gint presented_buf;      /* slot last committed, or -1 */
+
+	/* Cairo drawing surface of the current slot */
 	cairo_surface_t *cairo_surface;
 	cairo_t *cr;
 
@@ -135,10 +244,62 @@ struct _GstWaylandRenderer
 	/* Wallpaper state (set during RENDER_BACKGROUND dispatch) */
 	gboolean has_wallpaper;
 	gdouble wallpaper_bg_alpha;
+
+	/* Buffer area drawn since the last commit */
+	GstDamage *damage;
+
+	/* Buffer area module overlays drew over in the last frame */
+	GstDamage *overlay_damage;
+
+	/* Module images converted to cairo surfaces, kept across frames */
+	GstImageCache *images;
+
+	/* Per-line batching buffers, sized to the widest line drawn */
+	WlGlyphSpec *specbuf;
+	WlGlyphSpec *gatherbuf;
+	cairo_glyph_t *glyphbuf;
+	WlLineRun *runs;
+	gint n_runs;
+	gint line_buf_len;
+
+	/* Blit glyphs from the font cache's atlas instead of cairo_show_glyphs() */
+	gboolean use_atlas;
+
+	/*
+	 * Optional render thread. The main thread records a frame's
+	 * lines and cursor into @job; the thread paints them into the
+	 * current slot and the main loop presents the result. Only one
+	 * job is in flight, and nothing touches the slot meanwhile.
+	 */
+	GThread *render_thread;
+	GMutex job_lock;
+	GCond job_cond;
+	gboolean job_queued;     /* under job_lock: submitted, not painted */
+	gboolean job_quit;       /* under job_lock: thread should exit */
+	gboolean job_busy;       /* submitted and not yet presented */
+	gboolean job_recording;  /* the render pass records into @job */
+	WlRenderJob job;
+
+	/* Frame pacing: outstanding wl_surface.frame callback */
+	struct wl_callback *frame_cb;
+	gboolean draw_skipped;       /* a draw found every buffer held */
+	guint32 last_frame_time;     /* compositor timestamp, ms */
+	gint64 draw_start_us;
+	GstWaylandFrameTimings timings;
 };
 
 G_DEFINE_TYPE(GstWaylandRenderer, gst_wayland_renderer, GST_TYPE_RENDERER)
 
+enum {
+	SIGNAL_FRAME_DONE,
+	N_SIGNALS
+};
+
+static guint signals[N_SIGNALS] = { 0 };
+
+/* Frames between debug summaries of the frame timings */
+#define WL_TIMINGS_LOG_INTERVAL (300)
+
 /* ===== Shared memory buffer management ===== */
 
 /*
@@ -183,94 +344,344 @@ create_shm_file(gsize size)
 }
 
 /*
- * wl_create_buffer:
+ * wl_pool_reserve:
  * @self: the renderer
- * @width: buffer width in pixels
- * @height: buffer height in pixels
+ * @size: bytes the swapchain needs
  *
- * Creates a wl_shm buffer backed by shared memory, and
- * creates a Cairo image surface over that memory.
+ * Makes sure the shared pool holds at least @size bytes. The pool
+ * is created on first use and only ever grows, so shrinking or
+ * resizing back within its capacity costs no reallocation.
  *
  * Returns: TRUE on success
  */
 static gboolean
-wl_create_buffer(
+wl_pool_reserve(
 	GstWaylandRenderer  *self,
-	gint                width,
-	gint                height
+	gsize               size
 ){
-	gint stride;
-	gsize size;
+	guint8 *data;
 
-	stride = width * BYTES_PER_PIXEL;
-	size = (gsize)(stride * height);
-
-	/* Free old buffer resources */
-	if (self->cr != NULL) {
-		cairo_destroy(self->cr);
-		self->cr = NULL;
+	if (self->shm_pool != NULL && self->shm_size >= size) {
+		return TRUE;
 	}
-	if (self->cairo_surface != NULL) {
-		cairo_surface_destroy(self->cairo_surface);
-		self->cairo_surface = NULL;
-	}
-	if (self->buffer != NULL) {
-		wl_buffer_destroy(self->buffer);
-		self->buffer = NULL;
+
+	if (self->shm_fd < 0) {
+		self->shm_fd = create_shm_file(size);
+		if (self->shm_fd < 0) {
+			g_warning("gst_wayland_renderer: failed to create shm file: %s",
+				g_strerror(errno));
+			return FALSE;
+		}
+	} else if (ftruncate(self->shm_fd, (off_t)size) < 0) {
+		g_warning("gst_wayland_renderer: failed to grow shm file: %s",
+			g_strerror(errno));
+		return FALSE;
 	}
-	if (self->shm_pool != NULL) {
-		wl_shm_pool_destroy(self->shm_pool);
-		self->shm_pool = NULL;
+
+	data = (guint8 *)mmap(NULL, size, PROT_READ | PROT_WRITE,
+		MAP_SHARED, self->shm_fd, 0);
+	if (data == MAP_FAILED) {
+		g_warning("gst_wayland_renderer: mmap failed: %s",
+			g_strerror(errno));
+		return FALSE;
 	}
+
 	if (self->shm_data != NULL) {
 		munmap(self->shm_data, self->shm_size);
-		self->shm_data = NULL;
 	}
-	if (self->shm_fd >= 0) {
-		close(self->shm_fd);
-		self->shm_fd = -1;
+	self->shm_data = data;
+	self->shm_size = size;
+
+	if (self->shm_pool == NULL) {
+		self->shm_pool = wl_shm_create_pool(self->wl_shm,
+			self->shm_fd, (gint32)size);
+	} else {
+		wl_shm_pool_resize(self->shm_pool, (gint32)size);
+	}
+
+	return TRUE;
+}
+
+/*
+ * buffer_release:
+ *
+ * wl_buffer.release handler: the compositor no longer reads the
+ * buffer, so it may be drawn into again. If a draw was skipped
+ * because every buffer was held, "frame-done" is emitted so the
+ * draw loop retries now instead of waiting for new output.
+ */
+static void
+buffer_release(
+	void                *data,
+	struct wl_buffer    *buffer
+){
+	WlShmBuffer *slot;
+	GstWaylandRenderer *self;
+
+	slot = (WlShmBuffer *)data;
+	slot->busy = FALSE;
+
+	self = slot->owner;
+	if (self->draw_skipped) {
+		self->draw_skipped = FALSE;
+		g_signal_emit(self, signals[SIGNAL_FRAME_DONE], 0);
+	}
+}
+
+static const struct wl_buffer_listener buffer_listener = {
+	buffer_release
+};
+
+/*
+ * wl_swapchain_destroy:
+ * @self: the renderer
+ *
+ * Destroys every swapchain slot. The pool itself is kept.
+ */
+static void
+wl_swapchain_destroy(GstWaylandRenderer *self)
+{
+	gint i;
+
+	for (i = 0; i < self->n_bufs; i++) {
+		WlShmBuffer *slot;
+
+		slot = &self->bufs[i];
+		g_clear_pointer(&slot->cr, cairo_destroy);
+		g_clear_pointer(&slot->surface, cairo_surface_destroy);
+		g_clear_pointer(&slot->buffer, wl_buffer_destroy);
+		g_clear_pointer(&slot->stale, gst_damage_free);
+		slot->data = NULL;
+		slot->busy = FALSE;
 	}
 
+	self->n_bufs = 0;
+	self->cur_buf = -1;
+	self->presented_buf = -1;
+	self->cr = NULL;
+	self->cairo_surface = NULL;
+}
+
+/*
+ * wl_swapchain_reset:
+ * @self: the renderer
+ * @width: buffer width in pixels
+ * @height: buffer height in pixels
+ *
+ * Drops the old slots and reserves pool space for a full swapchain
+ * at the new size. Slots are created when first needed.
+ *
+ * Returns: TRUE on success
+ */
+static gboolean
+wl_swapchain_reset(
+	GstWaylandRenderer  *self,
+	gint                width,
+	gint                height
+){
+	wl_swapchain_destroy(self);
+
 	if (width <= 0 || height <= 0) {
 		return FALSE;
 	}
 
-	/* Create shared memory */
-	self->shm_fd = create_shm_file(size);
-	if (self->shm_fd < 0) {
-		g_warning("gst_wayland_renderer: failed to create shm file: %s",
-			g_strerror(errno));
-		return FALSE;
+	self->buf_width = width;
+	self->buf_height = height;
+	self->buf_stride = width * BYTES_PER_PIXEL;
+	self->buf_size = (gsize)self->buf_stride * (gsize)height;
+
+	return wl_pool_reserve(self, self->buf_size * WL_SWAPCHAIN_LEN);
+}
+
+/*
+ * wl_swapchain_add:
+ * @self: the renderer
+ *
+ * Creates the next swapchain slot: a wl_buffer over its part of the
+ * pool and a Cairo surface over the same memory. A new slot holds
+ * no valid pixels, so it is entirely stale.
+ *
+ * Returns: the new slot index, or -1 if the swapchain is full
+ */
+static gint
+wl_swapchain_add(GstWaylandRenderer *self)
+{
+	WlShmBuffer *slot;
+	gint idx;
+
+	if (self->n_bufs >= WL_SWAPCHAIN_LEN || self->shm_pool == NULL) {
+		return -1;
 	}
 
-	self->shm_data = (guint8 *)mmap(NULL, size, PROT_READ | PROT_WRITE,
-		MAP_SHARED, self->shm_fd, 0);
-	if (self->shm_data == MAP_FAILED) {
-		g_warning("gst_wayland_renderer: mmap failed: %s",
-			g_strerror(errno));
-		self->shm_data = NULL;
-		close(self->shm_fd);
-		self->shm_fd = -1;
-		return FALSE;
+	idx = self->n_bufs++;
+	slot = &self->bufs[idx];
+	slot->data = self->shm_data + (gsize)idx * self->buf_size;
+	slot->buffer = wl_shm_pool_create_buffer(self->shm_pool,
+		(gint32)((gsize)idx * self->buf_size),
+		self->buf_width, self->buf_height, self->buf_stride,
+		WL_SHM_FORMAT_ARGB8888);
+	wl_buffer_add_listener(slot->buffer, &buffer_listener, slot);
+	slot->surface = cairo_image_surface_create_for_data(slot->data,
+		CAIRO_FORMAT_ARGB32, self->buf_width, self->buf_height,
+		self->buf_stride);
+	slot->cr = cairo_create(slot->surface);
+	slot->busy = FALSE;
+	slot->owner = self;
+	slot->stale = gst_damage_new();
+	gst_damage_set_bounds(slot->stale, self->buf_width, self->buf_height);
+
+	return idx;
+}
+
+/*
+ * wl_copy_forward:
+ * @self: the renderer
+ * @dst: slot about to be drawn
+ *
+ * Brings @dst up to date with the last presented slot by copying
+ * only the areas that changed since @dst was last drawn.
+ */
+static void
+wl_copy_forward(
+	GstWaylandRenderer  *self,
+	WlShmBuffer         *dst
+){
+	WlShmBuffer *src;
+	const GstDamageRect *rects;
+	guint n_rects;
+	guint i;
+
+	if (self->presented_buf < 0 || gst_damage_is_empty(dst->stale)) {
+		gst_damage_clear(dst->stale);
+		return;
+	}
+
+	src = &self->bufs[self->presented_buf];
+	if (src == dst) {
+		gst_damage_clear(dst->stale);
+		return;
+	}
+	cairo_surface_flush(src->surface);
+	cairo_surface_flush(dst->surface);
+
+	if (gst_damage_is_full(dst->stale)) {
+		memcpy(dst->data, src->data, self->buf_size);
+	} else {
+		rects = gst_damage_get_rects(dst->stale, &n_rects);
+		for (i = 0; i < n_rects; i++) {
+			gsize off;
+			gsize len;
+			gint py;
+
+			off = (gsize)rects[i].x * BYTES_PER_PIXEL;
+			len = (gsize)rects[i].width * BYTES_PER_PIXEL;
+			for (py = rects[i].y; py < rects[i].y + rects[i].height; py++) {
+				memcpy(dst->data + (gsize)py * self->buf_stride + off,
+					src->data + (gsize)py * self->buf_stride + off, len);
+			}
+		}
+	}
+
+	cairo_surface_mark_dirty(dst->surface);
+	gst_damage_clear(dst->stale);
+}
+
+/*
+ * wl_acquire_buffer:
+ * @self: the renderer
+ *
+ * Makes sure the renderer draws into a slot the compositor does not
+ * hold. The current slot is kept while it is free; otherwise a
+ * released slot is taken (or a new one created) and brought up to
+ * date with the presented frame.
+ *
+ * Returns: FALSE if every slot is still held by the compositor
+ */
+static gboolean
+wl_acquire_buffer(GstWaylandRenderer *self)
+{
+	gint i;
+	gint idx;
+
+	if (self->cur_buf >= 0 && !self->bufs[self->cur_buf].busy) {
+		return TRUE;
 	}
-	self->shm_size = size;
 
-	/* Create wl_shm_pool and wl_buffer */
-	self->shm_pool = wl_shm_create_pool(self->wl_shm,
-		self->shm_fd, (gint32)size);
-	self->buffer = wl_shm_pool_create_buffer(self->shm_pool,
-		0, width, height, stride, WL_SHM_FORMAT_ARGB8888);
+	idx = -1;
+	for (i = 0; i < self->n_bufs; i++) {
+		if (!self->bufs[i].busy) {
+			idx = i;
+			break;
+		}
+	}
+	if (idx < 0) {
+		idx = wl_swapchain_add(self);
+	}
+	if (idx < 0) {
+		return FALSE;
+	}
 
-	/* Create cairo image surface backed by the shared memory */
-	self->cairo_surface = cairo_image_surface_create_for_data(
-		self->shm_data, CAIRO_FORMAT_ARGB32,
-		width, height, stride);
+	wl_copy_forward(self, &self->bufs[idx]);
 
-	self->cr = cairo_create(self->cairo_surface);
+	self->cur_buf = idx;
+	self->cr = self->bufs[idx].cr;
+	self->cairo_surface = self->bufs[idx].surface;
 
 	return TRUE;
 }
 
+/* ===== Frame pacing ===== */
+
+/*
+ * frame_done:
+ *
+ * wl_surface.frame handler: the compositor is ready for a new
+ * frame. Records the interval since the previous one and emits
+ * "frame-done". Surfaces that are hidden or fully occluded get
+ * no callback, so nothing is drawn for them.
+ */
+static void
+frame_done(
+	void                *data,
+	struct wl_callback  *cb,
+	uint32_t            time
+){
+	GstWaylandRenderer *self;
+	GstWaylandFrameTimings *t;
+
+	self = GST_WAYLAND_RENDERER(data);
+	t = &self->timings;
+
+	wl_callback_destroy(cb);
+	self->frame_cb = NULL;
+
+	if (t->frames > 0) {
+		t->last_interval_ms = time - self->last_frame_time;
+		if (t->frames == 1) {
+			t->avg_interval_ms = (gdouble)t->last_interval_ms;
+		} else {
+			t->avg_interval_ms += ((gdouble)t->last_interval_ms
+				- t->avg_interval_ms) / 16.0;
+		}
+	}
+	self->last_frame_time = time;
+	t->frames++;
+
+	if (t->frames % WL_TIMINGS_LOG_INTERVAL == 0) {
+		g_debug("wayland: %" G_GUINT64_FORMAT " frames, "
+			"interval %.2f ms avg, render %" G_GINT64_FORMAT " us "
+			"(max %" G_GINT64_FORMAT "), %" G_GUINT64_FORMAT " skipped",
+			t->frames, t->avg_interval_ms, t->last_render_us,
+			t->max_render_us, t->skipped);
+	}
+
+	g_signal_emit(self, signals[SIGNAL_FRAME_DONE], 0);
+}
+
+static const struct wl_callback_listener frame_listener = {
+	frame_done
+};
+
 /* ===== Static helper functions ===== */
 
 /*
@@ -429,13 +840,23 @@ wl_clear_rect(
 	gint                x2,
 	gint                y2
 ){
+	GstColor bg;
+
 	if (self->cr == NULL) {
 		return;
 	}
 
 	/* Use OPERATOR_SOURCE to write alpha directly into the buffer,
-	 * rather than blending over existing content */
-	wl_set_bg_color(self, self->cr, self->colors[self->default_bg]);
+	 * rather than blending over existing content. Borders are only
+	 * cleared during a render pass, where last_opacity matches the
+	 * window; unlike the window it is safe to read from the render
+	 * thread. */
+	bg = self->colors[self->default_bg];
+	cairo_set_source_rgba(self->cr,
+		(gdouble)GST_COLOR_R(bg) / 255.0,
+		(gdouble)GST_COLOR_G(bg) / 255.0,
+		(gdouble)GST_COLOR_B(bg) / 255.0,
+		self->last_opacity);
 	cairo_set_operator(self->cr, CAIRO_OPERATOR_SOURCE);
 	cairo_rectangle(self->cr, (gdouble)x1, (gdouble)y1,
 		(gdouble)(x2 - x1), (gdouble)(y2 - y1));
@@ -478,6 +899,45 @@ wl_fill_render_context(
 	ctx->num_colors = self->num_colors;
 	ctx->fg         = self->colors[self->default_fg];
 	ctx->bg         = self->colors[self->default_bg];
+	ctx->base.damage = self->damage;
+	ctx->base.images = self->images;
+}
+
+/*
+ * wl_damage_span:
+ * @self: the renderer
+ * @row: row index
+ * @x1: start column
+ * @x2: end column (exclusive)
+ *
+ * Adds the pixels of a drawn line span to the frame damage,
+ * including the border padding that is cleared when the span
+ * touches an edge of the terminal.
+ */
+static void
+wl_damage_span(
+	GstWaylandRenderer  *self,
+	gint                row,
+	gint                x1,
+	gint                x2
+){
+	gint left;
+	gint top;
+	gint right;
+	gint bottom;
+
+	left = (x1 == 0) ? 0 : self->borderpx + x1 * self->cw;
+	right = self->borderpx + x2 * self->cw;
+	if (right >= self->borderpx + self->tw) {
+		right = self->win_w;
+	}
+	top = (row == 0) ? 0 : self->borderpx + row * self->ch;
+	bottom = self->borderpx + (row + 1) * self->ch;
+	if (bottom >= self->borderpx + self->th) {
+		bottom = self->win_h;
+	}
+
+	gst_damage_add(self->damage, left, top, right - left, bottom - top);
 }
 
 /*
@@ -547,54 +1007,28 @@ resolve_bg_color(
 }
 
 /*
- * wl_draw_glyph_run:
+ * wl_resolve_colors:
  * @self: the renderer
- * @base: base glyph with attributes for this run
- * @len: number of character cells in the run
- * @x: starting column
- * @y: row
+ * @base: glyph whose attributes select the colors
+ * @fg_out: (out): foreground color
+ * @bg_out: (out): background color
  *
- * Draws the background and decorations for a run of glyphs
- * with the same attributes. The actual glyph rendering is
- * handled per-glyph via the font cache.
+ * Resolves a glyph's colors, applying reverse video, blink and
+ * invisible on top of resolve_fg_color().
  */
 static void
-wl_draw_glyph_run(
-	GstWaylandRenderer      *self,
-	GstGlyph                *base,
-	GstLine                 *line,
-	gint                    len,
-	gint                    x,
-	gint                    y
+wl_resolve_colors(
+	GstWaylandRenderer  *self,
+	const GstGlyph      *base,
+	GstColor            *fg_out,
+	GstColor            *bg_out
 ){
 	guint16 mode;
 	GstColor fg;
 	GstColor bg;
 	GstColor temp;
-	gint charlen;
-	gint winx;
-	gint winy;
-	gint width;
-	gint ascent;
-	gint i;
-	cairo_scaled_font_t *scaled_font;
-	gulong glyph_index;
-	GstGlyph *g;
-	GstRune rune;
-	GstFontStyle fstyle;
-	gfloat xp;
-
-	if (self->cr == NULL) {
-		return;
-	}
 
 	mode = (guint16)base->attr;
-	charlen = len * ((mode & GST_GLYPH_ATTR_WIDE) ? 2 : 1);
-	winx = self->borderpx + x * self->cw;
-	winy = self->borderpx + y * self->ch;
-	width = charlen * self->cw;
-
-	/* Resolve colors */
 	fg = resolve_fg_color(self, base->fg, mode);
 	bg = resolve_bg_color(self, base->bg);
 
@@ -615,141 +1049,131 @@ wl_draw_glyph_run(
 		fg = bg;
 	}
 
-	/* Clear border regions around this cell run */
-	if (x == 0) {
-		wl_clear_rect(self, 0, (y == 0) ? 0 : winy,
-			self->borderpx,
-			winy + self->ch + ((winy + self->ch >= self->borderpx + self->th)
-				? self->win_h : 0));
-	}
-	if (winx + width >= self->borderpx + self->tw) {
-		wl_clear_rect(self, winx + width, (y == 0) ? 0 : winy,
-			self->win_w,
-			(winy + self->ch >= self->borderpx + self->th)
-				? self->win_h : (winy + self->ch));
-	}
-	if (y == 0) {
-		wl_clear_rect(self, winx, 0, winx + width, self->borderpx);
-	}
-	if (winy + self->ch >= self->borderpx + self->th) {
-		wl_clear_rect(self, winx, winy + self->ch, winx + width, self->win_h);
-	}
+	*fg_out = fg;
+	*bg_out = bg;
+}
 
-	/* Fill background: when wallpaper is active and the cell uses the
-	 * default background (not reversed), draw with configurable alpha
-	 * so the background image shows through. Cairo supports proper
-	 * alpha compositing via CAIRO_OPERATOR_OVER. */
+/*
+ * wl_run_bg:
+ * @self: the renderer
+ * @base: base glyph of the run
+ * @alpha_out: (out): alpha to paint the background with
+ *
+ * Decides how a run's background is painted. While a wallpaper is
+ * active, default-bg cells are blended over it with the configured
+ * alpha; everything else is written with the window opacity.
+ *
+ * Returns: the operator to fill the background with
+ */
+static cairo_operator_t
+wl_run_bg(
+	GstWaylandRenderer  *self,
+	const GstGlyph      *base,
+	gdouble             *alpha_out
+){
 	if (self->has_wallpaper
 	    && base->bg == (guint32)self->default_bg
-	    && !(mode & GST_GLYPH_ATTR_REVERSE))
+	    && !(base->attr & GST_GLYPH_ATTR_REVERSE))
 	{
-		GstColor def_bg;
-
-		def_bg = self->colors[self->default_bg];
-		cairo_set_source_rgba(self->cr,
-			(gdouble)GST_COLOR_R(def_bg) / 255.0,
-			(gdouble)GST_COLOR_G(def_bg) / 255.0,
-			(gdouble)GST_COLOR_B(def_bg) / 255.0,
-			self->wallpaper_bg_alpha);
-		cairo_set_operator(self->cr, CAIRO_OPERATOR_OVER);
-		cairo_rectangle(self->cr, (gdouble)winx, (gdouble)winy,
-			(gdouble)width, (gdouble)self->ch);
-		cairo_fill(self->cr);
+		*alpha_out = self->wallpaper_bg_alpha;
+		return CAIRO_OPERATOR_OVER;
 	}
-	else
-	{
-		wl_set_bg_color(self, self->cr, bg);
-		cairo_set_operator(self->cr, CAIRO_OPERATOR_SOURCE);
-		cairo_rectangle(self->cr, (gdouble)winx, (gdouble)winy,
-			(gdouble)width, (gdouble)self->ch);
-		cairo_fill(self->cr);
-		cairo_set_operator(self->cr, CAIRO_OPERATOR_OVER);
-	}
-
-	/* Set clipping for glyph rendering */
-	cairo_save(self->cr);
-	cairo_rectangle(self->cr, (gdouble)winx, (gdouble)winy,
-		(gdouble)width, (gdouble)self->ch);
-	cairo_clip(self->cr);
-
-	/* Render glyphs */
-	wl_set_source_color(self->cr, fg);
-	ascent = gst_cairo_font_cache_get_ascent(self->font_cache);
-	xp = (gfloat)winx;
-
-	for (i = 0; i < len; i++) {
-		gfloat runewidth;
 
-		g = gst_line_get_glyph(line, x + i);
-		if (g == NULL) {
-			xp += (gfloat)self->cw;
-			continue;
-		}
-
-		rune = g->rune;
-
-		/* Skip wide char dummy cells */
-		if (g->attr & GST_GLYPH_ATTR_WDUMMY) {
-			continue;
-		}
+	*alpha_out = (self->wl_window != NULL)
+		? gst_wayland_window_get_opacity(self->wl_window) : 1.0;
+	return CAIRO_OPERATOR_SOURCE;
+}
 
-		runewidth = (gfloat)self->cw;
-		if (g->attr & GST_GLYPH_ATTR_WIDE) {
-			runewidth = (gfloat)(self->cw * 2);
-		}
+/*
+ * wl_clear_borders:
+ * @self: the renderer
+ * @winx: left pixel edge of the drawn span
+ * @width: pixel width of the drawn span
+ * @x: starting column of the span
+ * @y: row
+ *
+ * Clears the border padding adjacent to a span of cells.
+ */
+static void
+wl_clear_borders(
+	GstWaylandRenderer  *self,
+	gint                winx,
+	gint                width,
+	gint                x,
+	gint                y
+){
+	gint winy;
 
-		/* Determine font style */
-		fstyle = GST_FONT_STYLE_NORMAL;
-		if ((mode & GST_GLYPH_ATTR_ITALIC) && (mode & GST_GLYPH_ATTR_BOLD)) {
-			fstyle = GST_FONT_STYLE_BOLD_ITALIC;
-		} else if (mode & GST_GLYPH_ATTR_ITALIC) {
-			fstyle = GST_FONT_STYLE_ITALIC;
-		} else if (mode & GST_GLYPH_ATTR_BOLD) {
-			fstyle = GST_FONT_STYLE_BOLD;
-		}
+	winy = self->borderpx + y * self->ch;
 
-		/* Look up and render glyph */
-		if (gst_cairo_font_cache_lookup_glyph(self->font_cache,
-		    rune, fstyle, &scaled_font, &glyph_index))
-		{
-			cairo_glyph_t cg;
+	if (x == 0) {
+		wl_clear_rect(self, 0, (y == 0) ? 0 : winy,
+			self->borderpx,
+			winy + self->ch + ((winy + self->ch >= self->borderpx + self->th)
+				? self->win_h : 0));
+	}
+	if (winx + width >= self->borderpx + self->tw) {
+		wl_clear_rect(self, winx + width, (y == 0) ? 0 : winy,
+			self->win_w,
+			(winy + self->ch >= self->borderpx + self->th)
+				? self->win_h : (winy + self->ch));
+	}
+	if (y == 0) {
+		wl_clear_rect(self, winx, 0, winx + width, self->borderpx);
+	}
+	if (winy + self->ch >= self->borderpx + self->th) {
+		wl_clear_rect(self, winx, winy + self->ch, winx + width, self->win_h);
+	}
+}
 
-			cairo_set_scaled_font(self->cr, scaled_font);
-			cg.index = glyph_index;
-			cg.x = (gdouble)xp;
-			cg.y = (gdouble)(winy + ascent);
-			cairo_show_glyphs(self->cr, &cg, 1);
-		}
+/*
+ * wl_draw_decorations:
+ * @self: the renderer
+ * @fg: decoration color
+ * @mode: glyph attributes
+ * @winx: left pixel edge
+ * @winy: top pixel edge
+ * @width: pixel width
+ *
+ * Draws underline, strikethrough and undercurl for a run.
+ */
+static void
+wl_draw_decorations(
+	GstWaylandRenderer  *self,
+	GstColor            fg,
+	guint16             mode,
+	gint                winx,
+	gint                winy,
+	gint                width
+){
+	gint ascent;
 
-		xp += runewidth;
+	if (!(mode & (GST_GLYPH_ATTR_UNDERLINE | GST_GLYPH_ATTR_STRUCK
+	              | GST_GLYPH_ATTR_UNDERCURL))) {
+		return;
 	}
 
-	/* Restore clipping */
-	cairo_restore(self->cr);
+	ascent = gst_cairo_font_cache_get_ascent(self->font_cache);
+	wl_set_source_color(self->cr, fg);
 
 	/* Underline decoration */
 	if (mode & GST_GLYPH_ATTR_UNDERLINE) {
-		wl_set_source_color(self->cr, fg);
 		cairo_rectangle(self->cr, (gdouble)winx,
 			(gdouble)(winy + ascent + 1),
 			(gdouble)width, 1.0);
-		cairo_fill(self->cr);
 	}
 
 	/* Strikethrough decoration */
 	if (mode & GST_GLYPH_ATTR_STRUCK) {
-		wl_set_source_color(self->cr, fg);
 		cairo_rectangle(self->cr, (gdouble)winx,
 			(gdouble)(winy + 2 * ascent / 3),
 			(gdouble)width, 1.0);
-		cairo_fill(self->cr);
 	}
 
 	/* Undercurl decoration (sine wave below baseline) */
 	if (mode & GST_GLYPH_ATTR_UNDERCURL) {
 		gint uc_x;
 
-		wl_set_source_color(self->cr, fg);
 		for (uc_x = 0; uc_x < width; uc_x++) {
 			gint dy;
 
@@ -758,9 +1182,674 @@ wl_draw_glyph_run(
 				(gdouble)(winx + uc_x),
 				(gdouble)(winy + ascent + 1 + dy),
 				1.0, 1.0);
-			cairo_fill(self->cr);
 		}
 	}
+
+	cairo_fill(self->cr);
+}
+
+/*
+ * wl_make_glyph_spec:
+ * @self: the renderer
+ * @g: glyph to look up
+ * @mode: run attributes selecting the font style
+ * @px: left pixel edge of the cell
+ * @py: top pixel edge of the cell
+ * @spec: (out): the positioned glyph
+ *
+ * Returns: FALSE if no font has a glyph for the rune
+ */
+static gboolean
+wl_make_glyph_spec(
+	GstWaylandRenderer  *self,
+	const GstGlyph      *g,
+	guint16             mode,
+	gint                px,
+	gint                py,
+	WlGlyphSpec         *spec
+){
+	GstFontStyle fstyle;
+	gulong glyph_index;
+
+	fstyle = GST_FONT_STYLE_NORMAL;
+	if ((mode & GST_GLYPH_ATTR_ITALIC) && (mode & GST_GLYPH_ATTR_BOLD)) {
+		fstyle = GST_FONT_STYLE_BOLD_ITALIC;
+	} else if (mode & GST_GLYPH_ATTR_ITALIC) {
+		fstyle = GST_FONT_STYLE_ITALIC;
+	} else if (mode & GST_GLYPH_ATTR_BOLD) {
+		fstyle = GST_FONT_STYLE_BOLD;
+	}
+
+	if (!gst_cairo_font_cache_lookup_glyph(self->font_cache,
+	    g->rune, fstyle, &spec->font, &glyph_index)) {
+		return FALSE;
+	}
+
+	spec->glyph.index = glyph_index;
+	spec->glyph.x = (gdouble)px;
+	spec->glyph.y = (gdouble)(py
+		+ gst_cairo_font_cache_get_ascent(self->font_cache));
+	return TRUE;
+}
+
+/*
+ * wl_show_specs:
+ * @self: the renderer
+ * @specs: glyphs to draw; their font pointers are consumed
+ * @n: number of specs
+ *
+ * Draws @specs in the current source color with one
+ * cairo_show_glyphs() per distinct scaled font. Each spec's font
+ * is cleared once it has been drawn.
+ */
+static void
+wl_show_specs(
+	GstWaylandRenderer  *self,
+	WlGlyphSpec         *specs,
+	gint                n
+){
+	gint i;
+	gint j;
+
+	for (i = 0; i < n; i++) {
+		cairo_scaled_font_t *font;
+		gint count;
+
+		font = specs[i].font;
+		if (font == NULL) {
+			continue;
+		}
+
+		count = 0;
+		for (j = i; j < n; j++) {
+			if (specs[j].font == font) {
+				self->glyphbuf[count++] = specs[j].glyph;
+				specs[j].font = NULL;
+			}
+		}
+
+		cairo_set_scaled_font(self->cr, font);
+		cairo_show_glyphs(self->cr, self->glyphbuf, count);
+	}
+}
+
+/*
+ * wl_alloc_line_buffers:
+ * @self: the renderer
+ * @cols: number of columns a line may span
+ *
+ * Grows the per-line spec, gather, glyph and run buffers when
+ * needed.
+ */
+static void
+wl_alloc_line_buffers(
+	GstWaylandRenderer  *self,
+	gint                cols
+){
+	if (cols <= self->line_buf_len) {
+		return;
+	}
+
+	g_free(self->specbuf);
+	g_free(self->gatherbuf);
+	g_free(self->glyphbuf);
+	g_free(self->runs);
+
+	self->line_buf_len = cols;
+	self->specbuf = g_new(WlGlyphSpec, (gsize)cols);
+	self->gatherbuf = g_new(WlGlyphSpec, (gsize)cols);
+	self->glyphbuf = g_new(cairo_glyph_t, (gsize)cols);
+	self->runs = g_new(WlLineRun, (gsize)cols);
+	self->n_runs = 0;
+}
+
+/*
+ * wl_blit_line_glyphs:
+ * @self: the renderer
+ * @runs: the line's runs
+ * @n_runs: number of runs
+ * @specs: glyph specs the runs index into
+ * @clip_x: left edge of the line span
+ * @clip_y: top edge of the line
+ * @clip_w: width of the line span
+ *
+ * Composites the glyphs of @runs straight into the shm buffer from
+ * the font cache's coverage atlas, clipped to the line span. Glyphs
+ * the atlas cannot hold (color emoji, oversized) are collected per
+ * run and drawn through Cairo.
+ */
+static void
+wl_blit_line_glyphs(
+	GstWaylandRenderer  *self,
+	WlLineRun           *runs,
+	gint                n_runs,
+	WlGlyphSpec         *specs,
+	gint                clip_x,
+	gint                clip_y,
+	gint                clip_w
+){
+	guint8 *data;
+	gint stride;
+	gint cx1;
+	gint cy1;
+	gint cx2;
+	gint cy2;
+	gint i;
+	gint k;
+
+	cx1 = MAX(clip_x, 0);
+	cy1 = MAX(clip_y, 0);
+	cx2 = MIN(clip_x + clip_w,
+		cairo_image_surface_get_width(self->cairo_surface));
+	cy2 = MIN(clip_y + self->ch,
+		cairo_image_surface_get_height(self->cairo_surface));
+	if (cx1 >= cx2 || cy1 >= cy2) {
+		return;
+	}
+
+	cairo_surface_flush(self->cairo_surface);
+	data = cairo_image_surface_get_data(self->cairo_surface);
+	stride = cairo_image_surface_get_stride(self->cairo_surface);
+
+	for (i = 0; i < n_runs; i++) {
+		guint32 color;
+		gint n_fallback;
+
+		color = runs[i].fg >> 8;
+		n_fallback = 0;
+
+		for (k = 0; k < runs[i].nspecs; k++) {
+			WlGlyphSpec *spec;
+			GstAtlasGlyph ag;
+			const guint8 *atlas;
+			gint atlas_stride;
+			gint gx;
+			gint gy;
+			gint x1;
+			gint y1;
+			gint x2;
+			gint y2;
+
+			spec = &specs[runs[i].spec_start + k];
+			if (!gst_cairo_font_cache_get_atlas_glyph(self->font_cache,
+			    spec->font, spec->glyph.index, &ag)) {
+				self->gatherbuf[n_fallback++] = *spec;
+				continue;
+			}
+
+			gx = (gint)spec->glyph.x + ag.off_x;
+			gy = (gint)spec->glyph.y + ag.off_y;
+			x1 = MAX(gx, cx1);
+			y1 = MAX(gy, cy1);
+			x2 = MIN(gx + ag.width, cx2);
+			y2 = MIN(gy + ag.height, cy2);
+			if (x1 >= x2 || y1 >= y2) {
+				continue;
+			}
+
+			atlas = gst_cairo_font_cache_get_atlas_pixels(self->font_cache,
+				&atlas_stride);
+			gst_blit_a8_over(
+				data + (gsize)y1 * (gsize)stride + (gsize)x1 * 4, stride,
+				atlas + (gsize)(ag.y + y1 - gy) * (gsize)atlas_stride
+					+ (gsize)(ag.x + x1 - gx), atlas_stride,
+				x2 - x1, y2 - y1, color);
+		}
+
+		if (n_fallback > 0) {
+			cairo_surface_mark_dirty_rectangle(self->cairo_surface,
+				cx1, cy1, cx2 - cx1, cy2 - cy1);
+			cairo_save(self->cr);
+			cairo_rectangle(self->cr, (gdouble)cx1, (gdouble)cy1,
+				(gdouble)(cx2 - cx1), (gdouble)(cy2 - cy1));
+			cairo_clip(self->cr);
+			wl_set_source_color(self->cr, runs[i].fg);
+			wl_show_specs(self, self->gatherbuf, n_fallback);
+			cairo_restore(self->cr);
+			cairo_surface_flush(self->cairo_surface);
+		}
+	}
+
+	cairo_surface_mark_dirty_rectangle(self->cairo_surface,
+		cx1, cy1, cx2 - cx1, cy2 - cy1);
+}
+
+/*
+ * wl_paint_line_runs:
+ * @self: the renderer
+ * @runs: the line's runs, colors already resolved
+ * @n_runs: number of runs
+ * @specs: glyph specs the runs index into; fonts are consumed
+ * @y: row
+ * @use_atlas: blit glyphs from the font cache's atlas
+ *
+ * Paints a line's runs in a few large Cairo calls instead of a
+ * fill, clip and cairo_show_glyphs() per cell. Backgrounds sharing
+ * a color and operator are filled as one path; glyphs sharing a
+ * foreground go out as one cairo_show_glyphs() per scaled font,
+ * all under one clip covering the line span. With @use_atlas,
+ * glyphs are blitted by wl_blit_line_glyphs() instead.
+ *
+ * Only reads state that stays put while a job is in flight, so it
+ * also runs on the render thread.
+ */
+static void
+wl_paint_line_runs(
+	GstWaylandRenderer  *self,
+	WlLineRun           *runs,
+	gint                n_runs,
+	WlGlyphSpec         *specs,
+	gint                y,
+	gboolean            use_atlas
+){
+	gint winx;
+	gint winy;
+	gint span_x1;
+	gint span_x2;
+	gint i;
+	gint j;
+
+	if (n_runs == 0) {
+		return;
+	}
+
+	winy = self->borderpx + y * self->ch;
+
+	span_x1 = runs[0].x;
+	span_x2 = runs[0].x;
+	for (i = 0; i < n_runs; i++) {
+		runs[i].done = FALSE;
+		span_x2 = MAX(span_x2, runs[i].x + runs[i].ncols);
+	}
+
+	winx = self->borderpx + span_x1 * self->cw;
+	wl_clear_borders(self, winx, (span_x2 - span_x1) * self->cw,
+		span_x1, y);
+
+	/* Backgrounds: one path fill per distinct color and operator */
+	for (i = 0; i < n_runs; i++) {
+		GstColor bg;
+
+		if (runs[i].done) {
+			continue;
+		}
+
+		bg = runs[i].bg;
+		for (j = i; j < n_runs; j++) {
+			if (runs[j].done || runs[j].bg != bg
+			    || runs[j].bg_op != runs[i].bg_op
+			    || runs[j].bg_alpha != runs[i].bg_alpha) {
+				continue;
+			}
+			cairo_rectangle(self->cr,
+				(gdouble)(self->borderpx + runs[j].x * self->cw),
+				(gdouble)winy,
+				(gdouble)(runs[j].ncols * self->cw),
+				(gdouble)self->ch);
+			runs[j].done = TRUE;
+		}
+
+		cairo_set_source_rgba(self->cr,
+			(gdouble)GST_COLOR_R(bg) / 255.0,
+			(gdouble)GST_COLOR_G(bg) / 255.0,
+			(gdouble)GST_COLOR_B(bg) / 255.0,
+			runs[i].bg_alpha);
+		cairo_set_operator(self->cr, runs[i].bg_op);
+		cairo_fill(self->cr);
+	}
+	cairo_set_operator(self->cr, CAIRO_OPERATOR_OVER);
+
+	/* Glyphs: one clip for the span, one batch per foreground */
+	if (use_atlas) {
+		wl_blit_line_glyphs(self, runs, n_runs, specs, winx, winy,
+			(span_x2 - span_x1) * self->cw);
+	} else {
+		cairo_save(self->cr);
+		cairo_rectangle(self->cr, (gdouble)winx, (gdouble)winy,
+			(gdouble)((span_x2 - span_x1) * self->cw), (gdouble)self->ch);
+		cairo_clip(self->cr);
+
+		for (i = 0; i < n_runs; i++) {
+			runs[i].done = FALSE;
+		}
+		for (i = 0; i < n_runs; i++) {
+			gint n;
+
+			if (runs[i].done || runs[i].nspecs == 0) {
+				continue;
+			}
+
+			n = 0;
+			for (j = i; j < n_runs; j++) {
+				if (runs[j].done || runs[j].nspecs == 0
+				    || runs[j].fg != runs[i].fg) {
+					continue;
+				}
+				memcpy(&self->gatherbuf[n], &specs[runs[j].spec_start],
+					sizeof(WlGlyphSpec) * (gsize)runs[j].nspecs);
+				n += runs[j].nspecs;
+				runs[j].done = TRUE;
+			}
+
+			wl_set_source_color(self->cr, runs[i].fg);
+			wl_show_specs(self, self->gatherbuf, n);
+		}
+
+		cairo_restore(self->cr);
+	}
+
+	/* Decorations are rare; draw them per run */
+	for (i = 0; i < n_runs; i++) {
+		wl_draw_decorations(self, runs[i].fg, (guint16)runs[i].base.attr,
+			self->borderpx + runs[i].x * self->cw, winy,
+			runs[i].ncols * self->cw);
+	}
+}
+
+/* ===== Render thread jobs ===== */
+
+/*
+ * wl_job_add_op:
+ * @self: the renderer
+ *
+ * Returns: (transfer none): a new zeroed op at the end of the job
+ */
+static WlJobOp *
+wl_job_add_op(GstWaylandRenderer *self)
+{
+	WlRenderJob *job;
+	WlJobOp *op;
+
+	job = &self->job;
+	if (job->n_ops == job->ops_len) {
+		job->ops_len = (job->ops_len == 0) ? 64 : job->ops_len * 2;
+		job->ops = g_renew(WlJobOp, job->ops, (gsize)job->ops_len);
+	}
+
+	op = &job->ops[job->n_ops++];
+	memset(op, 0, sizeof(*op));
+	return op;
+}
+
+/*
+ * wl_job_hold_font:
+ * @self: the renderer
+ * @font: a scaled font the job draws with
+ *
+ * Keeps @font alive until the job is presented.
+ */
+static void
+wl_job_hold_font(
+	GstWaylandRenderer  *self,
+	cairo_scaled_font_t *font
+){
+	GPtrArray *fonts;
+	guint i;
+
+	fonts = self->job.fonts;
+	for (i = 0; i < fonts->len; i++) {
+		if (g_ptr_array_index(fonts, i) == font) {
+			return;
+		}
+	}
+	g_ptr_array_add(fonts, cairo_scaled_font_reference(font));
+}
+
+/*
+ * wl_job_record_line:
+ * @self: the renderer
+ * @runs: the line's resolved runs
+ * @n_runs: number of runs
+ * @y: row
+ *
+ * Copies a line's runs and specs into the job instead of painting
+ * them. Spec indices are rebased onto the job's spec array.
+ */
+static void
+wl_job_record_line(
+	GstWaylandRenderer  *self,
+	WlLineRun           *runs,
+	gint                n_runs,
+	gint                y
+){
+	WlRenderJob *job;
+	WlJobOp *op;
+	cairo_scaled_font_t *last_font;
+	gint nspecs;
+	gint i;
+
+	job = &self->job;
+
+	nspecs = 0;
+	for (i = 0; i < n_runs; i++) {
+		nspecs += runs[i].nspecs;
+	}
+	if (job->n_runs + n_runs > job->runs_len) {
+		job->runs_len = MAX(job->runs_len * 2, job->n_runs + n_runs);
+		job->runs = g_renew(WlLineRun, job->runs, (gsize)job->runs_len);
+	}
+	if (job->n_specs + nspecs > job->specs_len) {
+		job->specs_len = MAX(job->specs_len * 2, job->n_specs + nspecs);
+		job->specs = g_renew(WlGlyphSpec, job->specs, (gsize)job->specs_len);
+	}
+
+	op = wl_job_add_op(self);
+	op->row = y;
+	op->run_start = job->n_runs;
+	op->n_runs = n_runs;
+
+	last_font = NULL;
+	for (i = 0; i < n_runs; i++) {
+		WlLineRun *run;
+		gint k;
+
+		run = &job->runs[job->n_runs++];
+		*run = runs[i];
+		run->spec_start = job->n_specs;
+
+		for (k = 0; k < runs[i].nspecs; k++) {
+			WlGlyphSpec *spec;
+
+			spec = &job->specs[job->n_specs++];
+			*spec = self->specbuf[runs[i].spec_start + k];
+			if (spec->font != last_font) {
+				wl_job_hold_font(self, spec->font);
+				last_font = spec->font;
+			}
+		}
+	}
+}
+
+/*
+ * wl_job_paint:
+ * @self: the renderer
+ *
+ * Paints every recorded op into the current slot, in order.
+ * Runs on the render thread.
+ */
+static void
+wl_job_paint(GstWaylandRenderer *self)
+{
+	WlRenderJob *job;
+	gint i;
+
+	job = &self->job;
+	for (i = 0; i < job->n_ops; i++) {
+		WlJobOp *op;
+
+		op = &job->ops[i];
+		if (op->row >= 0) {
+			wl_paint_line_runs(self, &job->runs[op->run_start],
+				op->n_runs, job->specs, op->row, FALSE);
+			continue;
+		}
+
+		wl_set_source_color(self->cr, op->color);
+		cairo_rectangle(self->cr, (gdouble)op->x, (gdouble)op->y,
+			(gdouble)op->width, (gdouble)op->height);
+		cairo_fill(self->cr);
+	}
+	cairo_surface_flush(self->cairo_surface);
+}
+
+/*
+ * wl_job_reset:
+ * @self: the renderer
+ *
+ * Empties the job and drops its font references.
+ */
+static void
+wl_job_reset(GstWaylandRenderer *self)
+{
+	self->job.n_ops = 0;
+	self->job.n_runs = 0;
+	self->job.n_specs = 0;
+	if (self->job.fonts != NULL) {
+		g_ptr_array_set_size(self->job.fonts, 0);
+	}
+}
+
+/*
+ * wl_flush_line_runs:
+ * @self: the renderer
+ * @y: row
+ *
+ * Resolves the colors of the runs queued for a line, then paints
+ * them, or records them for the render thread while a threaded
+ * render pass is running.
+ */
+static void
+wl_flush_line_runs(
+	GstWaylandRenderer  *self,
+	gint                y
+){
+	WlLineRun *runs;
+	gint n_runs;
+	gint i;
+
+	runs = self->runs;
+	n_runs = self->n_runs;
+	self->n_runs = 0;
+	if (n_runs == 0) {
+		return;
+	}
+
+	for (i = 0; i < n_runs; i++) {
+		wl_resolve_colors(self, &runs[i].base, &runs[i].fg, &runs[i].bg);
+		runs[i].bg_op = wl_run_bg(self, &runs[i].base, &runs[i].bg_alpha);
+	}
+
+	if (self->job_recording) {
+		wl_job_record_line(self, runs, n_runs, y);
+		return;
+	}
+
+	wl_paint_line_runs(self, runs, n_runs, self->specbuf, y,
+		self->use_atlas);
+}
+
+/*
+ * wl_fill_cursor_rect:
+ * @self: the renderer
+ * @color: fill color
+ * @x: left edge
+ * @y: top edge
+ * @width: rectangle width
+ * @height: rectangle height
+ *
+ * Fills one piece of a cursor shape, or records it for the
+ * render thread.
+ */
+static void
+wl_fill_cursor_rect(
+	GstWaylandRenderer  *self,
+	GstColor            color,
+	gint                x,
+	gint                y,
+	gint                width,
+	gint                height
+){
+	WlJobOp *op;
+
+	if (!self->job_recording) {
+		wl_set_source_color(self->cr, color);
+		cairo_rectangle(self->cr, (gdouble)x, (gdouble)y,
+			(gdouble)width, (gdouble)height);
+		cairo_fill(self->cr);
+		return;
+	}
+
+	op = wl_job_add_op(self);
+	op->row = -1;
+	op->color = color;
+	op->x = x;
+	op->y = y;
+	op->width = width;
+	op->height = height;
+}
+
+/*
+ * wl_draw_glyph_run:
+ * @self: the renderer
+ * @base: base glyph with attributes for this run
+ * @line: line holding the run's glyphs
+ * @len: number of glyphs in the run
+ * @x: starting column
+ * @y: row
+ *
+ * Renders a single run of glyphs with the same attributes as a
+ * one-run line, so it gets its own background fill and clip. Used
+ * for the cursor block; lines are built by draw_line.
+ */
+static void
+wl_draw_glyph_run(
+	GstWaylandRenderer      *self,
+	GstGlyph                *base,
+	GstLine                 *line,
+	gint                    len,
+	gint                    x,
+	gint                    y
+){
+	WlLineRun *run;
+	guint16 mode;
+	gint charlen;
+	gint winy;
+	gint col;
+
+	if (self->cr == NULL) {
+		return;
+	}
+
+	mode = (guint16)base->attr;
+	charlen = len * ((mode & GST_GLYPH_ATTR_WIDE) ? 2 : 1);
+	winy = self->borderpx + y * self->ch;
+
+	wl_alloc_line_buffers(self, MAX(len, 1));
+
+	run = &self->runs[0];
+	run->base = *base;
+	run->x = x;
+	run->ncols = charlen;
+	run->spec_start = 0;
+	run->nspecs = 0;
+	self->n_runs = 1;
+
+	/* Look up the run's glyphs, skipping wide char dummy cells */
+	for (col = x; col < x + charlen && run->nspecs < len; col++) {
+		GstGlyph *g;
+
+		g = gst_line_get_glyph(line, col);
+		if (g == NULL || (g->attr & GST_GLYPH_ATTR_WDUMMY)) {
+			continue;
+		}
+		if (wl_make_glyph_spec(self, g, mode,
+		    self->borderpx + col * self->cw, winy,
+		    &self->specbuf[run->nspecs])) {
+			run->nspecs++;
+		}
+	}
+
+	wl_flush_line_runs(self, y);
 }
 
 /* ===== Virtual method implementations ===== */
@@ -772,8 +1861,8 @@ wl_draw_glyph_run(
  * @x1: start column
  * @x2: end column (exclusive)
  *
- * Draws a single line, grouping glyphs by attributes for
- * efficient batch rendering.
+ * Draws a single line, grouping glyphs by attributes into runs
+ * that are submitted together at the end of the line.
  */
 static void
 wl_renderer_draw_line_impl(
@@ -785,11 +1874,10 @@ wl_renderer_draw_line_impl(
 	GstWaylandRenderer *self;
 	GstTerminal *term;
 	GstLine *line;
-	gint i;
+	WlLineRun *run;
+	gint si;
 	gint x;
-	gint ox;
 	GstGlyph *new_glyph;
-	GstGlyph base;
 	GstGlyph cur;
 	guint16 new_mode;
 	GstModuleManager *mgr;
@@ -798,7 +1886,7 @@ wl_renderer_draw_line_impl(
 
 	self = GST_WAYLAND_RENDERER(renderer);
 	term = gst_renderer_get_terminal(renderer);
-	if (term == NULL) {
+	if (term == NULL || self->cr == NULL) {
 		return;
 	}
 
@@ -807,6 +1895,9 @@ wl_renderer_draw_line_impl(
 		return;
 	}
 
+	wl_damage_span(self, row, x1, x2);
+	wl_alloc_line_buffers(self, MAX(x2 - x1, 1));
+
 	/* Check if any glyph transformers are registered (fast path) */
 	mgr = gst_module_manager_get_default();
 	has_glyph_transformers = (mgr != NULL);
@@ -814,9 +1905,9 @@ wl_renderer_draw_line_impl(
 		wl_fill_render_context(self, &gt_ctx);
 	}
 
-	i = 0;
-	ox = x1;
-	memset(&base, 0, sizeof(GstGlyph));
+	si = 0;
+	run = NULL;
+	self->n_runs = 0;
 
 	/* Iterate and group by matching attributes */
 	for (x = x1; x < x2; x++) {
@@ -844,40 +1935,13 @@ wl_renderer_draw_line_impl(
 		if (has_glyph_transformers && cur.rune > 0x7F) {
 			gint pixel_x;
 			gint pixel_y;
-			GstColor gt_fg_c;
-			GstColor gt_bg_c;
-			GstColor gt_tmp_c;
-			guint16 gt_mode;
 
 			pixel_x = self->borderpx + x * self->cw;
 			pixel_y = self->borderpx + row * self->ch;
 
 			/* Resolve per-glyph fg/bg colors for the render context */
-			gt_mode = (guint16)cur.attr;
-			gt_fg_c = resolve_fg_color(self, cur.fg, gt_mode);
-			gt_bg_c = resolve_bg_color(self, cur.bg);
-
-			/* Reverse video */
-			if (gt_mode & GST_GLYPH_ATTR_REVERSE) {
-				gt_tmp_c = gt_fg_c;
-				gt_fg_c = gt_bg_c;
-				gt_bg_c = gt_tmp_c;
-			}
-
-			/* Blink: invisible during off phase */
-			if ((gt_mode & GST_GLYPH_ATTR_BLINK)
-			    && (self->win_mode & GST_WIN_MODE_BLINK)) {
-				gt_fg_c = gt_bg_c;
-			}
-
-			/* Invisible attribute */
-			if (gt_mode & GST_GLYPH_ATTR_INVISIBLE) {
-				gt_fg_c = gt_bg_c;
-			}
-
-			gt_ctx.fg = gt_fg_c;
-			gt_ctx.bg = gt_bg_c;
-			gt_ctx.base.glyph_attr = gt_mode;
+			wl_resolve_colors(self, &cur, &gt_ctx.fg, &gt_ctx.bg);
+			gt_ctx.base.glyph_attr = (guint16)cur.attr;
 			gt_ctx.base.current_line = line;
 			gt_ctx.base.current_col = x;
 			gt_ctx.base.current_cols = x2;
@@ -886,34 +1950,75 @@ wl_renderer_draw_line_impl(
 				mgr, cur.rune, &gt_ctx.base,
 				pixel_x, pixel_y, self->cw, self->ch))
 			{
-				/* Flush accumulated run before skipping */
-				if (i > 0) {
-					wl_draw_glyph_run(self, &base, line, i, ox, row);
-					i = 0;
-				}
-				ox = x + 1;
+				/* The transformer drew this cell; start a new
+				 * run after it */
+				run = NULL;
 				continue;
 			}
 		}
 
-		/* If attributes changed, flush the accumulated run */
-		if (i > 0 && ATTRCMP(base, cur)) {
-			wl_draw_glyph_run(self, &base, line, i, ox, row);
-			i = 0;
+		/* Start a new run when attributes change */
+		if (run == NULL || ATTRCMP(run->base, cur)) {
+			run = &self->runs[self->n_runs++];
+			run->base = cur;
+			run->x = x;
+			run->ncols = 0;
+			run->spec_start = si;
+			run->nspecs = 0;
+		}
+		run->ncols += (cur.attr & GST_GLYPH_ATTR_WIDE) ? 2 : 1;
+
+		if (wl_make_glyph_spec(self, &cur, (guint16)cur.attr,
+		    self->borderpx + x * self->cw, self->borderpx + row * self->ch,
+		    &self->specbuf[si])) {
+			run->nspecs++;
+			si++;
 		}
+	}
+
+	wl_flush_line_runs(self, row);
+}
+
+/*
+ * wl_cursor_span:
+ * @term: the terminal
+ * @cx: cursor column
+ * @cy: cursor row
+ * @x1: (out): first column to redraw
+ * @x2: (out): one past the last column to redraw
+ *
+ * Gets the cells to redraw to erase a cursor drawn at (@cx, @cy):
+ * its cell and one neighbour on each side, taking in both halves
+ * of any wide character at the edges.
+ *
+ * Returns: %FALSE if the position is no longer on the screen
+ */
+static gboolean
+wl_cursor_span(
+	GstTerminal *term,
+	gint         cx,
+	gint         cy,
+	gint        *x1,
+	gint        *x2
+){
+	GstLine *line;
 
-		/* Start new run */
-		if (i == 0) {
-			ox = x;
-			base = cur;
-		}
-		i++;
+	line = gst_terminal_get_line(term, cy);
+	if (line == NULL || cx < 0 || cx >= line->len) {
+		return FALSE;
 	}
 
-	/* Flush final run */
-	if (i > 0) {
-		wl_draw_glyph_run(self, &base, line, i, ox, row);
+	*x1 = MAX(cx - 1, 0);
+	*x2 = MIN(cx + 2, line->len);
+	if (*x1 > 0 && (line->glyphs[*x1].attr & GST_GLYPH_ATTR_WDUMMY)) {
+		(*x1)--;
 	}
+	if (*x2 < line->len
+	    && (line->glyphs[*x2 - 1].attr & GST_GLYPH_ATTR_WIDE))
+	{
+		(*x2)++;
+	}
+	return TRUE;
 }
 
 /*
@@ -949,18 +2054,15 @@ wl_renderer_draw_cursor_impl(
 		return;
 	}
 
-	/* Erase old cursor by redrawing the entire line. Single-cell erase
-	 * is insufficient: anti-aliased glyph edges from the cursor's
-	 * inverted-color block bleed into adjacent cells. Also redraw the
-	 * new cursor line when it differs, so the cursor is always drawn
-	 * on freshly rendered content. */
+	/* Erase the old cursor by redrawing its cell and one cell on
+	 * each side: anti-aliased glyph edges from the cursor's
+	 * inverted-color block bleed into adjacent cells. */
 	{
-		gint erase_cols;
+		gint x1;
+		gint x2;
 
-		gst_terminal_get_size(term, &erase_cols, NULL);
-		wl_renderer_draw_line_impl(renderer, oy, 0, erase_cols);
-		if (cy != oy) {
-			wl_renderer_draw_line_impl(renderer, cy, 0, erase_cols);
+		if (wl_cursor_span(term, ox, oy, &x1, &x2)) {
+			wl_renderer_draw_line_impl(renderer, oy, x1, x2);
 		}
 	}
 
@@ -974,6 +2076,10 @@ wl_renderer_draw_cursor_impl(
 		return;
 	}
 
+	/* Only the cursor cell itself changes on screen */
+	wl_damage_span(self, cy, cx,
+		cx + ((g->attr & GST_GLYPH_ATTR_WIDE) ? 2 : 1));
+
 	cursor = gst_terminal_get_cursor(term);
 	drawcol = self->colors[self->default_cs];
 
@@ -1003,45 +2109,185 @@ wl_renderer_draw_cursor_impl(
 			}
 			break;
 		case GST_CURSOR_SHAPE_UNDERLINE:
-			wl_set_source_color(self->cr, drawcol);
-			cairo_rectangle(self->cr,
-				(gdouble)winx,
-				(gdouble)(winy + self->ch - GST_CURSOR_THICKNESS),
-				(gdouble)self->cw, (gdouble)GST_CURSOR_THICKNESS);
-			cairo_fill(self->cr);
+			wl_fill_cursor_rect(self, drawcol,
+				winx, winy + self->ch - GST_CURSOR_THICKNESS,
+				self->cw, GST_CURSOR_THICKNESS);
 			break;
 		case GST_CURSOR_SHAPE_BAR:
-			wl_set_source_color(self->cr, drawcol);
-			cairo_rectangle(self->cr,
-				(gdouble)winx,
-				(gdouble)winy,
-				(gdouble)GST_CURSOR_THICKNESS, (gdouble)self->ch);
-			cairo_fill(self->cr);
+			wl_fill_cursor_rect(self, drawcol,
+				winx, winy, GST_CURSOR_THICKNESS, self->ch);
 			break;
 		}
 	} else {
 		/* Unfocused: hollow box cursor */
-		wl_set_source_color(self->cr, drawcol);
 		/* Top edge */
-		cairo_rectangle(self->cr,
-			(gdouble)winx, (gdouble)winy,
-			(gdouble)(self->cw - 1), 1.0);
-		cairo_fill(self->cr);
+		wl_fill_cursor_rect(self, drawcol,
+			winx, winy, self->cw - 1, 1);
 		/* Left edge */
-		cairo_rectangle(self->cr,
-			(gdouble)winx, (gdouble)winy,
-			1.0, (gdouble)(self->ch - 1));
-		cairo_fill(self->cr);
+		wl_fill_cursor_rect(self, drawcol,
+			winx, winy, 1, self->ch - 1);
 		/* Right edge */
-		cairo_rectangle(self->cr,
-			(gdouble)(winx + self->cw - 1), (gdouble)winy,
-			1.0, (gdouble)(self->ch - 1));
-		cairo_fill(self->cr);
+		wl_fill_cursor_rect(self, drawcol,
+			winx + self->cw - 1, winy, 1, self->ch - 1);
 		/* Bottom edge */
-		cairo_rectangle(self->cr,
-			(gdouble)winx, (gdouble)(winy + self->ch - 1),
-			(gdouble)self->cw, 1.0);
-		cairo_fill(self->cr);
+		wl_fill_cursor_rect(self, drawcol,
+			winx, winy + self->ch - 1, self->cw, 1);
+	}
+}
+
+/*
+ * wl_replay_scroll_log:
+ * @self: the Wayland renderer
+ * @term: the terminal
+ * @rows: number of terminal rows
+ * @oy: row the cursor was drawn on in the previous frame
+ *
+ * Replays the terminal's scroll log on the shm buffer so rows that
+ * only moved are shifted with memmove instead of redrawn. When a
+ * wallpaper or a selection is showing, the pixels cannot simply be
+ * moved, so the scrolled rows are marked dirty instead. The same goes
+ * for a region a module overlay drew over last frame: the overlay's
+ * pixels would move with the text and stay behind as a ghost.
+ *
+ * Returns: the previous cursor row after the scrolls, or -1 if it
+ *   left its region (its old cursor block must still be erased)
+ */
+static gint
+wl_replay_scroll_log(
+	GstWaylandRenderer  *self,
+	GstTerminal         *term,
+	gint                rows,
+	gint                oy
+){
+	const GstScrollOp *ops;
+	guint n_ops;
+	guint i;
+	gboolean blit;
+	guint8 *data;
+	gint stride;
+	gint xoff;
+	gint width;
+
+	ops = gst_terminal_get_scroll_log(term, &n_ops);
+	if (n_ops == 0) {
+		return oy;
+	}
+
+	blit = !self->has_wallpaper
+		&& self->cairo_surface != NULL
+		&& (self->selection == NULL
+		    || gst_selection_is_empty(self->selection));
+
+	data = NULL;
+	stride = 0;
+	xoff = 0;
+	width = 0;
+	if (blit) {
+		/* Pending cairo drawing must land before the pixels move */
+		cairo_surface_flush(self->cairo_surface);
+		data = cairo_image_surface_get_data(self->cairo_surface);
+		stride = cairo_image_surface_get_stride(self->cairo_surface);
+		xoff = self->borderpx * BYTES_PER_PIXEL;
+		width = MIN(self->tw, self->win_w - self->borderpx) * BYTES_PER_PIXEL;
+		blit = (data != NULL && width > 0);
+	}
+
+	for (i = 0; i < n_ops; i++) {
+		gint top;
+		gint bot;
+		gint shift;
+		gint y;
+
+		top = ops[i].top;
+		bot = MIN(ops[i].bot, rows - 1);
+		shift = ABS(ops[i].n);
+		if (top > bot) {
+			continue;
+		}
+
+		if (!blit || gst_damage_intersects(self->overlay_damage,
+		    self->borderpx, self->borderpx + top * self->ch,
+		    self->tw, (bot - top + 1) * self->ch)) {
+			for (y = top; y <= bot; y++) {
+				gst_terminal_mark_dirty(term, y);
+			}
+			continue;
+		}
+
+		if (shift <= bot - top) {
+			gint src;
+			gint dst;
+			gint height;
+			gint py;
+
+			src = self->borderpx
+				+ ((ops[i].n > 0) ? top + shift : top) * self->ch;
+			dst = self->borderpx
+				+ ((ops[i].n > 0) ? top : top + shift) * self->ch;
+			height = (bot - top + 1 - shift) * self->ch;
+			height = MIN(height, self->win_h - MAX(src, dst));
+
+			/* Copy in the direction that never reads a moved row */
+			if (dst < src) {
+				for (py = 0; py < height; py++) {
+					memmove(data + (gsize)(dst + py) * stride + xoff,
+						data + (gsize)(src + py) * stride + xoff,
+						(gsize)width);
+				}
+			} else {
+				for (py = height - 1; py >= 0; py--) {
+					memmove(data + (gsize)(dst + py) * stride + xoff,
+						data + (gsize)(src + py) * stride + xoff,
+						(gsize)width);
+				}
+			}
+			gst_damage_add(self->damage,
+				self->borderpx, self->borderpx + top * self->ch,
+				width / BYTES_PER_PIXEL, (bot - top + 1) * self->ch);
+		}
+
+		if (oy >= top && oy <= bot) {
+			oy -= ops[i].n;
+			if (oy < top || oy > bot) {
+				oy = -1;
+			}
+		}
+	}
+
+	if (blit) {
+		cairo_surface_mark_dirty(self->cairo_surface);
+	}
+
+	return oy;
+}
+
+/*
+ * wl_dispatch_overlays:
+ * @self: the renderer
+ *
+ * Lets modules draw their overlays on top of the frame. What they
+ * cover is kept so the next frame's scrolls do not move it along.
+ */
+static void
+wl_dispatch_overlays(GstWaylandRenderer *self)
+{
+	GstModuleManager *mgr;
+	GstWaylandRenderContext ctx;
+	const GstDamageRect *rects;
+	guint n_rects;
+	guint i;
+
+	mgr = gst_module_manager_get_default();
+	wl_fill_render_context(self, &ctx);
+	gst_damage_clear(self->overlay_damage);
+	ctx.base.damage = self->overlay_damage;
+	gst_module_manager_dispatch_render_overlay(
+		mgr, &ctx.base, self->win_w, self->win_h);
+
+	rects = gst_damage_get_rects(self->overlay_damage, &n_rects);
+	for (i = 0; i < n_rects; i++) {
+		gst_damage_add(self->damage, rects[i].x, rects[i].y,
+			rects[i].width, rects[i].height);
 	}
 }
 
@@ -1049,8 +2295,9 @@ wl_renderer_draw_cursor_impl(
  * wl_renderer_render_impl:
  * @renderer: the GstRenderer
  *
- * Full render pass: iterate dirty lines, draw cursor,
- * commit surface. Uses dirty-line optimization.
+ * Full render pass: replay scrolls, iterate dirty lines, draw
+ * cursor, commit surface. Only the dirty column span of each
+ * line is redrawn.
  */
 static void
 wl_renderer_render_impl(GstRenderer *renderer)
@@ -1102,6 +2349,7 @@ wl_renderer_render_impl(GstRenderer *renderer)
 			for (y = 0; y < rows; y++) {
 				gst_terminal_mark_dirty(term, y);
 			}
+			gst_damage_add_all(self->damage);
 		}
 	}
 
@@ -1118,20 +2366,51 @@ wl_renderer_render_impl(GstRenderer *renderer)
 			mgr, &bg_ctx.base, self->win_w, self->win_h);
 		self->has_wallpaper = bg_ctx.base.has_wallpaper;
 		self->wallpaper_bg_alpha = bg_ctx.base.wallpaper_bg_alpha;
+
+		/* The wallpaper repaints the whole surface */
+		if (self->has_wallpaper) {
+			gst_damage_add_all(self->damage);
+		}
+	}
+
+	/* Move scrolled rows; the old cursor block travels with them,
+	 * so repaint the cells it landed on */
+	{
+		gint moved_oy;
+		gint x1;
+		gint x2;
+
+		moved_oy = wl_replay_scroll_log(self, term, rows, self->ocy);
+		if (moved_oy >= 0 && moved_oy != self->ocy
+		    && wl_cursor_span(term, self->ocx, moved_oy, &x1, &x2))
+		{
+			gst_line_mark_dirty_range(
+				gst_terminal_get_line(term, moved_oy), x1, x2);
+		}
 	}
 
+	/* With a render thread, lines and cursor are only recorded
+	 * here and painted off the main thread */
+	self->job_recording = (self->render_thread != NULL);
+
 	/* Draw lines: force full redraw when wallpaper is active
 	 * because the background image overwrites the entire surface */
 	for (y = 0; y < rows; y++) {
 		GstLine *line;
+		gint x1;
+		gint x2;
 
 		line = gst_terminal_get_line(term, y);
 		if (line == NULL) {
 			continue;
 		}
 
-		if (self->has_wallpaper || gst_line_is_dirty(line)) {
+		if (self->has_wallpaper) {
 			wl_renderer_draw_line_impl(renderer, y, 0, cols);
+		} else if (gst_line_get_dirty_span(line, &x1, &x2)) {
+			/* Redraw only the damaged columns, widened to whole words */
+			gst_line_expand_span(line, &x1, &x2);
+			wl_renderer_draw_line_impl(renderer, y, x1, x2);
 		}
 	}
 
@@ -1139,22 +2418,228 @@ wl_renderer_render_impl(GstRenderer *renderer)
 	wl_renderer_draw_cursor_impl(renderer, cx, cy, self->ocx, self->ocy);
 	self->ocx = cx;
 	self->ocy = cy;
+	self->job_recording = FALSE;
 
-	/* Dispatch render overlays to modules */
-	{
-		GstModuleManager *mgr;
-		GstWaylandRenderContext ctx;
-
-		mgr = gst_module_manager_get_default();
-		wl_fill_render_context(self, &ctx);
-		gst_module_manager_dispatch_render_overlay(
-			mgr, &ctx.base, self->win_w, self->win_h);
+	/* Overlays go on top of the lines; with a recorded job they are
+	 * dispatched once the render thread has painted it */
+	if (self->job.n_ops == 0) {
+		wl_dispatch_overlays(self);
 	}
 
 	/* Clear terminal dirty flags (finish_draw presents the buffer) */
 	gst_terminal_clear_dirty(term);
 }
 
+/* ===== Render thread ===== */
+
+/*
+ * wl_present_frame:
+ * @self: the renderer
+ *
+ * Commits the current buffer to the Wayland surface, damaging only
+ * the areas drawn this frame. Nothing is committed when nothing was
+ * drawn. The committed buffer stays busy until the compositor
+ * releases it; the frame's damage is recorded as stale on every
+ * other buffer. A frame callback is requested with each commit.
+ */
+static void
+wl_present_frame(GstWaylandRenderer *self)
+{
+	WlShmBuffer *slot;
+	const GstDamageRect *rects;
+	guint n_rects;
+	guint i;
+	gint j;
+
+	if (self->cur_buf < 0) {
+		return;
+	}
+
+	if (gst_damage_is_empty(self->damage)) {
+		return;
+	}
+
+	slot = &self->bufs[self->cur_buf];
+	cairo_surface_flush(slot->surface);
+	wl_surface_attach(self->wl_surface, slot->buffer, 0, 0);
+	rects = gst_damage_get_rects(self->damage, &n_rects);
+	for (i = 0; i < n_rects; i++) {
+		wl_surface_damage_buffer(self->wl_surface,
+			rects[i].x, rects[i].y, rects[i].width, rects[i].height);
+	}
+	if (self->frame_cb == NULL) {
+		self->frame_cb = wl_surface_frame(self->wl_surface);
+		wl_callback_add_listener(self->frame_cb, &frame_listener, self);
+	}
+	wl_surface_commit(self->wl_surface);
+	slot->busy = TRUE;
+	self->presented_buf = self->cur_buf;
+
+	/* The other buffers now lag behind by this frame's damage */
+	for (j = 0; j < self->n_bufs; j++) {
+		if (j == self->cur_buf) {
+			continue;
+		}
+		if (gst_damage_is_full(self->damage)) {
+			gst_damage_add_all(self->bufs[j].stale);
+			continue;
+		}
+		for (i = 0; i < n_rects; i++) {
+			gst_damage_add(self->bufs[j].stale, rects[i].x, rects[i].y,
+				rects[i].width, rects[i].height);
+		}
+	}
+	gst_damage_clear(self->damage);
+
+	self->timings.last_render_us = g_get_monotonic_time()
+		- self->draw_start_us;
+	self->timings.max_render_us = MAX(self->timings.max_render_us,
+		self->timings.last_render_us);
+
+	if (self->wl_display != NULL) {
+		wl_display_flush(self->wl_display);
+	}
+}
+
+/*
+ * wl_job_finish:
+ * @self: the renderer
+ * @present: draw overlays and commit the painted frame
+ *
+ * Retires a painted job. Without @present, the painted area stays
+ * in the frame damage and goes out with the next commit.
+ */
+static void
+wl_job_finish(
+	GstWaylandRenderer  *self,
+	gboolean            present
+){
+	wl_job_reset(self);
+	self->job_busy = FALSE;
+
+	if (present) {
+		wl_dispatch_overlays(self);
+		wl_present_frame(self);
+	}
+}
+
+/*
+ * wl_job_done:
+ *
+ * Main loop callback queued by the render thread once a job is
+ * painted. A job already retired by wl_job_wait(), or a newer one
+ * still being painted, is left alone.
+ */
+static gboolean
+wl_job_done(gpointer data)
+{
+	GstWaylandRenderer *self;
+	gboolean queued;
+
+	self = GST_WAYLAND_RENDERER(data);
+	if (!self->job_busy) {
+		return G_SOURCE_REMOVE;
+	}
+
+	g_mutex_lock(&self->job_lock);
+	queued = self->job_queued;
+	g_mutex_unlock(&self->job_lock);
+
+	if (!queued) {
+		wl_job_finish(self, TRUE);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+/*
+ * wl_job_wait:
+ * @self: the renderer
+ * @present: commit the job's frame once painted
+ *
+ * Blocks until the job in flight (if any) is painted and retires
+ * it, so the main thread may touch the current slot again.
+ */
+static void
+wl_job_wait(
+	GstWaylandRenderer  *self,
+	gboolean            present
+){
+	if (!self->job_busy) {
+		return;
+	}
+
+	g_mutex_lock(&self->job_lock);
+	while (self->job_queued) {
+		g_cond_wait(&self->job_cond, &self->job_lock);
+	}
+	g_mutex_unlock(&self->job_lock);
+
+	wl_job_finish(self, present);
+}
+
+/*
+ * wl_render_thread_main:
+ *
+ * Render thread body. Sleeps until a job is queued, paints it into
+ * the current slot and hands the frame back to the main loop.
+ */
+static gpointer
+wl_render_thread_main(gpointer data)
+{
+	GstWaylandRenderer *self;
+
+	self = GST_WAYLAND_RENDERER(data);
+
+	g_mutex_lock(&self->job_lock);
+	for (;;) {
+		while (!self->job_queued && !self->job_quit) {
+			g_cond_wait(&self->job_cond, &self->job_lock);
+		}
+		if (self->job_quit) {
+			break;
+		}
+		g_mutex_unlock(&self->job_lock);
+
+		wl_job_paint(self);
+
+		g_mutex_lock(&self->job_lock);
+		self->job_queued = FALSE;
+		g_cond_broadcast(&self->job_cond);
+		g_idle_add_full(G_PRIORITY_HIGH_IDLE, wl_job_done,
+			g_object_ref(self), g_object_unref);
+	}
+	g_mutex_unlock(&self->job_lock);
+
+	return NULL;
+}
+
+/*
+ * wl_render_thread_stop:
+ * @self: the renderer
+ *
+ * Joins the render thread, dropping a job it has not started on.
+ * Callers that still want the frame wait for it first.
+ */
+static void
+wl_render_thread_stop(GstWaylandRenderer *self)
+{
+	if (self->render_thread == NULL) {
+		return;
+	}
+
+	g_mutex_lock(&self->job_lock);
+	self->job_quit = TRUE;
+	g_cond_broadcast(&self->job_cond);
+	g_mutex_unlock(&self->job_lock);
+
+	g_thread_join(self->render_thread);
+	self->render_thread = NULL;
+	self->job_quit = FALSE;
+	self->job_queued = FALSE;
+	wl_job_finish(self, FALSE);
+}
+
 /*
  * wl_renderer_resize_impl:
  * @renderer: the GstRenderer
@@ -1176,6 +2661,10 @@ wl_renderer_resize_impl(
 	gint rows;
 
 	self = GST_WAYLAND_RENDERER(renderer);
+
+	/* The swapchain is recarved below; the repaint covers the job */
+	wl_job_wait(self, FALSE);
+
 	self->win_w = (gint)width;
 	self->win_h = (gint)height;
 
@@ -1192,11 +2681,14 @@ wl_renderer_resize_impl(
 		self->th = rows * self->ch;
 	}
 
-	/* Recreate shm buffer and cairo surface */
-	wl_create_buffer(self, self->win_w, self->win_h);
+	/* Recarve the swapchain; the pool is reused if large enough */
+	wl_swapchain_reset(self, self->win_w, self->win_h);
+	gst_damage_set_bounds(self->damage, self->win_w, self->win_h);
+	gst_damage_set_bounds(self->overlay_damage, self->win_w, self->win_h);
+	gst_damage_clear(self->overlay_damage);
 
 	/* Fill with background color (alpha-aware) */
-	if (self->cr != NULL && self->colors != NULL) {
+	if (wl_acquire_buffer(self) && self->colors != NULL) {
 		wl_set_bg_color(self, self->cr, self->colors[self->default_bg]);
 		cairo_set_operator(self->cr, CAIRO_OPERATOR_SOURCE);
 		cairo_paint(self->cr);
@@ -1216,12 +2708,14 @@ wl_renderer_clear_impl(GstRenderer *renderer)
 	GstWaylandRenderer *self;
 
 	self = GST_WAYLAND_RENDERER(renderer);
+	wl_job_wait(self, TRUE);
 
-	if (self->cr != NULL && self->colors != NULL) {
+	if (wl_acquire_buffer(self) && self->colors != NULL) {
 		wl_set_bg_color(self, self->cr, self->colors[self->default_bg]);
 		cairo_set_operator(self->cr, CAIRO_OPERATOR_SOURCE);
 		cairo_paint(self->cr);
 		cairo_set_operator(self->cr, CAIRO_OPERATOR_OVER);
+		gst_damage_add_all(self->damage);
 	}
 }
 
@@ -1229,7 +2723,12 @@ wl_renderer_clear_impl(GstRenderer *renderer)
  * wl_renderer_start_draw_impl:
  * @renderer: the GstRenderer
  *
- * Checks if Cairo drawing is ready.
+ * Picks a swapchain buffer the compositor has released. If all
+ * are still held the frame is skipped and the dirty lines wait;
+ * "frame-done" is emitted as soon as one is released, so the draw
+ * loop can try again. Events are not dispatched here, since their
+ * handlers may schedule draws themselves. While the render thread
+ * still owns the current slot, nothing can be drawn either.
  *
  * Returns: TRUE if drawing can proceed
  */
@@ -1244,15 +2743,29 @@ wl_renderer_start_draw_impl(GstRenderer *renderer)
 		return FALSE;
 	}
 
-	return (self->cr != NULL);
+	if (self->job_busy) {
+		self->timings.skipped++;
+		return FALSE;
+	}
+
+	self->draw_start_us = g_get_monotonic_time();
+
+	if (wl_acquire_buffer(self)) {
+		return TRUE;
+	}
+
+	self->draw_skipped = TRUE;
+	self->timings.skipped++;
+	return FALSE;
 }
 
 /*
  * wl_renderer_finish_draw_impl:
  * @renderer: the GstRenderer
  *
- * Flushes the Cairo surface and commits the buffer
- * to the Wayland surface.
+ * Presents the frame. When the render pass recorded a job, it is
+ * handed to the render thread instead and presented from the main
+ * loop once painted.
  */
 static void
 wl_renderer_finish_draw_impl(GstRenderer *renderer)
@@ -1261,19 +2774,16 @@ wl_renderer_finish_draw_impl(GstRenderer *renderer)
 
 	self = GST_WAYLAND_RENDERER(renderer);
 
-	if (self->cr == NULL || self->cairo_surface == NULL) {
+	if (self->job.n_ops > 0) {
+		self->job_busy = TRUE;
+		g_mutex_lock(&self->job_lock);
+		self->job_queued = TRUE;
+		g_cond_signal(&self->job_cond);
+		g_mutex_unlock(&self->job_lock);
 		return;
 	}
 
-	cairo_surface_flush(self->cairo_surface);
-	wl_surface_attach(self->wl_surface, self->buffer, 0, 0);
-	wl_surface_damage_buffer(self->wl_surface, 0, 0,
-		self->win_w, self->win_h);
-	wl_surface_commit(self->wl_surface);
-
-	if (self->wl_display != NULL) {
-		wl_display_flush(self->wl_display);
-	}
+	wl_present_frame(self);
 }
 
 /* ===== GObject lifecycle ===== */
@@ -1285,21 +2795,22 @@ gst_wayland_renderer_dispose(GObject *object)
 
 	self = GST_WAYLAND_RENDERER(object);
 
-	/* Free Cairo resources */
-	if (self->cr != NULL) {
-		cairo_destroy(self->cr);
-		self->cr = NULL;
-	}
-	if (self->cairo_surface != NULL) {
-		cairo_surface_destroy(self->cairo_surface);
-		self->cairo_surface = NULL;
-	}
+	/* The render thread draws into the swapchain; stop it first */
+	wl_render_thread_stop(self);
+	g_clear_pointer(&self->job.ops, g_free);
+	g_clear_pointer(&self->job.runs, g_free);
+	g_clear_pointer(&self->job.specs, g_free);
+	g_clear_pointer(&self->job.fonts, g_ptr_array_unref);
+	self->job.ops_len = 0;
+	self->job.runs_len = 0;
+	self->job.specs_len = 0;
+
+	g_clear_pointer(&self->frame_cb, wl_callback_destroy);
+
+	/* Free the swapchain and its Cairo surfaces */
+	wl_swapchain_destroy(self);
 
 	/* Free Wayland buffer resources */
-	if (self->buffer != NULL) {
-		wl_buffer_destroy(self->buffer);
-		self->buffer = NULL;
-	}
 	if (self->shm_pool != NULL) {
 		wl_shm_pool_destroy(self->shm_pool);
 		self->shm_pool = NULL;
@@ -1319,11 +2830,34 @@ gst_wayland_renderer_dispose(GObject *object)
 	g_clear_pointer(&self->colors, g_free);
 	self->num_colors = 0;
 
+	/* Free line batching buffers */
+	g_clear_pointer(&self->specbuf, g_free);
+	g_clear_pointer(&self->gatherbuf, g_free);
+	g_clear_pointer(&self->glyphbuf, g_free);
+	g_clear_pointer(&self->runs, g_free);
+	self->line_buf_len = 0;
+
 	g_clear_object(&self->selection);
+	g_clear_pointer(&self->damage, gst_damage_free);
+	g_clear_pointer(&self->overlay_damage, gst_damage_free);
+	g_clear_pointer(&self->images, gst_image_cache_free);
 
 	G_OBJECT_CLASS(gst_wayland_renderer_parent_class)->dispose(object);
 }
 
+static void
+gst_wayland_renderer_finalize(GObject *object)
+{
+	GstWaylandRenderer *self;
+
+	self = GST_WAYLAND_RENDERER(object);
+
+	g_mutex_clear(&self->job_lock);
+	g_cond_clear(&self->job_cond);
+
+	G_OBJECT_CLASS(gst_wayland_renderer_parent_class)->finalize(object);
+}
+
 /*
  * wl_renderer_capture_screenshot_impl:
  *
@@ -1346,6 +2880,7 @@ wl_renderer_capture_screenshot_impl(
 	gint x, y;
 
 	self = GST_WAYLAND_RENDERER(renderer);
+	wl_job_wait(self, TRUE);
 
 	w = self->win_w;
 	h = self->win_h;
@@ -1406,6 +2941,7 @@ gst_wayland_renderer_class_init(GstWaylandRendererClass *klass)
 
 	object_class = G_OBJECT_CLASS(klass);
 	object_class->dispose = gst_wayland_renderer_dispose;
+	object_class->finalize = gst_wayland_renderer_finalize;
 
 	renderer_class = GST_RENDERER_CLASS(klass);
 	renderer_class->render = wl_renderer_render_impl;
@@ -1416,6 +2952,23 @@ gst_wayland_renderer_class_init(GstWaylandRendererClass *klass)
 	renderer_class->start_draw = wl_renderer_start_draw_impl;
 	renderer_class->finish_draw = wl_renderer_finish_draw_impl;
 	renderer_class->capture_screenshot = wl_renderer_capture_screenshot_impl;
+
+	/**
+	 * GstWaylandRenderer::frame-done:
+	 * @self: the renderer
+	 *
+	 * Emitted when the compositor signals, through the frame
+	 * callback of the last commit, that it is ready to show a
+	 * new frame, and when it releases a buffer after a draw was
+	 * skipped because none was free.
+	 */
+	signals[SIGNAL_FRAME_DONE] = g_signal_new(
+		"frame-done",
+		G_TYPE_FROM_CLASS(klass),
+		G_SIGNAL_RUN_LAST,
+		0, NULL, NULL, NULL,
+		G_TYPE_NONE, 0
+	);
 }
 
 static void
@@ -1429,7 +2982,35 @@ gst_wayland_renderer_init(GstWaylandRenderer *self)
 	self->shm_data = NULL;
 	self->shm_size = 0;
 	self->shm_pool = NULL;
-	self->buffer = NULL;
+	memset(self->bufs, 0, sizeof(self->bufs));
+	self->n_bufs = 0;
+	self->buf_width = 0;
+	self->buf_height = 0;
+	self->buf_stride = 0;
+	self->buf_size = 0;
+	self->cur_buf = -1;
+	self->presented_buf = -1;
+	self->specbuf = NULL;
+	self->gatherbuf = NULL;
+	self->glyphbuf = NULL;
+	self->runs = NULL;
+	self->n_runs = 0;
+	self->line_buf_len = 0;
+	self->use_atlas = FALSE;
+	self->render_thread = NULL;
+	g_mutex_init(&self->job_lock);
+	g_cond_init(&self->job_cond);
+	self->job_queued = FALSE;
+	self->job_quit = FALSE;
+	self->job_busy = FALSE;
+	self->job_recording = FALSE;
+	memset(&self->job, 0, sizeof(self->job));
+	self->job.fonts = g_ptr_array_new_with_free_func(
+		(GDestroyNotify)cairo_scaled_font_destroy);
+	self->frame_cb = NULL;
+	self->last_frame_time = 0;
+	self->draw_start_us = 0;
+	memset(&self->timings, 0, sizeof(self->timings));
 	self->cairo_surface = NULL;
 	self->cr = NULL;
 	self->colors = NULL;
@@ -1451,6 +3032,9 @@ gst_wayland_renderer_init(GstWaylandRenderer *self)
 	self->default_rcs = GST_COLOR_REVERSE_BG;
 	self->selection = NULL;
 	self->last_opacity = 1.0;
+	self->damage = gst_damage_new();
+	self->overlay_damage = gst_damage_new();
+	self->images = gst_wayland_render_context_new_image_cache();
 }
 
 /* ===== Public API ===== */
@@ -1501,8 +3085,12 @@ gst_wayland_renderer_new(
 	self->win_w = 2 * borderpx + self->tw;
 	self->win_h = 2 * borderpx + self->th;
 
-	/* Create initial shm buffer and cairo surface */
-	wl_create_buffer(self, self->win_w, self->win_h);
+	/* Create the shm pool and the first swapchain buffer */
+	wl_swapchain_reset(self, self->win_w, self->win_h);
+	wl_acquire_buffer(self);
+	gst_damage_set_bounds(self->damage, self->win_w, self->win_h);
+	gst_damage_set_bounds(self->overlay_damage, self->win_w, self->win_h);
+	gst_damage_clear(self->overlay_damage);
 
 	return self;
 }
@@ -1527,6 +3115,9 @@ gst_wayland_renderer_load_colors(
 
 	g_return_val_if_fail(GST_IS_WAYLAND_RENDERER(self), FALSE);
 
+	/* The render thread reads the palette */
+	wl_job_wait(self, FALSE);
+
 	/* Free old colors if any */
 	g_clear_pointer(&self->colors, g_free);
 
@@ -1653,6 +3244,7 @@ gst_wayland_renderer_load_colors(
 		cairo_set_operator(self->cr, CAIRO_OPERATOR_SOURCE);
 		cairo_paint(self->cr);
 		cairo_set_operator(self->cr, CAIRO_OPERATOR_OVER);
+		gst_damage_add_all(self->damage);
 	}
 
 	return TRUE;
@@ -1711,3 +3303,96 @@ gst_wayland_renderer_set_selection(
 	}
 	self->selection = (selection != NULL) ? g_object_ref(selection) : NULL;
 }
+
+/**
+ * gst_wayland_renderer_set_glyph_atlas:
+ * @self: A #GstWaylandRenderer
+ * @enabled: whether to blit glyphs from the atlas
+ *
+ * Switches line glyphs between cairo_show_glyphs() and direct
+ * blits of pre-rasterized coverage from the font cache's atlas.
+ */
+void
+gst_wayland_renderer_set_glyph_atlas(
+	GstWaylandRenderer  *self,
+	gboolean            enabled
+){
+	g_return_if_fail(GST_IS_WAYLAND_RENDERER(self));
+
+	self->use_atlas = enabled;
+}
+
+/**
+ * gst_wayland_renderer_set_render_thread:
+ * @self: A #GstWaylandRenderer
+ * @enabled: whether to paint lines on a render thread
+ *
+ * Starts or stops the render thread. A frame still in flight is
+ * presented before the thread stops. If the thread cannot be
+ * started, frames keep being drawn on the main thread.
+ */
+void
+gst_wayland_renderer_set_render_thread(
+	GstWaylandRenderer  *self,
+	gboolean            enabled
+){
+	GError *error;
+
+	g_return_if_fail(GST_IS_WAYLAND_RENDERER(self));
+
+	error = NULL;
+	if (enabled == (self->render_thread != NULL)) {
+		return;
+	}
+
+	if (!enabled) {
+		wl_job_wait(self, TRUE);
+		wl_render_thread_stop(self);
+		return;
+	}
+
+	self->render_thread = g_thread_try_new("gst-wl-render",
+		wl_render_thread_main, self, &error);
+	if (self->render_thread == NULL) {
+		g_warning("gst-wayland-renderer: cannot start render thread: %s",
+			error->message);
+		g_error_free(error);
+	}
+}
+
+/**
+ * gst_wayland_renderer_is_frame_pending:
+ * @self: A #GstWaylandRenderer
+ *
+ * Checks whether a committed frame is still waiting for its
+ * wl_surface.frame callback, or a frame is still with the render
+ * thread. Its commit requests a callback, so "frame-done" follows
+ * either way.
+ *
+ * Returns: TRUE if a frame callback or render job is outstanding
+ */
+gboolean
+gst_wayland_renderer_is_frame_pending(GstWaylandRenderer *self)
+{
+	g_return_val_if_fail(GST_IS_WAYLAND_RENDERER(self), FALSE);
+
+	return (self->frame_cb != NULL || self->job_busy);
+}
+
+/**
+ * gst_wayland_renderer_get_frame_timings:
+ * @self: A #GstWaylandRenderer
+ * @timings: (out caller-allocates): location for the measurements
+ *
+ * Copies the current frame pacing measurements into @timings.
+ */
+void
+gst_wayland_renderer_get_frame_timings(
+	GstWaylandRenderer      *self,
+	GstWaylandFrameTimings  *timings
+){
+	g_return_if_fail(GST_IS_WAYLAND_RENDERER(self));
+	g_return_if_fail(timings != NULL);
+
+	*timings = self->timings;
+}
@@ -32,6 +32,27 @@ G_BEGIN_DECLS
 G_DECLARE_FINAL_TYPE(GstWaylandRenderer, gst_wayland_renderer,
 	GST, WAYLAND_RENDERER, GstRenderer)
 
+/**
+ * GstWaylandFrameTimings:
+ * @frames: frames the compositor has reported as shown
+ * @skipped: draws skipped because every buffer was still held
+ * @last_interval_ms: time between the last two frame callbacks
+ * @avg_interval_ms: moving average of @last_interval_ms
+ * @last_render_us: time from start_draw to commit of the last frame
+ * @max_render_us: longest render time seen
+ *
+ * Frame pacing measurements, for debugging.
+ */
+typedef struct
+{
+	guint64 frames;
+	guint64 skipped;
+	guint32 last_interval_ms;
+	gdouble avg_interval_ms;
+	gint64  last_render_us;
+	gint64  max_render_us;
+} GstWaylandFrameTimings;
+
 /**
  * gst_wayland_renderer_new:
  * @terminal: the terminal to render
@@ -40,7 +61,7 @@ G_DECLARE_FINAL_TYPE(GstWaylandRenderer, gst_wayland_renderer,
  * @borderpx: border padding in pixels
  *
  * Creates a new Wayland renderer with Cairo drawing and
- * wl_shm double-buffered rendering. The renderer reads the
+ * wl_shm triple-buffered rendering. The renderer reads the
  * window's opacity value to paint backgrounds with alpha.
  *
  * Returns: (transfer full): A new #GstWaylandRenderer
@@ -104,6 +125,67 @@ gst_wayland_renderer_set_selection(
 	GstSelection        *selection
 );
 
+/**
+ * gst_wayland_renderer_set_glyph_atlas:
+ * @self: A #GstWaylandRenderer
+ * @enabled: whether to blit glyphs from the atlas
+ *
+ * Enables the software glyph path: glyphs are rasterized once into
+ * the font cache's A8 atlas and composited straight into the shm
+ * buffer with SIMD blend kernels. Color and oversized glyphs still
+ * go through Cairo. Off by default.
+ */
+void
+gst_wayland_renderer_set_glyph_atlas(
+	GstWaylandRenderer  *self,
+	gboolean            enabled
+);
+
+/**
+ * gst_wayland_renderer_set_render_thread:
+ * @self: A #GstWaylandRenderer
+ * @enabled: whether to paint lines on a render thread
+ *
+ * Moves rasterization off the main thread. Each render pass then
+ * only records the resolved runs, glyphs and cursor of the dirty
+ * lines; a worker thread paints them into the current shm buffer
+ * and the main loop attaches and commits it when the worker is
+ * done. Module backgrounds, glyph transformers and overlays still
+ * draw on the main thread. Off by default.
+ */
+void
+gst_wayland_renderer_set_render_thread(
+	GstWaylandRenderer  *self,
+	gboolean            enabled
+);
+
+/**
+ * gst_wayland_renderer_is_frame_pending:
+ * @self: A #GstWaylandRenderer
+ *
+ * Checks whether a committed frame is still waiting for its
+ * wl_surface.frame callback, or a frame is still with the render
+ * thread. While one is pending, new draws should be held back
+ * until #GstWaylandRenderer::frame-done.
+ *
+ * Returns: TRUE if a frame callback or render job is outstanding
+ */
+gboolean
+gst_wayland_renderer_is_frame_pending(GstWaylandRenderer *self);
+
+/**
+ * gst_wayland_renderer_get_frame_timings:
+ * @self: A #GstWaylandRenderer
+ * @timings: (out caller-allocates): location for the measurements
+ *
+ * Copies the current frame pacing measurements into @timings.
+ */
+void
+gst_wayland_renderer_get_frame_timings(
+	GstWaylandRenderer      *self,
+	GstWaylandFrameTimings  *timings
+);
+
 G_END_DECLS
 
 #endif /* GST_WAYLAND_RENDERER_H */
@@ -6,7 +6,8 @@
  *
  * Implements the GstRenderContextOps vtable for the X11 backend.
  * Wraps Xft drawing calls (XftDrawRect, XftDrawGlyphFontSpec)
- * behind the abstract render context interface.
+ * behind the abstract render context interface. Registered images
+ * live server-side as Pixmaps with XRender Pictures.
  */
 
 #include "gst-x11-render-context.h"
@@ -42,6 +43,7 @@ x11_fill_rect(
 	GstX11RenderContext *ctx;
 
 	ctx = (GstX11RenderContext *)base;
+	gst_render_context_add_damage(base, x, y, w, h);
 
 	if (color_idx < ctx->num_colors) {
 		XftDrawRect(ctx->xft_draw, &ctx->colors[color_idx],
@@ -72,6 +74,7 @@ x11_fill_rect_rgba(
 	XftColor xft_color;
 
 	ctx = (GstX11RenderContext *)base;
+	gst_render_context_add_damage(base, x, y, w, h);
 
 	color.red   = (guint16)((guint16)r << 8 | r);
 	color.green = (guint16)((guint16)g << 8 | g);
@@ -102,6 +105,7 @@ x11_fill_rect_fg(
 	GstX11RenderContext *ctx;
 
 	ctx = (GstX11RenderContext *)base;
+	gst_render_context_add_damage(base, x, y, w, h);
 
 	if (ctx->fg != NULL) {
 		XftDrawRect(ctx->xft_draw, ctx->fg, x, y, (guint)w, (guint)h);
@@ -124,6 +128,7 @@ x11_fill_rect_bg(
 	GstX11RenderContext *ctx;
 
 	ctx = (GstX11RenderContext *)base;
+	gst_render_context_add_damage(base, x, y, w, h);
 
 	if (ctx->bg != NULL) {
 		XftDrawRect(ctx->xft_draw, ctx->bg, x, y, (guint)w, (guint)h);
@@ -155,6 +160,7 @@ x11_draw_glyph(
 	XftColor *fg_color;
 
 	ctx = (GstX11RenderContext *)base;
+	gst_render_context_add_damage(base, px, py, 2 * base->cw, base->ch);
 
 	/* Look up glyph in font cache */
 	gst_font_cache_lookup_glyph(ctx->font_cache, rune, style,
@@ -179,78 +185,91 @@ x11_draw_glyph(
 }
 
 /*
- * x11_draw_image:
+ * X11CachedImage:
+ * @pix: 32-bit pixmap holding the premultiplied image
+ * @pic: XRender picture over @pix
+ * @width: image width in pixels
+ * @height: image height in pixels
  *
- * Draws an RGBA image using XRender compositing.
- * Converts RGBA row data to an XImage (BGRA byte order for
- * XRender's 32-bit visual), creates a temporary Pixmap + Picture,
- * then composites onto the drawable with PictOpOver for alpha blending.
+ * An image uploaded to the X server, kept in the image cache.
+ */
+typedef struct
+{
+	Pixmap  pix;
+	Picture pic;
+	gint    width;
+	gint    height;
+} X11CachedImage;
+
+/*
+ * x11_free_image:
+ *
+ * GstImageCacheFreeFunc releasing an X11CachedImage.
+ * @user_data is the Display.
  */
 static void
-x11_draw_image(
-	GstRenderContext *base,
-	const guint8     *data,
-	gint              src_w,
-	gint              src_h,
-	gint              src_stride,
-	gint              dst_x,
-	gint              dst_y,
-	gint              dst_w,
-	gint              dst_h
+x11_free_image(
+	gpointer resource,
+	gpointer user_data
 ){
-	GstX11RenderContext *ctx;
-	XImage *ximg;
-	Pixmap pix;
-	Picture pic_src;
-	Picture pic_dst;
+	X11CachedImage *img;
+	Display *display;
+
+	img = (X11CachedImage *)resource;
+	display = (Display *)user_data;
+
+	XRenderFreePicture(display, img->pic);
+	XFreePixmap(display, img->pix);
+	g_free(img);
+}
+
+/*
+ * x11_upload_image:
+ *
+ * Converts RGBA rows to premultiplied BGRA (XRender's ARGB32 in
+ * little-endian byte order), puts them into a new 32-bit pixmap
+ * and wraps it in a Picture.
+ *
+ * Returns: (transfer full) (nullable): the uploaded image
+ */
+static X11CachedImage *
+x11_upload_image(
+	GstX11RenderContext *ctx,
+	const guint8        *data,
+	gint                 src_w,
+	gint                 src_h,
+	gint                 src_stride
+){
+	X11CachedImage *img;
 	XRenderPictFormat *fmt;
 	XRenderPictureAttributes pa;
-	XTransform xform;
+	XImage *ximg;
 	guint8 *bgra;
 	gint row;
 	gint col;
-	gint idx_src;
-	gint idx_dst;
-
-	ctx = (GstX11RenderContext *)base;
-
-	if (data == NULL || src_w <= 0 || src_h <= 0) {
-		return;
-	}
 
 	/* Find a 32-bit ARGB format for XRender */
 	fmt = XRenderFindStandardFormat(ctx->display, PictStandardARGB32);
 	if (fmt == NULL) {
-		return;
+		return NULL;
 	}
 
-	/*
-	 * Convert RGBA to pre-multiplied BGRA (XRender expects pre-multiplied alpha
-	 * in ARGB32 format, which is BGRA byte order on little-endian).
-	 */
 	bgra = (guint8 *)g_malloc((gsize)src_w * (gsize)src_h * 4);
 	for (row = 0; row < src_h; row++) {
-		for (col = 0; col < src_w; col++) {
-			guint8 r, g, b, a;
-			guint16 pr, pg, pb;
+		const guint8 *s;
+		guint8 *d;
 
-			idx_src = row * src_stride + col * 4;
-			idx_dst = (row * src_w + col) * 4;
-
-			r = data[idx_src + 0];
-			g = data[idx_src + 1];
-			b = data[idx_src + 2];
-			a = data[idx_src + 3];
+		s = data + (gsize)row * (gsize)src_stride;
+		d = bgra + (gsize)row * (gsize)src_w * 4;
+		for (col = 0; col < src_w; col++, s += 4, d += 4) {
+			guint a;
 
 			/* Pre-multiply RGB by alpha */
-			pr = (guint16)((guint16)r * a + 127) / 255;
-			pg = (guint16)((guint16)g * a + 127) / 255;
-			pb = (guint16)((guint16)b * a + 127) / 255;
-
-			bgra[idx_dst + 0] = (guint8)pb;   /* B */
-			bgra[idx_dst + 1] = (guint8)pg;   /* G */
-			bgra[idx_dst + 2] = (guint8)pr;   /* R */
-			bgra[idx_dst + 3] = a;             /* A */
+			a = s[3];
+			d[0] = (guint8)((s[2] * a + 127) / 255);   /* B */
+			d[1] = (guint8)((s[1] * a + 127) / 255);   /* G */
+			d[2] = (guint8)((s[0] * a + 127) / 255);   /* R */
+			d[3] = (guint8)a;                          /* A */
 		}
 	}
 
@@ -259,54 +278,203 @@ x11_draw_image(
 		(char *)bgra, (guint)src_w, (guint)src_h, 32, src_w * 4);
 	if (ximg == NULL) {
 		g_free(bgra);
-		return;
+		return NULL;
 	}
 
-	/* Create a temporary pixmap and put the image into it */
-	pix = XCreatePixmap(ctx->display, ctx->window,
+	img = g_new0(X11CachedImage, 1);
+	img->width = src_w;
+	img->height = src_h;
+	img->pix = XCreatePixmap(ctx->display, ctx->window,
 		(guint)src_w, (guint)src_h, 32);
 
-	XPutImage(ctx->display, pix, ctx->gc, ximg,
+	XPutImage(ctx->display, img->pix, ctx->gc, ximg,
 		0, 0, 0, 0, (guint)src_w, (guint)src_h);
 
-	/* Create XRender pictures */
 	memset(&pa, 0, sizeof(pa));
-	pic_src = XRenderCreatePicture(ctx->display, pix, fmt, 0, &pa);
+	img->pic = XRenderCreatePicture(ctx->display, img->pix, fmt, 0, &pa);
+
+	/* XDestroyImage would free the data pointer too */
+	ximg->data = NULL;
+	XDestroyImage(ximg);
+	g_free(bgra);
+
+	return img;
+}
+
+/*
+ * x11_composite_image:
+ *
+ * Composites a source rectangle of @img onto the drawable with
+ * PictOpOver, scaling it bilinearly when the sizes differ. The
+ * picture's transform and filter are reset on every call since
+ * cached pictures are drawn at different sizes.
+ */
+static void
+x11_composite_image(
+	GstX11RenderContext *ctx,
+	X11CachedImage      *img,
+	gint                 src_x,
+	gint                 src_y,
+	gint                 src_w,
+	gint                 src_h,
+	gint                 dst_x,
+	gint                 dst_y,
+	gint                 dst_w,
+	gint                 dst_h
+){
+	XRenderPictFormat *fmt;
+	XRenderPictureAttributes pa;
+	XTransform xform;
+	Picture pic_dst;
+	gint origin_x;
+	gint origin_y;
+
+	memset(&xform, 0, sizeof(xform));
+	xform.matrix[0][0] = XDoubleToFixed(1.0);
+	xform.matrix[1][1] = XDoubleToFixed(1.0);
+	xform.matrix[2][2] = XDoubleToFixed(1.0);
+	origin_x = src_x;
+	origin_y = src_y;
 
-	/* Apply scaling transform if src and dst sizes differ */
 	if (dst_w != src_w || dst_h != src_h) {
-		memset(&xform, 0, sizeof(xform));
+		/* Map destination pixels into the source rectangle */
 		xform.matrix[0][0] = XDoubleToFixed((double)src_w / (double)dst_w);
+		xform.matrix[0][2] = XDoubleToFixed((double)src_x);
 		xform.matrix[1][1] = XDoubleToFixed((double)src_h / (double)dst_h);
-		xform.matrix[2][2] = XDoubleToFixed(1.0);
-		XRenderSetPictureTransform(ctx->display, pic_src, &xform);
-		XRenderSetPictureFilter(ctx->display, pic_src, "bilinear", NULL, 0);
+		xform.matrix[1][2] = XDoubleToFixed((double)src_y);
+		origin_x = 0;
+		origin_y = 0;
+		XRenderSetPictureFilter(ctx->display, img->pic, "bilinear", NULL, 0);
+	} else {
+		XRenderSetPictureFilter(ctx->display, img->pic, "nearest", NULL, 0);
 	}
+	XRenderSetPictureTransform(ctx->display, img->pic, &xform);
 
 	/* Get the picture for the drawable */
 	fmt = XRenderFindVisualFormat(ctx->display, ctx->visual);
-	if (fmt != NULL) {
-		pic_dst = XRenderCreatePicture(ctx->display, ctx->drawable,
-			fmt, 0, &pa);
-
-		/* Composite with alpha blending */
-		XRenderComposite(ctx->display, PictOpOver,
-			pic_src, None, pic_dst,
-			0, 0,   /* src origin */
-			0, 0,   /* mask origin */
-			dst_x, dst_y,
-			(guint)dst_w, (guint)dst_h);
-
-		XRenderFreePicture(ctx->display, pic_dst);
+	if (fmt == NULL) {
+		return;
 	}
 
-	XRenderFreePicture(ctx->display, pic_src);
-	XFreePixmap(ctx->display, pix);
+	memset(&pa, 0, sizeof(pa));
+	pic_dst = XRenderCreatePicture(ctx->display, ctx->drawable, fmt, 0, &pa);
 
-	/* XDestroyImage frees both the XImage struct and the data pointer */
-	ximg->data = NULL; /* prevent double-free, we free bgra ourselves */
-	XDestroyImage(ximg);
-	g_free(bgra);
+	/* Composite with alpha blending */
+	XRenderComposite(ctx->display, PictOpOver,
+		img->pic, None, pic_dst,
+		origin_x, origin_y,   /* src origin */
+		0, 0,                 /* mask origin */
+		dst_x, dst_y,
+		(guint)dst_w, (guint)dst_h);
+
+	XRenderFreePicture(ctx->display, pic_dst);
+}
+
+/*
+ * x11_draw_image:
+ *
+ * Draws an RGBA image using XRender compositing. Uploads it
+ * into a temporary Pixmap + Picture, composites, and frees it.
+ * Images drawn every frame should go through register_image.
+ */
+static void
+x11_draw_image(
+	GstRenderContext *base,
+	const guint8     *data,
+	gint              src_w,
+	gint              src_h,
+	gint              src_stride,
+	gint              dst_x,
+	gint              dst_y,
+	gint              dst_w,
+	gint              dst_h
+){
+	GstX11RenderContext *ctx;
+	X11CachedImage *img;
+
+	ctx = (GstX11RenderContext *)base;
+	gst_render_context_add_damage(base, dst_x, dst_y, dst_w, dst_h);
+
+	if (data == NULL || src_w <= 0 || src_h <= 0) {
+		return;
+	}
+
+	img = x11_upload_image(ctx, data, src_w, src_h, src_stride);
+	if (img == NULL) {
+		return;
+	}
+
+	x11_composite_image(ctx, img, 0, 0, src_w, src_h,
+		dst_x, dst_y, dst_w, dst_h);
+	x11_free_image(img, ctx->display);
+}
+
+/*
+ * x11_register_image:
+ *
+ * Uploads an RGBA image into a persistent Pixmap + Picture owned
+ * by the image cache.
+ */
+static guint
+x11_register_image(
+	GstRenderContext *base,
+	const guint8     *data,
+	gint              src_w,
+	gint              src_h,
+	gint              src_stride
+){
+	GstX11RenderContext *ctx;
+	X11CachedImage *img;
+
+	ctx = (GstX11RenderContext *)base;
+
+	if (data == NULL || src_w <= 0 || src_h <= 0) {
+		return 0;
+	}
+
+	img = x11_upload_image(ctx, data, src_w, src_h, src_stride);
+	if (img == NULL) {
+		return 0;
+	}
+
+	return gst_image_cache_insert(base->images, img,
+		(gsize)src_w * (gsize)src_h * 4);
+}
+
+/*
+ * x11_draw_image_handle:
+ *
+ * Composites part of a cached image without re-uploading it.
+ */
+static gboolean
+x11_draw_image_handle(
+	GstRenderContext *base,
+	guint             handle,
+	gint              src_x,
+	gint              src_y,
+	gint              src_w,
+	gint              src_h,
+	gint              dst_x,
+	gint              dst_y,
+	gint              dst_w,
+	gint              dst_h
+){
+	GstX11RenderContext *ctx;
+	X11CachedImage *img;
+
+	ctx = (GstX11RenderContext *)base;
+
+	img = (X11CachedImage *)gst_image_cache_lookup(base->images, handle);
+	if (img == NULL) {
+		return FALSE;
+	}
+
+	gst_render_context_add_damage(base, dst_x, dst_y, dst_w, dst_h);
+	if (src_w > 0 && src_h > 0 && dst_w > 0 && dst_h > 0) {
+		x11_composite_image(ctx, img, src_x, src_y, src_w, src_h,
+			dst_x, dst_y, dst_w, dst_h);
+	}
+	return TRUE;
 }
 
 /*
@@ -331,6 +499,7 @@ x11_draw_glyph_id(
 	FT_UInt glyph_index;
 
 	ctx = (GstX11RenderContext *)base;
+	gst_render_context_add_damage(base, px, py, 2 * base->cw, base->ch);
 
 	/* Get the font for the requested style */
 	fv = gst_font_cache_get_font(ctx->font_cache, style);
@@ -357,7 +526,9 @@ static const GstRenderContextOps x11_ops = {
 	x11_fill_rect_bg,
 	x11_draw_glyph,
 	x11_draw_image,
-	x11_draw_glyph_id
+	x11_draw_glyph_id,
+	x11_register_image,
+	x11_draw_image_handle
 };
 
 /* ===== Public API ===== */
@@ -374,3 +545,19 @@ gst_x11_render_context_init_ops(GstX11RenderContext *ctx)
 	ctx->base.ops = &x11_ops;
 	ctx->base.backend = GST_BACKEND_X11;
 }
+
+/**
+ * gst_x11_render_context_new_image_cache:
+ * @display: display the cached Pixmaps and Pictures belong to
+ *
+ * Creates the image cache an X11 renderer hands to its render
+ * contexts. It must be freed while @display is still open.
+ *
+ * Returns: (transfer full): a new #GstImageCache
+ */
+GstImageCache *
+gst_x11_render_context_new_image_cache(Display *display)
+{
+	return gst_image_cache_new(GST_IMAGE_CACHE_DEFAULT_BUDGET,
+		x11_free_image, display);
+}
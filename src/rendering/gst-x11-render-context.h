@@ -73,6 +73,19 @@ typedef struct
 void
 gst_x11_render_context_init_ops(GstX11RenderContext *ctx);
 
+/**
+ * gst_x11_render_context_new_image_cache:
+ * @display: display the cached images are uploaded to
+ *
+ * Creates the cache backing gst_render_context_register_image()
+ * for X11 contexts. Entries are Pixmaps with XRender Pictures;
+ * free the cache before closing @display.
+ *
+ * Returns: (transfer full): a new #GstImageCache
+ */
+GstImageCache *
+gst_x11_render_context_new_image_cache(Display *display);
+
 G_END_DECLS
 
 #endif /* GST_X11_RENDER_CONTEXT_H */
@@ -14,6 +14,7 @@
 
 #include "gst-x11-renderer.h"
 #include "gst-x11-render-context.h"
+#include "gst-damage.h"
 #include "../core/gst-terminal.h"
 #include "../core/gst-line.h"
 #include "../boxed/gst-glyph.h"
@@ -56,9 +57,59 @@ static const gchar *default_colorname[] = {
 /* Cursor thickness in pixels */
 #define GST_CURSOR_THICKNESS (2)
 
+/* Number of allocated colors kept by the truecolor LRU cache */
+#define X11_COLOR_CACHE_SIZE (512)
+
 /* Attribute comparison: TRUE if fg/bg/mode differ */
 #define ATTRCMP(a, b) ((a).attr != (b).attr || (a).fg != (b).fg || (a).bg != (b).bg)
 
+/*
+ * X11ColorCacheEntry:
+ *
+ * An allocated color in the LRU cache, keyed by its packed 16-bit
+ * RGBA value. @prev and @next link entries from most to least
+ * recently used by index, -1 terminated.
+ */
+typedef struct
+{
+	guint64  key;
+	XftColor color;
+	gboolean allocated;
+	gint     prev;
+	gint     next;
+} X11ColorCacheEntry;
+
+/*
+ * X11RunColors:
+ *
+ * Resolved foreground and background for a run of glyphs. Both are
+ * copies, so they stay usable after their cache entries are evicted.
+ */
+typedef struct
+{
+	XftColor fg;
+	XftColor bg;
+} X11RunColors;
+
+/*
+ * X11LineRun:
+ *
+ * One same-attribute run queued while a line is being drawn. Runs
+ * are collected for the whole line and then submitted together by
+ * x11_flush_line_runs().
+ */
+typedef struct
+{
+	GstGlyph     base;
+	gint         x;           /* starting column */
+	gint         spec_start;  /* index of first spec in specbuf */
+	gint         nspecs;
+	X11RunColors colors;
+	XRenderColor bg_fill;
+	gboolean     has_bg_fill;
+	gboolean     done;        /* already emitted in the current pass */
+} X11LineRun;
+
 struct _GstX11Renderer
 {
 	GstRenderer parent_instance;
@@ -77,10 +128,25 @@ struct _GstX11Renderer
 	XftGlyphFontSpec *specbuf;
 	gint specbuf_len;
 
+	/* Runs queued for the line being drawn, plus scratch buffers
+	 * for grouping them by color (all sized to the column count) */
+	X11LineRun *runs;
+	gint n_runs;
+	XftGlyphFontSpec *gatherbuf;
+	XRectangle *rectbuf;
+
 	/* Color palette */
 	XftColor *colors;
 	gsize num_colors;
 
+	/* LRU cache of colors outside the palette (truecolor, dimmed,
+	 * premultiplied), so repeated frames allocate nothing */
+	X11ColorCacheEntry *color_cache;
+	GHashTable *color_map;   /* &entry->key -> X11ColorCacheEntry* */
+	gint color_cache_len;
+	gint color_lru_head;
+	gint color_lru_tail;
+
 	/* Font cache (not owned, caller manages lifetime) */
 	GstFontCache *font_cache;
 
@@ -123,6 +189,15 @@ struct _GstX11Renderer
 	gint depth;              /* 32 for ARGB visual, else DefaultDepth */
 	GstX11Window *x11_window; /* for reading opacity (not owned) */
 	gdouble last_opacity;    /* last rendered opacity for change detection */
+
+	/* Pixmap area drawn since the last present */
+	GstDamage *damage;
+
+	/* Pixmap area module overlays drew over in the last frame */
+	GstDamage *overlay_damage;
+
+	/* Module images uploaded as Pictures, created with the first context */
+	GstImageCache *images;
 };
 
 G_DEFINE_TYPE(GstX11Renderer, gst_x11_renderer, GST_TYPE_RENDERER)
@@ -195,6 +270,151 @@ load_single_color(
 		self->cmap, name, ncolor);
 }
 
+/*
+ * x11_color_cache_unlink:
+ * @self: the renderer
+ * @idx: entry index
+ *
+ * Removes an entry from the LRU list.
+ */
+static void
+x11_color_cache_unlink(
+	GstX11Renderer  *self,
+	gint            idx
+){
+	X11ColorCacheEntry *e;
+
+	e = &self->color_cache[idx];
+	if (e->prev >= 0) {
+		self->color_cache[e->prev].next = e->next;
+	} else {
+		self->color_lru_head = e->next;
+	}
+	if (e->next >= 0) {
+		self->color_cache[e->next].prev = e->prev;
+	} else {
+		self->color_lru_tail = e->prev;
+	}
+	e->prev = -1;
+	e->next = -1;
+}
+
+/*
+ * x11_color_cache_push_front:
+ * @self: the renderer
+ * @idx: entry index
+ *
+ * Makes an unlinked entry the most recently used one.
+ */
+static void
+x11_color_cache_push_front(
+	GstX11Renderer  *self,
+	gint            idx
+){
+	X11ColorCacheEntry *e;
+
+	e = &self->color_cache[idx];
+	e->prev = -1;
+	e->next = self->color_lru_head;
+	if (self->color_lru_head >= 0) {
+		self->color_cache[self->color_lru_head].prev = idx;
+	}
+	self->color_lru_head = idx;
+	if (self->color_lru_tail < 0) {
+		self->color_lru_tail = idx;
+	}
+}
+
+/*
+ * x11_color_cache_flush:
+ * @self: the renderer
+ *
+ * Frees every cached color. Must run whenever the visual or colormap
+ * the colors were allocated against changes.
+ */
+static void
+x11_color_cache_flush(GstX11Renderer *self)
+{
+	gint i;
+
+	if (self->color_map != NULL) {
+		g_hash_table_remove_all(self->color_map);
+	}
+
+	for (i = 0; i < self->color_cache_len; i++) {
+		if (self->color_cache[i].allocated && self->display != NULL) {
+			XftColorFree(self->display, self->vis, self->cmap,
+				&self->color_cache[i].color);
+		}
+	}
+
+	self->color_cache_len = 0;
+	self->color_lru_head = -1;
+	self->color_lru_tail = -1;
+}
+
+/*
+ * x11_cached_color:
+ * @self: the renderer
+ * @rc: the color value
+ *
+ * Looks up an allocated #XftColor for @rc, allocating it on a miss.
+ * When the cache is full the least recently used color is freed.
+ * The returned pointer is only valid until the next lookup.
+ *
+ * Returns: (transfer none): the allocated color
+ */
+static const XftColor *
+x11_cached_color(
+	GstX11Renderer      *self,
+	const XRenderColor  *rc
+){
+	X11ColorCacheEntry *e;
+	guint64 key;
+	gint idx;
+
+	key = ((guint64)rc->red << 48) | ((guint64)rc->green << 32)
+		| ((guint64)rc->blue << 16) | (guint64)rc->alpha;
+
+	e = (X11ColorCacheEntry *)g_hash_table_lookup(self->color_map, &key);
+	if (e != NULL) {
+		idx = (gint)(e - self->color_cache);
+		if (idx != self->color_lru_head) {
+			x11_color_cache_unlink(self, idx);
+			x11_color_cache_push_front(self, idx);
+		}
+		return &e->color;
+	}
+
+	/* Take a free slot, or recycle the least recently used one */
+	if (self->color_cache_len < X11_COLOR_CACHE_SIZE) {
+		idx = self->color_cache_len++;
+	} else {
+		idx = self->color_lru_tail;
+		x11_color_cache_unlink(self, idx);
+		g_hash_table_remove(self->color_map, &self->color_cache[idx].key);
+		if (self->color_cache[idx].allocated) {
+			XftColorFree(self->display, self->vis, self->cmap,
+				&self->color_cache[idx].color);
+		}
+	}
+
+	e = &self->color_cache[idx];
+	e->key = key;
+	e->allocated = (gboolean)XftColorAllocValue(self->display, self->vis,
+		self->cmap, rc, &e->color);
+	if (!e->allocated) {
+		/* XRender only needs the value; keep it without a pixel */
+		e->color.pixel = 0;
+		e->color.color = *rc;
+	}
+
+	g_hash_table_insert(self->color_map, &e->key, e);
+	x11_color_cache_push_front(self, idx);
+
+	return &e->color;
+}
+
 /*
  * x11_get_opacity:
  * @self: the renderer
@@ -237,7 +457,6 @@ x11_fill_rect_alpha(
 	XftColor        *base_color,
 	gdouble         alpha
 ){
-	XftColor col;
 	XRenderColor rc;
 
 	rc.red   = (guint16)((gdouble)base_color->color.red   * alpha);
@@ -245,9 +464,7 @@ x11_fill_rect_alpha(
 	rc.blue  = (guint16)((gdouble)base_color->color.blue  * alpha);
 	rc.alpha = (guint16)(alpha * (gdouble)0xFFFF);
 
-	XftColorAllocValue(self->display, self->vis, self->cmap, &rc, &col);
-	XftDrawRect(self->draw, &col, x, y, w, h);
-	XftColorFree(self->display, self->vis, self->cmap, &col);
+	XftDrawRect(self->draw, x11_cached_color(self, &rc), x, y, w, h);
 }
 
 /*
@@ -322,6 +539,49 @@ x11_fill_render_context(
 	ctx->font_cache = self->font_cache;
 	ctx->fg         = NULL;
 	ctx->bg         = NULL;
+	ctx->base.damage = self->damage;
+
+	if (self->images == NULL && self->display != NULL) {
+		self->images = gst_x11_render_context_new_image_cache(self->display);
+	}
+	ctx->base.images = self->images;
+}
+
+/*
+ * x11_damage_span:
+ * @self: the renderer
+ * @row: row index
+ * @x1: start column
+ * @x2: end column (exclusive)
+ *
+ * Adds the pixels of a drawn line span to the frame damage,
+ * including the border padding that is cleared when the span
+ * touches an edge of the terminal.
+ */
+static void
+x11_damage_span(
+	GstX11Renderer  *self,
+	gint            row,
+	gint            x1,
+	gint            x2
+){
+	gint left;
+	gint top;
+	gint right;
+	gint bottom;
+
+	left = (x1 == 0) ? 0 : self->borderpx + x1 * self->cw;
+	right = self->borderpx + x2 * self->cw;
+	if (right >= self->borderpx + self->tw) {
+		right = self->win_w;
+	}
+	top = (row == 0) ? 0 : self->borderpx + row * self->ch;
+	bottom = self->borderpx + (row + 1) * self->ch;
+	if (bottom >= self->borderpx + self->th) {
+		bottom = self->win_h;
+	}
+
+	gst_damage_add(self->damage, left, top, right - left, bottom - top);
 }
 
 /*
@@ -423,118 +683,152 @@ x11_make_glyph_specs(
 }
 
 /*
- * x11_draw_glyph_specs:
+ * x11_resolve_colors:
  * @self: the renderer
- * @specs: array of glyph font specs
- * @base: base glyph with attributes for this run
- * @len: number of specs
- * @x: starting column
- * @y: row
+ * @base: glyph carrying the run's attributes
+ * @colors: (out): resolved colors
  *
- * Renders a run of glyphs with the same attributes.
- * Handles true color, reverse video, bold brightening,
- * faint dimming, blink, invisible, underline, strikethrough.
- * Ports st's xdrawglyphfontspecs().
+ * Resolves the colors a run is drawn with: true color, bold
+ * brightening, faint dimming, reverse video, blink and invisible.
  */
 static void
-x11_draw_glyph_specs(
-	GstX11Renderer          *self,
-	const XftGlyphFontSpec  *specs,
-	GstGlyph                *base,
-	gint                    len,
-	gint                    x,
-	gint                    y
+x11_resolve_colors(
+	GstX11Renderer  *self,
+	const GstGlyph  *base,
+	X11RunColors    *colors
 ){
 	guint16 mode;
 	guint32 fg_idx;
 	guint32 bg_idx;
-	gint charlen;
-	gint winx;
-	gint winy;
-	gint width;
-	XftColor *fg;
-	XftColor *bg;
-	XftColor *temp;
-	XftColor truefg;
-	XftColor truebg;
-	XftColor revfg;
-	XRenderColor colfg;
-	XRenderColor colbg;
-	XRectangle r;
-	GstFontVariant *fv;
-	gboolean truefg_alloc;
-	gboolean truebg_alloc;
+	XRenderColor rc;
+	XftColor temp;
 
 	mode = (guint16)base->attr;
 	fg_idx = base->fg;
 	bg_idx = base->bg;
-	charlen = len * ((mode & GST_GLYPH_ATTR_WIDE) ? 2 : 1);
-	winx = self->borderpx + x * self->cw;
-	winy = self->borderpx + y * self->ch;
-	width = charlen * self->cw;
-	truefg_alloc = FALSE;
-	truebg_alloc = FALSE;
 
 	/* Determine foreground color */
 	if (GST_IS_TRUECOLOR(fg_idx)) {
-		colfg.alpha = 0xffff;
-		colfg.red = (guint16)GST_TRUERED(fg_idx);
-		colfg.green = (guint16)GST_TRUEGREEN(fg_idx);
-		colfg.blue = (guint16)GST_TRUEBLUE(fg_idx);
-		XftColorAllocValue(self->display, self->vis, self->cmap, &colfg, &truefg);
-		fg = &truefg;
-		truefg_alloc = TRUE;
+		rc.alpha = 0xffff;
+		rc.red = (guint16)GST_TRUERED(fg_idx);
+		rc.green = (guint16)GST_TRUEGREEN(fg_idx);
+		rc.blue = (guint16)GST_TRUEBLUE(fg_idx);
+		colors->fg = *x11_cached_color(self, &rc);
 	} else {
-		fg = &self->colors[fg_idx];
+		colors->fg = self->colors[fg_idx];
 	}
 
 	/* Determine background color */
 	if (GST_IS_TRUECOLOR(bg_idx)) {
-		colbg.alpha = 0xffff;
-		colbg.red = (guint16)GST_TRUERED(bg_idx);
-		colbg.green = (guint16)GST_TRUEGREEN(bg_idx);
-		colbg.blue = (guint16)GST_TRUEBLUE(bg_idx);
-		XftColorAllocValue(self->display, self->vis, self->cmap, &colbg, &truebg);
-		bg = &truebg;
-		truebg_alloc = TRUE;
+		rc.alpha = 0xffff;
+		rc.red = (guint16)GST_TRUERED(bg_idx);
+		rc.green = (guint16)GST_TRUEGREEN(bg_idx);
+		rc.blue = (guint16)GST_TRUEBLUE(bg_idx);
+		colors->bg = *x11_cached_color(self, &rc);
 	} else {
-		bg = &self->colors[bg_idx];
+		colors->bg = self->colors[bg_idx];
 	}
 
 	/* Bold brightening: shift colors 0-7 to 8-15 */
 	if ((mode & GST_GLYPH_ATTR_BOLD) && !(mode & GST_GLYPH_ATTR_FAINT)
 	    && fg_idx <= 7) {
-		fg = &self->colors[fg_idx + 8];
+		colors->fg = self->colors[fg_idx + 8];
 	}
 
 	/* Faint dimming: halve foreground RGB */
 	if ((mode & GST_GLYPH_ATTR_FAINT) && !(mode & GST_GLYPH_ATTR_BOLD)) {
-		colfg.red = fg->color.red / 2;
-		colfg.green = fg->color.green / 2;
-		colfg.blue = fg->color.blue / 2;
-		colfg.alpha = fg->color.alpha;
-		XftColorAllocValue(self->display, self->vis, self->cmap, &colfg, &revfg);
-		fg = &revfg;
+		rc.red = colors->fg.color.red / 2;
+		rc.green = colors->fg.color.green / 2;
+		rc.blue = colors->fg.color.blue / 2;
+		rc.alpha = colors->fg.color.alpha;
+		colors->fg = *x11_cached_color(self, &rc);
 	}
 
 	/* Per-glyph reverse: swap fg and bg */
 	if (mode & GST_GLYPH_ATTR_REVERSE) {
-		temp = fg;
-		fg = bg;
-		bg = temp;
+		temp = colors->fg;
+		colors->fg = colors->bg;
+		colors->bg = temp;
 	}
 
 	/* Blink: invisible during off phase */
 	if ((mode & GST_GLYPH_ATTR_BLINK) && (self->win_mode & GST_WIN_MODE_BLINK)) {
-		fg = bg;
+		colors->fg = colors->bg;
 	}
 
 	/* Invisible attribute */
 	if (mode & GST_GLYPH_ATTR_INVISIBLE) {
-		fg = bg;
+		colors->fg = colors->bg;
 	}
+}
+
+/*
+ * x11_run_bg_fill:
+ * @self: the renderer
+ * @base: glyph carrying the run's attributes
+ * @bg: the resolved background color
+ * @out: (out): the color to fill the cells with
+ *
+ * Decides how a run's background is painted. Default-bg cells are
+ * left alone while a wallpaper shows through, and are filled with a
+ * premultiplied color when the ARGB visual is translucent.
+ *
+ * Returns: FALSE if the background must not be painted
+ */
+static gboolean
+x11_run_bg_fill(
+	GstX11Renderer  *self,
+	const GstGlyph  *base,
+	const XftColor  *bg,
+	XRenderColor    *out
+){
+	gboolean is_default;
+	gdouble opacity;
+
+	is_default = (base->bg == (guint32)self->default_bg
+		&& !(base->attr & GST_GLYPH_ATTR_REVERSE));
+
+	/* wallpaper is already painted underneath; leave it visible */
+	if (self->has_wallpaper && is_default) {
+		return FALSE;
+	}
+
+	*out = bg->color;
+	if (self->depth == 32 && is_default) {
+		opacity = x11_get_opacity(self);
+		if (opacity < 1.0) {
+			out->red   = (guint16)((gdouble)bg->color.red   * opacity);
+			out->green = (guint16)((gdouble)bg->color.green * opacity);
+			out->blue  = (guint16)((gdouble)bg->color.blue  * opacity);
+			out->alpha = (guint16)(opacity * (gdouble)0xFFFF);
+		}
+	}
+
+	return TRUE;
+}
+
+/*
+ * x11_clear_borders:
+ * @self: the renderer
+ * @winx: left pixel edge of the drawn span
+ * @width: pixel width of the drawn span
+ * @x: starting column of the span
+ * @y: row
+ *
+ * Clears the border padding adjacent to a span of cells.
+ */
+static void
+x11_clear_borders(
+	GstX11Renderer  *self,
+	gint            winx,
+	gint            width,
+	gint            x,
+	gint            y
+){
+	gint winy;
+
+	winy = self->borderpx + y * self->ch;
 
-	/* Clear border regions around this cell run */
 	if (x == 0) {
 		x11_clear_rect(self, 0, (y == 0) ? 0 : winy,
 			self->borderpx,
@@ -553,59 +847,45 @@ x11_draw_glyph_specs(
 	if (winy + self->ch >= self->borderpx + self->th) {
 		x11_clear_rect(self, winx, winy + self->ch, winx + width, self->win_h);
 	}
+}
 
-	/* Fill background: skip for default-bg cells when wallpaper is active
-	 * so the background image shows through.
-	 * For ARGB transparency: default-bg cells use premultiplied alpha
-	 * so the desktop shows through; non-default cells stay fully opaque. */
-	if (self->has_wallpaper
-	    && bg_idx == (guint32)self->default_bg
-	    && !(mode & GST_GLYPH_ATTR_REVERSE))
-	{
-		/* wallpaper is already painted underneath; leave it visible */
-	}
-	else if (self->depth == 32
-	         && bg_idx == (guint32)self->default_bg
-	         && !(mode & GST_GLYPH_ATTR_REVERSE))
-	{
-		gdouble opacity;
+/*
+ * x11_draw_decorations:
+ * @self: the renderer
+ * @fg: decoration color
+ * @mode: glyph attributes
+ * @winx: left pixel edge
+ * @winy: top pixel edge
+ * @width: pixel width
+ *
+ * Draws underline, strikethrough and undercurl for a run.
+ */
+static void
+x11_draw_decorations(
+	GstX11Renderer  *self,
+	const XftColor  *fg,
+	guint16         mode,
+	gint            winx,
+	gint            winy,
+	gint            width
+){
+	GstFontVariant *fv;
 
-		opacity = x11_get_opacity(self);
-		if (opacity < 1.0) {
-			x11_fill_rect_alpha(self, winx, winy,
-				(guint)width, (guint)self->ch, bg, opacity);
-		} else {
-			XftDrawRect(self->draw, bg, winx, winy,
-				(guint)width, (guint)self->ch);
-		}
-	}
-	else
-	{
-		XftDrawRect(self->draw, bg, winx, winy, (guint)width, (guint)self->ch);
+	if (!(mode & (GST_GLYPH_ATTR_UNDERLINE | GST_GLYPH_ATTR_STRUCK
+	              | GST_GLYPH_ATTR_UNDERCURL))) {
+		return;
 	}
 
-	/* Set clipping for glyph rendering */
-	r.x = 0;
-	r.y = 0;
-	r.height = (gushort)self->ch;
-	r.width = (gushort)width;
-	XftDrawSetClipRectangles(self->draw, winx, winy, &r, 1);
-
-	/* Render glyphs */
-	if (len > 0) {
-		XftDrawGlyphFontSpec(self->draw, fg, specs, len);
-	}
+	fv = gst_font_cache_get_font(self->font_cache, GST_FONT_STYLE_NORMAL);
 
 	/* Underline decoration */
 	if (mode & GST_GLYPH_ATTR_UNDERLINE) {
-		fv = gst_font_cache_get_font(self->font_cache, GST_FONT_STYLE_NORMAL);
 		XftDrawRect(self->draw, fg, winx, winy + fv->ascent + 1,
 			(guint)width, 1);
 	}
 
 	/* Strikethrough decoration */
 	if (mode & GST_GLYPH_ATTR_STRUCK) {
-		fv = gst_font_cache_get_font(self->font_cache, GST_FONT_STYLE_NORMAL);
 		XftDrawRect(self->draw, fg, winx, winy + 2 * fv->ascent / 3,
 			(guint)width, 1);
 	}
@@ -614,7 +894,6 @@ x11_draw_glyph_specs(
 	if (mode & GST_GLYPH_ATTR_UNDERCURL) {
 		gint uc_x;
 
-		fv = gst_font_cache_get_font(self->font_cache, GST_FONT_STYLE_NORMAL);
 		for (uc_x = 0; uc_x < width; uc_x++) {
 			gint dy;
 
@@ -623,17 +902,264 @@ x11_draw_glyph_specs(
 				winx + uc_x, winy + fv->ascent + 1 + dy, 1, 1);
 		}
 	}
+}
+
+/*
+ * x11_draw_glyph_specs:
+ * @self: the renderer
+ * @specs: array of glyph font specs
+ * @base: base glyph with attributes for this run
+ * @len: number of specs
+ * @x: starting column
+ * @y: row
+ *
+ * Renders a single run of glyphs with the same attributes, with its
+ * own background fill and clip. Used for the cursor block; lines go
+ * through x11_flush_line_runs(). Ports st's xdrawglyphfontspecs().
+ */
+static void
+x11_draw_glyph_specs(
+	GstX11Renderer          *self,
+	const XftGlyphFontSpec  *specs,
+	GstGlyph                *base,
+	gint                    len,
+	gint                    x,
+	gint                    y
+){
+	guint16 mode;
+	gint charlen;
+	gint winx;
+	gint winy;
+	gint width;
+	X11RunColors colors;
+	XRenderColor fill;
+	XRectangle r;
+
+	mode = (guint16)base->attr;
+	charlen = len * ((mode & GST_GLYPH_ATTR_WIDE) ? 2 : 1);
+	winx = self->borderpx + x * self->cw;
+	winy = self->borderpx + y * self->ch;
+	width = charlen * self->cw;
+
+	x11_resolve_colors(self, base, &colors);
+
+	/* Clear border regions around this cell run */
+	x11_clear_borders(self, winx, width, x, y);
+
+	/* Fill background */
+	if (x11_run_bg_fill(self, base, &colors.bg, &fill)) {
+		XftColor col;
+
+		col = colors.bg;
+		col.color = fill;
+		XftDrawRect(self->draw, &col, winx, winy,
+			(guint)width, (guint)self->ch);
+	}
+
+	/* Set clipping for glyph rendering */
+	r.x = 0;
+	r.y = 0;
+	r.height = (gushort)self->ch;
+	r.width = (gushort)width;
+	XftDrawSetClipRectangles(self->draw, winx, winy, &r, 1);
+
+	/* Render glyphs */
+	if (len > 0) {
+		XftDrawGlyphFontSpec(self->draw, &colors.fg, specs, len);
+	}
+
+	x11_draw_decorations(self, &colors.fg, mode, winx, winy, width);
 
 	/* Reset clipping */
 	XftDrawSetClip(self->draw, 0);
+}
+
+/*
+ * x11_same_color:
+ *
+ * Returns: TRUE if two render colors are identical
+ */
+static gboolean
+x11_same_color(
+	const XRenderColor  *a,
+	const XRenderColor  *b
+){
+	return a->red == b->red && a->green == b->green
+		&& a->blue == b->blue && a->alpha == b->alpha;
+}
+
+/*
+ * x11_flush_line_runs:
+ * @self: the renderer
+ * @y: row
+ *
+ * Submits the runs queued for a line as a handful of batched
+ * requests instead of a fill, clip change and text request per run.
+ * Backgrounds sharing a color go out as one XRenderFillRectangles,
+ * glyphs sharing a foreground as one XftDrawGlyphFontSpec (a single
+ * CompositeText request against the fonts' server-side glyph sets),
+ * all under one clip covering the line span.
+ */
+static void
+x11_flush_line_runs(
+	GstX11Renderer  *self,
+	gint            y
+){
+	X11LineRun *runs;
+	gint n_runs;
+	gint winx;
+	gint winy;
+	gint span_x1;
+	gint span_x2;
+	gint i;
+	gint j;
+	Picture pict;
+	XRectangle r;
+
+	runs = self->runs;
+	n_runs = self->n_runs;
+	self->n_runs = 0;
+	if (n_runs == 0) {
+		return;
+	}
+
+	winy = self->borderpx + y * self->ch;
+
+	/* Resolve colors and the covered column span */
+	span_x1 = runs[0].x;
+	span_x2 = runs[0].x;
+	for (i = 0; i < n_runs; i++) {
+		gint ncols;
+
+		x11_resolve_colors(self, &runs[i].base, &runs[i].colors);
+		runs[i].has_bg_fill = x11_run_bg_fill(self, &runs[i].base,
+			&runs[i].colors.bg, &runs[i].bg_fill);
+		runs[i].done = FALSE;
+
+		ncols = runs[i].nspecs
+			* ((runs[i].base.attr & GST_GLYPH_ATTR_WIDE) ? 2 : 1);
+		span_x2 = MAX(span_x2, runs[i].x + ncols);
+	}
+
+	winx = self->borderpx + span_x1 * self->cw;
+	x11_clear_borders(self, winx, (span_x2 - span_x1) * self->cw,
+		span_x1, y);
+
+	/* Backgrounds: one fill request per distinct color */
+	pict = XftDrawPicture(self->draw);
+	for (i = 0; i < n_runs; i++) {
+		gint n;
+
+		if (runs[i].done || !runs[i].has_bg_fill) {
+			continue;
+		}
+
+		n = 0;
+		for (j = i; j < n_runs; j++) {
+			gint ncols;
+
+			if (runs[j].done || !runs[j].has_bg_fill
+			    || !x11_same_color(&runs[i].bg_fill, &runs[j].bg_fill)) {
+				continue;
+			}
+			ncols = runs[j].nspecs
+				* ((runs[j].base.attr & GST_GLYPH_ATTR_WIDE) ? 2 : 1);
+			self->rectbuf[n].x = (gshort)(self->borderpx + runs[j].x * self->cw);
+			self->rectbuf[n].y = (gshort)winy;
+			self->rectbuf[n].width = (gushort)(ncols * self->cw);
+			self->rectbuf[n].height = (gushort)self->ch;
+			runs[j].done = TRUE;
+			n++;
+		}
+
+		if (pict != 0) {
+			XRenderFillRectangles(self->display, PictOpSrc, pict,
+				&runs[i].bg_fill, self->rectbuf, n);
+		} else {
+			XftColor col;
+
+			col = runs[i].colors.bg;
+			col.color = runs[i].bg_fill;
+			for (j = 0; j < n; j++) {
+				XftDrawRect(self->draw, &col,
+					self->rectbuf[j].x, self->rectbuf[j].y,
+					self->rectbuf[j].width, self->rectbuf[j].height);
+			}
+		}
+	}
+
+	/* Glyphs: one clip for the span, one text request per foreground */
+	r.x = 0;
+	r.y = 0;
+	r.width = (gushort)((span_x2 - span_x1) * self->cw);
+	r.height = (gushort)self->ch;
+	XftDrawSetClipRectangles(self->draw, winx, winy, &r, 1);
+
+	for (i = 0; i < n_runs; i++) {
+		runs[i].done = FALSE;
+	}
+	for (i = 0; i < n_runs; i++) {
+		gint n;
+
+		if (runs[i].done || runs[i].nspecs == 0) {
+			continue;
+		}
+
+		n = 0;
+		for (j = i; j < n_runs; j++) {
+			if (runs[j].done || runs[j].nspecs == 0
+			    || !x11_same_color(&runs[i].colors.fg.color,
+			                       &runs[j].colors.fg.color)) {
+				continue;
+			}
+			memcpy(&self->gatherbuf[n], &self->specbuf[runs[j].spec_start],
+				sizeof(XftGlyphFontSpec) * (gsize)runs[j].nspecs);
+			n += runs[j].nspecs;
+			runs[j].done = TRUE;
+		}
 
-	/* Free allocated true colors */
-	if (truefg_alloc) {
-		XftColorFree(self->display, self->vis, self->cmap, &truefg);
+		XftDrawGlyphFontSpec(self->draw, &runs[i].colors.fg,
+			self->gatherbuf, n);
 	}
-	if (truebg_alloc) {
-		XftColorFree(self->display, self->vis, self->cmap, &truebg);
+
+	/* Decorations are rare; draw them per run */
+	for (i = 0; i < n_runs; i++) {
+		gint ncols;
+
+		ncols = runs[i].nspecs
+			* ((runs[i].base.attr & GST_GLYPH_ATTR_WIDE) ? 2 : 1);
+		x11_draw_decorations(self, &runs[i].colors.fg,
+			(guint16)runs[i].base.attr,
+			self->borderpx + runs[i].x * self->cw, winy,
+			ncols * self->cw);
 	}
+
+	XftDrawSetClip(self->draw, 0);
+}
+
+/*
+ * x11_alloc_line_buffers:
+ * @self: the renderer
+ * @cols: number of terminal columns
+ *
+ * (Re)allocates the per-line spec, run, gather and rectangle buffers.
+ */
+static void
+x11_alloc_line_buffers(
+	GstX11Renderer  *self,
+	gint            cols
+){
+	g_free(self->specbuf);
+	g_free(self->gatherbuf);
+	g_free(self->runs);
+	g_free(self->rectbuf);
+
+	self->specbuf_len = cols;
+	self->specbuf = g_new(XftGlyphFontSpec, (gsize)cols);
+	self->gatherbuf = g_new(XftGlyphFontSpec, (gsize)cols);
+	self->runs = g_new(X11LineRun, (gsize)cols);
+	self->n_runs = 0;
+	self->rectbuf = g_new(XRectangle, (gsize)cols);
 }
 
 /* ===== Virtual method implementations ===== */
@@ -645,8 +1171,9 @@ x11_draw_glyph_specs(
  * @x1: start column
  * @x2: end column (exclusive)
  *
- * Draws a single line, grouping glyphs by attributes for
- * efficient batch rendering. Ports st's xdrawline().
+ * Draws a single line, grouping glyphs by attributes into runs
+ * that are submitted together at the end of the line. Ports st's
+ * xdrawline().
  */
 static void
 x11_renderer_draw_line_impl(
@@ -658,13 +1185,11 @@ x11_renderer_draw_line_impl(
 	GstX11Renderer *self;
 	GstTerminal *term;
 	GstLine *line;
-	XftGlyphFontSpec *specs;
+	X11LineRun *run;
 	gint numspecs;
-	gint i;
+	gint si;
 	gint x;
-	gint ox;
 	GstGlyph *new_glyph;
-	GstGlyph base;
 	GstGlyph cur;
 	guint16 new_mode;
 	GstModuleManager *mgr;
@@ -682,6 +1207,8 @@ x11_renderer_draw_line_impl(
 		return;
 	}
 
+	x11_damage_span(self, row, x1, x2);
+
 	/* Check if any glyph transformers are registered (fast path) */
 	mgr = gst_module_manager_get_default();
 	has_glyph_transformers = (mgr != NULL);
@@ -689,16 +1216,17 @@ x11_renderer_draw_line_impl(
 		x11_fill_render_context(self, &gt_ctx);
 	}
 
-	/* Generate all glyph specs for this line segment */
-	specs = self->specbuf;
-	numspecs = x11_make_glyph_specs(self, specs, line, x2 - x1, x1, row);
+	/* Generate all glyph specs for this line segment; there is one
+	 * spec per cell that is not a wide-char dummy */
+	numspecs = x11_make_glyph_specs(self, self->specbuf, line,
+		x2 - x1, x1, row);
 
-	i = 0;
-	ox = 0;
-	memset(&base, 0, sizeof(GstGlyph));
+	si = 0;
+	run = NULL;
+	self->n_runs = 0;
 
 	/* Iterate and group by matching attributes */
-	for (x = x1; x < x2 && i < numspecs; x++) {
+	for (x = x1; x < x2 && si < numspecs; x++) {
 		new_glyph = gst_line_get_glyph(line, x);
 		if (new_glyph == NULL) {
 			continue;
@@ -721,98 +1249,19 @@ x11_renderer_draw_line_impl(
 
 		/* Let glyph transformers handle non-ASCII codepoints */
 		if (has_glyph_transformers && cur.rune > 0x7F) {
+			X11RunColors gt_colors;
 			gint pixel_x;
 			gint pixel_y;
-			XftColor *gt_fg;
-			XftColor *gt_bg;
-			XftColor *gt_temp;
-			XftColor gt_truefg;
-			XftColor gt_truebg;
-			XftColor gt_dimfg;
-			XRenderColor gt_colfg;
-			XRenderColor gt_colbg;
-			gboolean gt_truefg_alloc;
-			gboolean gt_truebg_alloc;
-			guint16 gt_mode;
-			guint32 gt_fg_idx;
-			guint32 gt_bg_idx;
 
 			pixel_x = self->borderpx + x * self->cw;
 			pixel_y = self->borderpx + row * self->ch;
 
 			/* Resolve per-glyph fg/bg colors for the render context */
-			gt_mode = (guint16)cur.attr;
-			gt_fg_idx = cur.fg;
-			gt_bg_idx = cur.bg;
-			gt_truefg_alloc = FALSE;
-			gt_truebg_alloc = FALSE;
-
-			if (GST_IS_TRUECOLOR(gt_fg_idx)) {
-				gt_colfg.alpha = 0xffff;
-				gt_colfg.red = (guint16)GST_TRUERED(gt_fg_idx);
-				gt_colfg.green = (guint16)GST_TRUEGREEN(gt_fg_idx);
-				gt_colfg.blue = (guint16)GST_TRUEBLUE(gt_fg_idx);
-				XftColorAllocValue(self->display, self->vis,
-					self->cmap, &gt_colfg, &gt_truefg);
-				gt_fg = &gt_truefg;
-				gt_truefg_alloc = TRUE;
-			} else {
-				gt_fg = &self->colors[gt_fg_idx];
-			}
-
-			if (GST_IS_TRUECOLOR(gt_bg_idx)) {
-				gt_colbg.alpha = 0xffff;
-				gt_colbg.red = (guint16)GST_TRUERED(gt_bg_idx);
-				gt_colbg.green = (guint16)GST_TRUEGREEN(gt_bg_idx);
-				gt_colbg.blue = (guint16)GST_TRUEBLUE(gt_bg_idx);
-				XftColorAllocValue(self->display, self->vis,
-					self->cmap, &gt_colbg, &gt_truebg);
-				gt_bg = &gt_truebg;
-				gt_truebg_alloc = TRUE;
-			} else {
-				gt_bg = &self->colors[gt_bg_idx];
-			}
+			x11_resolve_colors(self, &cur, &gt_colors);
 
-			/* Bold brightening */
-			if ((gt_mode & GST_GLYPH_ATTR_BOLD)
-			    && !(gt_mode & GST_GLYPH_ATTR_FAINT)
-			    && !GST_IS_TRUECOLOR(gt_fg_idx) && gt_fg_idx <= 7) {
-				gt_fg = &self->colors[gt_fg_idx + 8];
-			}
-
-			/* Faint dimming */
-			if ((gt_mode & GST_GLYPH_ATTR_FAINT)
-			    && !(gt_mode & GST_GLYPH_ATTR_BOLD)) {
-				gt_colfg.red = gt_fg->color.red / 2;
-				gt_colfg.green = gt_fg->color.green / 2;
-				gt_colfg.blue = gt_fg->color.blue / 2;
-				gt_colfg.alpha = gt_fg->color.alpha;
-				XftColorAllocValue(self->display, self->vis,
-					self->cmap, &gt_colfg, &gt_dimfg);
-				gt_fg = &gt_dimfg;
-			}
-
-			/* Reverse video */
-			if (gt_mode & GST_GLYPH_ATTR_REVERSE) {
-				gt_temp = gt_fg;
-				gt_fg = gt_bg;
-				gt_bg = gt_temp;
-			}
-
-			/* Blink: invisible during off phase */
-			if ((gt_mode & GST_GLYPH_ATTR_BLINK)
-			    && (self->win_mode & GST_WIN_MODE_BLINK)) {
-				gt_fg = gt_bg;
-			}
-
-			/* Invisible attribute */
-			if (gt_mode & GST_GLYPH_ATTR_INVISIBLE) {
-				gt_fg = gt_bg;
-			}
-
-			gt_ctx.fg = gt_fg;
-			gt_ctx.bg = gt_bg;
-			gt_ctx.base.glyph_attr = gt_mode;
+			gt_ctx.fg = &gt_colors.fg;
+			gt_ctx.bg = &gt_colors.bg;
+			gt_ctx.base.glyph_attr = (guint16)cur.attr;
 			gt_ctx.base.current_line = line;
 			gt_ctx.base.current_col = x;
 			gt_ctx.base.current_cols = x2;
@@ -821,57 +1270,69 @@ x11_renderer_draw_line_impl(
 				mgr, cur.rune, &gt_ctx.base,
 				pixel_x, pixel_y, self->cw, self->ch))
 			{
-				/* Free truecolor resources */
-				if (gt_truefg_alloc) {
-					XftColorFree(self->display, self->vis,
-						self->cmap, &gt_truefg);
-				}
-				if (gt_truebg_alloc) {
-					XftColorFree(self->display, self->vis,
-						self->cmap, &gt_truebg);
-				}
-
-				/* Flush accumulated run before skipping */
-				if (i > 0) {
-					x11_draw_glyph_specs(self, specs, &base, i, ox, row);
-					specs += i;
-					numspecs -= i;
-					i = 0;
-				}
+				/* The transformer drew this cell; skip its spec
+				 * and start a new run after it */
+				si++;
+				run = NULL;
 				continue;
 			}
-
-			/* Free truecolor resources if transformer didn't handle it */
-			if (gt_truefg_alloc) {
-				XftColorFree(self->display, self->vis,
-					self->cmap, &gt_truefg);
-			}
-			if (gt_truebg_alloc) {
-				XftColorFree(self->display, self->vis,
-					self->cmap, &gt_truebg);
-			}
 		}
 
-		/* If attributes changed, flush the accumulated run */
-		if (i > 0 && ATTRCMP(base, cur)) {
-			x11_draw_glyph_specs(self, specs, &base, i, ox, row);
-			specs += i;
-			numspecs -= i;
-			i = 0;
+		/* Start a new run when attributes change */
+		if (run == NULL || ATTRCMP(run->base, cur)) {
+			run = &self->runs[self->n_runs++];
+			run->base = cur;
+			run->x = x;
+			run->spec_start = si;
+			run->nspecs = 0;
 		}
+		run->nspecs++;
+		si++;
+	}
 
-		/* Start new run */
-		if (i == 0) {
-			ox = x;
-			base = cur;
-		}
-		i++;
+	x11_flush_line_runs(self, row);
+}
+
+/*
+ * x11_cursor_span:
+ * @term: the terminal
+ * @cx: cursor column
+ * @cy: cursor row
+ * @x1: (out): first column to redraw
+ * @x2: (out): one past the last column to redraw
+ *
+ * Gets the cells to redraw to erase a cursor drawn at (@cx, @cy):
+ * its cell and one neighbour on each side, taking in both halves
+ * of any wide character at the edges.
+ *
+ * Returns: %FALSE if the position is no longer on the screen
+ */
+static gboolean
+x11_cursor_span(
+	GstTerminal *term,
+	gint         cx,
+	gint         cy,
+	gint        *x1,
+	gint        *x2
+){
+	GstLine *line;
+
+	line = gst_terminal_get_line(term, cy);
+	if (line == NULL || cx < 0 || cx >= line->len) {
+		return FALSE;
 	}
 
-	/* Flush final run */
-	if (i > 0) {
-		x11_draw_glyph_specs(self, specs, &base, i, ox, row);
+	*x1 = MAX(cx - 1, 0);
+	*x2 = MIN(cx + 2, line->len);
+	if (*x1 > 0 && (line->glyphs[*x1].attr & GST_GLYPH_ATTR_WDUMMY)) {
+		(*x1)--;
+	}
+	if (*x2 < line->len
+	    && (line->glyphs[*x2 - 1].attr & GST_GLYPH_ATTR_WIDE))
+	{
+		(*x2)++;
 	}
+	return TRUE;
 }
 
 /*
@@ -909,18 +1370,15 @@ x11_renderer_draw_cursor_impl(
 		return;
 	}
 
-	/* Erase old cursor by redrawing the entire line (matches st behavior).
-	 * Single-cell erase is insufficient: Xft anti-aliased glyph edges
-	 * from the cursor's inverted-color block bleed into adjacent cells.
-	 * Also redraw the new cursor line when it differs from the old one,
-	 * so the cursor is always drawn on freshly rendered content. */
+	/* Erase the old cursor by redrawing its cell and one cell on
+	 * each side: Xft anti-aliased glyph edges from the cursor's
+	 * inverted-color block bleed into adjacent cells. */
 	{
-		gint erase_cols;
+		gint x1;
+		gint x2;
 
-		gst_terminal_get_size(term, &erase_cols, NULL);
-		x11_renderer_draw_line_impl(renderer, oy, 0, erase_cols);
-		if (cy != oy) {
-			x11_renderer_draw_line_impl(renderer, cy, 0, erase_cols);
+		if (x11_cursor_span(term, ox, oy, &x1, &x2)) {
+			x11_renderer_draw_line_impl(renderer, oy, x1, x2);
 		}
 	}
 
@@ -934,6 +1392,10 @@ x11_renderer_draw_cursor_impl(
 		return;
 	}
 
+	/* Only the cursor cell itself changes on screen */
+	x11_damage_span(self, cy, cx,
+		cx + ((g->attr & GST_GLYPH_ATTR_WIDE) ? 2 : 1));
+
 	cursor = gst_terminal_get_cursor(term);
 	drawcol = self->colors[self->default_cs];
 	gmode = (guint16)g->attr;
@@ -994,12 +1456,98 @@ x11_renderer_draw_cursor_impl(
 	}
 }
 
+/*
+ * x11_replay_scroll_log:
+ * @self: the X11 renderer
+ * @term: the terminal
+ * @rows: number of terminal rows
+ * @oy: row the cursor was drawn on in the previous frame
+ *
+ * Replays the terminal's scroll log on the back pixmap so rows that
+ * only moved are blitted with XCopyArea instead of redrawn. When a
+ * wallpaper or a selection is showing, the pixels cannot simply be
+ * moved, so the scrolled rows are marked dirty instead. The same goes
+ * for a region a module overlay drew over last frame: the overlay's
+ * pixels would move with the text and stay behind as a ghost.
+ *
+ * Returns: the previous cursor row after the scrolls, or -1 if it
+ *   left its region (its old cursor block must still be erased)
+ */
+static gint
+x11_replay_scroll_log(
+	GstX11Renderer  *self,
+	GstTerminal     *term,
+	gint            rows,
+	gint            oy
+){
+	const GstScrollOp *ops;
+	guint n_ops;
+	guint i;
+	gboolean blit;
+
+	ops = gst_terminal_get_scroll_log(term, &n_ops);
+	blit = !self->has_wallpaper
+		&& (self->selection == NULL
+		    || gst_selection_is_empty(self->selection));
+
+	for (i = 0; i < n_ops; i++) {
+		gint top;
+		gint bot;
+		gint shift;
+		gint y;
+
+		top = ops[i].top;
+		bot = MIN(ops[i].bot, rows - 1);
+		shift = ABS(ops[i].n);
+		if (top > bot) {
+			continue;
+		}
+
+		if (!blit || gst_damage_intersects(self->overlay_damage,
+		    self->borderpx, self->borderpx + top * self->ch,
+		    self->tw, (bot - top + 1) * self->ch)) {
+			for (y = top; y <= bot; y++) {
+				gst_terminal_mark_dirty(term, y);
+			}
+			continue;
+		}
+
+		if (shift <= bot - top) {
+			gint src;
+			gint dst;
+
+			src = (ops[i].n > 0) ? top + shift : top;
+			dst = (ops[i].n > 0) ? top : top + shift;
+			XCopyArea(self->display, self->buf, self->buf, self->gc,
+				self->borderpx,
+				self->borderpx + src * self->ch,
+				(guint)(self->tw),
+				(guint)((bot - top + 1 - shift) * self->ch),
+				self->borderpx,
+				self->borderpx + dst * self->ch);
+			gst_damage_add(self->damage,
+				self->borderpx, self->borderpx + top * self->ch,
+				self->tw, (bot - top + 1) * self->ch);
+		}
+
+		if (oy >= top && oy <= bot) {
+			oy -= ops[i].n;
+			if (oy < top || oy > bot) {
+				oy = -1;
+			}
+		}
+	}
+
+	return oy;
+}
+
 /*
  * x11_renderer_render_impl:
  * @renderer: the GstRenderer
  *
- * Full render pass: iterate dirty lines, draw cursor,
- * copy pixmap to window. Uses dirty-line optimization.
+ * Full render pass: replay scrolls, iterate dirty lines, draw
+ * cursor, copy pixmap to window. Only the dirty column span of
+ * each line is redrawn.
  */
 static void
 x11_renderer_render_impl(GstRenderer *renderer)
@@ -1034,6 +1582,7 @@ x11_renderer_render_impl(GstRenderer *renderer)
 		if (cur_opacity != self->last_opacity) {
 			self->last_opacity = cur_opacity;
 			x11_clear_rect(self, 0, 0, self->win_w, self->win_h);
+			gst_damage_add_all(self->damage);
 			for (y = 0; y < rows; y++) {
 				gst_terminal_mark_dirty(term, y);
 			}
@@ -1053,20 +1602,47 @@ x11_renderer_render_impl(GstRenderer *renderer)
 			mgr, &bg_ctx.base, self->win_w, self->win_h);
 		self->has_wallpaper = bg_ctx.base.has_wallpaper;
 		self->wallpaper_bg_alpha = bg_ctx.base.wallpaper_bg_alpha;
+
+		/* The wallpaper repaints the whole pixmap */
+		if (self->has_wallpaper) {
+			gst_damage_add_all(self->damage);
+		}
+	}
+
+	/* Move scrolled rows; the old cursor block travels with them,
+	 * so repaint the cells it landed on */
+	{
+		gint moved_oy;
+		gint x1;
+		gint x2;
+
+		moved_oy = x11_replay_scroll_log(self, term, rows, self->ocy);
+		if (moved_oy >= 0 && moved_oy != self->ocy
+		    && x11_cursor_span(term, self->ocx, moved_oy, &x1, &x2))
+		{
+			gst_line_mark_dirty_range(
+				gst_terminal_get_line(term, moved_oy), x1, x2);
+		}
 	}
 
 	/* Draw lines: force full redraw when wallpaper is active
 	 * because the background image overwrites the entire pixmap */
 	for (y = 0; y < rows; y++) {
 		GstLine *line;
+		gint x1;
+		gint x2;
 
 		line = gst_terminal_get_line(term, y);
 		if (line == NULL) {
 			continue;
 		}
 
-		if (self->has_wallpaper || gst_line_is_dirty(line)) {
+		if (self->has_wallpaper) {
 			x11_renderer_draw_line_impl(renderer, y, 0, cols);
+		} else if (gst_line_get_dirty_span(line, &x1, &x2)) {
+			/* Redraw only the damaged columns, widened to whole words */
+			gst_line_expand_span(line, &x1, &x2);
+			x11_renderer_draw_line_impl(renderer, y, x1, x2);
 		}
 	}
 
@@ -1075,15 +1651,29 @@ x11_renderer_render_impl(GstRenderer *renderer)
 	self->ocx = cx;
 	self->ocy = cy;
 
-	/* Dispatch render overlays to modules */
+	/*
+	 * Dispatch render overlays to modules, recording what they cover
+	 * so the next frame's scrolls do not blit their pixels along
+	 */
 	{
 		GstModuleManager *mgr;
 		GstX11RenderContext ctx;
+		const GstDamageRect *rects;
+		guint n_rects;
+		guint i;
 
 		mgr = gst_module_manager_get_default();
 		x11_fill_render_context(self, &ctx);
+		gst_damage_clear(self->overlay_damage);
+		ctx.base.damage = self->overlay_damage;
 		gst_module_manager_dispatch_render_overlay(
 			mgr, &ctx.base, self->win_w, self->win_h);
+
+		rects = gst_damage_get_rects(self->overlay_damage, &n_rects);
+		for (i = 0; i < n_rects; i++) {
+			gst_damage_add(self->damage, rects[i].x, rects[i].y,
+				rects[i].width, rects[i].height);
+		}
 	}
 
 	/* Clear terminal dirty flags (finish_draw presents the buffer) */
@@ -1147,13 +1737,14 @@ x11_renderer_resize_impl(
 		self->colors[self->default_bg].pixel);
 	XFillRectangle(self->display, self->buf, self->gc,
 		0, 0, (guint)self->win_w, (guint)self->win_h);
+	gst_damage_set_bounds(self->damage, self->win_w, self->win_h);
+	gst_damage_set_bounds(self->overlay_damage, self->win_w, self->win_h);
+	gst_damage_clear(self->overlay_damage);
 
-	/* Reallocate glyph spec buffer */
+	/* Reallocate per-line glyph spec and run buffers */
 	if (term != NULL) {
 		gst_terminal_get_size(term, &cols, &rows);
-		g_free(self->specbuf);
-		self->specbuf_len = cols;
-		self->specbuf = g_new(XftGlyphFontSpec, (gsize)cols);
+		x11_alloc_line_buffers(self, cols);
 	}
 }
 
@@ -1173,6 +1764,7 @@ x11_renderer_clear_impl(GstRenderer *renderer)
 	if (self->draw != NULL) {
 		XftDrawRect(self->draw, &self->colors[self->default_bg],
 			0, 0, (guint)self->win_w, (guint)self->win_h);
+		gst_damage_add_all(self->damage);
 	}
 }
 
@@ -1202,17 +1794,29 @@ x11_renderer_start_draw_impl(GstRenderer *renderer)
  * x11_renderer_finish_draw_impl:
  * @renderer: the GstRenderer
  *
- * Copies the pixmap to the window and flushes.
+ * Copies the damaged areas of the pixmap to the window and flushes.
+ * Exposes mark every line dirty, so a window that lost its contents
+ * is always fully damaged.
  */
 static void
 x11_renderer_finish_draw_impl(GstRenderer *renderer)
 {
 	GstX11Renderer *self;
+	const GstDamageRect *rects;
+	guint n_rects;
+	guint i;
 
 	self = GST_X11_RENDERER(renderer);
 
-	XCopyArea(self->display, self->buf, self->xwindow, self->gc,
-		0, 0, (guint)self->win_w, (guint)self->win_h, 0, 0);
+	rects = gst_damage_get_rects(self->damage, &n_rects);
+	for (i = 0; i < n_rects; i++) {
+		XCopyArea(self->display, self->buf, self->xwindow, self->gc,
+			rects[i].x, rects[i].y,
+			(guint)rects[i].width, (guint)rects[i].height,
+			rects[i].x, rects[i].y);
+	}
+	gst_damage_clear(self->damage);
+
 	XFlush(self->display);
 }
 
@@ -1237,8 +1841,16 @@ gst_x11_renderer_dispose(GObject *object)
 		self->num_colors = 0;
 	}
 
-	/* Free glyph spec buffer */
+	/* Free cached colors */
+	x11_color_cache_flush(self);
+	g_clear_pointer(&self->color_map, g_hash_table_destroy);
+	g_clear_pointer(&self->color_cache, g_free);
+
+	/* Free per-line buffers */
 	g_clear_pointer(&self->specbuf, g_free);
+	g_clear_pointer(&self->gatherbuf, g_free);
+	g_clear_pointer(&self->runs, g_free);
+	g_clear_pointer(&self->rectbuf, g_free);
 
 	/* Free XftDraw */
 	if (self->draw != NULL) {
@@ -1246,6 +1858,9 @@ gst_x11_renderer_dispose(GObject *object)
 		self->draw = NULL;
 	}
 
+	/* Cached images hold Pixmaps on the display */
+	g_clear_pointer(&self->images, gst_image_cache_free);
+
 	/* Free pixmap */
 	if (self->buf != 0 && self->display != NULL) {
 		XFreePixmap(self->display, self->buf);
@@ -1259,6 +1874,8 @@ gst_x11_renderer_dispose(GObject *object)
 	}
 
 	g_clear_object(&self->selection);
+	g_clear_pointer(&self->damage, gst_damage_free);
+	g_clear_pointer(&self->overlay_damage, gst_damage_free);
 
 	G_OBJECT_CLASS(gst_x11_renderer_parent_class)->dispose(object);
 }
@@ -1371,8 +1988,17 @@ gst_x11_renderer_init(GstX11Renderer *self)
 	self->draw = NULL;
 	self->specbuf = NULL;
 	self->specbuf_len = 0;
+	self->runs = NULL;
+	self->n_runs = 0;
+	self->gatherbuf = NULL;
+	self->rectbuf = NULL;
 	self->colors = NULL;
 	self->num_colors = 0;
+	self->color_cache = g_new0(X11ColorCacheEntry, X11_COLOR_CACHE_SIZE);
+	self->color_map = g_hash_table_new(g_int64_hash, g_int64_equal);
+	self->color_cache_len = 0;
+	self->color_lru_head = -1;
+	self->color_lru_tail = -1;
 	self->font_cache = NULL;
 	self->cw = 0;
 	self->ch = 0;
@@ -1392,6 +2018,9 @@ gst_x11_renderer_init(GstX11Renderer *self)
 	self->depth = 0;
 	self->x11_window = NULL;
 	self->last_opacity = 1.0;
+	self->damage = gst_damage_new();
+	self->overlay_damage = gst_damage_new();
+	self->images = NULL;
 }
 
 /* ===== Public API ===== */
@@ -1467,10 +2096,12 @@ gst_x11_renderer_new(
 
 	/* Create Xft draw context on pixmap */
 	self->draw = XftDrawCreate(display, self->buf, visual, colormap);
+	gst_damage_set_bounds(self->damage, self->win_w, self->win_h);
+	gst_damage_set_bounds(self->overlay_damage, self->win_w, self->win_h);
+	gst_damage_clear(self->overlay_damage);
 
-	/* Allocate glyph spec buffer */
-	self->specbuf_len = cols;
-	self->specbuf = g_new(XftGlyphFontSpec, (gsize)cols);
+	/* Allocate per-line glyph spec and run buffers */
+	x11_alloc_line_buffers(self, cols);
 
 	return self;
 }
@@ -1502,7 +2133,8 @@ x11_override_color(
  * @config: (nullable): A #GstConfig for palette and color overrides
  *
  * Loads the full color palette (262 colors) from defaults,
- * then applies any overrides from @config.
+ * then applies any overrides from @config. Colors cached outside
+ * the palette are freed as well.
  *
  * Returns: TRUE on success
  */
@@ -1516,6 +2148,9 @@ gst_x11_renderer_load_colors(
 
 	g_return_val_if_fail(GST_IS_X11_RENDERER(self), FALSE);
 
+	/* Drop cached colors along with the palette */
+	x11_color_cache_flush(self);
+
 	/* Free old colors if any */
 	if (self->colors != NULL) {
 		for (i = 0; i < self->num_colors; i++) {
@@ -1611,6 +2246,7 @@ gst_x11_renderer_load_colors(
 			self->colors[self->default_bg].pixel);
 		XFillRectangle(self->display, self->buf, self->gc,
 			0, 0, (guint)self->win_w, (guint)self->win_h);
+		gst_damage_add_all(self->damage);
 	}
 
 	return TRUE;
@@ -0,0 +1,478 @@
+/*
+ * bench-terminal.c - Throughput benchmark for the terminal write path
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Headless harness in the spirit of vtebench: generates reproducible
+ * corpora (fixed PRNG seed), feeds each through gst_terminal_write()
+ * in PTY-sized chunks and reports throughput, time per byte and heap
+ * allocations per MiB of input. Run with `make bench`.
+ */
+
+#include <glib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "core/gst-terminal.h"
+
+#define BENCH_SEED (0x67737421)
+
+/* ===== Allocation counting ===== */
+
+/*
+ * On glibc the harness interposes malloc, calloc and realloc so it
+ * can count every heap allocation made by libgst and GLib while a
+ * corpus is being written. Elsewhere the column reads "n/a".
+ */
+#ifdef __GLIBC__
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static volatile gulong bench_allocs = 0;
+
+void *
+malloc(size_t size)
+{
+    bench_allocs++;
+    return __libc_malloc(size);
+}
+
+void *
+calloc(
+    size_t  nmemb,
+    size_t  size
+){
+    bench_allocs++;
+    return __libc_calloc(nmemb, size);
+}
+
+void *
+realloc(
+    void    *ptr,
+    size_t  size
+){
+    bench_allocs++;
+    return __libc_realloc(ptr, size);
+}
+
+#define BENCH_COUNTS_ALLOCS (TRUE)
+#else
+static gulong bench_allocs = 0;
+
+#define BENCH_COUNTS_ALLOCS (FALSE)
+#endif
+
+/* ===== Options ===== */
+
+static gint opt_size_mb = 8;
+static gint opt_chunk = 4096;
+static gint opt_iterations = 3;
+static gint opt_cols = 120;
+static gint opt_rows = 40;
+static gchar *opt_only = NULL;
+
+static GOptionEntry bench_entries[] = {
+    { "size", 's', 0, G_OPTION_ARG_INT, &opt_size_mb,
+      "MiB of input per corpus (default 8)", "MIB" },
+    { "chunk", 'c', 0, G_OPTION_ARG_INT, &opt_chunk,
+      "Bytes per gst_terminal_write() call (default 4096)", "BYTES" },
+    { "iterations", 'i', 0, G_OPTION_ARG_INT, &opt_iterations,
+      "Timed passes per corpus, fastest is reported (default 3)", "N" },
+    { "cols", 0, 0, G_OPTION_ARG_INT, &opt_cols,
+      "Terminal columns (default 120)", "N" },
+    { "rows", 0, 0, G_OPTION_ARG_INT, &opt_rows,
+      "Terminal rows (default 40)", "N" },
+    { "only", 'o', 0, G_OPTION_ARG_STRING, &opt_only,
+      "Run only the named corpus", "NAME" },
+    { NULL }
+};
+
+/* ===== Corpus generators ===== */
+
+/*
+ * gen_word:
+ *
+ * Appends a random lowercase word of 1-10 letters.
+ */
+static void
+gen_word(
+    GString *out,
+    GRand   *rand
+){
+    gint len;
+    gint i;
+
+    len = g_rand_int_range(rand, 1, 11);
+    for (i = 0; i < len; i++) {
+        g_string_append_c(out, (gchar)g_rand_int_range(rand, 'a', 'z' + 1));
+    }
+}
+
+/*
+ * gen_ascii:
+ *
+ * Dense printable ASCII: lines of words wrapped short of the
+ * right margin, like compiler or log output.
+ */
+static void
+gen_ascii(
+    GString *out,
+    GRand   *rand,
+    gsize   size
+){
+    gsize line_start;
+
+    line_start = out->len;
+    while (out->len < size) {
+        gen_word(out, rand);
+        if (out->len - line_start >= (gsize)(opt_cols - 12)) {
+            g_string_append(out, "\r\n");
+            line_start = out->len;
+        } else {
+            g_string_append_c(out, ' ');
+        }
+    }
+}
+
+/*
+ * gen_cjk:
+ *
+ * UTF-8 CJK ideographs (three bytes, two cells each) with the
+ * occasional ASCII punctuation, one screen line per text line.
+ */
+static void
+gen_cjk(
+    GString *out,
+    GRand   *rand,
+    gsize   size
+){
+    gint i;
+
+    while (out->len < size) {
+        for (i = 0; i < opt_cols / 2 - 2; i++) {
+            g_string_append_unichar(out,
+                (gunichar)g_rand_int_range(rand, 0x4e00, 0x9fa0));
+            if (g_rand_int_range(rand, 0, 16) == 0) {
+                g_string_append_c(out, ',');
+            }
+        }
+        g_string_append(out, "\r\n");
+    }
+}
+
+/*
+ * gen_sgr:
+ *
+ * Truecolor-heavy output: every one to four cells switch both
+ * foreground and background via SGR 38;2 / 48;2, with bold and
+ * underline sprinkled in, as produced by syntax highlighters.
+ */
+static void
+gen_sgr(
+    GString *out,
+    GRand   *rand,
+    gsize   size
+){
+    gint col;
+
+    col = 0;
+    while (out->len < size) {
+        g_string_append_printf(out, "\033[38;2;%d;%d;%dm\033[48;2;%d;%d;%dm",
+            g_rand_int_range(rand, 0, 256), g_rand_int_range(rand, 0, 256),
+            g_rand_int_range(rand, 0, 256), g_rand_int_range(rand, 0, 256),
+            g_rand_int_range(rand, 0, 256), g_rand_int_range(rand, 0, 256));
+        switch (g_rand_int_range(rand, 0, 8)) {
+        case 0:
+            g_string_append(out, "\033[1m");
+            break;
+        case 1:
+            g_string_append(out, "\033[4m");
+            break;
+        default:
+            break;
+        }
+        gen_word(out, rand);
+        col += 10;
+        if (col >= opt_cols - 10) {
+            g_string_append(out, "\033[0m\r\n");
+            col = 0;
+        }
+    }
+}
+
+/*
+ * gen_tui:
+ *
+ * Cursor-addressed updates as a TUI (htop, vim) sends them:
+ * absolute moves, short colored fields, erase-in-line, relative
+ * moves and the occasional full clear.
+ */
+static void
+gen_tui(
+    GString *out,
+    GRand   *rand,
+    gsize   size
+){
+    while (out->len < size) {
+        g_string_append_printf(out, "\033[%d;%dH",
+            g_rand_int_range(rand, 1, opt_rows + 1),
+            g_rand_int_range(rand, 1, opt_cols - 20));
+        switch (g_rand_int_range(rand, 0, 6)) {
+        case 0:
+            g_string_append(out, "\033[K");
+            break;
+        case 1:
+            g_string_append_printf(out, "\033[%dC\033[%dA",
+                g_rand_int_range(rand, 1, 8), g_rand_int_range(rand, 1, 4));
+            break;
+        case 2:
+            g_string_append_printf(out, "\033[3%dm",
+                g_rand_int_range(rand, 0, 8));
+            break;
+        default:
+            break;
+        }
+        gen_word(out, rand);
+        g_string_append(out, "\033[m");
+        if (g_rand_int_range(rand, 0, 2000) == 0) {
+            g_string_append(out, "\033[H\033[2J");
+        }
+    }
+}
+
+/*
+ * gen_scroll:
+ *
+ * Scrolling-region churn: a status area above and below a narrow
+ * region that is scrolled by newlines, reverse index and insert/
+ * delete line, like a pager or a chat client.
+ */
+static void
+gen_scroll(
+    GString *out,
+    GRand   *rand,
+    gsize   size
+){
+    gint top;
+    gint bot;
+
+    top = 3;
+    bot = MAX(top + 2, opt_rows - 3);
+    g_string_append_printf(out, "\033[%d;%dr", top, bot);
+    while (out->len < size) {
+        switch (g_rand_int_range(rand, 0, 8)) {
+        case 0:
+            g_string_append_printf(out, "\033[%d;1H\033M", top);
+            break;
+        case 1:
+            g_string_append_printf(out, "\033[%d;1H\033[%dL",
+                g_rand_int_range(rand, top, bot + 1),
+                g_rand_int_range(rand, 1, 4));
+            break;
+        case 2:
+            g_string_append_printf(out, "\033[%d;1H\033[%dM",
+                g_rand_int_range(rand, top, bot + 1),
+                g_rand_int_range(rand, 1, 4));
+            break;
+        default:
+            g_string_append_printf(out, "\033[%d;1H", bot);
+            gen_word(out, rand);
+            g_string_append_c(out, ' ');
+            gen_word(out, rand);
+            g_string_append(out, "\n");
+            break;
+        }
+    }
+    g_string_append(out, "\033[r");
+}
+
+/*
+ * gen_altscreen:
+ *
+ * Full-screen redraws on the alternate screen: enter, repaint
+ * every row, leave, as a fullscreen program started and quit in
+ * a loop would.
+ */
+static void
+gen_altscreen(
+    GString *out,
+    GRand   *rand,
+    gsize   size
+){
+    gint frame;
+    gint y;
+
+    frame = 0;
+    while (out->len < size) {
+        if (frame % 8 == 0) {
+            g_string_append(out, "\033[?1049h\033[H\033[2J");
+        }
+        for (y = 1; y <= opt_rows; y++) {
+            gsize line_start;
+
+            g_string_append_printf(out, "\033[%d;1H", y);
+            line_start = out->len;
+            while (out->len - line_start < (gsize)(opt_cols - 12)) {
+                gen_word(out, rand);
+                g_string_append_c(out, ' ');
+            }
+            g_string_append(out, "\033[K");
+        }
+        frame++;
+        if (frame % 8 == 0) {
+            g_string_append(out, "\033[?1049l");
+        }
+    }
+}
+
+typedef void (*BenchGenFunc)(GString *out, GRand *rand, gsize size);
+
+typedef struct {
+    const gchar  *name;
+    BenchGenFunc  gen;
+} BenchCorpus;
+
+static const BenchCorpus bench_corpora[] = {
+    { "ascii",     gen_ascii },
+    { "cjk",       gen_cjk },
+    { "sgr",       gen_sgr },
+    { "tui",       gen_tui },
+    { "scroll",    gen_scroll },
+    { "altscreen", gen_altscreen },
+};
+
+/* ===== Harness ===== */
+
+/*
+ * bench_feed:
+ *
+ * Writes @len bytes to @term in chunks of opt_chunk bytes.
+ */
+static void
+bench_feed(
+    GstTerminal *term,
+    const gchar *data,
+    gsize       len
+){
+    gsize off;
+    gsize n;
+
+    for (off = 0; off < len; off += n) {
+        n = MIN((gsize)opt_chunk, len - off);
+        gst_terminal_write(term, data + off, (gssize)n);
+    }
+}
+
+/*
+ * bench_run:
+ *
+ * Times opt_iterations passes of @corpus through a fresh terminal
+ * each and prints one result row. The fastest pass is reported;
+ * allocations are averaged over all passes.
+ */
+static void
+bench_run(const BenchCorpus *corpus)
+{
+    GString *data;
+    GRand *rand;
+    gint64 best;
+    gulong allocs;
+    gdouble mib;
+    gint i;
+
+    rand = g_rand_new_with_seed(BENCH_SEED);
+    data = g_string_sized_new((gsize)opt_size_mb * 1024 * 1024 + 4096);
+    corpus->gen(data, rand, (gsize)opt_size_mb * 1024 * 1024);
+    g_rand_free(rand);
+
+    best = G_MAXINT64;
+    allocs = 0;
+    for (i = 0; i < opt_iterations; i++) {
+        GstTerminal *term;
+        gulong before;
+        gint64 start;
+        gint64 elapsed;
+
+        term = gst_terminal_new(opt_cols, opt_rows);
+
+        /* Untimed warm-up so first-touch allocations don't count */
+        gst_terminal_write(term, "\033[H\033[2J", -1);
+
+        before = bench_allocs;
+        start = g_get_monotonic_time();
+        bench_feed(term, data->str, data->len);
+        elapsed = g_get_monotonic_time() - start;
+        allocs += bench_allocs - before;
+
+        best = MIN(best, elapsed);
+        g_object_unref(term);
+    }
+
+    mib = (gdouble)data->len / (1024.0 * 1024.0);
+    best = MAX(best, 1);
+    if (BENCH_COUNTS_ALLOCS) {
+        printf("%-10s %10.1f %10.2f %12.1f\n", corpus->name,
+            mib / ((gdouble)best / G_USEC_PER_SEC),
+            (gdouble)best * 1000.0 / (gdouble)data->len,
+            (gdouble)allocs / (gdouble)opt_iterations / mib);
+    } else {
+        printf("%-10s %10.1f %10.2f %12s\n", corpus->name,
+            mib / ((gdouble)best / G_USEC_PER_SEC),
+            (gdouble)best * 1000.0 / (gdouble)data->len, "n/a");
+    }
+    fflush(stdout);
+
+    g_string_free(data, TRUE);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    GOptionContext *ctx;
+    GError *error;
+    gboolean found;
+    gsize i;
+
+    error = NULL;
+    ctx = g_option_context_new("- terminal write-path benchmark");
+    g_option_context_add_main_entries(ctx, bench_entries, NULL);
+    if (!g_option_context_parse(ctx, &argc, &argv, &error)) {
+        fprintf(stderr, "bench-terminal: %s\n", error->message);
+        g_error_free(error);
+        g_option_context_free(ctx);
+        return 2;
+    }
+    g_option_context_free(ctx);
+
+    opt_size_mb = MAX(opt_size_mb, 1);
+    opt_chunk = MAX(opt_chunk, 1);
+    opt_iterations = MAX(opt_iterations, 1);
+    opt_cols = CLAMP(opt_cols, 40, GST_MAX_COLS);
+    opt_rows = CLAMP(opt_rows, 10, GST_MAX_ROWS);
+
+    printf("# %dx%d, %d MiB per corpus, %d-byte writes, best of %d\n",
+        opt_cols, opt_rows, opt_size_mb, opt_chunk, opt_iterations);
+    printf("%-10s %10s %10s %12s\n", "corpus", "MiB/s", "ns/byte",
+        "allocs/MiB");
+
+    found = FALSE;
+    for (i = 0; i < G_N_ELEMENTS(bench_corpora); i++) {
+        if (opt_only != NULL && strcmp(opt_only, bench_corpora[i].name) != 0) {
+            continue;
+        }
+        found = TRUE;
+        bench_run(&bench_corpora[i]);
+    }
+
+    if (!found) {
+        fprintf(stderr, "bench-terminal: no corpus named '%s'\n", opt_only);
+        return 2;
+    }
+
+    g_free(opt_only);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/*
+ * test-block-arena.c - Tests for GstBlockArena
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include <string.h>
+#include "core/gst-block-arena.h"
+
+static void
+test_block_arena_alloc(void)
+{
+    GstBlockArena *arena;
+    guint8 *a;
+    guint8 *b;
+    guint8 *c;
+    guint ba;
+    guint bb;
+    guint bc;
+
+    arena = gst_block_arena_new(256);
+
+    /* Records are packed into one block, 8-byte aligned */
+    a = gst_block_arena_alloc(arena, 100, &ba);
+    b = gst_block_arena_alloc(arena, 3, &bb);
+    g_assert_cmpuint(ba, ==, bb);
+    g_assert_true(b == a + 104);
+    g_assert_cmpuint((guintptr)b % 8, ==, 0);
+    memset(a, 0xAA, 100);
+    memset(b, 0xBB, 3);
+
+    /* A record that does not fit opens the next block */
+    c = gst_block_arena_alloc(arena, 200, &bc);
+    g_assert_cmpuint(bc, !=, ba);
+    g_assert_cmpuint(gst_block_arena_get_n_blocks(arena), ==, 2);
+    memset(c, 0xCC, 200);
+    g_assert_cmpint(a[99], ==, 0xAA);
+    g_assert_cmpint(b[2], ==, 0xBB);
+
+    /* Oversized records get a block of their own */
+    a = gst_block_arena_alloc(arena, 1000, &ba);
+    g_assert_cmpuint(ba, !=, bc);
+    memset(a, 0, 1000);
+    g_assert_cmpuint(gst_block_arena_get_bytes(arena), ==, 256 + 256 + 1000);
+
+    gst_block_arena_free(arena);
+}
+
+static void
+test_block_arena_recycle(void)
+{
+    GstBlockArena *arena;
+    guint ids[64];
+    gsize bytes;
+    guint i;
+    guint round;
+
+    arena = gst_block_arena_new(256);
+
+    /* A ring of 64 records of 64 bytes spans 16 blocks */
+    for (i = 0; i < 64; i++) {
+        gst_block_arena_alloc(arena, 64, &ids[i]);
+    }
+    g_assert_cmpuint(gst_block_arena_get_n_blocks(arena), ==, 16);
+    bytes = gst_block_arena_get_bytes(arena);
+
+    /* Overwriting the ring in order reuses whole blocks */
+    for (round = 0; round < 4; round++) {
+        for (i = 0; i < 64; i++) {
+            gst_block_arena_release(arena, ids[i]);
+            gst_block_arena_alloc(arena, 64, &ids[i]);
+        }
+        g_assert_cmpuint(gst_block_arena_get_n_blocks(arena), <=, 17);
+        g_assert_cmpuint(gst_block_arena_get_bytes(arena), <=, bytes + 256);
+    }
+
+    /* Releasing everything keeps only a small pool */
+    for (i = 0; i < 64; i++) {
+        gst_block_arena_release(arena, ids[i]);
+    }
+    g_assert_cmpuint(gst_block_arena_get_n_blocks(arena), ==, 0);
+    g_assert_cmpuint(gst_block_arena_get_bytes(arena), <=, 3 * 256);
+
+    gst_block_arena_alloc(arena, 64, &ids[0]);
+    gst_block_arena_clear(arena);
+    g_assert_cmpuint(gst_block_arena_get_n_blocks(arena), ==, 0);
+    g_assert_cmpuint(gst_block_arena_get_bytes(arena), <=, 2 * 256);
+
+    gst_block_arena_free(arena);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/block-arena/alloc", test_block_arena_alloc);
+    g_test_add_func("/block-arena/recycle", test_block_arena_recycle);
+
+    return g_test_run();
+}
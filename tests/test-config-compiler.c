@@ -149,6 +149,19 @@ test_config_setters(void)
 
 	gst_config_set_max_latency(config, 50);
 	g_assert_cmpuint(gst_config_get_max_latency(config), ==, 50);
+
+	/* PTY read batching setters */
+	gst_config_set_pty_read_budget(config, 65536);
+	g_assert_cmpuint(gst_config_get_pty_read_budget(config), ==, 65536);
+
+	gst_config_set_pty_read_time(config, 2);
+	g_assert_cmpuint(gst_config_get_pty_read_time(config), ==, 2);
+
+	gst_config_set_glyph_atlas(config, TRUE);
+	g_assert_true(gst_config_get_glyph_atlas(config));
+
+	gst_config_set_render_thread(config, TRUE);
+	g_assert_true(gst_config_get_render_thread(config));
 }
 
 /* ===== Test: add_keybind ===== */
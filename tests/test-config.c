@@ -79,9 +79,17 @@ test_config_defaults(void)
 	g_assert_cmpuint(gst_config_get_min_latency(config), ==, 8);
 	g_assert_cmpuint(gst_config_get_max_latency(config), ==, 33);
 
+	/* PTY read batching defaults */
+	g_assert_cmpuint(gst_config_get_pty_read_budget(config), ==, 1048576);
+	g_assert_cmpuint(gst_config_get_pty_read_time(config), ==, 4);
+	g_assert_false(gst_config_get_glyph_atlas(config));
+	g_assert_false(gst_config_get_render_thread(config));
+
 	/* Module config defaults */
 	g_assert_true(config->modules.scrollback.enabled);
 	g_assert_cmpint(config->modules.scrollback.lines, ==, 10000);
+	g_assert_false(config->modules.scrollback.spill_to_disk);
+	g_assert_false(config->modules.scrollback.search_index);
 	g_assert_false(config->modules.transparency.enabled);
 	g_assert_false(config->modules.sixel.enabled);
 }
@@ -606,6 +614,8 @@ test_config_module_config(void)
 		"  scrollback:\n"
 		"    enabled: true\n"
 		"    lines: 5000\n"
+		"    spill_to_disk: true\n"
+		"    search_index: true\n"
 		"  transparency:\n"
 		"    enabled: false\n"
 		"    opacity: 0.95\n"
@@ -618,6 +628,8 @@ test_config_module_config(void)
 	/* Scrollback: enabled + lines overridden from YAML */
 	g_assert_true(config->modules.scrollback.enabled);
 	g_assert_cmpint(config->modules.scrollback.lines, ==, 5000);
+	g_assert_true(config->modules.scrollback.spill_to_disk);
+	g_assert_true(config->modules.scrollback.search_index);
 
 	/* Transparency: disabled, opacity overridden */
 	g_assert_false(config->modules.transparency.enabled);
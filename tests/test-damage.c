@@ -0,0 +1,162 @@
+/*
+ * test-damage.c - Tests for GstDamage
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include "rendering/gst-damage.h"
+
+static void
+test_damage_bounds_and_clear(void)
+{
+    GstDamage *damage;
+    const GstDamageRect *rects;
+    guint n;
+
+    damage = gst_damage_new();
+    g_assert_true(gst_damage_is_empty(damage));
+
+    /* A new surface is fully damaged */
+    gst_damage_set_bounds(damage, 640, 480);
+    g_assert_true(gst_damage_is_full(damage));
+    rects = gst_damage_get_rects(damage, &n);
+    g_assert_cmpuint(n, ==, 1);
+    g_assert_cmpint(rects[0].width, ==, 640);
+    g_assert_cmpint(rects[0].height, ==, 480);
+
+    /* Adding to a full region changes nothing */
+    gst_damage_add(damage, 10, 10, 5, 5);
+    gst_damage_get_rects(damage, &n);
+    g_assert_cmpuint(n, ==, 1);
+
+    gst_damage_clear(damage);
+    g_assert_true(gst_damage_is_empty(damage));
+    g_assert_false(gst_damage_is_full(damage));
+
+    gst_damage_free(damage);
+}
+
+static void
+test_damage_merge_and_clip(void)
+{
+    GstDamage *damage;
+    const GstDamageRect *rects;
+    guint n;
+
+    damage = gst_damage_new();
+    gst_damage_set_bounds(damage, 640, 480);
+    gst_damage_clear(damage);
+
+    /* Consecutive full-width rows collapse into one rectangle */
+    gst_damage_add(damage, 0, 16, 640, 16);
+    gst_damage_add(damage, 0, 32, 640, 16);
+    gst_damage_add(damage, 0, 48, 640, 16);
+    rects = gst_damage_get_rects(damage, &n);
+    g_assert_cmpuint(n, ==, 1);
+    g_assert_cmpint(rects[0].y, ==, 16);
+    g_assert_cmpint(rects[0].height, ==, 48);
+
+    /* A contained rectangle is absorbed */
+    gst_damage_add(damage, 100, 20, 8, 8);
+    gst_damage_get_rects(damage, &n);
+    g_assert_cmpuint(n, ==, 1);
+
+    /* A distant cell stays separate */
+    gst_damage_add(damage, 80, 400, 8, 16);
+    rects = gst_damage_get_rects(damage, &n);
+    g_assert_cmpuint(n, ==, 2);
+    g_assert_cmpint(rects[1].x, ==, 80);
+
+    /* Rectangles are clipped to the surface; empty ones are dropped */
+    gst_damage_clear(damage);
+    gst_damage_add(damage, -10, 470, 30, 30);
+    gst_damage_add(damage, 700, 0, 10, 10);
+    rects = gst_damage_get_rects(damage, &n);
+    g_assert_cmpuint(n, ==, 1);
+    g_assert_cmpint(rects[0].x, ==, 0);
+    g_assert_cmpint(rects[0].y, ==, 470);
+    g_assert_cmpint(rects[0].width, ==, 20);
+    g_assert_cmpint(rects[0].height, ==, 10);
+
+    gst_damage_free(damage);
+}
+
+static void
+test_damage_overflow(void)
+{
+    GstDamage *damage;
+    const GstDamageRect *rects;
+    guint n;
+    guint i;
+    gint64 covered;
+
+    damage = gst_damage_new();
+    gst_damage_set_bounds(damage, 1000, 1000);
+    gst_damage_clear(damage);
+
+    /* Scattered cells beyond the limit get folded into existing ones */
+    for (i = 0; i < GST_DAMAGE_MAX_RECTS * 2; i++) {
+        gst_damage_add(damage, (gint)(i * 30), (gint)(i * 30), 10, 10);
+    }
+    rects = gst_damage_get_rects(damage, &n);
+    g_assert_cmpuint(n, ==, GST_DAMAGE_MAX_RECTS);
+    g_assert_false(gst_damage_is_full(damage));
+
+    /* Every added cell is still covered */
+    for (i = 0; i < GST_DAMAGE_MAX_RECTS * 2; i++) {
+        guint j;
+        gint cx;
+
+        cx = (gint)(i * 30);
+        covered = 0;
+        for (j = 0; j < n; j++) {
+            if (rects[j].x <= cx && rects[j].y <= cx
+                && rects[j].x + rects[j].width >= cx + 10
+                && rects[j].y + rects[j].height >= cx + 10) {
+                covered++;
+            }
+        }
+        g_assert_cmpint(covered, >, 0);
+    }
+
+    gst_damage_free(damage);
+}
+
+static void
+test_damage_intersects(void)
+{
+    GstDamage *damage;
+
+    damage = gst_damage_new();
+    gst_damage_set_bounds(damage, 100, 100);
+    gst_damage_clear(damage);
+    g_assert_false(gst_damage_intersects(damage, 0, 0, 100, 100));
+
+    gst_damage_add(damage, 10, 20, 30, 10);
+    g_assert_true(gst_damage_intersects(damage, 0, 25, 100, 5));
+    g_assert_true(gst_damage_intersects(damage, 39, 29, 1, 1));
+
+    /* Touching edges do not overlap */
+    g_assert_false(gst_damage_intersects(damage, 0, 30, 100, 10));
+    g_assert_false(gst_damage_intersects(damage, 40, 20, 10, 10));
+    g_assert_false(gst_damage_intersects(damage, 0, 0, 100, 20));
+
+    gst_damage_free(damage);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/damage/bounds-and-clear", test_damage_bounds_and_clear);
+    g_test_add_func("/damage/merge-and-clip", test_damage_merge_and_clip);
+    g_test_add_func("/damage/overflow", test_damage_overflow);
+    g_test_add_func("/damage/intersects", test_damage_intersects);
+
+    return g_test_run();
+}
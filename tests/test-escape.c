@@ -11,6 +11,7 @@
 
 #include <glib.h>
 #include "core/gst-terminal.h"
+#include "core/gst-escape-parser.h"
 #include "core/gst-line.h"
 #include "boxed/gst-glyph.h"
 #include "boxed/gst-cursor.h"
@@ -1705,6 +1706,143 @@ test_combining_char_no_advance(void)
 	g_object_unref(term);
 }
 
+/*
+ * Test that control codes embedded in a CSI sequence execute
+ * immediately without aborting the sequence, and that an 8-bit
+ * C1 CSI introducer is recognized.
+ */
+static void
+test_csi_embedded_control(void)
+{
+	GstTerminal *term;
+	GstCursor *cursor;
+
+	term = gst_terminal_new(80, 24);
+	cursor = gst_terminal_get_cursor(term);
+
+	/* CR inside CUF: cursor returns to col 0, then moves 5 right */
+	term_write(term, "abc\033[\r5C");
+	g_assert_cmpint(cursor->x, ==, 5);
+	g_assert_cmpuint(glyph_at(term, 0, 0), ==, 'a');
+
+	/* C1 CSI (U+009B) followed by CUP */
+	term_write(term, "\xc2\x9b" "3;4H");
+	g_assert_cmpint(cursor->y, ==, 2);
+	g_assert_cmpint(cursor->x, ==, 3);
+
+	g_object_unref(term);
+}
+
+/*
+ * Test that OSC titles keep non-ASCII text intact and that ESC \
+ * (ST) terminates the string.
+ */
+static void
+test_osc_title_utf8_st(void)
+{
+	GstTerminal *term;
+
+	term = gst_terminal_new(80, 24);
+
+	term_write(term, "\033]2;caf\xc3\xa9\033\\x");
+	g_assert_cmpstr(gst_terminal_get_title(term), ==, "caf\xc3\xa9");
+
+	/* The byte after ST is printed normally */
+	g_assert_cmpuint(glyph_at(term, 0, 0), ==, 'x');
+
+	g_object_unref(term);
+}
+
+/*
+ * Collects parser callbacks for test_parser_standalone().
+ */
+typedef struct {
+	GString *printed;
+	gint     csi_count;
+	gchar    csi_final;
+	gchar    csi_prefix;
+	gint     csi_nargs;
+	gint     csi_args[4];
+} ParserLog;
+
+static void
+log_print(
+	gpointer    user_data,
+	GstRune     rune
+){
+	ParserLog *plog = user_data;
+
+	g_string_append_unichar(plog->printed, (gunichar)rune);
+}
+
+static void
+log_csi(
+	gpointer                user_data,
+	const GstEscapeParams   *params,
+	gchar                   final
+){
+	ParserLog *plog = user_data;
+	gint i;
+
+	plog->csi_count++;
+	plog->csi_final = final;
+	plog->csi_prefix = params->prefix;
+	plog->csi_nargs = params->nargs;
+	for (i = 0; i < 4; i++) {
+		plog->csi_args[i] = params->args[i];
+	}
+}
+
+/*
+ * Test the table-driven parser on its own: parameters are
+ * accumulated in place, empty parameters read as 0, and
+ * malformed sequences are swallowed.
+ */
+static void
+test_parser_standalone(void)
+{
+	GstEscapeParserActions actions = { 0 };
+	GstEscapeParser *parser;
+	ParserLog plog = { 0 };
+
+	actions.print = log_print;
+	actions.csi_dispatch = log_csi;
+	plog.printed = g_string_new(NULL);
+
+	parser = gst_escape_parser_new_full(&actions, &plog);
+	g_assert_true(gst_escape_parser_is_ground(parser));
+
+	gst_escape_parser_feed(parser, "a\033[?12;;7hb", -1);
+	g_assert_cmpstr(plog.printed->str, ==, "ab");
+	g_assert_cmpint(plog.csi_count, ==, 1);
+	g_assert_cmpint(plog.csi_final, ==, 'h');
+	g_assert_cmpint(plog.csi_prefix, ==, '?');
+	g_assert_cmpint(plog.csi_nargs, ==, 3);
+	g_assert_cmpint(plog.csi_args[0], ==, 12);
+	g_assert_cmpint(plog.csi_args[1], ==, 0);
+	g_assert_cmpint(plog.csi_args[2], ==, 7);
+
+	/* No parameters still reports one (zero) argument */
+	gst_escape_parser_feed(parser, "\033[m", -1);
+	g_assert_cmpint(plog.csi_count, ==, 2);
+	g_assert_cmpint(plog.csi_nargs, ==, 1);
+	g_assert_cmpint(plog.csi_args[0], ==, 0);
+
+	/* Colon sub-parameters are not supported: swallowed entirely */
+	gst_escape_parser_feed(parser, "\033[4:3mc", -1);
+	g_assert_cmpint(plog.csi_count, ==, 2);
+	g_assert_cmpstr(plog.printed->str, ==, "abc");
+
+	/* Mid-sequence the parser is not in ground state */
+	gst_escape_parser_feed(parser, "\033[1", -1);
+	g_assert_false(gst_escape_parser_is_ground(parser));
+	gst_escape_parser_reset(parser);
+	g_assert_true(gst_escape_parser_is_ground(parser));
+
+	g_object_unref(parser);
+	g_string_free(plog.printed, TRUE);
+}
+
 int
 main(
 	int     argc,
@@ -1817,5 +1955,13 @@ main(
 	g_test_add_func("/escape/charwidth/combining-no-advance",
 	    test_combining_char_no_advance);
 
+	/* Table-driven parser */
+	g_test_add_func("/escape/csi/embedded-control",
+	    test_csi_embedded_control);
+	g_test_add_func("/escape/osc/title-utf8-st",
+	    test_osc_title_utf8_st);
+	g_test_add_func("/escape/parser/standalone",
+	    test_parser_standalone);
+
 	return g_test_run();
 }
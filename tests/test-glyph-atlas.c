@@ -0,0 +1,162 @@
+/*
+ * test-glyph-atlas.c - Tests for GstGlyphAtlas and the blit kernels
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include <string.h>
+#include "rendering/gst-glyph-atlas.h"
+#include "rendering/gst-blit.h"
+
+static void
+test_atlas_insert_lookup(void)
+{
+    GstGlyphAtlas *atlas;
+    GstAtlasGlyph g;
+    const guint8 *pixels;
+    guint8 bitmap[6];
+    gint stride;
+    gint font_a;
+    gint font_b;
+
+    atlas = gst_glyph_atlas_new(64, 64);
+    g_assert_false(gst_glyph_atlas_lookup(atlas, &font_a, 7, &g));
+
+    /* A 3x2 bitmap is copied in and placed with its bearings */
+    memcpy(bitmap, "\x01\x02\x03\x04\x05\x06", 6);
+    gst_glyph_atlas_insert(atlas, &font_a, 7, bitmap, 3, 3, 2, -1, -9, &g);
+    g_assert_false(g.fallback);
+    g_assert_true(gst_glyph_atlas_lookup(atlas, &font_a, 7, &g));
+    g_assert_cmpint(g.width, ==, 3);
+    g_assert_cmpint(g.height, ==, 2);
+    g_assert_cmpint(g.off_x, ==, -1);
+    g_assert_cmpint(g.off_y, ==, -9);
+
+    pixels = gst_glyph_atlas_get_pixels(atlas, &stride);
+    g_assert_cmpint(pixels[g.y * stride + g.x], ==, 1);
+    g_assert_cmpint(pixels[(g.y + 1) * stride + g.x + 2], ==, 6);
+
+    /* The same index in another font is a different glyph */
+    g_assert_false(gst_glyph_atlas_lookup(atlas, &font_b, 7, &g));
+
+    /* Fallbacks and oversized bitmaps are remembered without pixels */
+    gst_glyph_atlas_insert(atlas, &font_b, 7, NULL, 0, 0, 0, 0, 0, NULL);
+    g_assert_true(gst_glyph_atlas_lookup(atlas, &font_b, 7, &g));
+    g_assert_true(g.fallback);
+    gst_glyph_atlas_insert(atlas, &font_b, 8, bitmap, 3, 65, 1, 0, 0, &g);
+    g_assert_true(g.fallback);
+    g_assert_cmpuint(gst_glyph_atlas_get_n_glyphs(atlas), ==, 3);
+
+    gst_glyph_atlas_clear(atlas);
+    g_assert_false(gst_glyph_atlas_lookup(atlas, &font_a, 7, &g));
+    g_assert_cmpuint(gst_glyph_atlas_get_n_glyphs(atlas), ==, 0);
+
+    gst_glyph_atlas_free(atlas);
+}
+
+static void
+test_atlas_packing(void)
+{
+    GstGlyphAtlas *atlas;
+    GstAtlasGlyph g;
+    guint8 bitmap[10 * 12];
+    gint font;
+    gulong i;
+    gint prev_x;
+
+    atlas = gst_glyph_atlas_new(64, 64);
+    memset(bitmap, 0xFF, sizeof(bitmap));
+
+    /* Glyphs fill a shelf left to right without overlapping */
+    prev_x = -1;
+    for (i = 0; i < 5; i++) {
+        gst_glyph_atlas_insert(atlas, &font, i, bitmap, 10, 10, 12, 0, 0, &g);
+        g_assert_cmpint(g.y, ==, 0);
+        g_assert_cmpint(g.x, >, prev_x);
+        prev_x = g.x + g.width - 1;
+    }
+
+    /* The sixth no longer fits and opens a new shelf */
+    gst_glyph_atlas_insert(atlas, &font, 5, bitmap, 10, 10, 12, 0, 0, &g);
+    g_assert_cmpint(g.x, ==, 0);
+    g_assert_cmpint(g.y, >=, 12);
+
+    /* Overfilling starts over instead of failing */
+    for (i = 6; i < 200; i++) {
+        gst_glyph_atlas_insert(atlas, &font, i, bitmap, 10, 10, 12, 0, 0, &g);
+        g_assert_false(g.fallback);
+        g_assert_cmpint(g.y + g.height, <=, 64);
+    }
+    g_assert_cmpuint(gst_glyph_atlas_get_n_glyphs(atlas), <=, 25);
+    g_assert_true(gst_glyph_atlas_lookup(atlas, &font, 199, &g));
+
+    gst_glyph_atlas_free(atlas);
+}
+
+static void
+test_blit_matches_scalar(void)
+{
+    guint32 expect[7 * 37];
+    guint32 got[7 * 37];
+    guint8 mask[7 * 37];
+    guint i;
+
+    /* Odd widths exercise both the vector body and the scalar tail */
+    for (i = 0; i < G_N_ELEMENTS(mask); i++) {
+        mask[i] = (guint8)((i * 37 + (i >> 3)) & 0xFF);
+        if (i % 11 == 0) {
+            mask[i] = 0;
+        }
+        expect[i] = 0x80000000u | (i * 2654435761u >> 8);
+        got[i] = expect[i];
+    }
+
+    gst_blit_a8_over_scalar((guint8 *)expect, 37 * 4, mask, 37, 37, 7,
+        0x336699);
+    gst_blit_a8_over((guint8 *)got, 37 * 4, mask, 37, 37, 7, 0x336699);
+
+    for (i = 0; i < G_N_ELEMENTS(got); i++) {
+        g_assert_cmpuint(got[i], ==, expect[i]);
+    }
+    g_assert_nonnull(gst_blit_get_impl());
+}
+
+static void
+test_blit_coverage(void)
+{
+    guint32 px[3];
+    guint8 mask[3];
+
+    px[0] = 0xFF000000u;
+    px[1] = 0xFF000000u;
+    px[2] = 0xFF000000u;
+    mask[0] = 0;
+    mask[1] = 255;
+    mask[2] = 128;
+
+    gst_blit_a8_over((guint8 *)px, 12, mask, 3, 3, 1, 0xFFFFFF);
+
+    /* No coverage leaves the pixel, full coverage replaces it */
+    g_assert_cmpuint(px[0], ==, 0xFF000000u);
+    g_assert_cmpuint(px[1], ==, 0xFFFFFFFFu);
+
+    /* Half coverage lands half way, rounded */
+    g_assert_cmpuint(px[2], ==, 0xFF808080u);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/glyph-atlas/insert-lookup", test_atlas_insert_lookup);
+    g_test_add_func("/glyph-atlas/packing", test_atlas_packing);
+    g_test_add_func("/glyph-atlas/blit-matches-scalar", test_blit_matches_scalar);
+    g_test_add_func("/glyph-atlas/blit-coverage", test_blit_coverage);
+
+    return g_test_run();
+}
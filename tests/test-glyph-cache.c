@@ -0,0 +1,112 @@
+/*
+ * test-glyph-cache.c - Tests for GstGlyphCache
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include "rendering/gst-glyph-cache.h"
+
+static void
+test_glyph_cache_direct(void)
+{
+    GstGlyphCache *cache;
+    gint font_a;
+    gint font_b;
+    gpointer font;
+    gulong glyph;
+
+    cache = gst_glyph_cache_new();
+    g_assert_false(gst_glyph_cache_lookup(cache, 'A',
+        GST_FONT_STYLE_NORMAL, &font, &glyph));
+
+    gst_glyph_cache_insert(cache, 'A', GST_FONT_STYLE_NORMAL, &font_a, 36);
+    gst_glyph_cache_insert(cache, 'A', GST_FONT_STYLE_BOLD, &font_b, 37);
+    g_assert_cmpuint(gst_glyph_cache_get_size(cache), ==, 2);
+
+    /* Styles are cached independently */
+    g_assert_true(gst_glyph_cache_lookup(cache, 'A',
+        GST_FONT_STYLE_NORMAL, &font, &glyph));
+    g_assert_true(font == &font_a);
+    g_assert_cmpuint(glyph, ==, 36);
+    g_assert_true(gst_glyph_cache_lookup(cache, 'A',
+        GST_FONT_STYLE_BOLD, &font, &glyph));
+    g_assert_true(font == &font_b);
+    g_assert_cmpuint(glyph, ==, 37);
+    g_assert_false(gst_glyph_cache_lookup(cache, 'A',
+        GST_FONT_STYLE_ITALIC, &font, &glyph));
+
+    /* Replacing an entry does not grow the cache */
+    gst_glyph_cache_insert(cache, 'A', GST_FONT_STYLE_NORMAL, &font_b, 5);
+    g_assert_cmpuint(gst_glyph_cache_get_size(cache), ==, 2);
+
+    gst_glyph_cache_free(cache);
+}
+
+static void
+test_glyph_cache_hashed(void)
+{
+    GstGlyphCache *cache;
+    gint font_a;
+    gpointer font;
+    gulong glyph;
+
+    cache = gst_glyph_cache_new();
+
+    gst_glyph_cache_insert(cache, 0x4e2d, GST_FONT_STYLE_NORMAL, &font_a, 900);
+    gst_glyph_cache_insert(cache, 0x1f600, GST_FONT_STYLE_ITALIC, &font_a, 77);
+
+    g_assert_true(gst_glyph_cache_lookup(cache, 0x4e2d,
+        GST_FONT_STYLE_NORMAL, &font, &glyph));
+    g_assert_cmpuint(glyph, ==, 900);
+    g_assert_true(gst_glyph_cache_lookup(cache, 0x1f600,
+        GST_FONT_STYLE_ITALIC, &font, &glyph));
+    g_assert_cmpuint(glyph, ==, 77);
+    g_assert_false(gst_glyph_cache_lookup(cache, 0x1f600,
+        GST_FONT_STYLE_NORMAL, &font, &glyph));
+
+    gst_glyph_cache_free(cache);
+}
+
+static void
+test_glyph_cache_miss_and_clear(void)
+{
+    GstGlyphCache *cache;
+    gint font_a;
+    gpointer font;
+    gulong glyph;
+
+    cache = gst_glyph_cache_new();
+
+    /* A cached miss is still a cache hit, with glyph 0 */
+    gst_glyph_cache_insert(cache, 0xe0b0, GST_FONT_STYLE_NORMAL, &font_a, 0);
+    g_assert_true(gst_glyph_cache_lookup(cache, 0xe0b0,
+        GST_FONT_STYLE_NORMAL, &font, &glyph));
+    g_assert_cmpuint(glyph, ==, 0);
+
+    gst_glyph_cache_insert(cache, 'x', GST_FONT_STYLE_NORMAL, &font_a, 1);
+    gst_glyph_cache_clear(cache);
+    g_assert_cmpuint(gst_glyph_cache_get_size(cache), ==, 0);
+    g_assert_false(gst_glyph_cache_lookup(cache, 0xe0b0,
+        GST_FONT_STYLE_NORMAL, &font, &glyph));
+    g_assert_false(gst_glyph_cache_lookup(cache, 'x',
+        GST_FONT_STYLE_NORMAL, &font, &glyph));
+
+    gst_glyph_cache_free(cache);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/glyph-cache/direct", test_glyph_cache_direct);
+    g_test_add_func("/glyph-cache/hashed", test_glyph_cache_hashed);
+    g_test_add_func("/glyph-cache/miss-and-clear",
+                    test_glyph_cache_miss_and_clear);
+
+    return g_test_run();
+}
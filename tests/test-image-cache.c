@@ -0,0 +1,104 @@
+/*
+ * test-image-cache.c - Tests for GstImageCache
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include "rendering/gst-image-cache.h"
+
+static gint freed;
+
+static void
+count_free(
+    gpointer resource,
+    gpointer user_data
+){
+    freed++;
+}
+
+static void
+test_image_cache_insert_lookup(void)
+{
+    GstImageCache *cache;
+    gint a;
+    gint b;
+    guint ha;
+    guint hb;
+
+    freed = 0;
+    cache = gst_image_cache_new(100, count_free, NULL);
+
+    ha = gst_image_cache_insert(cache, &a, 40);
+    hb = gst_image_cache_insert(cache, &b, 40);
+    g_assert_cmpuint(ha, !=, 0);
+    g_assert_cmpuint(hb, !=, ha);
+    g_assert_true(gst_image_cache_lookup(cache, ha) == &a);
+    g_assert_true(gst_image_cache_lookup(cache, hb) == &b);
+    g_assert_cmpuint(gst_image_cache_get_bytes(cache), ==, 80);
+
+    /* Removed handles miss and are never handed out again */
+    gst_image_cache_remove(cache, ha);
+    g_assert_cmpint(freed, ==, 1);
+    g_assert_true(gst_image_cache_lookup(cache, ha) == NULL);
+    g_assert_true(gst_image_cache_lookup(cache, 0) == NULL);
+    ha = gst_image_cache_insert(cache, &a, 10);
+    g_assert_cmpuint(ha, !=, hb);
+    g_assert_cmpuint(gst_image_cache_get_n_images(cache), ==, 2);
+
+    gst_image_cache_free(cache);
+    g_assert_cmpint(freed, ==, 3);
+}
+
+static void
+test_image_cache_budget(void)
+{
+    GstImageCache *cache;
+    gint a;
+    gint b;
+    gint c;
+    gint big;
+    guint ha;
+    guint hb;
+    guint hc;
+
+    freed = 0;
+    cache = gst_image_cache_new(100, count_free, NULL);
+
+    ha = gst_image_cache_insert(cache, &a, 40);
+    hb = gst_image_cache_insert(cache, &b, 40);
+
+    /* Drawing a makes b the least recently used */
+    gst_image_cache_lookup(cache, ha);
+    hc = gst_image_cache_insert(cache, &c, 40);
+    g_assert_cmpuint(hc, !=, 0);
+    g_assert_true(gst_image_cache_lookup(cache, hb) == NULL);
+    g_assert_true(gst_image_cache_lookup(cache, ha) == &a);
+    g_assert_cmpint(freed, ==, 1);
+    g_assert_cmpuint(gst_image_cache_get_bytes(cache), <=, 100);
+
+    /* Larger than the budget: released, nothing evicted */
+    g_assert_cmpuint(gst_image_cache_insert(cache, &big, 101), ==, 0);
+    g_assert_cmpint(freed, ==, 2);
+    g_assert_cmpuint(gst_image_cache_get_n_images(cache), ==, 2);
+
+    gst_image_cache_clear(cache);
+    g_assert_cmpuint(gst_image_cache_get_n_images(cache), ==, 0);
+    g_assert_cmpuint(gst_image_cache_get_bytes(cache), ==, 0);
+
+    gst_image_cache_free(cache);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/image-cache/insert-lookup", test_image_cache_insert_lookup);
+    g_test_add_func("/image-cache/budget", test_image_cache_budget);
+
+    return g_test_run();
+}
@@ -0,0 +1,123 @@
+/*
+ * test-lz.c - Tests for the LZ block codec
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include <string.h>
+#include "core/gst-lz.h"
+
+static void
+roundtrip(
+    const guint8    *src,
+    gsize           n,
+    gsize           *packed_out
+){
+    guint8 *packed;
+    guint8 *out;
+    gsize cap;
+    gsize packed_len;
+
+    cap = gst_lz_compress_bound(n);
+    packed = g_malloc(cap);
+    out = g_malloc(n + 1);
+
+    packed_len = gst_lz_compress(src, n, packed, cap);
+    g_assert_cmpuint(packed_len, >, 0);
+    g_assert_cmpuint(packed_len, <=, cap);
+
+    g_assert_true(gst_lz_decompress(packed, packed_len, out, n));
+    g_assert_true(n == 0 || memcmp(src, out, n) == 0);
+
+    /* The exact size is required */
+    if (n > 0) {
+        g_assert_false(gst_lz_decompress(packed, packed_len, out, n - 1));
+    }
+    g_assert_false(gst_lz_decompress(packed, packed_len, out, n + 1));
+
+    if (packed_out != NULL) {
+        *packed_out = packed_len;
+    }
+    g_free(packed);
+    g_free(out);
+}
+
+static void
+test_lz_roundtrip(void)
+{
+    GString *text;
+    guint8 noise[5000];
+    gsize packed;
+    guint32 seed;
+    guint i;
+
+    roundtrip((const guint8 *)"", 0, NULL);
+    roundtrip((const guint8 *)"abc", 3, NULL);
+
+    /* Repetitive text shrinks well */
+    text = g_string_new(NULL);
+    for (i = 0; i < 400; i++) {
+        g_string_append_printf(text, "drwxr-xr-x 2 user user 4096 file-%u\n", i);
+    }
+    roundtrip((const guint8 *)text->str, text->len, &packed);
+    g_assert_cmpuint(packed * 3, <, text->len);
+    g_string_free(text, TRUE);
+
+    /* Long runs exercise extended match lengths and overlap */
+    memset(noise, 'x', sizeof(noise));
+    roundtrip(noise, sizeof(noise), &packed);
+    g_assert_cmpuint(packed, <, 64);
+
+    /* Incompressible data stays within the bound */
+    seed = 12345;
+    for (i = 0; i < sizeof(noise); i++) {
+        seed = seed * 1103515245u + 12345u;
+        noise[i] = (guint8)(seed >> 16);
+    }
+    roundtrip(noise, sizeof(noise), NULL);
+}
+
+static void
+test_lz_corrupt(void)
+{
+    const gchar *src;
+    guint8 packed[256];
+    guint8 out[128];
+    gsize n;
+    gsize len;
+    gsize i;
+
+    src = "hello hello hello hello hello hello";
+    n = strlen(src);
+    len = gst_lz_compress((const guint8 *)src, n, packed, sizeof(packed));
+    g_assert_cmpuint(len, >, 0);
+
+    /* Truncation stays in bounds and never yields wrong bytes */
+    for (i = 0; i < len; i++) {
+        if (gst_lz_decompress(packed, i, out, n)) {
+            g_assert_true(memcmp(out, src, n) == 0);
+        }
+    }
+    g_assert_false(gst_lz_decompress(packed, len / 2, out, n));
+
+    /* Too small an output buffer */
+    g_assert_false(gst_lz_decompress(packed, len, out, 4));
+
+    /* A too small destination is refused up front */
+    g_assert_cmpuint(gst_lz_compress((const guint8 *)src, n, packed, 8), ==, 0);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/lz/roundtrip", test_lz_roundtrip);
+    g_test_add_func("/lz/corrupt", test_lz_corrupt);
+
+    return g_test_run();
+}
@@ -10,6 +10,7 @@
  */
 
 #include <glib.h>
+#include <string.h>
 #include <glib-object.h>
 #include "gst-types.h"
 #include "gst-enums.h"
@@ -147,6 +148,77 @@ static const GstRenderContextOps mock_ops = {
 	mock_draw_glyph
 };
 
+/* ===== Mock image ops (backed by a real GstImageCache) ===== */
+
+static gint mock_draw_image_calls = 0;
+static gint mock_register_image_calls = 0;
+static gint mock_draw_handle_calls = 0;
+static gint mock_image_resource = 0;
+
+static void
+mock_draw_image(
+	GstRenderContext *ctx,
+	const guint8     *data,
+	gint              src_w,
+	gint              src_h,
+	gint              src_stride,
+	gint              dst_x,
+	gint              dst_y,
+	gint              dst_w,
+	gint              dst_h
+){
+	mock_draw_image_calls++;
+	mock_last_w = src_w;
+	mock_last_h = src_h;
+}
+
+static guint
+mock_register_image(
+	GstRenderContext *ctx,
+	const guint8     *data,
+	gint              src_w,
+	gint              src_h,
+	gint              src_stride
+){
+	mock_register_image_calls++;
+	return gst_image_cache_insert(ctx->images, &mock_image_resource,
+		(gsize)src_w * (gsize)src_h * 4);
+}
+
+static gboolean
+mock_draw_image_handle(
+	GstRenderContext *ctx,
+	guint             handle,
+	gint              src_x,
+	gint              src_y,
+	gint              src_w,
+	gint              src_h,
+	gint              dst_x,
+	gint              dst_y,
+	gint              dst_w,
+	gint              dst_h
+){
+	if (gst_image_cache_lookup(ctx->images, handle) == NULL) {
+		return FALSE;
+	}
+	mock_draw_handle_calls++;
+	mock_last_x = src_x;
+	mock_last_y = src_y;
+	return TRUE;
+}
+
+static const GstRenderContextOps mock_image_ops = {
+	mock_fill_rect,
+	mock_fill_rect_rgba,
+	mock_fill_rect_fg,
+	mock_fill_rect_bg,
+	mock_draw_glyph,
+	mock_draw_image,
+	NULL,
+	mock_register_image,
+	mock_draw_image_handle
+};
+
 /*
  * create_mock_context:
  *
@@ -394,6 +466,61 @@ test_win_mode_in_context(void)
 	g_assert_true((ctx.win_mode & GST_WIN_MODE_VISIBLE) != 0);
 }
 
+/*
+ * test_cached_image_dispatch:
+ *
+ * Verifies that an image is registered once and then drawn by
+ * handle, re-registered after release or eviction, and drawn
+ * uncached when the context has no image cache.
+ */
+static void
+test_cached_image_dispatch(void)
+{
+	GstRenderContext ctx;
+	guint8 pixels[4 * 4 * 4];
+	guint handle;
+	guint old;
+
+	ctx = create_mock_context();
+	ctx.ops = &mock_image_ops;
+	ctx.damage = NULL;
+	ctx.images = gst_image_cache_new(sizeof(pixels), NULL, NULL);
+	memset(pixels, 0xFF, sizeof(pixels));
+	mock_draw_image_calls = 0;
+	mock_register_image_calls = 0;
+	mock_draw_handle_calls = 0;
+
+	/* First draw uploads, later draws reuse the handle */
+	handle = 0;
+	gst_render_context_draw_cached_image(&ctx, &handle, pixels,
+		4, 4, 16, 1, 2, 2, 2, 10, 10, 4, 4);
+	gst_render_context_draw_cached_image(&ctx, &handle, pixels,
+		4, 4, 16, 1, 2, 2, 2, 10, 10, 4, 4);
+	g_assert_cmpuint(handle, !=, 0);
+	g_assert_cmpint(mock_register_image_calls, ==, 1);
+	g_assert_cmpint(mock_draw_handle_calls, ==, 2);
+	g_assert_cmpint(mock_last_x, ==, 1);
+	g_assert_cmpint(mock_last_y, ==, 2);
+
+	/* A released handle misses and the image is uploaded again */
+	old = handle;
+	gst_render_context_release_image(&ctx, handle);
+	gst_render_context_draw_cached_image(&ctx, &handle, pixels,
+		4, 4, 16, 0, 0, 4, 4, 0, 0, 4, 4);
+	g_assert_cmpuint(handle, !=, old);
+	g_assert_cmpint(mock_register_image_calls, ==, 2);
+	g_assert_cmpint(mock_draw_image_calls, ==, 0);
+
+	/* Without a cache the crop is drawn directly */
+	gst_image_cache_free(ctx.images);
+	ctx.images = NULL;
+	gst_render_context_draw_cached_image(&ctx, &handle, pixels,
+		4, 4, 16, 1, 1, 3, 2, 0, 0, 3, 2);
+	g_assert_cmpint(mock_draw_image_calls, ==, 1);
+	g_assert_cmpint(mock_last_w, ==, 3);
+	g_assert_cmpint(mock_last_h, ==, 2);
+}
+
 /* ===== Main ===== */
 
 int
@@ -419,6 +546,8 @@ main(int argc, char **argv)
 		test_multiple_dispatch_calls);
 	g_test_add_func("/render-context/win-mode-in-context",
 		test_win_mode_in_context);
+	g_test_add_func("/render-context/cached-image-dispatch",
+		test_cached_image_dispatch);
 
 	return g_test_run();
 }
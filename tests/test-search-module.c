@@ -0,0 +1,582 @@
+/*
+ * test-search-module.c - Search module unit tests
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ *
+ * Drives the search module through its key handler against a
+ * headless terminal, with the scrollback module providing history,
+ * and reads long histories back from the scrollback module's frozen
+ * and spilled pages. Links against the search and scrollback module
+ * objects.
+ */
+
+#include <glib.h>
+#include <glib-object.h>
+#include <X11/keysym.h>
+#include <X11/X.h>
+
+#include "../modules/search/gst-search-module.h"
+#include "../modules/scrollback/gst-scrollback-module.h"
+#include "../src/module/gst-module.h"
+#include "../src/module/gst-module-manager.h"
+#include "../src/interfaces/gst-input-handler.h"
+#include "../src/config/gst-config.h"
+#include "../src/core/gst-terminal.h"
+
+typedef struct
+{
+    GstTerminal         *term;
+    GstScrollbackModule *sb;
+    GstSearchModule     *search;
+} Fixture;
+
+/*
+ * fixture_setup_config:
+ *
+ * Creates a terminal and the scrollback and search modules,
+ * registered with the default module manager and activated. The
+ * scrollback module is configured from @cfg.
+ */
+static void
+fixture_setup_config(
+    Fixture   *fx,
+    gint       cols,
+    gint       rows,
+    GstConfig *cfg
+){
+    GstModuleManager *mgr;
+
+    mgr = gst_module_manager_get_default();
+    fx->term = gst_terminal_new(cols, rows);
+    gst_module_manager_set_terminal(mgr, fx->term);
+
+    fx->sb = g_object_new(GST_TYPE_SCROLLBACK_MODULE, NULL);
+    gst_module_configure(GST_MODULE(fx->sb), cfg);
+    gst_module_manager_register(mgr, GST_MODULE(fx->sb));
+    g_assert_true(gst_module_activate(GST_MODULE(fx->sb)));
+
+    fx->search = g_object_new(GST_TYPE_SEARCH_MODULE, NULL);
+    gst_module_manager_register(mgr, GST_MODULE(fx->search));
+    g_assert_true(gst_module_activate(GST_MODULE(fx->search)));
+}
+
+/* Sets up the fixture with default scrollback settings */
+static void
+fixture_setup(
+    Fixture  *fx,
+    gint      cols,
+    gint      rows,
+    gboolean  search_index
+){
+    GstConfig *cfg;
+
+    cfg = gst_config_new();
+    cfg->modules.scrollback.search_index = search_index;
+    fixture_setup_config(fx, cols, rows, cfg);
+    g_object_unref(cfg);
+}
+
+static void
+fixture_teardown(Fixture *fx)
+{
+    GstModuleManager *mgr;
+
+    mgr = gst_module_manager_get_default();
+    gst_module_manager_unregister(mgr, "search");
+    gst_module_manager_unregister(mgr, "scrollback");
+    g_object_unref(fx->search);
+    g_object_unref(fx->sb);
+    gst_module_manager_set_terminal(mgr, NULL);
+    g_object_unref(fx->term);
+}
+
+/* Runs the history scan to completion */
+static void
+settle(void)
+{
+    while (g_main_context_iteration(NULL, FALSE)) {
+    }
+}
+
+static void
+press(
+    Fixture *fx,
+    guint    keyval,
+    guint    state
+){
+    g_assert_true(gst_input_handler_handle_key_event(
+        GST_INPUT_HANDLER(fx->search), keyval, 0, state));
+}
+
+/* Types @text into the query, one key per character */
+static void
+type(
+    Fixture     *fx,
+    const gchar *text
+){
+    const gchar *p;
+
+    for (p = text; *p != '\0'; p = g_utf8_next_char(p)) {
+        gunichar uc;
+
+        uc = g_utf8_get_char(p);
+        press(fx, (uc < 0x100) ? uc : 0x01000000 | uc, 0);
+    }
+}
+
+/* Opens search mode and searches for @query */
+static void
+search(
+    Fixture     *fx,
+    const gchar *query
+){
+    press(fx, XK_f, ControlMask | ShiftMask);
+    type(fx, query);
+    settle();
+}
+
+static void
+close_search(Fixture *fx)
+{
+    press(fx, XK_Escape, 0);
+}
+
+static void
+assert_match(
+    Fixture *fx,
+    guint    index,
+    gint64   line,
+    gint     col_start,
+    gint     col_end
+){
+    gint64 l;
+    gint s;
+    gint e;
+
+    g_assert_true(gst_search_module_get_match(fx->search, index,
+        &l, &s, &e));
+    g_assert_cmpint(l, ==, line);
+    g_assert_cmpint(s, ==, col_start);
+    g_assert_cmpint(e, ==, col_end);
+}
+
+/* Writes lines "row 0" .. "row @n - 1", each followed by its entry
+ * of @extras unless that is NULL */
+static void
+write_rows(
+    Fixture            *fx,
+    gint                n,
+    const gchar *const *extras
+){
+    gchar buf[64];
+    gint i;
+
+    for (i = 0; i < n; i++) {
+        g_snprintf(buf, sizeof(buf), "%srow %d%s", (i > 0) ? "\r\n" : "",
+            i, (extras[i] != NULL) ? extras[i] : "");
+        gst_terminal_write(fx->term, buf, -1);
+    }
+}
+
+static void
+test_search_wide_columns(void)
+{
+    Fixture fx;
+
+    fixture_setup(&fx, 20, 4, TRUE);
+
+    /* Wide chars take two cells but one rune of the line's text */
+    gst_terminal_write(fx.term,
+        "\xe6\xbc\xa2\xe5\xad\x97 abc \xe6\xbc\xa2" "ab\r\n"
+        "\xc3\x84\xc3\x96x", -1);
+
+    search(&fx, "ab");
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 2);
+    assert_match(&fx, 0, 0, 11, 13);
+    assert_match(&fx, 1, 0, 5, 7);
+    close_search(&fx);
+
+    search(&fx, "\xe5\xad\x97");
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 1);
+    assert_match(&fx, 0, 0, 2, 4);
+    close_search(&fx);
+
+    /* Caseless matching folds non-ASCII runes in place */
+    search(&fx, "\xc3\xa4\xc3\xb6");
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 1);
+    assert_match(&fx, 0, 1, 0, 2);
+    close_search(&fx);
+
+    fixture_teardown(&fx);
+}
+
+static void
+test_search_newest_first(void)
+{
+    const gchar *extras[24] = { NULL };
+    Fixture fx;
+    gint64 prev_line;
+    gint prev_col;
+    guint n;
+    guint i;
+
+    fixture_setup(&fx, 40, 4, FALSE);
+
+    /* Rows 20..23 stay on screen, the rest go to the scrollback */
+    extras[2] = " ee ee";
+    extras[9] = " ee ee";
+    extras[21] = " ee ee";
+    write_rows(&fx, 24, extras);
+    g_assert_cmpint(gst_scrollback_module_get_count(fx.sb), ==, 20);
+
+    /* Too short for an index anyway: every line is scanned */
+    search(&fx, "ee");
+    n = gst_search_module_get_n_matches(fx.search);
+    g_assert_cmpuint(n, ==, 6);
+    assert_match(&fx, 0, 21, 10, 12);
+    assert_match(&fx, 1, 21, 7, 9);
+    assert_match(&fx, 2, 9, 9, 11);
+    assert_match(&fx, 5, 2, 6, 8);
+
+    prev_line = G_MAXINT64;
+    prev_col = G_MAXINT;
+    for (i = 0; i < n; i++) {
+        gint64 line;
+        gint col;
+
+        gst_search_module_get_match(fx.search, i, &line, &col, NULL);
+        g_assert_true(line < prev_line
+            || (line == prev_line && col < prev_col));
+        prev_line = line;
+        prev_col = col;
+    }
+    close_search(&fx);
+
+    fixture_teardown(&fx);
+}
+
+static void
+test_search_refine(void)
+{
+    const gchar *extras[20] = { NULL };
+    Fixture fx;
+
+    fixture_setup(&fx, 40, 4, FALSE);
+
+    /* Rows 16..19 stay on screen, the rest go to the scrollback */
+    extras[1] = " needle";
+    extras[6] = " needle net";
+    extras[12] = " net";
+    extras[14] = " needle";
+    extras[17] = " net";
+    extras[18] = " needle";
+    write_rows(&fx, 20, extras);
+    g_assert_cmpint(gst_scrollback_module_get_count(fx.sb), ==, 16);
+
+    /* "ne" matches both words; growing it rescans only its lines */
+    search(&fx, "ne");
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 7);
+    type(&fx, "e");
+    settle();
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 4);
+    assert_match(&fx, 0, 18, 7, 10);
+    assert_match(&fx, 1, 14, 7, 10);
+    assert_match(&fx, 2, 6, 6, 9);
+    assert_match(&fx, 3, 1, 6, 9);
+
+    /* Shrinking it again is a fresh search */
+    press(&fx, XK_BackSpace, 0);
+    settle();
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 7);
+    close_search(&fx);
+
+    /* Refining a scan that had not started yet still runs it */
+    press(&fx, XK_f, ControlMask | ShiftMask);
+    type(&fx, "ne");
+    type(&fx, "t");
+    settle();
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 3);
+    assert_match(&fx, 0, 17, 7, 10);
+    assert_match(&fx, 1, 12, 7, 10);
+    assert_match(&fx, 2, 6, 13, 16);
+    close_search(&fx);
+
+    fixture_teardown(&fx);
+}
+
+static void
+test_search_index_lines(void)
+{
+    const gchar *extras[30] = { NULL };
+    Fixture fx;
+    const GstGlyph *glyphs;
+    gint64 line;
+    gint col;
+    gint cols;
+    gint count;
+    guint i;
+
+    fixture_setup(&fx, 40, 4, TRUE);
+
+    /* Rows 26..29 stay on screen, the rest go to the scrollback */
+    extras[3] = " needle";
+    extras[17] = " needle";
+    extras[27] = " needle";
+    write_rows(&fx, 30, extras);
+    count = gst_scrollback_module_get_count(fx.sb);
+    g_assert_cmpint(count, ==, 26);
+
+    /* The index narrows the history to its candidates, whose
+     * indices map back to the lines they were scrolled out from */
+    search(&fx, "needle");
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 3);
+    assert_match(&fx, 0, 27, 7, 13);
+    assert_match(&fx, 1, 17, 7, 13);
+    assert_match(&fx, 2, 3, 6, 12);
+
+    for (i = 1; i < 3; i++) {
+        gst_search_module_get_match(fx.search, i, &line, &col, NULL);
+        glyphs = gst_scrollback_module_get_line_glyphs(fx.sb,
+            (gint)(count - 1 - line), &cols);
+        g_assert_nonnull(glyphs);
+        g_assert_cmpint(col, <, cols);
+        g_assert_cmpuint(glyphs[col].rune, ==, 'n');
+    }
+    close_search(&fx);
+
+    /* Output since keeps the old lines' numbers */
+    gst_terminal_write(fx.term, "\r\nmore\r\nneedle", -1);
+    search(&fx, "needle");
+    g_assert_cmpuint(gst_search_module_get_n_matches(fx.search), ==, 4);
+    assert_match(&fx, 0, 31, 0, 6);
+    assert_match(&fx, 1, 27, 7, 13);
+    assert_match(&fx, 3, 3, 6, 12);
+    close_search(&fx);
+
+    fixture_teardown(&fx);
+}
+
+/* Columns and rows of the terminal in the cold tier tests */
+#define COLD_COLS   (40)
+#define COLD_ROWS   (4)
+
+/* Rows written: enough to fill the hot ring and freeze pages, and
+ * with 12 distinct styles each, to overflow the style table */
+#define COLD_WRITTEN    (7000)
+
+/* Cells of a styled row that carry a style of their own */
+#define COLD_STYLED     (12)
+
+/* The foreground of cell @k of row @i, distinct for every cell */
+static guint32
+cold_fg(
+    gint i,
+    gint k
+){
+    gint c;
+
+    c = i * COLD_STYLED + k;
+    return GST_TRUECOLOR((c >> 16) & 0xFF, (c >> 8) & 0xFF, c & 0xFF);
+}
+
+/*
+ * write_styled_rows:
+ *
+ * Writes @n rows mixing SGR styles: distinct truecolor cells with
+ * and without bold, an interior blank, underlined and colored
+ * cells, and depending on the row, trailing default blanks (which
+ * are not stored), trailing reverse text or trailing cells with a
+ * background (which are). Every seventh row is left empty.
+ */
+static void
+write_styled_rows(
+    Fixture *fx,
+    gint     n
+){
+    GString *buf;
+    guint32 fg;
+    gint i;
+    gint k;
+
+    buf = g_string_new(NULL);
+    for (i = 0; i < n; i++) {
+        g_string_truncate(buf, 0);
+        if (i > 0) {
+            g_string_append(buf, "\r\n");
+        }
+        if (i % 7 == 3) {
+            gst_terminal_write(fx->term, buf->str, (gssize)buf->len);
+            continue;
+        }
+
+        for (k = 0; k < COLD_STYLED; k++) {
+            fg = cold_fg(i, k);
+            g_string_append_printf(buf, "\033[%d;38;2;%u;%u;%um%c",
+                (k % 2) ? 1 : 22, (fg >> 16) & 0xFF, (fg >> 8) & 0xFF,
+                fg & 0xFF, 'a' + (i + k) % 26);
+        }
+        g_string_append(buf, "\033[0m \033[4;31mX\033[24;44m  ");
+        if (i % 3 == 0) {
+            g_string_append(buf, "\033[0m    ");
+        } else if (i % 3 == 1) {
+            g_string_append(buf, "\033[0;7mzz");
+        }
+        g_string_append(buf, "\033[0m");
+        gst_terminal_write(fx->term, buf->str, (gssize)buf->len);
+    }
+    g_string_free(buf, TRUE);
+}
+
+/* Fills @out with the COLD_COLS cells row @i was written with */
+static void
+expect_styled_row(
+    gint      i,
+    GstGlyph *out
+){
+    static const GstGlyph blank = GST_GLYPH_INIT;
+    gint k;
+
+    for (k = 0; k < COLD_COLS; k++) {
+        out[k] = blank;
+    }
+    if (i % 7 == 3) {
+        return;
+    }
+
+    for (k = 0; k < COLD_STYLED; k++) {
+        out[k].rune = 'a' + (i + k) % 26;
+        out[k].attr = (k % 2) ? GST_GLYPH_ATTR_BOLD : GST_GLYPH_ATTR_NONE;
+        out[k].fg = cold_fg(i, k);
+    }
+
+    out[13].rune = 'X';
+    out[13].attr = GST_GLYPH_ATTR_UNDERLINE;
+    out[13].fg = 1;
+    for (k = 14; k < 16; k++) {
+        out[k].fg = 1;
+        out[k].bg = 4;
+    }
+
+    if (i % 3 == 1) {
+        for (k = 16; k < 18; k++) {
+            out[k].rune = 'z';
+            out[k].attr = GST_GLYPH_ATTR_REVERSE;
+        }
+    }
+}
+
+/* Checks scrollback line @index against the row it was written as */
+static void
+assert_cold_line(
+    Fixture *fx,
+    gint     index
+){
+    GstGlyph want[COLD_COLS];
+    const GstGlyph *glyphs;
+    gint cols;
+    gint x;
+
+    glyphs = gst_scrollback_module_get_line_glyphs(fx->sb, index, &cols);
+    g_assert_nonnull(glyphs);
+    g_assert_cmpint(cols, ==, COLD_COLS);
+
+    /* Line 0 is the last row scrolled out */
+    expect_styled_row(COLD_WRITTEN - COLD_ROWS - 1 - index, want);
+    for (x = 0; x < COLD_COLS; x++) {
+        g_assert_cmpuint(glyphs[x].rune, ==, want[x].rune);
+        g_assert_cmpuint(glyphs[x].attr, ==, want[x].attr);
+        g_assert_cmphex(glyphs[x].fg, ==, want[x].fg);
+        g_assert_cmphex(glyphs[x].bg, ==, want[x].bg);
+    }
+}
+
+/*
+ * check_cold_tier:
+ *
+ * Fills a scrollback of @lines with styled rows, freezing most of
+ * them into pages, and reads every line back, then alternates
+ * between the oldest and a newer page so cached pages are hit out
+ * of order.
+ */
+static void
+check_cold_tier(
+    gint     lines,
+    gboolean spill_to_disk
+){
+    Fixture fx;
+    GstConfig *cfg;
+    gint count;
+    gint cols;
+    gint i;
+
+    cfg = gst_config_new();
+    cfg->modules.scrollback.lines = lines;
+    cfg->modules.scrollback.spill_to_disk = spill_to_disk;
+    fixture_setup_config(&fx, COLD_COLS, COLD_ROWS, cfg);
+    g_object_unref(cfg);
+
+    write_styled_rows(&fx, COLD_WRITTEN);
+    count = gst_scrollback_module_get_count(fx.sb);
+    g_assert_cmpint(count, ==, MIN(lines, COLD_WRITTEN - COLD_ROWS));
+
+    for (i = 0; i < count; i++) {
+        assert_cold_line(&fx, i);
+    }
+    g_assert_null(gst_scrollback_module_get_line_glyphs(fx.sb, count, &cols));
+
+    for (i = 0; i < 8; i++) {
+        assert_cold_line(&fx, count - 1 - i);
+        assert_cold_line(&fx, count - 1 - 600 - i);
+    }
+
+    fixture_teardown(&fx);
+}
+
+static void
+test_search_cold_tier(void)
+{
+    check_cold_tier(10000, FALSE);
+}
+
+static void
+test_search_cold_tier_dropped(void)
+{
+    /* The oldest page ends up partly dropped */
+    check_cold_tier(5000, FALSE);
+}
+
+static void
+test_search_cold_tier_spilled(void)
+{
+    check_cold_tier(10000, TRUE);
+}
+
+static void
+test_search_cold_tier_spilled_dropped(void)
+{
+    check_cold_tier(5000, TRUE);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    /* Isolated directories give the spill file a scratch home */
+    g_test_init(&argc, &argv, G_TEST_OPTION_ISOLATE_DIRS, NULL);
+
+    g_test_add_func("/search/wide-columns", test_search_wide_columns);
+    g_test_add_func("/search/newest-first", test_search_newest_first);
+    g_test_add_func("/search/refine", test_search_refine);
+    g_test_add_func("/search/index-lines", test_search_index_lines);
+    g_test_add_func("/search/cold-tier", test_search_cold_tier);
+    g_test_add_func("/search/cold-tier-dropped",
+        test_search_cold_tier_dropped);
+    g_test_add_func("/search/cold-tier-spilled",
+        test_search_cold_tier_spilled);
+    g_test_add_func("/search/cold-tier-spilled-dropped",
+        test_search_cold_tier_spilled_dropped);
+
+    return g_test_run();
+}
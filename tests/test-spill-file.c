@@ -0,0 +1,92 @@
+/*
+ * test-spill-file.c - Tests for GstSpillFile
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include "core/gst-spill-file.h"
+
+static void
+test_spill_file_roundtrip(void)
+{
+    GstSpillFile *spill;
+    GError *error;
+    gchar *dir;
+    guint8 big[10000];
+    const guint8 *p;
+    guint64 off_a;
+    guint64 off_b;
+    guint64 off_c;
+    guint i;
+
+    error = NULL;
+    dir = g_dir_make_tmp("gst-spill-XXXXXX", &error);
+    g_assert_no_error(error);
+
+    spill = gst_spill_file_new(dir, &error);
+    g_assert_no_error(error);
+    g_assert_nonnull(spill);
+
+    /* The file has no name on disk */
+    g_assert_cmpint(g_rmdir(dir), ==, 0);
+
+    g_assert_true(gst_spill_file_append(spill, "hello", 5, &off_a, NULL));
+    g_assert_true(gst_spill_file_append(spill, "world!", 6, &off_b, NULL));
+    g_assert_cmpuint(off_a, ==, 0);
+    g_assert_cmpuint(off_b, ==, 5);
+    g_assert_cmpuint(gst_spill_file_get_size(spill), ==, 11);
+
+    p = gst_spill_file_read(spill, off_b, 6);
+    g_assert_nonnull(p);
+    g_assert_true(memcmp(p, "world!", 6) == 0);
+
+    /* A read past the current mapping remaps the grown file */
+    for (i = 0; i < sizeof(big); i++) {
+        big[i] = (guint8)(i * 7);
+    }
+    g_assert_true(gst_spill_file_append(spill, big, sizeof(big), &off_c, NULL));
+    p = gst_spill_file_read(spill, off_c, sizeof(big));
+    g_assert_nonnull(p);
+    g_assert_true(memcmp(p, big, sizeof(big)) == 0);
+
+    /* Discarding one record leaves the others intact */
+    gst_spill_file_discard(spill, off_a, 5);
+    p = gst_spill_file_read(spill, off_b, 6);
+    g_assert_nonnull(p);
+    g_assert_true(memcmp(p, "world!", 6) == 0);
+
+    /* Out of range */
+    g_assert_null(gst_spill_file_read(spill, off_c, sizeof(big) + 1));
+    g_assert_null(gst_spill_file_read(spill, 0, 0));
+
+    gst_spill_file_free(spill);
+    g_free(dir);
+}
+
+static void
+test_spill_file_bad_dir(void)
+{
+    GError *error;
+
+    error = NULL;
+    g_assert_null(gst_spill_file_new("/dev/null/gst", &error));
+    g_assert_nonnull(error);
+    g_error_free(error);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/spill-file/roundtrip", test_spill_file_roundtrip);
+    g_test_add_func("/spill-file/bad-dir", test_spill_file_bad_dir);
+
+    return g_test_run();
+}
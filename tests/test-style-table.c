@@ -0,0 +1,203 @@
+/*
+ * test-style-table.c - Tests for packed cells and GstStyleTable
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include <string.h>
+#include "core/gst-style-table.h"
+
+static void
+test_style_table_default(void)
+{
+    GstStyleTable *table;
+    const GstStyle *style;
+    guint16 id;
+
+    table = gst_style_table_new();
+    g_assert_cmpuint(gst_style_table_get_size(table), ==, 1);
+
+    g_assert_true(gst_style_table_intern(table, GST_GLYPH_ATTR_NONE,
+        GST_COLOR_DEFAULT_FG, GST_COLOR_DEFAULT_BG, &id));
+    g_assert_cmpuint(id, ==, GST_STYLE_ID_DEFAULT);
+
+    style = gst_style_table_lookup(table, GST_STYLE_ID_DEFAULT);
+    g_assert_nonnull(style);
+    g_assert_cmpuint(style->fg, ==, GST_COLOR_DEFAULT_FG);
+    g_assert_null(gst_style_table_lookup(table, 1));
+
+    gst_style_table_free(table);
+}
+
+static void
+test_style_table_intern(void)
+{
+    GstStyleTable *table;
+    guint16 a;
+    guint16 b;
+    guint16 c;
+
+    table = gst_style_table_new();
+
+    /* Equal styles share an ID, different ones do not */
+    gst_style_table_intern(table, GST_GLYPH_ATTR_BOLD, 1, 2, &a);
+    gst_style_table_intern(table, GST_GLYPH_ATTR_NONE, 3, 4, &b);
+    gst_style_table_intern(table, GST_GLYPH_ATTR_BOLD, 1, 2, &c);
+    g_assert_cmpuint(a, !=, b);
+    g_assert_cmpuint(a, ==, c);
+    g_assert_cmpuint(gst_style_table_get_size(table), ==, 3);
+
+    /* Clearing leaves only the default style */
+    gst_style_table_clear(table);
+    g_assert_cmpuint(gst_style_table_get_size(table), ==, 1);
+
+    gst_style_table_free(table);
+}
+
+static void
+test_style_table_pack_row(void)
+{
+    GstStyleTable *table;
+    GstGlyph in[4];
+    GstGlyph out[4];
+    GstPackedCell cells[4];
+    gint i;
+
+    g_assert_cmpuint(sizeof(GstPackedCell), ==, 8);
+
+    in[0].rune = 'a';
+    in[0].attr = GST_GLYPH_ATTR_NONE;
+    in[0].fg = GST_COLOR_DEFAULT_FG;
+    in[0].bg = GST_COLOR_DEFAULT_BG;
+    in[1].rune = 0x10ffff;
+    in[1].attr = GST_GLYPH_ATTR_ITALIC | GST_GLYPH_ATTR_UNDERLINE;
+    in[1].fg = 0x00ff8000;
+    in[1].bg = 17;
+    in[2].rune = 0x4e2d;
+    in[2].attr = GST_GLYPH_ATTR_WIDE;
+    in[2].fg = 1;
+    in[2].bg = 2;
+    in[3] = in[2];
+    in[3].rune = 0;
+    in[3].attr = GST_GLYPH_ATTR_WDUMMY;
+
+    table = gst_style_table_new();
+    g_assert_true(gst_style_table_pack_row(table, in, 4, cells));
+    g_assert_cmpuint(GST_PACKED_CELL_STYLE(cells[0]), ==,
+        GST_STYLE_ID_DEFAULT);
+    g_assert_cmpuint(GST_PACKED_CELL_RUNE(cells[1]), ==, 0x10ffff);
+
+    gst_style_table_unpack_row(table, cells, 4, out);
+    for (i = 0; i < 4; i++) {
+        g_assert_cmpuint(out[i].rune, ==, in[i].rune);
+        g_assert_cmpuint(out[i].attr, ==, in[i].attr);
+        g_assert_cmpuint(out[i].fg, ==, in[i].fg);
+        g_assert_cmpuint(out[i].bg, ==, in[i].bg);
+    }
+
+    gst_style_table_free(table);
+}
+
+static void
+test_style_table_full(void)
+{
+    GstStyleTable *table;
+    guint16 id;
+    guint32 i;
+
+    table = gst_style_table_new();
+
+    for (i = 1; i < GST_STYLE_TABLE_MAX; i++) {
+        g_assert_true(gst_style_table_intern(table, GST_GLYPH_ATTR_NONE,
+            i, 0, &id));
+    }
+    g_assert_cmpuint(gst_style_table_get_size(table), ==,
+        GST_STYLE_TABLE_MAX);
+
+    /* New styles are refused, known ones still resolve */
+    g_assert_false(gst_style_table_intern(table, GST_GLYPH_ATTR_BOLD,
+        0, 0, &id));
+    g_assert_true(gst_style_table_intern(table, GST_GLYPH_ATTR_NONE,
+        5, 0, &id));
+    g_assert_cmpuint(id, ==, 5);
+
+    gst_style_table_free(table);
+}
+
+static void
+test_style_table_repack_row(void)
+{
+    GstStyleTable *old;
+    GstStyleTable *fresh;
+    GstStyleTable *full;
+    GstGlyph in[3];
+    GstGlyph out[3];
+    GstPackedCell cells[3];
+    GstPackedCell saved[3];
+    guint16 id;
+    guint32 i;
+
+    old = gst_style_table_new();
+    for (i = 1; i < 100; i++) {
+        gst_style_table_intern(old, GST_GLYPH_ATTR_NONE, i, 0, &id);
+    }
+
+    memset(in, 0, sizeof(in));
+    in[0].rune = 'a';
+    in[0].fg = 42;
+    in[1].rune = 'b';
+    in[1].attr = GST_GLYPH_ATTR_BOLD;
+    in[1].fg = 7;
+    in[1].bg = 3;
+    in[2].rune = 'c';
+    in[2].attr = GST_GLYPH_ATTR_NONE;
+    in[2].fg = GST_COLOR_DEFAULT_FG;
+    in[2].bg = GST_COLOR_DEFAULT_BG;
+    g_assert_true(gst_style_table_pack_row(old, in, 3, cells));
+
+    /* Only the styles in use move over, and the cells still unpack */
+    fresh = gst_style_table_new();
+    g_assert_true(gst_style_table_repack_row(old, fresh, cells, 3));
+    g_assert_cmpuint(gst_style_table_get_size(fresh), ==, 3);
+    g_assert_cmpuint(GST_PACKED_CELL_STYLE(cells[2]), ==,
+        GST_STYLE_ID_DEFAULT);
+    gst_style_table_free(old);
+
+    gst_style_table_unpack_row(fresh, cells, 3, out);
+    for (i = 0; i < 3; i++) {
+        g_assert_cmpuint(out[i].rune, ==, in[i].rune);
+        g_assert_cmpuint(out[i].attr, ==, in[i].attr);
+        g_assert_cmpuint(out[i].fg, ==, in[i].fg);
+        g_assert_cmpuint(out[i].bg, ==, in[i].bg);
+    }
+
+    /* A full target leaves the cells as they were */
+    full = gst_style_table_new();
+    for (i = 1; i < GST_STYLE_TABLE_MAX; i++) {
+        gst_style_table_intern(full, GST_GLYPH_ATTR_ITALIC, i, 0, &id);
+    }
+    memcpy(saved, cells, sizeof(cells));
+    g_assert_false(gst_style_table_repack_row(fresh, full, cells, 3));
+    g_assert_cmpmem(saved, sizeof(saved), cells, sizeof(cells));
+
+    gst_style_table_free(fresh);
+    gst_style_table_free(full);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/style-table/default", test_style_table_default);
+    g_test_add_func("/style-table/intern", test_style_table_intern);
+    g_test_add_func("/style-table/pack-row", test_style_table_pack_row);
+    g_test_add_func("/style-table/full", test_style_table_full);
+    g_test_add_func("/style-table/repack-row", test_style_table_repack_row);
+
+    return g_test_run();
+}
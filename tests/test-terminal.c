@@ -6,6 +6,7 @@
  */
 
 #include <glib.h>
+#include <string.h>
 #include "core/gst-terminal.h"
 #include "core/gst-line.h"
 
@@ -36,6 +37,43 @@ test_terminal_resize(void)
     g_object_unref(term);
 }
 
+static void
+test_terminal_resize_content(void)
+{
+    GstTerminal *term;
+    GstGlyph *glyph;
+
+    term = gst_terminal_new(10, 4);
+
+    /* Scroll once so the row table no longer matches slot order */
+    gst_terminal_write(term, "0\r\n1\r\n2\r\n3\r\nabcdefghij", -1);
+    glyph = gst_terminal_get_glyph(term, 0, 0);
+    g_assert_cmpuint(glyph->rune, ==, '1');
+
+    /* Shrinking keeps the surviving cells */
+    gst_terminal_resize(term, 5, 3);
+    glyph = gst_terminal_get_glyph(term, 0, 2);
+    g_assert_cmpuint(glyph->rune, ==, '3');
+
+    /* Growing back within capacity blanks what was cut off */
+    gst_terminal_resize(term, 10, 4);
+    glyph = gst_terminal_get_glyph(term, 0, 0);
+    g_assert_cmpuint(glyph->rune, ==, '1');
+    glyph = gst_terminal_get_glyph(term, 0, 3);
+    g_assert_cmpuint(glyph->rune, ==, ' ');
+
+    /* Growing past capacity keeps content in screen order */
+    gst_terminal_resize(term, 20, 6);
+    glyph = gst_terminal_get_glyph(term, 0, 2);
+    g_assert_cmpuint(glyph->rune, ==, '3');
+    glyph = gst_terminal_get_glyph(term, 15, 2);
+    g_assert_cmpuint(glyph->rune, ==, ' ');
+    glyph = gst_terminal_get_glyph(term, 0, 5);
+    g_assert_cmpuint(glyph->rune, ==, ' ');
+
+    g_object_unref(term);
+}
+
 static void
 test_terminal_cursor(void)
 {
@@ -167,6 +205,280 @@ test_terminal_reset(void)
     g_object_unref(term);
 }
 
+static void
+test_terminal_write_ascii_run(void)
+{
+    GstTerminal *term;
+    GstGlyph *glyph;
+    GstCursor *cursor;
+
+    term = gst_terminal_new(10, 4);
+
+    /* A run longer than the line wraps onto the next row */
+    gst_terminal_write(term, "abcdefghijKLM", -1);
+
+    glyph = gst_terminal_get_glyph(term, 9, 0);
+    g_assert_cmpuint(glyph->rune, ==, 'j');
+    g_assert_true((glyph->attr & GST_GLYPH_ATTR_WRAP) != 0);
+
+    glyph = gst_terminal_get_glyph(term, 2, 1);
+    g_assert_cmpuint(glyph->rune, ==, 'M');
+
+    cursor = gst_terminal_get_cursor(term);
+    g_assert_cmpint(cursor->x, ==, 3);
+    g_assert_cmpint(cursor->y, ==, 1);
+
+    /* Overwriting half of a wide char blanks the other half */
+    gst_terminal_write(term, "\r\xe4\xb8\xad", -1);
+    gst_terminal_write(term, "\rx", -1);
+
+    glyph = gst_terminal_get_glyph(term, 1, 1);
+    g_assert_cmpuint(glyph->rune, ==, ' ');
+    g_assert_false((glyph->attr & GST_GLYPH_ATTR_WDUMMY) != 0);
+
+    /* Without autowrap the run piles up on the last column */
+    gst_terminal_set_mode(term, GST_MODE_WRAP, FALSE);
+    gst_terminal_set_cursor_pos(term, 0, 2);
+    gst_terminal_write(term, "0123456789XYZ", -1);
+
+    glyph = gst_terminal_get_glyph(term, 9, 2);
+    g_assert_cmpuint(glyph->rune, ==, 'Z');
+    glyph = gst_terminal_get_glyph(term, 0, 3);
+    g_assert_cmpuint(glyph->rune, ==, ' ');
+
+    g_object_unref(term);
+}
+
+/* Checks that two terminals hold the same cells and cursor */
+static void
+assert_same_screen(
+    GstTerminal *a,
+    GstTerminal *b
+){
+    gint cols;
+    gint rows;
+    gint x;
+    gint y;
+
+    gst_terminal_get_size(a, &cols, &rows);
+    for (y = 0; y < rows; y++) {
+        for (x = 0; x < cols; x++) {
+            GstGlyph *ga;
+            GstGlyph *gb;
+
+            ga = gst_terminal_get_glyph(a, x, y);
+            gb = gst_terminal_get_glyph(b, x, y);
+            g_assert_cmpuint(ga->rune, ==, gb->rune);
+            g_assert_cmpuint(ga->attr, ==, gb->attr);
+        }
+    }
+    g_assert_cmpint(gst_terminal_get_cursor(a)->x, ==,
+        gst_terminal_get_cursor(b)->x);
+    g_assert_cmpint(gst_terminal_get_cursor(a)->y, ==,
+        gst_terminal_get_cursor(b)->y);
+    g_assert_cmpuint(gst_terminal_get_cursor(a)->state, ==,
+        gst_terminal_get_cursor(b)->state);
+}
+
+static void
+test_terminal_write_utf8_run(void)
+{
+    /* Wide chars at the margin, a combining accent, a C1 NEL */
+    static const gchar text[] =
+        "abc\xe4\xb8\xad\xe6\x96\x87"
+        "e\xcc\x81\xc3\xa9\xc2\x85x\xe4\xb8\xad";
+    GstTerminal *bulk;
+    GstTerminal *single;
+    const gchar *p;
+    GstGlyph *glyph;
+
+    bulk = gst_terminal_new(6, 4);
+    single = gst_terminal_new(6, 4);
+
+    gst_terminal_write(bulk, text, -1);
+    for (p = text; *p != '\0'; p = g_utf8_next_char(p)) {
+        gst_terminal_put_char(single, (GstRune)g_utf8_get_char(p));
+    }
+    assert_same_screen(bulk, single);
+
+    /* The wide char that did not fit wrapped to the next row */
+    glyph = gst_terminal_get_glyph(bulk, 0, 1);
+    g_assert_cmpuint(glyph->rune, ==, 0x6587);
+    g_assert_true((glyph->attr & GST_GLYPH_ATTR_WIDE) != 0);
+    glyph = gst_terminal_get_glyph(bulk, 1, 1);
+    g_assert_true((glyph->attr & GST_GLYPH_ATTR_WDUMMY) != 0);
+
+    /* The accent replaced its base cell */
+    glyph = gst_terminal_get_glyph(bulk, 2, 1);
+    g_assert_cmpuint(glyph->rune, ==, 0x301);
+
+    /* A sequence split across writes is still decoded */
+    gst_terminal_write(bulk, "\r\xe6\x96", -1);
+    gst_terminal_write(bulk, "\x87z", -1);
+    gst_terminal_write(single, "\r", -1);
+    gst_terminal_put_char(single, 0x6587);
+    gst_terminal_put_char(single, 'z');
+    assert_same_screen(bulk, single);
+
+    g_object_unref(bulk);
+    g_object_unref(single);
+}
+
+static void
+test_terminal_dirty_span(void)
+{
+    GstTerminal *term;
+    GstLine *line;
+    gint x1;
+    gint x2;
+
+    term = gst_terminal_new(80, 4);
+    gst_terminal_clear_dirty(term);
+
+    line = gst_terminal_get_line(term, 0);
+    g_assert_false(gst_line_get_dirty_span(line, &x1, &x2));
+
+    /* Printing damages only the cells written (plus wide partners) */
+    gst_terminal_set_cursor_pos(term, 40, 0);
+    gst_terminal_write(term, "ab", -1);
+    g_assert_true(gst_line_get_dirty_span(line, &x1, &x2));
+    g_assert_cmpint(x1, >=, 39);
+    g_assert_cmpint(x2, <=, 43);
+    g_assert_cmpint(x1, <=, 40);
+    g_assert_cmpint(x2, >=, 42);
+
+    /* Expansion grows to the surrounding word */
+    x1 = 41;
+    x2 = 42;
+    gst_line_expand_span(line, &x1, &x2);
+    g_assert_cmpint(x1, ==, 40);
+    g_assert_cmpint(x2, ==, 42);
+
+    /* Erase to end of line widens the span to the right edge */
+    gst_terminal_write(term, "\033[10G\033[K", -1);
+    g_assert_true(gst_line_get_dirty_span(line, &x1, &x2));
+    g_assert_cmpint(x1, ==, 9);
+    g_assert_cmpint(x2, ==, 80);
+
+    /* A full-line mark covers the whole line */
+    gst_terminal_clear_dirty(term);
+    gst_terminal_mark_dirty(term, 1);
+    line = gst_terminal_get_line(term, 1);
+    g_assert_true(gst_line_get_dirty_span(line, &x1, &x2));
+    g_assert_cmpint(x1, ==, 0);
+    g_assert_cmpint(x2, ==, 80);
+
+    g_object_unref(term);
+}
+
+static void
+test_terminal_scroll_log(void)
+{
+    GstTerminal *term;
+    const GstScrollOp *ops;
+    guint n_ops;
+
+    term = gst_terminal_new(80, 10);
+    gst_terminal_clear_dirty(term);
+
+    /* Consecutive scrolls of one region merge into a single entry */
+    gst_terminal_scroll_up(term, 0, 1);
+    gst_terminal_scroll_up(term, 0, 2);
+    ops = gst_terminal_get_scroll_log(term, &n_ops);
+    g_assert_cmpuint(n_ops, ==, 1);
+    g_assert_cmpint(ops[0].top, ==, 0);
+    g_assert_cmpint(ops[0].bot, ==, 9);
+    g_assert_cmpint(ops[0].n, ==, 3);
+
+    /* Moved rows stay clean; only the exposed rows need drawing */
+    g_assert_false(gst_line_is_dirty(gst_terminal_get_line(term, 0)));
+    g_assert_false(gst_line_is_dirty(gst_terminal_get_line(term, 6)));
+    g_assert_true(gst_line_is_dirty(gst_terminal_get_line(term, 7)));
+    g_assert_true(gst_line_is_dirty(gst_terminal_get_line(term, 9)));
+
+    /* A scroll the other way starts a new entry */
+    gst_terminal_scroll_down(term, 0, 1);
+    ops = gst_terminal_get_scroll_log(term, &n_ops);
+    g_assert_cmpuint(n_ops, ==, 2);
+    g_assert_cmpint(ops[1].n, ==, -1);
+
+    gst_terminal_clear_dirty(term);
+    gst_terminal_get_scroll_log(term, &n_ops);
+    g_assert_cmpuint(n_ops, ==, 0);
+
+    /* After a full repaint request, scrolls mark moved rows dirty */
+    gst_terminal_mark_dirty(term, -1);
+    gst_terminal_scroll_up(term, 0, 1);
+    gst_terminal_get_scroll_log(term, &n_ops);
+    g_assert_cmpuint(n_ops, ==, 0);
+    gst_terminal_clear_dirty(term);
+    gst_terminal_scroll_up(term, 0, 1);
+    g_assert_false(gst_line_is_dirty(gst_terminal_get_line(term, 0)));
+
+    g_object_unref(term);
+}
+
+typedef struct {
+    gint emissions;
+    gint lines;
+    GstRune first_rune;
+} ScrolledOut;
+
+static void
+on_lines_scrolled_out(
+    GstTerminal *term,
+    GstLine     **lines,
+    gint        n_lines,
+    gint        cols,
+    gpointer    user_data
+){
+    ScrolledOut *out;
+
+    (void)term;
+    (void)cols;
+
+    out = (ScrolledOut *)user_data;
+    if (out->lines == 0) {
+        out->first_rune = lines[0]->glyphs[0].rune;
+    }
+    out->emissions++;
+    out->lines += n_lines;
+}
+
+static void
+test_terminal_lines_scrolled_out(void)
+{
+    GstTerminal *term;
+    ScrolledOut out;
+    GString *text;
+    gint i;
+
+    term = gst_terminal_new(20, 4);
+    memset(&out, 0, sizeof(out));
+    g_signal_connect(term, "lines-scrolled-out",
+        G_CALLBACK(on_lines_scrolled_out), &out);
+
+    /* A whole write scrolls out as one batch, oldest line first */
+    text = g_string_new(NULL);
+    for (i = 0; i < 50; i++) {
+        g_string_append_printf(text, "%c\r\n", 'a' + (i % 26));
+    }
+    gst_terminal_write(term, text->str, (gssize)text->len);
+    g_string_free(text, TRUE);
+
+    g_assert_cmpint(out.emissions, ==, 1);
+    g_assert_cmpint(out.lines, ==, 47);
+    g_assert_cmpuint(out.first_rune, ==, 'a');
+
+    /* Outside a write, each scroll call is its own batch */
+    memset(&out, 0, sizeof(out));
+    gst_terminal_scroll_up(term, 0, 3);
+    g_assert_cmpint(out.emissions, ==, 1);
+    g_assert_cmpint(out.lines, ==, 3);
+
+    g_object_unref(term);
+}
+
 int
 main(
     int     argc,
@@ -176,12 +488,19 @@ main(
 
     g_test_add_func("/terminal/new", test_terminal_new);
     g_test_add_func("/terminal/resize", test_terminal_resize);
+    g_test_add_func("/terminal/resize-content", test_terminal_resize_content);
     g_test_add_func("/terminal/cursor", test_terminal_cursor);
     g_test_add_func("/terminal/put-char", test_terminal_put_char);
     g_test_add_func("/terminal/modes", test_terminal_modes);
     g_test_add_func("/terminal/clear", test_terminal_clear);
     g_test_add_func("/terminal/scroll-region", test_terminal_scroll_region);
     g_test_add_func("/terminal/reset", test_terminal_reset);
+    g_test_add_func("/terminal/write-ascii-run", test_terminal_write_ascii_run);
+    g_test_add_func("/terminal/write-utf8-run", test_terminal_write_utf8_run);
+    g_test_add_func("/terminal/dirty-span", test_terminal_dirty_span);
+    g_test_add_func("/terminal/scroll-log", test_terminal_scroll_log);
+    g_test_add_func("/terminal/lines-scrolled-out",
+                    test_terminal_lines_scrolled_out);
 
     return g_test_run();
 }
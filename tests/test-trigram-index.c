@@ -0,0 +1,212 @@
+/*
+ * test-trigram-index.c - Tests for GstTrigramIndex
+ *
+ * Copyright (C) 2026 Zach Podbielniak
+ * SPDX-License-Identifier: AGPL-3.0-or-later
+ */
+
+#include <glib.h>
+#include <string.h>
+#include "core/gst-trigram-index.h"
+
+/* Indexes an ASCII line @cols cells wide */
+static guint64
+add_text(
+    GstTrigramIndex *index,
+    const gchar     *text,
+    gint             cols
+){
+    GstGlyph glyphs[256];
+    gint len;
+    gint i;
+
+    len = (gint)strlen(text);
+    memset(glyphs, 0, sizeof(glyphs));
+    for (i = 0; i < len; i++) {
+        glyphs[i].rune = (GstRune)text[i];
+    }
+    return gst_trigram_index_add_line(index, glyphs, len, MAX(cols, len));
+}
+
+/* Looks up @pattern; returns the candidates, or NULL if unnarrowed */
+static GArray *
+lookup(
+    GstTrigramIndex *index,
+    const gchar     *pattern,
+    gboolean         regex
+){
+    GArray *seqs;
+
+    seqs = g_array_new(FALSE, FALSE, sizeof(guint64));
+    if (!gst_trigram_index_lookup(index, pattern, regex, seqs)) {
+        g_array_free(seqs, TRUE);
+        return NULL;
+    }
+    return seqs;
+}
+
+static gboolean
+has_seq(
+    GArray  *seqs,
+    guint64  seq
+){
+    guint i;
+
+    for (i = 0; i < seqs->len; i++) {
+        if (g_array_index(seqs, guint64, i) == seq) {
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static void
+test_trigram_index_literal(void)
+{
+    GstTrigramIndex *index;
+    GArray *seqs;
+
+    index = gst_trigram_index_new();
+    g_assert_cmpuint(add_text(index, "make: *** [all] Error 1", 80), ==, 0);
+    add_text(index, "compiling gst-terminal.c", 80);
+    add_text(index, "ERROR: disk full", 80);
+    add_text(index, "", 80);
+    g_assert_cmpuint(gst_trigram_index_get_next_seq(index), ==, 4);
+
+    /* Caseless superset, newest first */
+    seqs = lookup(index, "error", FALSE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 2);
+    g_assert_cmpuint(g_array_index(seqs, guint64, 0), ==, 2);
+    g_assert_cmpuint(g_array_index(seqs, guint64, 1), ==, 0);
+    g_array_free(seqs, TRUE);
+
+    seqs = lookup(index, "terminal", FALSE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 1);
+    g_assert_true(has_seq(seqs, 1));
+    g_array_free(seqs, TRUE);
+
+    seqs = lookup(index, "nowhere", FALSE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 0);
+    g_array_free(seqs, TRUE);
+
+    /* The blank tail reads as spaces */
+    seqs = lookup(index, "full  ", FALSE);
+    g_assert_nonnull(seqs);
+    g_assert_true(has_seq(seqs, 2));
+    g_array_free(seqs, TRUE);
+
+    /* Too short to narrow anything */
+    g_assert_null(lookup(index, "er", FALSE));
+
+    gst_trigram_index_free(index);
+}
+
+static void
+test_trigram_index_regex(void)
+{
+    GstTrigramIndex *index;
+    GArray *seqs;
+
+    index = gst_trigram_index_new();
+    add_text(index, "foo = bar", 40);
+    add_text(index, "xyzacde", 40);
+    add_text(index, "value: 0x41", 40);
+    add_text(index, "foobar", 40);
+
+    seqs = lookup(index, "foo.*bar", TRUE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 2);
+    g_assert_true(has_seq(seqs, 0));
+    g_assert_true(has_seq(seqs, 3));
+    g_array_free(seqs, TRUE);
+
+    /* Optional characters do not join their neighbours */
+    seqs = lookup(index, "xyzab*cde", TRUE);
+    g_assert_nonnull(seqs);
+    g_assert_true(has_seq(seqs, 1));
+    g_array_free(seqs, TRUE);
+
+    /* Escapes break runs; their arguments are not literals */
+    seqs = lookup(index, "\\bvalue\\b: \\x30x41", TRUE);
+    g_assert_nonnull(seqs);
+    g_assert_true(has_seq(seqs, 2));
+    g_array_free(seqs, TRUE);
+
+    seqs = lookup(index, "\\Qfoo = b\\E", TRUE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 1);
+    g_assert_true(has_seq(seqs, 0));
+    g_array_free(seqs, TRUE);
+
+    /* Nothing every match must contain */
+    g_assert_null(lookup(index, "foo|bar", TRUE));
+    g_assert_null(lookup(index, "(?x) f o o", TRUE));
+    g_assert_null(lookup(index, "[a-z]+\\d*", TRUE));
+
+    gst_trigram_index_free(index);
+}
+
+static void
+test_trigram_index_drop(void)
+{
+    GstTrigramIndex *index;
+    GArray *seqs;
+    gchar buf[64];
+    guint64 i;
+
+    index = gst_trigram_index_new();
+
+    /* Spans several sealed segments */
+    for (i = 0; i < 10000; i++) {
+        g_snprintf(buf, sizeof(buf), "line %" G_GUINT64_FORMAT " id%s",
+            i, (i % 1000 == 7) ? "needle" : "hay");
+        add_text(index, buf, 80);
+    }
+
+    seqs = lookup(index, "needle", FALSE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 10);
+    g_assert_cmpuint(g_array_index(seqs, guint64, 0), ==, 9007);
+    g_assert_cmpuint(g_array_index(seqs, guint64, 9), ==, 7);
+    g_array_free(seqs, TRUE);
+
+    gst_trigram_index_drop_before(index, 5000);
+    seqs = lookup(index, "needle", FALSE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 5);
+    g_assert_cmpuint(g_array_index(seqs, guint64, 4), ==, 5007);
+    g_array_free(seqs, TRUE);
+
+    /* Dropping everything empties the open segment too */
+    gst_trigram_index_drop_before(index, 10000);
+    seqs = lookup(index, "needle", FALSE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 0);
+    g_array_free(seqs, TRUE);
+
+    add_text(index, "one more needle", 80);
+    seqs = lookup(index, "needle", FALSE);
+    g_assert_nonnull(seqs);
+    g_assert_cmpuint(seqs->len, ==, 1);
+    g_assert_cmpuint(g_array_index(seqs, guint64, 0), ==, 10000);
+    g_array_free(seqs, TRUE);
+
+    gst_trigram_index_free(index);
+}
+
+int
+main(
+    int     argc,
+    char    **argv
+){
+    g_test_init(&argc, &argv, NULL);
+
+    g_test_add_func("/trigram-index/literal", test_trigram_index_literal);
+    g_test_add_func("/trigram-index/regex", test_trigram_index_regex);
+    g_test_add_func("/trigram-index/drop", test_trigram_index_drop);
+
+    return g_test_run();
+}